@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <filesystem>
+#include <string_view>
+
+#include "core/math/types.h"
+#include "core/common/ctor.h"
+
+
+enum class BandFormat : uint8_t {
+    // float32 samples, native byte order, rows from top to bottom, without a header
+    Raw = 0,
+    // portable float map (HDR as EXR, readable by most image tools), rows from bottom to top
+    Pfm = 1,
+    // 16-bit grayscale portable graymap (lossless as PNG), values are mapped from [minValue, maxValue]
+    Pgm = 2,
+};
+
+BandFormat BandFormatFromString(std::string_view value);
+
+// Streams the bands of TileSampler to an image file, only the current band is kept in memory
+class BandWriter : Fixed {
+public:
+    BandWriter() = delete;
+    BandWriter(const std::filesystem::path& path, BandFormat format, math::Size size, float minValue, float maxValue);
+    ~BandWriter() = default;
+
+    // TileSampler::Sample must pass the bands from bottom to top
+    bool IsBottomUp() const noexcept { return (m_format == BandFormat::Pfm); }
+    // rows of the band from top to bottom
+    void Write(const float* rows, uint32_t rowsCount);
+    // returns the file size in bytes
+    uint64_t Finish();
+
+private:
+    void WriteHeader();
+
+private:
+    BandFormat m_format;
+    math::Size m_size;
+    float m_minValue;
+    float m_maxValue;
+    uint32_t m_writtenRows = 0;
+    std::filesystem::path m_path;
+    std::ofstream m_file;
+};
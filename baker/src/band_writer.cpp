@@ -0,0 +1,100 @@
+#include "baker/band_writer.h"
+
+#include <cmath>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+#include "fmt/fmt.h"
+#include "core/common/exception.h"
+
+
+BandFormat BandFormatFromString(std::string_view value) {
+    if (value == "raw") {
+        return BandFormat::Raw;
+    }
+    if (value == "pfm") {
+        return BandFormat::Pfm;
+    }
+    if (value == "pgm") {
+        return BandFormat::Pgm;
+    }
+
+    throw EngineError("unknown output format '{}', expected raw, pfm or pgm", value);
+}
+
+BandWriter::BandWriter(const std::filesystem::path& path, BandFormat format, math::Size size, float minValue, float maxValue)
+    : m_format(format)
+    , m_size(size)
+    , m_minValue(minValue)
+    , m_maxValue(maxValue)
+    , m_path(path)
+    , m_file(path.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc) {
+
+    if (!m_file) {
+        throw EngineError("BandWriter: couldn't open file '{}', error: {}", path.c_str(), strerror(errno));
+    }
+    if ((format == BandFormat::Pgm) && !(maxValue > minValue)) {
+        throw EngineError("BandWriter: maxValue ({}) must be greater than minValue ({})", maxValue, minValue);
+    }
+
+    WriteHeader();
+}
+
+void BandWriter::Write(const float* rows, uint32_t rowsCount) {
+    const size_t rowSize = static_cast<size_t>(m_size.w);
+    if (m_format == BandFormat::Pgm) {
+        // big-endian 16-bit samples
+        const float scale = 65535.f / (m_maxValue - m_minValue);
+        std::vector<uint8_t> row(rowSize * 2);
+        for (uint32_t y=0; y!=rowsCount; ++y) {
+            const float* src = rows + y * rowSize;
+            for (size_t x=0; x!=rowSize; ++x) {
+                const float value = std::clamp((src[x] - m_minValue) * scale, 0.f, 65535.f);
+                const auto sample = static_cast<uint16_t>(std::lround(value));
+                row[x * 2] = static_cast<uint8_t>(sample >> 8);
+                row[x * 2 + 1] = static_cast<uint8_t>(sample & 0xFF);
+            }
+            m_file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+        }
+    } else if (IsBottomUp()) {
+        for (uint32_t y=rowsCount; y!=0; --y) {
+            m_file.write(reinterpret_cast<const char*>(rows + (y - 1) * rowSize), static_cast<std::streamsize>(rowSize * sizeof(float)));
+        }
+    } else {
+        m_file.write(reinterpret_cast<const char*>(rows), static_cast<std::streamsize>(rowSize * rowsCount * sizeof(float)));
+    }
+
+    if (!m_file) {
+        throw EngineError("BandWriter: couldn't write file '{}', error: {}", m_path.c_str(), strerror(errno));
+    }
+    m_writtenRows += rowsCount;
+}
+
+uint64_t BandWriter::Finish() {
+    if (m_writtenRows != m_size.h) {
+        throw EngineError("BandWriter: written {} rows, expected {}", m_writtenRows, m_size.h);
+    }
+    m_file.close();
+    if (!m_file) {
+        throw EngineError("BandWriter: couldn't close file '{}', error: {}", m_path.c_str(), strerror(errno));
+    }
+
+    return static_cast<uint64_t>(std::filesystem::file_size(m_path));
+}
+
+void BandWriter::WriteHeader() {
+    std::string header;
+    if (m_format == BandFormat::Pfm) {
+        // negative scale - little-endian samples
+        header = fmt::format("Pf\n{} {}\n-1.0\n", m_size.w, m_size.h);
+    } else if (m_format == BandFormat::Pgm) {
+        header = fmt::format("P5\n{} {}\n65535\n", m_size.w, m_size.h);
+    }
+
+    if (!header.empty()) {
+        m_file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    }
+}
@@ -0,0 +1,226 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <algorithm>
+#include <string_view>
+
+#include "cpgf/variant.h"
+#include "baker/band_writer.h"
+#include "core/common/timer.h"
+#include "core/common/exception.h"
+#include "core/math/generator_type.h"
+#include "middleware/gschema/graph/gs_graph.h"
+#include "middleware/gschema/graph/gs_class_storage.h"
+#include "middleware/generator/texture/tile_sampler.h"
+#include "middleware/generator/texture/section_plane.h"
+
+
+namespace {
+
+// exit code if the throughput is less than --min-msps, to detect performance regressions in CI
+constexpr const int EXIT_SLOW = 2;
+
+constexpr const char* USAGE =
+    "usage: terra_baker --schema <file> --node <id> [options]\n"
+    "Evaluates the gs schema without a window and GPU and bakes the generator output to a file\n"
+    "  --schema <file>      schema saved by gs::Graph::SaveToFile\n"
+    "  --node <id>          node with the Generator2d, Generator3d or Float output\n"
+    "  --pin <offset>       output pin offset of the node, default 0\n"
+    "  --rect x,y,w,h       region in the generator space, default -5,-5,10,10\n"
+    "  --size w,h           count of samples, default 1024,1024\n"
+    "  --z <value>          offset of the XY section plane for Generator3d, default 0\n"
+    "  --tile <size>        side of the tile in samples, default 256\n"
+    "  --threads <count>    0 - all hardware threads, default 0\n"
+    "  --format <format>    raw (float32), pfm (float32) or pgm (uint16), default raw\n"
+    "  --range min,max      value range mapped to [0, 65535] for pgm, default -1,1\n"
+    "  --out <file>         output file, without it the samples are only counted\n"
+    "  --min-msps <value>   exit with code 2 if the throughput is less than value (Msamples/s)\n";
+
+struct Options {
+    std::string schemaPath;
+    uint16_t nodeId = 0;
+    uint8_t pinOffset = 0;
+    float sectionOffset = 0;
+    float minValue = -1.f;
+    float maxValue = 1.f;
+    double minThroughput = 0;
+    std::string outPath;
+    BandFormat format = BandFormat::Raw;
+    TileSamplerDesc sampler;
+};
+
+std::vector<double> ParseNumbers(std::string_view name, const std::string& value, size_t count) {
+    std::vector<double> result;
+    size_t pos = 0;
+    while (pos <= value.size()) {
+        size_t end = value.find(',', pos);
+        if (end == std::string::npos) {
+            end = value.size();
+        }
+        const std::string item = value.substr(pos, end - pos);
+        char* itemEnd = nullptr;
+        const double number = std::strtod(item.c_str(), &itemEnd);
+        if (item.empty() || (*itemEnd != '\0')) {
+            throw EngineError("wrong value '{}' of {}", value, name);
+        }
+        result.push_back(number);
+        pos = end + 1;
+    }
+
+    if (result.size() != count) {
+        throw EngineError("wrong value '{}' of {}, expected {} numbers", value, name, count);
+    }
+
+    return result;
+}
+
+template<typename T> T ToUInt(std::string_view name, double number, uint64_t maxValue) {
+    if ((number < 0) || (number > static_cast<double>(maxValue)) || (static_cast<double>(static_cast<uint64_t>(number)) < number)) {
+        throw EngineError("wrong value {} of {}, expected integer in range [0, {}]", number, name, maxValue);
+    }
+
+    return static_cast<T>(number);
+}
+
+template<typename T> T ParseUInt(std::string_view name, const std::string& value, uint64_t maxValue) {
+    return ToUInt<T>(name, ParseNumbers(name, value, 1)[0], maxValue);
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i=1; i<argc; i+=2) {
+        const std::string_view name = argv[i];
+        if ((name == "-h") || (name == "--help")) {
+            std::fputs(USAGE, stdout);
+            std::exit(EXIT_SUCCESS);
+        }
+        if (i + 1 == argc) {
+            throw EngineError("missing value of {}", name);
+        }
+
+        const std::string value = argv[i + 1];
+        if (name == "--schema") {
+            options.schemaPath = value;
+        } else if (name == "--node") {
+            options.nodeId = ParseUInt<uint16_t>(name, value, UINT16_MAX);
+        } else if (name == "--pin") {
+            options.pinOffset = ParseUInt<uint8_t>(name, value, UINT8_MAX);
+        } else if (name == "--rect") {
+            const auto v = ParseNumbers(name, value, 4);
+            options.sampler.region = math::RectF(static_cast<float>(v[0]), static_cast<float>(v[1]), static_cast<float>(v[2]), static_cast<float>(v[3]));
+        } else if (name == "--size") {
+            const auto v = ParseNumbers(name, value, 2);
+            options.sampler.size = math::Size(ToUInt<uint32_t>(name, v[0], UINT32_MAX), ToUInt<uint32_t>(name, v[1], UINT32_MAX));
+        } else if (name == "--z") {
+            options.sectionOffset = static_cast<float>(ParseNumbers(name, value, 1)[0]);
+        } else if (name == "--tile") {
+            options.sampler.tileSize = ParseUInt<uint32_t>(name, value, UINT16_MAX);
+        } else if (name == "--threads") {
+            options.sampler.threadCount = ParseUInt<uint32_t>(name, value, UINT16_MAX);
+        } else if (name == "--format") {
+            options.format = BandFormatFromString(value);
+        } else if (name == "--range") {
+            const auto v = ParseNumbers(name, value, 2);
+            options.minValue = static_cast<float>(v[0]);
+            options.maxValue = static_cast<float>(v[1]);
+        } else if (name == "--out") {
+            options.outPath = value;
+        } else if (name == "--min-msps") {
+            options.minThroughput = ParseNumbers(name, value, 1)[0];
+        } else {
+            throw EngineError("unknown option {}", name);
+        }
+    }
+
+    if (options.schemaPath.empty() || (options.nodeId == 0)) {
+        throw EngineError("--schema and --node are required");
+    }
+
+    return options;
+}
+
+// the generator functors are pure, so one generator is sampled from all threads
+math::Generator2D LoadGenerator(const Options& options) {
+    auto classStorage = std::make_shared<gs::ClassStorage>();
+    gs::Graph graph(classStorage);
+    graph.LoadFromFile(options.schemaPath);
+    graph.UpdateState();
+
+    cpgf::GVariant value;
+    const auto typeId = graph.GetOutputBaseValue(options.nodeId, options.pinOffset, value);
+    switch (typeId) {
+    case gs::TypeId::Float:
+        return math::Generator2D(cpgf::fromVariant<float>(value));
+    case gs::TypeId::Generator2d:
+        return cpgf::fromVariant<math::Generator2D>(value);
+    case gs::TypeId::Generator3d: {
+        SectionPlaneX0Y sectionPlane;
+        sectionPlane.SetOffset(options.sectionOffset);
+        sectionPlane.SetInput(cpgf::fromVariant<math::Generator3D>(value));
+        return sectionPlane.Result();
+    }
+    default:
+        throw EngineError("output type {} of node {} can not be baked, expected float or generator",
+            static_cast<uint32_t>(typeId), options.nodeId);
+    }
+}
+
+int Run(const Options& options) {
+    const auto generator = LoadGenerator(options);
+    TileSampler sampler(options.sampler);
+
+    std::unique_ptr<BandWriter> writer;
+    if (!options.outPath.empty()) {
+        writer = std::make_unique<BandWriter>(options.outPath, options.format, options.sampler.size, options.minValue, options.maxValue);
+    }
+
+    Timer timer;
+    timer.Start();
+    double writeTime = 0;
+    const bool bottomUp = (writer != nullptr) && writer->IsBottomUp();
+    sampler.Sample(generator, [&writer, &writeTime](const float* rows, uint32_t /* y */, uint32_t rowsCount) {
+        if (writer != nullptr) {
+            Timer writeTimer;
+            writeTimer.Start();
+            writer->Write(rows, rowsCount);
+            writeTime += writeTimer.TimePoint();
+        }
+    }, bottomUp);
+    const uint64_t fileSize = (writer != nullptr) ? writer->Finish() : 0;
+    const double totalTime = timer.TimePoint();
+
+    const uint64_t samples = sampler.GetSampledCount();
+    const double sampleTime = std::max(totalTime - writeTime, 1e-9);
+    const double throughput = static_cast<double>(samples) / sampleTime / 1000000.;
+    // one line with key=value pairs for CI scripts
+    std::printf("samples=%ju tiles=%u threads=%u sample_time_s=%.3f write_time_s=%.3f msamples_per_s=%.2f file_bytes=%ju\n",
+        static_cast<uintmax_t>(samples),
+        sampler.GetBandCount() * ((options.sampler.size.w + options.sampler.tileSize - 1) / options.sampler.tileSize),
+        sampler.GetThreadCount(),
+        sampleTime,
+        writeTime,
+        throughput,
+        static_cast<uintmax_t>(fileSize));
+
+    if (throughput < options.minThroughput) {
+        std::fprintf(stderr, "throughput %.2f Msamples/s is less than %.2f\n", throughput, options.minThroughput);
+        return EXIT_SLOW;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        return Run(ParseOptions(argc, argv));
+    } catch(const std::exception& e) {
+        std::fprintf(stderr, "error: %s\n%s", e.what(), USAGE);
+        return EXIT_FAILURE;
+    }
+}
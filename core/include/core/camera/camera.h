@@ -21,6 +21,11 @@ public:
 	void SetViewParams(const dg::float3& position, const dg::float3& direction);
 	dg::double3 ScreenPointToRay(math::PointF mousePos, math::SizeF screenSize) const;
 
+	// In the radians
+	float GetFovY() const noexcept {
+		return m_fovy;
+	}
+
 	float GetNearPlane() const noexcept {
 		return m_nearPlane;
 	}
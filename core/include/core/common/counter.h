@@ -1,12 +1,14 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <cstddef>
 
 
+// ids are unique for T, objects can be created from several threads
 template<typename T> class Counter {
 public:
-    Counter() : m_id(++Counter::m_lastId) {}
+    Counter() : m_id(Counter::m_lastId.fetch_add(1, std::memory_order_relaxed) + 1) {}
 
     uint32_t GetId() const noexcept { return m_id; }
 
@@ -14,10 +16,10 @@ private:
     uint32_t m_id = 0;
 
 private:
-    static uint32_t m_lastId;
+    static std::atomic<uint32_t> m_lastId;
 };
 
-template <class T> uint32_t Counter<T>::m_lastId = 0;
+template <class T> std::atomic<uint32_t> Counter<T>::m_lastId = 0;
 
 template<typename T, size_t SIZE> class CyclicalCounter {
 public:
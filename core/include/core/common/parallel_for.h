@@ -0,0 +1,58 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+#include "core/common/ctor.h"
+
+
+// threadCount == 0 - std::thread::hardware_concurrency(), the result is in [1, max(count, 1)]
+uint32_t ResolveThreadCount(uint32_t threadCount, size_t count) noexcept;
+
+// Threads for the repeated parallel loops, they are started once and sleep between the loops.
+// The calling thread takes part in each loop, so the pool starts threadCount - 1 threads.
+// ParallelFor is called from one thread at a time and func must not call ParallelFor of the same pool
+class WorkerPool : Fixed {
+public:
+    using Func = std::function<void (size_t index)>;
+
+    WorkerPool() = delete;
+    // threadCount == 0 - std::thread::hardware_concurrency()
+    explicit WorkerPool(uint32_t threadCount);
+    ~WorkerPool();
+
+    // with the calling thread
+    uint32_t GetThreadCount() const noexcept { return static_cast<uint32_t>(m_threads.size() + 1); }
+
+    // calls func(index) for each index in [0, count) and returns after all calls,
+    // after an exception the rest of indexes are skipped and the first exception is rethrown
+    void ParallelFor(size_t count, const Func& func);
+
+private:
+    void WorkerLoop();
+    void Stop() noexcept;
+    void RunLoop() noexcept;
+
+private:
+    bool m_isStopped = false;
+    uint64_t m_loopIndex = 0;
+    size_t m_activeCount = 0;
+    size_t m_count = 0;
+    std::atomic<size_t> m_nextIndex = 0;
+    const Func* m_func = nullptr;
+    std::exception_ptr m_exception;
+    std::mutex m_mutex;
+    std::condition_variable m_loopStarted;
+    std::condition_variable m_loopFinished;
+    std::vector<std::thread> m_threads;
+};
+
+// one loop on the temporary pool of ResolveThreadCount(threadCount, count) threads
+void ParallelFor(size_t count, uint32_t threadCount, const WorkerPool::Func& func);
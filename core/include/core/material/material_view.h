@@ -17,6 +17,8 @@ public:
     void SetGeometryShaderVar(const char* name, DeviceRaw value);
 
     void Bind(ContextPtr& context);
+    // skips the pipeline state and the resources, that are already bound by the previous view
+    void Bind(ContextPtr& context, const MaterialView& prev);
 
 private:
     struct Impl;
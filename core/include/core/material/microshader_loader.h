@@ -17,6 +17,7 @@ namespace ucl {
 }
 struct ucl_object_s;
 typedef ucl_object_s ucl_object_t;
+class FileView;
 class MicroshaderLoader : Fixed {
 public:
     struct Source {
@@ -50,7 +51,8 @@ public:
     Source GetSources(uint64_t mask, const msh::SemanticDecls& vertexInput) const;
 
 private:
-    bool ReadMicroshader(const std::filesystem::path& filepath, const std::string& requiredExtension, ucl_object_t* schema, ucl::Ucl& section);
+    // parses and validates the read file, filepath is used for the errors
+    void ReadMicroshader(const std::filesystem::path& filepath, const FileView& file, ucl_object_t* schema, ucl::Ucl& section);
     void ParseMicroshader(const ucl::Ucl& section, Microshader& ms);
 
 private:
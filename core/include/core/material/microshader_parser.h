@@ -24,6 +24,7 @@ struct PixelMicroshader {
     bool isOverride = false;
     Items includes;
     Items textures2D;
+    Items textures2DArray;
     SemanticDecls psInput;
     SemanticDecls psOutput;
     Decls psLocal;
@@ -25,6 +25,7 @@ public:
     void GenerateNone();
     void GenerateIncludes(std::string& out);
     void GenerateTextures(const std::string& samplerSuffix, std::string& out);
+    void GenerateTextureArrays(const std::string& samplerSuffix, std::string& out);
 
 private:
     bool m_isPreProcessed = false;
@@ -25,6 +25,9 @@ public:
     void SetDefaultDepthTarget();
     void SetDepthTarget(dg::TEXTURE_FORMAT format, const char* name = nullptr);
 
+    uint32_t GetWidth() const noexcept { return m_width; }
+    uint32_t GetHeight() const noexcept { return m_height; }
+
     uint16_t Update(uint8_t countColorTargets = 1, uint32_t width = 0, uint32_t height = 0);
     void Bind();
 
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/common/ctor.h"
+
+
+// CPU memory for the texture uploads, the buffers are kept and reused between the uploads.
+// The acquired buffer belongs to the caller until Release, it is never given to another caller,
+// if all buffers are acquired a new one is added
+class StagingBuffers : Fixed {
+public:
+    StagingBuffers() = default;
+    ~StagingBuffers() = default;
+
+    // the buffer of at least size bytes
+    uint8_t* Acquire(size_t size);
+    // the pointer that isn't acquired is ignored
+    void Release(const uint8_t* data) noexcept;
+    // frees the memory of the buffers that aren't acquired
+    void FreeReleased() noexcept;
+
+    size_t GetBufferCount() const noexcept { return m_buffers.size(); }
+    size_t GetAcquiredCount() const noexcept;
+    // size of all buffers in bytes
+    size_t GetMemorySize() const noexcept;
+
+private:
+    struct Buffer {
+        bool isAcquired = false;
+        std::vector<uint8_t> data;
+    };
+    std::vector<Buffer> m_buffers;
+};
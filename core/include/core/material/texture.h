@@ -1,45 +1,89 @@
 #pragma once
 
+#include <memory>
+#include <string>
 #include <cstdint>
 
 #include "dg/dg.h"
+#include "dg/texture.h"
 #include "dg/object_base.h"
+#include "core/math/types.h"
 #include "core/common/ctor.h"
+#include "core/material/staging_buffers.h"
+#include "core/material/texture_residency.h"
 
 
 namespace Diligent {
-    struct TextureDesc;
     class IReferenceCounters;
 }
 
+// The texture is registered in TextureResidency (if it isn't nullptr) and can be evicted as a whole,
+// when it isn't used for a while. The owner calls Restore before each use, it recreates the evicted texture
+// and returns true, if the content is lost and must be uploaded again. Get returns nullptr for the evicted texture,
+// Lock, Update and GenerateMips throw
 class DynamicTexture : public dg::ObjectBase<dg::IObject> {
 public:
+    // Locks the rect of the mip level 0 (RGBA8 texels) for write, the rect is uploaded on unlock.
+    // data points to the first texel of the rect, on GL it is the staging buffer of the texture,
+    // that is released on unlock. Several locks can be held at the same time
     struct LockHelper : Fixed {
         LockHelper() = delete;
-        LockHelper(DevicePtr& device, ContextPtr& context, TexturePtr& texture);
+        LockHelper(DynamicTexture& texture, ContextPtr& context, const math::Rect& rect, bool generateMips);
         ~LockHelper();
 
         uint8_t* data = nullptr;
         uint32_t stride = 0;
+        const uint32_t x = 0;
+        const uint32_t y = 0;
         const uint32_t width = 0;
         const uint32_t height = 0;
 
     private:
-        uint8_t* m_updateData = nullptr;
+        bool m_isMapped = false;
+        bool m_generateMips = false;
         ContextPtr m_context;
         TexturePtr m_texture;
+        dg::RefCntAutoPtr<DynamicTexture> m_owner;
     };
 
 public:
     DynamicTexture() = delete;
-    DynamicTexture(dg::IReferenceCounters* refCounters, DevicePtr& device, const dg::TextureDesc& desc);
+    DynamicTexture(dg::IReferenceCounters* refCounters, DevicePtr& device, const dg::TextureDesc& desc,
+        const std::shared_ptr<TextureResidency>& residency = nullptr);
     ~DynamicTexture();
 
+    // nullptr if the texture is evicted
     TexturePtr Get() const noexcept;
+    // returns true if the texture size is changed, the content is undefined
     bool SetSize(uint32_t width,  uint32_t height);
-    LockHelper Lock(ContextPtr& context);
+    bool IsEvicted() const noexcept { return !m_texture; }
+    // marks the texture as used and recreates the evicted texture,
+    // returns true if the content is undefined and must be uploaded again
+    bool Restore();
+    // size of the texture with all mips in bytes
+    size_t GetMemorySize() const noexcept;
+    // generateMips - regenerate all mips of the texture on unlock
+    LockHelper Lock(ContextPtr& context, bool generateMips);
+    // only the rect is uploaded
+    LockHelper Lock(ContextPtr& context, const math::Rect& rect, bool generateMips);
+    // writes only the rect of the mip level 0 (RGBA8 texels), data points to the first texel of the rect, stride in bytes.
+    // Mips aren't updated, see GenerateMips
+    void Update(ContextPtr& context, const math::Rect& rect, const uint8_t* data, uint32_t stride);
+    void GenerateMips(ContextPtr& context);
+
+private:
+    void CreateTexture();
 
 protected:
     DevicePtr m_device;
     TexturePtr m_texture;
+
+private:
+    // the desc to recreate the texture, the name is stored in m_name
+    dg::TextureDesc m_desc;
+    std::string m_name;
+    ResidentTexture m_resident;
+
+    // GL devices upload from the CPU memory, the buffers are reused between locks
+    StagingBuffers m_staging;
 };
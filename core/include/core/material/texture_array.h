@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/math/types.h"
+#include "core/material/texture_decoder.h"
+
+
+// place of the packed texture in the texture array
+struct TextureArraySlot {
+    uint32_t slice = 0;
+    // part of the slice, that is taken by the texture, in UV coordinates
+    math::RectF uvRect = math::RectF(0.f, 0.f, 1.f, 1.f);
+};
+
+// CPU side of the texture array, all slices have the same size, format and mips count
+struct PackedTextureArray {
+    std::vector<DecodedTexture> slices;
+    // slot of each packed texture in the order of the input textures
+    std::vector<TextureArraySlot> slots;
+
+    size_t ByteSize() const noexcept;
+};
+
+// Packs the small textures of the same format into the texture array, one texture per slice.
+// The slice size is the max size of the textures. The smaller uncompressed texture is placed at
+// the top left corner, the rest of the slice is filled by its edge texels (the bilinear filter
+// doesn't see the neighbour slots) and the mips are regenerated, if any texture has the mips.
+// The compressed textures must have the same size and mips count. Throws EngineError on a mismatch
+PackedTextureArray PackTextureArray(const std::vector<const DecodedTexture*>& textures);
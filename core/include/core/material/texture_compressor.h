@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/material/texture_decoder.h"
+
+
+enum class CompressionQuality : uint8_t {
+    // endpoints from the bounding box of the block
+    Fast = 0,
+    // endpoints from the principal axis, refined by the least squares
+    Normal = 1,
+    // more refinement iterations and the search around the quantized endpoints
+    High = 2,
+};
+
+struct TextureCompressorDesc {
+    BlockFormat format = BlockFormat::BC1;
+    CompressionQuality quality = CompressionQuality::Normal;
+    // 0 - std::thread::hardware_concurrency()
+    uint32_t threadCount = 0;
+};
+
+// bytes of one 4x4 block, texel size in bytes for BlockFormat::None
+size_t GetBlockSize(BlockFormat format) noexcept;
+// bytes of the image (one mip level), the partial blocks are counted as the whole blocks
+size_t CalcCompressedSize(BlockFormat format, uint32_t width, uint32_t height) noexcept;
+
+// Compresses RGBA8 texels (stride in bytes) to 4x4 blocks in the order of rows, the block rows are
+// compressed in parallel. The partial blocks on the right and bottom edges are padded by the edge texels.
+// BC7 uses only mode 6 (one subset, RGBA endpoints with p-bits, 4-bit indices)
+void CompressTexture(const TextureCompressorDesc& desc, const uint8_t* texels, uint32_t width, uint32_t height, uint32_t stride, uint8_t* blocks);
+// The blocks to RGBA8 texels as the GPU samples them: BC4 - (r, 0, 0, 255), BC5 - (r, g, 0, 255).
+// Only BC7 mode 6 is supported, it is used by CompressTexture
+void DecompressTexture(BlockFormat format, const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* texels);
+// compresses all mips of the uncompressed texture
+void CompressMips(DecodedTexture& texture, const TextureCompressorDesc& desc);
+
+// root mean square error of the first channelsCount channels of RGBA8 texels
+double CalcRMSE(const uint8_t* texels, const uint8_t* reference, size_t texelsCount, uint32_t channelsCount = 4);
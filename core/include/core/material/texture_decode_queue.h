@@ -0,0 +1,94 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <filesystem>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "core/common/ctor.h"
+#include "core/material/texture_decoder.h"
+#include "core/material/texture_compressor.h"
+
+
+enum class TextureLoadState : uint8_t {
+    // unknown id or the texture is released
+    None = 0,
+    Queued = 1,
+    Decoding = 2,
+    // decoded, the mips are waiting for the upload or are being uploaded
+    Uploading = 3,
+    Ready = 4,
+    Failed = 5,
+    Canceled = 6,
+};
+
+struct TextureLoadDesc {
+    std::filesystem::path path;
+    bool isSRGB = true;
+    // generate the mip chain on the worker thread
+    bool generateMips = true;
+    // the mips are compressed on the worker thread: BC4 for one channel (samples as (r, 0, 0, 1)), BC5 for normal maps
+    BlockFormat compression = BlockFormat::None;
+    CompressionQuality quality = CompressionQuality::Normal;
+};
+
+// Worker threads, that decode the texture files and generate the mips, the GPU side is TextureManager.
+// The decoded textures are taken by Pop in the order of completion
+class TextureDecodeQueue : Fixed {
+public:
+    // returns mip 0, throws EngineError on a failure
+    using Decoder = std::function<DecodedTexture (const TextureLoadDesc& desc)>;
+
+private:
+    struct Item {
+        TextureLoadState state = TextureLoadState::Queued;
+        TextureLoadDesc desc;
+        std::string error;
+    };
+
+public:
+    TextureDecodeQueue() = delete;
+    // threadCount == 0 - std::thread::hardware_concurrency() - 1, but at least one thread
+    TextureDecodeQueue(Decoder&& decoder, uint32_t threadCount = 0);
+    ~TextureDecodeQueue();
+
+    uint32_t Push(const TextureLoadDesc& desc);
+    // returns false if the texture is already ready, failed or unknown
+    bool Cancel(uint32_t id);
+    // forgets the texture, the decoding in progress is dropped
+    void Erase(uint32_t id);
+
+    // takes the next decoded texture, its state stays Uploading until Finish
+    bool Pop(uint32_t& id, DecodedTexture& texture);
+    // the upload is finished: Ready or Failed
+    void Finish(uint32_t id, TextureLoadState state, const std::string& error = std::string());
+
+    TextureLoadState GetState(uint32_t id) const;
+    // error message of the failed texture
+    std::string GetError(uint32_t id) const;
+    // waits until all pushed textures are decoded, failed or canceled
+    void WaitIdle();
+
+private:
+    void WorkerLoop();
+
+private:
+    Decoder m_decoder;
+    uint32_t m_nextId = 1;
+    uint32_t m_activeCount = 0;
+    bool m_isStopped = false;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_queueChanged;
+    std::condition_variable m_idle;
+    std::deque<uint32_t> m_queue;
+    std::deque<std::pair<uint32_t, DecodedTexture>> m_decoded;
+    std::unordered_map<uint32_t, Item> m_items;
+    std::vector<std::thread> m_threads;
+};
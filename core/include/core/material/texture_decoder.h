@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+
+enum class BlockFormat : uint8_t {
+    // RGBA8 texels
+    None = 0,
+    // RGB, alpha is ignored, 8 bytes per 4x4 block
+    BC1 = 1,
+    // red channel, 8 bytes per block
+    BC4 = 2,
+    // red and green channels (normal maps), 16 bytes per block
+    BC5 = 3,
+    // RGBA, 16 bytes per block
+    BC7 = 4,
+};
+
+// RGBA8 texels or the compressed 4x4 blocks of the mip level, rows from top to bottom without padding
+struct TextureMip {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> texels;
+};
+
+// CPU side of the texture, decoded on a worker thread and uploaded by TextureManager
+struct DecodedTexture {
+    // mip 0 is the image, the next mips are halved down to 1x1
+    std::vector<TextureMip> mips;
+    bool isSRGB = true;
+    BlockFormat format = BlockFormat::None;
+
+    size_t ByteSize() const noexcept;
+};
+
+// Replaces the mips after mip 0 by the full chain down to 1x1. Each texel is the 2x2 box average
+// of the previous mip (the last row and column of the odd sizes are dropped), colors of sRGB textures
+// are averaged in the linear space, alpha is always linear. The texture must be uncompressed
+void GenerateMips(DecodedTexture& texture);
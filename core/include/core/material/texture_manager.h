@@ -1,20 +1,137 @@
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+#include <optional>
+#include <cstddef>
 #include <cstdint>
+#include <unordered_map>
 
 #include "dg/dg.h"
 #include "core/common/ctor.h"
+#include "core/material/texture_array.h"
+#include "core/material/texture_residency.h"
+#include "core/material/texture_decode_queue.h"
 
 
 class DynamicTexture;
+// Creates the dynamic textures and loads the texture files asynchronously: the files are decoded
+// and the mips are generated on the worker threads (TextureDecodeQueue), the mips are uploaded
+// in Update by parts, not more than the upload budget per frame. Until the texture is ready,
+// GetTextureView returns the placeholder (1x1 gray texture).
+// The textures of the manager and the live dynamic textures are counted in TextureResidency,
+// only the dynamic textures are evicted (as a whole by LRU). The loaded textures and the arrays are bound
+// once by their users, so they stay resident. The views kept after the dynamic texture is released aren't counted.
+// The small textures of the same format can be loaded into one texture array, the materials bind the array
+// and select the texture by its slot, so they share the pipeline and the texture binding
 class TextureManager : Fixed {
+    struct LoadedTexture {
+        TexturePtr texture;
+        uint32_t residencyId = 0;
+    };
+
+    struct TextureArray {
+        std::string name;
+        TextureLoadState state = TextureLoadState::Queued;
+        std::string error;
+        // ids of the async loads in the order of the slots
+        std::vector<uint32_t> textureIds;
+        std::vector<DecodedTexture> decoded;
+        size_t decodedCount = 0;
+        std::vector<TextureArraySlot> slots;
+        TexturePtr texture;
+        uint32_t residencyId = 0;
+    };
+
+    struct Upload {
+        uint32_t id = 0;
+        DecodedTexture decoded;
+        TexturePtr texture;
+        // the next mip and row to upload
+        uint32_t mip = 0;
+        uint32_t row = 0;
+    };
+
 public:
+    // 4 MB per frame is about 1 ms of the PCIe transfer
+    static constexpr const size_t DefaultUploadBudget = 4 * 1024 * 1024;
+
     TextureManager() = delete;
-    TextureManager(DevicePtr& device);
+    TextureManager(DevicePtr& device, ContextPtr& context);
     ~TextureManager();
 
     DynamicTexture* CreateDynamicTexture(dg::TEXTURE_FORMAT format, uint32_t width = 1, uint32_t height = 1, const char* name = nullptr);
+    // immutable texture with all mips of the decoded (and maybe compressed) texture,
+    // the size of the compressed texture must be multiple of 4. It isn't counted in the memory budget
+    TexturePtr CreateStaticTexture(const DecodedTexture& decoded, const std::string& name);
+
+    // returns the id of the texture, the load starts immediately
+    uint32_t LoadTextureAsync(const TextureLoadDesc& desc);
+    TextureLoadState GetLoadState(uint32_t id) const;
+    // error message of the failed load
+    std::string GetLoadError(uint32_t id) const;
+    // returns false if the texture is already ready or failed
+    bool CancelLoad(uint32_t id);
+    // the texture view of the ready texture, or the placeholder. The texture is marked as used
+    TextureViewPtr GetTextureView(uint32_t id);
+    void ReleaseTexture(uint32_t id);
+
+    // Loads the textures asynchronously and packs them into one texture array (see PackTextureArray),
+    // returns the id of the array. The array is created at once, when all textures are decoded, it isn't
+    // limited by the upload budget and isn't evicted, so it is intended for the small textures
+    uint32_t LoadTextureArrayAsync(const std::vector<TextureLoadDesc>& descs, const std::string& name);
+    // Ready, when the array is created, Failed, if any texture is failed or canceled
+    TextureLoadState GetTextureArrayState(uint32_t arrayId) const;
+    std::string GetTextureArrayError(uint32_t arrayId) const;
+    // slot of the texture with the index in descs, the default slot until the array is ready
+    TextureArraySlot GetTextureArraySlot(uint32_t arrayId, uint32_t index) const;
+    // the view of the ready array or the placeholder (1x1 gray array with one slice), the array is marked as used
+    TextureViewPtr GetTextureArrayView(uint32_t arrayId);
+    void ReleaseTextureArray(uint32_t arrayId);
+
+    size_t GetUploadBudget() const noexcept { return m_uploadBudget; }
+    // bytes per frame, at least one row is uploaded in a frame
+    void SetUploadBudget(size_t value) noexcept { m_uploadBudget = value; }
+    // bytes uploaded by the last Update
+    size_t GetLastUploadSize() const noexcept { return m_lastUploadSize; }
+
+    // texture memory budget in bytes, the usage can exceed it, if the textures are used in the last frames
+    size_t GetMemoryBudget() const noexcept { return m_residency->GetBudget(); }
+    void SetMemoryBudget(size_t value) noexcept { m_residency->SetBudget(value); }
+    TextureResidencyCounters GetResidencyCounters() const noexcept { return m_residency->GetCounters(); }
+
+    // uploads the decoded textures and evicts the least recently used dynamic textures over the memory budget,
+    // is called once per frame before the application update
+    void Update();
+
+private:
+    TexturePtr CreateTexture(const DecodedTexture& decoded, const std::string& name, bool isImmutable);
+    // takes the decoded texture of the array, returns false if the texture isn't a part of an array
+    bool TakeArrayTexture(uint32_t id, DecodedTexture& decoded);
+    // fails the arrays with the failed textures, creates the arrays with all decoded textures
+    void UpdateTextureArrays();
+    void CreateTextureArray(TextureArray& textureArray);
+    // returns the uploaded bytes
+    size_t UploadRows(Upload& upload, size_t budget);
+    void FinishUpload(Upload& upload);
+    TextureViewPtr& GetPlaceholder();
+    TextureViewPtr& GetArrayPlaceholder();
 
 private:
     DevicePtr m_device;
+    ContextPtr m_context;
+    size_t m_uploadBudget = DefaultUploadBudget;
+    size_t m_lastUploadSize = 0;
+    TextureViewPtr m_placeholder;
+    TextureViewPtr m_arrayPlaceholder;
+    // the texture, that is being uploaded
+    std::optional<Upload> m_upload;
+    std::unordered_map<uint32_t, LoadedTexture> m_textures;
+    uint32_t m_nextArrayId = 1;
+    std::unordered_map<uint32_t, TextureArray> m_arrays;
+    // id of the async load => id of the array
+    std::unordered_map<uint32_t, uint32_t> m_arrayTextures;
+    std::shared_ptr<TextureResidency> m_residency;
+    std::unique_ptr<TextureDecodeQueue> m_decodeQueue;
 };
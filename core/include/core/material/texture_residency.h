@@ -0,0 +1,106 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include "core/common/ctor.h"
+
+
+struct TextureResidencyCounters {
+    size_t budget = 0;
+    // bytes of the resident textures, can exceed the budget if the textures are used in the last frames
+    size_t usage = 0;
+    size_t textures = 0;
+    uint64_t evictedTextures = 0;
+    uint64_t evictedMips = 0;
+    uint64_t restores = 0;
+};
+
+// bytes of the texture with mipLevels (0 - the full chain) and texelSize in bytes
+size_t CalcTextureMemory(uint32_t width, uint32_t height, uint32_t mipLevels, uint32_t texelSize) noexcept;
+
+// Size accounting and LRU of the GPU textures, the CPU side of the texture memory budget.
+// The owners register their textures with an evictor and touch them when they are used,
+// Trim evicts the top mips or the whole least recently used textures, until the usage fits into the budget.
+// The textures used in the current or the previous frame are never evicted
+class TextureResidency : Fixed {
+public:
+    // frees a part of the texture, returns the new size: the same size - nothing can be evicted,
+    // 0 - the whole texture is evicted. The evictor must not call the methods of TextureResidency
+    using Evictor = std::function<size_t ()>;
+    static constexpr const size_t DefaultBudget = 256 * 1024 * 1024;
+
+private:
+    struct Entry {
+        uint32_t id;
+        size_t size;
+        uint64_t lastUsedFrame;
+        bool isEvicted;
+        Evictor evictor;
+    };
+
+public:
+    TextureResidency() = default;
+    TextureResidency(size_t budget);
+    ~TextureResidency() = default;
+
+    // returns the id of the texture, the texture is touched
+    uint32_t Add(size_t size, Evictor&& evictor);
+    void Remove(uint32_t id);
+    // the texture is resized or restored after the eviction (counted as a restore), the texture is touched
+    void SetSize(uint32_t id, size_t size);
+    void Touch(uint32_t id);
+
+    uint64_t GetFrame() const noexcept { return m_frame; }
+    void NextFrame() noexcept { ++m_frame; }
+
+    size_t GetBudget() const noexcept { return m_budget; }
+    void SetBudget(size_t value) noexcept { m_budget = value; }
+    // evicts the least recently used textures, that aren't used in the current or the previous frame
+    void Trim();
+
+    TextureResidencyCounters GetCounters() const noexcept;
+
+private:
+    size_t m_budget = DefaultBudget;
+    size_t m_usage = 0;
+    uint64_t m_frame = 0;
+    uint32_t m_nextId = 1;
+    uint64_t m_evictedTextures = 0;
+    uint64_t m_evictedMips = 0;
+    uint64_t m_restores = 0;
+    // front - the most recently used
+    std::list<Entry> m_entries;
+    std::unordered_map<uint32_t, std::list<Entry>::iterator> m_index;
+};
+
+// The texture, that is evicted as a whole, in TextureResidency (if it isn't nullptr).
+// The release callback frees the GPU texture on the eviction, the owner calls Restore before each use,
+// it recreates the evicted texture and tells, that the content is lost
+class ResidentTexture : Fixed {
+public:
+    using Release = std::function<void ()>;
+    // recreates the texture, returns its size in bytes
+    using Create = std::function<size_t ()>;
+
+    ResidentTexture() = delete;
+    ResidentTexture(const std::shared_ptr<TextureResidency>& residency, size_t size, Release&& release);
+    ~ResidentTexture();
+
+    bool IsEvicted() const noexcept { return m_isEvicted; }
+    // marks the texture as used, the evicted texture is recreated by create,
+    // returns true if the content is undefined and must be uploaded again
+    bool Restore(const Create& create);
+    // the texture is recreated with the new size (the evicted texture too), the texture is marked as used
+    void SetSize(size_t size);
+
+private:
+    bool m_isEvicted = false;
+    uint32_t m_id = 0;
+    Release m_release;
+    std::shared_ptr<TextureResidency> m_residency;
+};
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <memory>
 #include <functional>
 #include <type_traits>
 
 #include "core/common/meta.h"
+#include "core/math/interval.h"
 #include "core/math/generator_type_fwd.h"
 
 
@@ -12,32 +14,98 @@ namespace math {
 template<typename T>
     constexpr bool GeneratorCompatibleType = std::is_floating_point_v<T>;
 
+// value of a generator with its partial derivatives
+template <typename T> struct Gradient2 {
+    T value = 0;
+    T dx = 0;
+    T dy = 0;
+};
+
+template <typename T> struct Gradient3 {
+    T value = 0;
+    T dx = 0;
+    T dy = 0;
+    T dz = 0;
+};
+
+// step of the central differences for generators without the analytic gradient
+template <typename T> inline constexpr T GradientStep = static_cast<T>(1e-4);
+
 template <typename T, typename Enable = std::enable_if_t<GeneratorCompatibleType<T>>>
     class Generator2 {
 public:
     using Type = T;
     using Functor = std::function<T (T, T)>;
+    using GradientFunctor = std::function<Gradient2<T> (T, T)>;
+    using BoundsFunctor = std::function<Interval<T> (Interval<T>, Interval<T>)>;
 
-    Generator2() = default;
-    Generator2(const Generator2& other) : m_functor(other.m_functor) { }
-    Generator2(Generator2&& other) noexcept : m_functor(std::move(other.m_functor)) {}
+    Generator2() : m_functor(Zero()) { }
+    // the functor is shared, so copy and move are a pointer copy, the moved-from object keeps the same functor
+    Generator2(const Generator2& other) noexcept : m_functor(other.m_functor), m_gradient(other.m_gradient), m_bounds(other.m_bounds) { }
+    Generator2(Generator2&& other) noexcept : m_functor(other.m_functor), m_gradient(other.m_gradient), m_bounds(other.m_bounds) {}
 
-    explicit Generator2(const Functor& functor) noexcept : m_functor(functor) { }
-    explicit Generator2(Functor&& functor) noexcept : m_functor(std::move(functor)) { }
+    explicit Generator2(const Functor& functor) : m_functor(std::make_shared<const Functor>(functor)) { }
+    explicit Generator2(Functor&& functor) : m_functor(std::make_shared<const Functor>(std::move(functor))) { }
+    // the gradient functor returns the same value as the functor and its analytic partial derivatives
+    explicit Generator2(Functor&& functor, GradientFunctor&& gradient)
+        : m_functor(std::make_shared<const Functor>(std::move(functor)))
+        , m_gradient(std::make_shared<const GradientFunctor>(std::move(gradient))) { }
 
     template <typename U, std::enable_if_t<GeneratorCompatibleType<U>, int> = 0>
-        explicit Generator2(U value) : m_functor([v = static_cast<T>(value)](T, T) -> T { return v; }) { }
+        explicit Generator2(U value) : Generator2(
+            Functor([v = static_cast<T>(value)](T, T) -> T { return v; }),
+            GradientFunctor([v = static_cast<T>(value)](T, T) -> Gradient2<T> { return Gradient2<T>{v, 0, 0}; })) {
+        SetBounds([v = static_cast<T>(value)](Interval<T>, Interval<T>) { return Interval<T>::Point(v); });
+    }
 
     template <typename U, std::enable_if_t<meta::IsArrayLikeV<U>, int> = 0>
         explicit Generator2(const U& value) : Generator2(value[0]) { }
 
-    Generator2& operator=(const Generator2& other) { m_functor = other.m_functor; return *this; }
-    Generator2& operator=(Generator2&& other) noexcept { m_functor = std::move(other.m_functor); return *this; }
+    Generator2& operator=(const Generator2& other) noexcept { m_functor = other.m_functor; m_gradient = other.m_gradient; m_bounds = other.m_bounds; return *this; }
+    Generator2& operator=(Generator2&& other) noexcept { m_functor = other.m_functor; m_gradient = other.m_gradient; m_bounds = other.m_bounds; return *this; }
+
+    T operator()(T x, T y) const { return (*m_functor)(x, y); }
+
+    bool HasBounds() const noexcept { return static_cast<bool>(m_bounds); }
+    // conservative range of values over the box, the result contains all values of the generator in the box.
+    // Without the bounds functor the range is unbounded
+    Interval<T> Bounds(Interval<T> x, Interval<T> y) const {
+        return m_bounds ? (*m_bounds)(x, y) : Interval<T>();
+    }
+    // the bounds functor must be conservative: it may overestimate the range, but never underestimate it
+    void SetBounds(BoundsFunctor&& bounds) { m_bounds = std::make_shared<const BoundsFunctor>(std::move(bounds)); }
+
+    bool HasGradient() const noexcept { return static_cast<bool>(m_gradient); }
+    // value and derivatives in one pass, without the analytic gradient they are calculated by central differences
+    Gradient2<T> Gradient(T x, T y) const {
+        if (m_gradient) {
+            return (*m_gradient)(x, y);
+        }
+
+        constexpr T step = GradientStep<T>;
+        constexpr T invStep2 = static_cast<T>(0.5) / step;
+        const Functor& f = *m_functor;
+        return Gradient2<T>{f(x, y), (f(x + step, y) - f(x - step, y)) * invStep2, (f(x, y + step) - f(x, y - step)) * invStep2};
+    }
+
+    // true if both generators evaluate the same functor object
+    bool IsShared(const Generator2& other) const noexcept { return (m_functor == other.m_functor); }
+    // identity of the functor object, it is unique while any copy of the generator is alive.
+    // The functors are immutable, so the identity changes with every change of the generator
+    const void* GetId() const noexcept { return m_functor.get(); }
 
-    T operator()(T x, T y) const { return m_functor(x, y); }
+private:
+    static const std::shared_ptr<const Functor>& Zero() {
+        static const auto zero = std::make_shared<const Functor>([](T, T) -> T { return 0; });
+        return zero;
+    }
 
 private:
-    Functor m_functor = [](T, T) { return 0; };
+    std::shared_ptr<const Functor> m_functor;
+    // nullptr if the analytic gradient is unknown
+    std::shared_ptr<const GradientFunctor> m_gradient;
+    // nullptr if the range of values is unknown
+    std::shared_ptr<const BoundsFunctor> m_bounds;
 };
 
 template <typename T, typename Enable = std::enable_if_t<GeneratorCompatibleType<T>>>
@@ -45,27 +113,79 @@ template <typename T, typename Enable = std::enable_if_t<GeneratorCompatibleType
 public:
     using Type = T;
     using Functor = std::function<T (T, T, T)>;
+    using GradientFunctor = std::function<Gradient3<T> (T, T, T)>;
+    using BoundsFunctor = std::function<Interval<T> (Interval<T>, Interval<T>, Interval<T>)>;
 
-    Generator3() = default;
-    Generator3(const Generator3& other) : m_functor(other.m_functor) { }
-    Generator3(Generator3&& other) noexcept : m_functor(std::move(other.m_functor)) {}
+    Generator3() : m_functor(Zero()) { }
+    // the functor is shared, so copy and move are a pointer copy, the moved-from object keeps the same functor
+    Generator3(const Generator3& other) noexcept : m_functor(other.m_functor), m_gradient(other.m_gradient), m_bounds(other.m_bounds) { }
+    Generator3(Generator3&& other) noexcept : m_functor(other.m_functor), m_gradient(other.m_gradient), m_bounds(other.m_bounds) {}
 
-    explicit Generator3(const Functor& functor) noexcept : m_functor(functor) { }
-    explicit Generator3(Functor&& functor) noexcept : m_functor(std::move(functor)) { }
+    explicit Generator3(const Functor& functor) : m_functor(std::make_shared<const Functor>(functor)) { }
+    explicit Generator3(Functor&& functor) : m_functor(std::make_shared<const Functor>(std::move(functor))) { }
+    // the gradient functor returns the same value as the functor and its analytic partial derivatives
+    explicit Generator3(Functor&& functor, GradientFunctor&& gradient)
+        : m_functor(std::make_shared<const Functor>(std::move(functor)))
+        , m_gradient(std::make_shared<const GradientFunctor>(std::move(gradient))) { }
 
     template <typename U, std::enable_if_t<GeneratorCompatibleType<U>, int> = 0>
-        explicit Generator3(U value) : m_functor([v = static_cast<T>(value)](T, T, T) -> T { return v; }) { }
+        explicit Generator3(U value) : Generator3(
+            Functor([v = static_cast<T>(value)](T, T, T) -> T { return v; }),
+            GradientFunctor([v = static_cast<T>(value)](T, T, T) -> Gradient3<T> { return Gradient3<T>{v, 0, 0, 0}; })) {
+        SetBounds([v = static_cast<T>(value)](Interval<T>, Interval<T>, Interval<T>) { return Interval<T>::Point(v); });
+    }
 
     template <typename U, std::enable_if_t<meta::IsArrayLikeV<U>, int> = 0>
         explicit Generator3(const U& value) : Generator3(value[0]) { }
 
-    Generator3& operator=(const Generator3& other) { m_functor = other.m_functor; return *this; }
-    Generator3& operator=(Generator3&& other) noexcept { m_functor = std::move(other.m_functor); return *this; }
+    Generator3& operator=(const Generator3& other) noexcept { m_functor = other.m_functor; m_gradient = other.m_gradient; m_bounds = other.m_bounds; return *this; }
+    Generator3& operator=(Generator3&& other) noexcept { m_functor = other.m_functor; m_gradient = other.m_gradient; m_bounds = other.m_bounds; return *this; }
+
+    T operator()(T x, T y, T z) const { return (*m_functor)(x, y, z); }
+
+    bool HasBounds() const noexcept { return static_cast<bool>(m_bounds); }
+    // conservative range of values over the box, the result contains all values of the generator in the box.
+    // Without the bounds functor the range is unbounded
+    Interval<T> Bounds(Interval<T> x, Interval<T> y, Interval<T> z) const {
+        return m_bounds ? (*m_bounds)(x, y, z) : Interval<T>();
+    }
+    // the bounds functor must be conservative: it may overestimate the range, but never underestimate it
+    void SetBounds(BoundsFunctor&& bounds) { m_bounds = std::make_shared<const BoundsFunctor>(std::move(bounds)); }
+
+    bool HasGradient() const noexcept { return static_cast<bool>(m_gradient); }
+    // value and derivatives in one pass, without the analytic gradient they are calculated by central differences
+    Gradient3<T> Gradient(T x, T y, T z) const {
+        if (m_gradient) {
+            return (*m_gradient)(x, y, z);
+        }
+
+        constexpr T step = GradientStep<T>;
+        constexpr T invStep2 = static_cast<T>(0.5) / step;
+        const Functor& f = *m_functor;
+        return Gradient3<T>{f(x, y, z),
+            (f(x + step, y, z) - f(x - step, y, z)) * invStep2,
+            (f(x, y + step, z) - f(x, y - step, z)) * invStep2,
+            (f(x, y, z + step) - f(x, y, z - step)) * invStep2};
+    }
+
+    // true if both generators evaluate the same functor object
+    bool IsShared(const Generator3& other) const noexcept { return (m_functor == other.m_functor); }
+    // identity of the functor object, it is unique while any copy of the generator is alive.
+    // The functors are immutable, so the identity changes with every change of the generator
+    const void* GetId() const noexcept { return m_functor.get(); }
 
-    T operator()(T x, T y, T z) const { return m_functor(x, y, z); }
+private:
+    static const std::shared_ptr<const Functor>& Zero() {
+        static const auto zero = std::make_shared<const Functor>([](T, T, T) -> T { return 0; });
+        return zero;
+    }
 
 private:
-    Functor m_functor = [](T, T, T) { return 0; };
+    std::shared_ptr<const Functor> m_functor;
+    // nullptr if the analytic gradient is unknown
+    std::shared_ptr<const GradientFunctor> m_gradient;
+    // nullptr if the range of values is unknown
+    std::shared_ptr<const BoundsFunctor> m_bounds;
 };
 
 }
@@ -1,70 +1,161 @@
 #pragma once
 
+#include <utility>
 #include <type_traits>
 
 #include "core/math/generator_type.h"
 
 
+// the result has the analytic gradient only if all generator operands have it,
+// the bounds are set if they narrow the unbounded range
+namespace math {
+
+namespace detail {
+
+template<typename Generator, typename Func, typename GradientFunc, typename BoundsFunc>
+Generator MakeGenerator(Func&& func, bool hasGradient, GradientFunc&& gradient, bool hasBounds, BoundsFunc&& bounds) {
+    Generator result = hasGradient ?
+        Generator(typename Generator::Functor(std::forward<Func>(func)), typename Generator::GradientFunctor(std::forward<GradientFunc>(gradient))) :
+        Generator(typename Generator::Functor(std::forward<Func>(func)));
+    if (hasBounds) {
+        result.SetBounds(typename Generator::BoundsFunctor(std::forward<BoundsFunc>(bounds)));
+    }
+
+    return result;
+}
+
+}
+
+}
+
 namespace std {
 
 // Min
 
 template<typename T>
 math::Generator2<T> min(const math::Generator2<T>& a, const math::Generator2<T>& b) {
-    return math::Generator2<T>([a, b](T x, T y) -> T {
-        return std::min(a(x, y), b(x, y));
-    });
+    return math::detail::MakeGenerator<math::Generator2<T>>(
+        [a, b](T x, T y) -> T {
+            return std::min(a(x, y), b(x, y));
+        },
+        a.HasGradient() && b.HasGradient(), [a, b](T x, T y) -> math::Gradient2<T> {
+            const auto ga = a.Gradient(x, y);
+            const auto gb = b.Gradient(x, y);
+            return (gb.value < ga.value) ? gb : ga;
+        },
+        a.HasBounds() || b.HasBounds(), [a, b](math::Interval<T> x, math::Interval<T> y) -> math::Interval<T> {
+            return math::IntervalMin(a.Bounds(x, y), b.Bounds(x, y));
+        });
 }
 
 template<typename T, typename U, std::enable_if_t<math::GeneratorCompatibleType<U>, int> = 0>
 math::Generator2<T> min(const math::Generator2<T>& a, U b) {
-    return math::Generator2<T>([a, b = static_cast<T>(b)](T x, T y) -> T {
-        return std::min(a(x, y), b);
-    });
+    return math::detail::MakeGenerator<math::Generator2<T>>(
+        [a, b = static_cast<T>(b)](T x, T y) -> T {
+            return std::min(a(x, y), b);
+        },
+        a.HasGradient(), [a, b = static_cast<T>(b)](T x, T y) -> math::Gradient2<T> {
+            const auto ga = a.Gradient(x, y);
+            return (b < ga.value) ? math::Gradient2<T>{b, 0, 0} : ga;
+        },
+        true, [a, b = static_cast<T>(b)](math::Interval<T> x, math::Interval<T> y) -> math::Interval<T> {
+            return math::IntervalMin(a.Bounds(x, y), math::Interval<T>::Point(b));
+        });
 }
 
 template<typename T>
 math::Generator3<T> min(const math::Generator3<T>& a, const math::Generator3<T>& b) {
-    return math::Generator3<T>([a, b](T x, T y, T z) -> T {
-        return std::min(a(x, y, z), b(x, y, z));
-    });
+    return math::detail::MakeGenerator<math::Generator3<T>>(
+        [a, b](T x, T y, T z) -> T {
+            return std::min(a(x, y, z), b(x, y, z));
+        },
+        a.HasGradient() && b.HasGradient(), [a, b](T x, T y, T z) -> math::Gradient3<T> {
+            const auto ga = a.Gradient(x, y, z);
+            const auto gb = b.Gradient(x, y, z);
+            return (gb.value < ga.value) ? gb : ga;
+        },
+        a.HasBounds() || b.HasBounds(), [a, b](math::Interval<T> x, math::Interval<T> y, math::Interval<T> z) -> math::Interval<T> {
+            return math::IntervalMin(a.Bounds(x, y, z), b.Bounds(x, y, z));
+        });
 }
 
 template<typename T, typename U, std::enable_if_t<math::GeneratorCompatibleType<U>, int> = 0>
 math::Generator3<T> min(const math::Generator3<T>& a, U b) {
-    return math::Generator3<T>([a, b = static_cast<T>(b)](T x, T y, T z) -> T {
-        return std::min(a(x, y, z), b);
-    });
+    return math::detail::MakeGenerator<math::Generator3<T>>(
+        [a, b = static_cast<T>(b)](T x, T y, T z) -> T {
+            return std::min(a(x, y, z), b);
+        },
+        a.HasGradient(), [a, b = static_cast<T>(b)](T x, T y, T z) -> math::Gradient3<T> {
+            const auto ga = a.Gradient(x, y, z);
+            return (b < ga.value) ? math::Gradient3<T>{b, 0, 0, 0} : ga;
+        },
+        true, [a, b = static_cast<T>(b)](math::Interval<T> x, math::Interval<T> y, math::Interval<T> z) -> math::Interval<T> {
+            return math::IntervalMin(a.Bounds(x, y, z), math::Interval<T>::Point(b));
+        });
 }
 
 // Max
 
 template<typename T>
 math::Generator2<T> max(const math::Generator2<T>& a, const math::Generator2<T>& b) {
-    return math::Generator2<T>([a, b](T x, T y) -> T {
-        return std::max(a(x, y), b(x, y));
-    });
+    return math::detail::MakeGenerator<math::Generator2<T>>(
+        [a, b](T x, T y) -> T {
+            return std::max(a(x, y), b(x, y));
+        },
+        a.HasGradient() && b.HasGradient(), [a, b](T x, T y) -> math::Gradient2<T> {
+            const auto ga = a.Gradient(x, y);
+            const auto gb = b.Gradient(x, y);
+            return (ga.value < gb.value) ? gb : ga;
+        },
+        a.HasBounds() || b.HasBounds(), [a, b](math::Interval<T> x, math::Interval<T> y) -> math::Interval<T> {
+            return math::IntervalMax(a.Bounds(x, y), b.Bounds(x, y));
+        });
 }
 
 template<typename T, typename U, std::enable_if_t<math::GeneratorCompatibleType<U>, int> = 0>
 math::Generator2<T> max(const math::Generator2<T>& a, U b) {
-    return math::Generator2<T>([a, b = static_cast<T>(b)](T x, T y) -> T {
-        return std::max(a(x, y), b);
-    });
+    return math::detail::MakeGenerator<math::Generator2<T>>(
+        [a, b = static_cast<T>(b)](T x, T y) -> T {
+            return std::max(a(x, y), b);
+        },
+        a.HasGradient(), [a, b = static_cast<T>(b)](T x, T y) -> math::Gradient2<T> {
+            const auto ga = a.Gradient(x, y);
+            return (ga.value < b) ? math::Gradient2<T>{b, 0, 0} : ga;
+        },
+        true, [a, b = static_cast<T>(b)](math::Interval<T> x, math::Interval<T> y) -> math::Interval<T> {
+            return math::IntervalMax(a.Bounds(x, y), math::Interval<T>::Point(b));
+        });
 }
 
 template<typename T>
 math::Generator3<T> max(const math::Generator3<T>& a, const math::Generator3<T>& b) {
-    return math::Generator3<T>([a, b](T x, T y, T z) -> T {
-        return std::max(a(x, y, z), b(x, y, z));
-    });
+    return math::detail::MakeGenerator<math::Generator3<T>>(
+        [a, b](T x, T y, T z) -> T {
+            return std::max(a(x, y, z), b(x, y, z));
+        },
+        a.HasGradient() && b.HasGradient(), [a, b](T x, T y, T z) -> math::Gradient3<T> {
+            const auto ga = a.Gradient(x, y, z);
+            const auto gb = b.Gradient(x, y, z);
+            return (ga.value < gb.value) ? gb : ga;
+        },
+        a.HasBounds() || b.HasBounds(), [a, b](math::Interval<T> x, math::Interval<T> y, math::Interval<T> z) -> math::Interval<T> {
+            return math::IntervalMax(a.Bounds(x, y, z), b.Bounds(x, y, z));
+        });
 }
 
 template<typename T, typename U, std::enable_if_t<math::GeneratorCompatibleType<U>, int> = 0>
 math::Generator3<T> max(const math::Generator3<T>& a, U b) {
-    return math::Generator3<T>([a, b = static_cast<T>(b)](T x, T y, T z) -> T {
-        return std::max(a(x, y, z), b);
-    });
+    return math::detail::MakeGenerator<math::Generator3<T>>(
+        [a, b = static_cast<T>(b)](T x, T y, T z) -> T {
+            return std::max(a(x, y, z), b);
+        },
+        a.HasGradient(), [a, b = static_cast<T>(b)](T x, T y, T z) -> math::Gradient3<T> {
+            const auto ga = a.Gradient(x, y, z);
+            return (ga.value < b) ? math::Gradient3<T>{b, 0, 0, 0} : ga;
+        },
+        true, [a, b = static_cast<T>(b)](math::Interval<T> x, math::Interval<T> y, math::Interval<T> z) -> math::Interval<T> {
+            return math::IntervalMax(a.Bounds(x, y, z), math::Interval<T>::Point(b));
+        });
 }
 
 }
@@ -75,30 +166,66 @@ namespace math {
 
 template<typename T>
 Generator2<T> operator+(const Generator2<T>& a, const Generator2<T>& b) {
-    return Generator2<T>([a, b](T x, T y) -> T {
-        return (a(x, y) + b(x, y));
-    });
+    return detail::MakeGenerator<Generator2<T>>(
+        [a, b](T x, T y) -> T {
+            return (a(x, y) + b(x, y));
+        },
+        a.HasGradient() && b.HasGradient(), [a, b](T x, T y) -> Gradient2<T> {
+            const auto ga = a.Gradient(x, y);
+            const auto gb = b.Gradient(x, y);
+            return Gradient2<T>{ga.value + gb.value, ga.dx + gb.dx, ga.dy + gb.dy};
+        },
+        a.HasBounds() && b.HasBounds(), [a, b](Interval<T> x, Interval<T> y) -> Interval<T> {
+            return a.Bounds(x, y) + b.Bounds(x, y);
+        });
 }
 
 template<typename T, typename U, std::enable_if_t<GeneratorCompatibleType<U>, int> = 0>
 Generator2<T> operator+(const Generator2<T>& a, U b) {
-    return Generator2<T>([a, b = static_cast<T>(b)](T x, T y) -> T {
-        return (a(x, y) + b);
-    });
+    return detail::MakeGenerator<Generator2<T>>(
+        [a, b = static_cast<T>(b)](T x, T y) -> T {
+            return (a(x, y) + b);
+        },
+        a.HasGradient(), [a, b = static_cast<T>(b)](T x, T y) -> Gradient2<T> {
+            auto ga = a.Gradient(x, y);
+            ga.value += b;
+            return ga;
+        },
+        a.HasBounds(), [a, b = static_cast<T>(b)](Interval<T> x, Interval<T> y) -> Interval<T> {
+            return a.Bounds(x, y) + Interval<T>::Point(b);
+        });
 }
 
 template<typename T>
 Generator3<T> operator+(const Generator3<T>& a, const Generator3<T>& b) {
-    return Generator3<T>([a, b](T x, T y, T z) -> T {
-        return (a(x, y, z) + b(x, y, z));
-    });
+    return detail::MakeGenerator<Generator3<T>>(
+        [a, b](T x, T y, T z) -> T {
+            return (a(x, y, z) + b(x, y, z));
+        },
+        a.HasGradient() && b.HasGradient(), [a, b](T x, T y, T z) -> Gradient3<T> {
+            const auto ga = a.Gradient(x, y, z);
+            const auto gb = b.Gradient(x, y, z);
+            return Gradient3<T>{ga.value + gb.value, ga.dx + gb.dx, ga.dy + gb.dy, ga.dz + gb.dz};
+        },
+        a.HasBounds() && b.HasBounds(), [a, b](Interval<T> x, Interval<T> y, Interval<T> z) -> Interval<T> {
+            return a.Bounds(x, y, z) + b.Bounds(x, y, z);
+        });
 }
 
 template<typename T, typename U, std::enable_if_t<GeneratorCompatibleType<U>, int> = 0>
 Generator3<T> operator+(const Generator3<T>& a, U b) {
-    return Generator3<T>([a, b = static_cast<T>(b)](T x, T y, T z) -> T {
-        return (a(x, y, z) + b);
-    });
+    return detail::MakeGenerator<Generator3<T>>(
+        [a, b = static_cast<T>(b)](T x, T y, T z) -> T {
+            return (a(x, y, z) + b);
+        },
+        a.HasGradient(), [a, b = static_cast<T>(b)](T x, T y, T z) -> Gradient3<T> {
+            auto ga = a.Gradient(x, y, z);
+            ga.value += b;
+            return ga;
+        },
+        a.HasBounds(), [a, b = static_cast<T>(b)](Interval<T> x, Interval<T> y, Interval<T> z) -> Interval<T> {
+            return a.Bounds(x, y, z) + Interval<T>::Point(b);
+        });
 }
 
 }
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+
+namespace math {
+
+// closed range of values for the interval arithmetic, unbounded by default
+template <typename T> struct Interval {
+    T lower = -std::numeric_limits<T>::infinity();
+    T upper = std::numeric_limits<T>::infinity();
+
+    static Interval Point(T v) noexcept { return Interval{v, v}; }
+    bool IsBounded() const noexcept { return (lower > -std::numeric_limits<T>::infinity()) && (upper < std::numeric_limits<T>::infinity()); }
+    bool Contains(T v) const noexcept { return (lower <= v) && (v <= upper); }
+};
+
+template<typename T> Interval<T> operator+(const Interval<T>& a, const Interval<T>& b) {
+    return Interval<T>{a.lower + b.lower, a.upper + b.upper};
+}
+
+template<typename T> Interval<T> IntervalMin(const Interval<T>& a, const Interval<T>& b) {
+    return Interval<T>{std::min(a.lower, b.lower), std::min(a.upper, b.upper)};
+}
+
+template<typename T> Interval<T> IntervalMax(const Interval<T>& a, const Interval<T>& b) {
+    return Interval<T>{std::max(a.lower, b.lower), std::max(a.upper, b.upper)};
+}
+
+// range of squares
+template<typename T> Interval<T> IntervalSqr(const Interval<T>& a) {
+    const T lowerSqr = a.lower * a.lower;
+    const T upperSqr = a.upper * a.upper;
+    if (a.Contains(0)) {
+        return Interval<T>{0, std::max(lowerSqr, upperSqr)};
+    }
+
+    return Interval<T>{std::min(lowerSqr, upperSqr), std::max(lowerSqr, upperSqr)};
+}
+
+// range of distances from the origin to the points of the box
+template<typename T> Interval<T> IntervalHypot(const Interval<T>& x, const Interval<T>& y) {
+    const auto sum = IntervalSqr(x) + IntervalSqr(y);
+    return Interval<T>{std::sqrt(sum.lower), std::sqrt(sum.upper)};
+}
+
+template<typename T> Interval<T> IntervalHypot(const Interval<T>& x, const Interval<T>& y, const Interval<T>& z) {
+    const auto sum = IntervalSqr(x) + IntervalSqr(y) + IntervalSqr(z);
+    return Interval<T>{std::sqrt(sum.lower), std::sqrt(sum.upper)};
+}
+
+}
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <array>
 #include <random>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 
 #include "dg/math.h"
 
 
+// Global generator for the single-threaded code, the result depends on the order of all calls.
+// The parallel code uses the counter-based functions below
 extern std::mt19937_64 randomGenerator;
 
 void RandSeed(std::mt19937_64::result_type value);
@@ -49,3 +54,98 @@ template<typename T> typename std::enable_if_t<std::is_same_v<T, dg::float3>, T>
 template<typename T> typename std::enable_if_t<std::is_same_v<T, dg::float4>, T> inline LinearRand(const T& minValue, const T& maxValue) {
     return T(LinearRand<float>(minValue.x, maxValue.x), LinearRand<float>(minValue.y, maxValue.y), LinearRand<float>(minValue.z, maxValue.z), LinearRand<float>(minValue.w, maxValue.w));
 }
+
+// Counter-based generator Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+// The value is a pure function of (seed, stream, index), so it is thread-safe and doesn't depend
+// on the order of calls and the thread count, and it is the same for all standard libraries.
+// Block is 4 random uint32 of the counter {index, stream} with the key seed
+inline std::array<uint32_t, 4> RandBlock(uint64_t seed, uint64_t stream, uint64_t counter) {
+    constexpr uint32_t m0 = 0xD2511F53;
+    constexpr uint32_t m1 = 0xCD9E8D57;
+    constexpr uint32_t w0 = 0x9E3779B9;
+    constexpr uint32_t w1 = 0xBB67AE85;
+
+    uint32_t c0 = static_cast<uint32_t>(counter);
+    uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+    uint32_t c2 = static_cast<uint32_t>(stream);
+    uint32_t c3 = static_cast<uint32_t>(stream >> 32);
+    uint32_t k0 = static_cast<uint32_t>(seed);
+    uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+    for (uint32_t round=0; round!=10; ++round) {
+        const uint64_t p0 = static_cast<uint64_t>(m0) * c0;
+        const uint64_t p1 = static_cast<uint64_t>(m1) * c2;
+        c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<uint32_t>(p1);
+        c3 = static_cast<uint32_t>(p0);
+        k0 += w0;
+        k1 += w1;
+    }
+
+    return {c0, c1, c2, c3};
+}
+
+// [0, 1) with 24 random bits
+inline float RandToFloat(uint32_t value) {
+    return static_cast<float>(value >> 8) * (1.f / 16777216.f);
+}
+
+// [0, 1) with 53 random bits
+inline double RandToDouble(uint32_t lo, uint32_t hi) {
+    return static_cast<double>(((static_cast<uint64_t>(hi) << 32) | lo) >> 11) * (1. / 9007199254740992.);
+}
+
+// Scalars of the stream are packed by 4 (uint32, float) or by 2 (uint64, double) in the blocks,
+// vectors take the first components of the block with the number index
+template<typename T> typename std::enable_if_t<std::is_same_v<T, uint32_t>, T> inline Rand(uint64_t seed, uint64_t stream, uint64_t index) {
+    return RandBlock(seed, stream, index >> 2)[index & 3];
+}
+
+template<typename T> typename std::enable_if_t<std::is_same_v<T, uint64_t>, T> inline Rand(uint64_t seed, uint64_t stream, uint64_t index) {
+    const auto block = RandBlock(seed, stream, index >> 1);
+    const size_t offset = (index & 1) * 2;
+    return (static_cast<uint64_t>(block[offset + 1]) << 32) | block[offset];
+}
+
+template<typename T> typename std::enable_if_t<std::is_same_v<T, float>, T> inline Rand(uint64_t seed, uint64_t stream, uint64_t index) {
+    return RandToFloat(Rand<uint32_t>(seed, stream, index));
+}
+
+template<typename T> typename std::enable_if_t<std::is_same_v<T, double>, T> inline Rand(uint64_t seed, uint64_t stream, uint64_t index) {
+    const auto block = RandBlock(seed, stream, index >> 1);
+    const size_t offset = (index & 1) * 2;
+    return RandToDouble(block[offset], block[offset + 1]);
+}
+
+template<typename T> typename std::enable_if_t<std::is_same_v<T, dg::float2>, T> inline Rand(uint64_t seed, uint64_t stream, uint64_t index) {
+    const auto block = RandBlock(seed, stream, index);
+    return T(RandToFloat(block[0]), RandToFloat(block[1]));
+}
+
+template<typename T> typename std::enable_if_t<std::is_same_v<T, dg::float3>, T> inline Rand(uint64_t seed, uint64_t stream, uint64_t index) {
+    const auto block = RandBlock(seed, stream, index);
+    return T(RandToFloat(block[0]), RandToFloat(block[1]), RandToFloat(block[2]));
+}
+
+template<typename T> typename std::enable_if_t<std::is_same_v<T, dg::float4>, T> inline Rand(uint64_t seed, uint64_t stream, uint64_t index) {
+    const auto block = RandBlock(seed, stream, index);
+    return T(RandToFloat(block[0]), RandToFloat(block[1]), RandToFloat(block[2]), RandToFloat(block[3]));
+}
+
+// [minValue, maxValue)
+template<typename T> typename std::enable_if_t<std::is_floating_point_v<T>, T> inline LinearRand(uint64_t seed, uint64_t stream, uint64_t index, const T minValue, const T maxValue) {
+    return minValue + (maxValue - minValue) * Rand<T>(seed, stream, index);
+}
+
+template<typename T> typename std::enable_if_t<std::is_same_v<T, dg::float2> || std::is_same_v<T, dg::float3> || std::is_same_v<T, dg::float4>, T>
+    inline LinearRand(uint64_t seed, uint64_t stream, uint64_t index, const T& minValue, const T& maxValue) {
+    return minValue + (maxValue - minValue) * Rand<T>(seed, stream, index);
+}
+
+// Batch versions, dst[i] = Rand<T>(seed, stream, firstIndex + i), the blocks are generated by groups of lanes,
+// so the compiler vectorizes them
+void RandFill(uint64_t seed, uint64_t stream, uint64_t firstIndex, float* dst, size_t count);
+void RandFill(uint64_t seed, uint64_t stream, uint64_t firstIndex, dg::float3* dst, size_t count);
+// dst[i] = LinearRand<T>(seed, stream, firstIndex + i, minValue, maxValue)
+void LinearRandFill(uint64_t seed, uint64_t stream, uint64_t firstIndex, float minValue, float maxValue, float* dst, size_t count);
+void LinearRandFill(uint64_t seed, uint64_t stream, uint64_t firstIndex, const dg::float3& minValue, const dg::float3& maxValue, dg::float3* dst, size_t count);
@@ -516,6 +516,11 @@ struct RectT {
     T CenterY() const noexcept { return y + h / 2; }
     PointT<T> Center() const noexcept { return PointT<T>(CenterX(), CenterY()); }
 
+    // true if the rects have a common area
+    bool Intersects(const RectT& o) const noexcept {
+        return ((Left() < o.Right()) && (o.Left() < Right()) && (Top() < o.Bottom()) && (o.Top() < Bottom()));
+    }
+
 #pragma GCC diagnostic push
 #if defined(__clang__)
 #pragma clang diagnostic ignored "-Wnested-anon-types"
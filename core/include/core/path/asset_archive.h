@@ -0,0 +1,97 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+#include "core/common/ctor.h"
+#include "core/path/file_view.h"
+
+
+class MappedFile;
+struct AssetArchiveDesc {
+    // alignment of the stored (not compressed) data in the file, the power of two,
+    // the views of the mapped archive are aligned the same way
+    uint32_t alignment = 16;
+    bool compress = true;
+    // the data is stored as is if the compressed size is greater than originalSize * maxCompressionRatio
+    float maxCompressionRatio = 0.9f;
+};
+
+struct AssetArchiveStats {
+    uint32_t entriesCount = 0;
+    uint32_t compressedCount = 0;
+    uint64_t originalSize = 0;
+    uint64_t archiveSize = 0;
+};
+
+// Read only pack of the asset files with the index sorted by the hash of the name.
+// File layout: the header, the index entries, the names blob, the data of the entries.
+// The archive is mapped, the stored entries are read without the copy, the compressed
+// entries (LZ4 block) are decompressed into the own buffer of the view.
+// The entries are named by the relative paths with '/' separator ("assets/fonts/bfont.ttf")
+class AssetArchive : Fixed {
+public:
+    struct Entry {
+        uint64_t hash;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t originalSize;
+        uint32_t nameOffset;
+        uint32_t nameSize;
+        uint32_t compression;
+        uint32_t reserved;
+    };
+
+public:
+    AssetArchive() = default;
+    ~AssetArchive() = default;
+
+    bool Open(const std::filesystem::path& path, std::string& error) noexcept;
+    void Open(const std::filesystem::path& path);
+
+    bool Contains(const std::filesystem::path& name) const noexcept;
+    size_t GetEntriesCount() const noexcept { return m_entries.size(); }
+    // in the order of the index
+    std::vector<std::string> GetNames() const;
+
+    // is thread safe
+    bool Read(const std::filesystem::path& name, FileView& view, std::string& error) const noexcept;
+    FileView Read(const std::filesystem::path& name) const;
+
+    // the name of the entry, empty for the absolute path and the path out of the root
+    static std::string NormalizeName(const std::filesystem::path& name);
+    static uint64_t HashName(const std::string& name) noexcept;
+
+private:
+    const Entry* Find(const std::filesystem::path& name) const noexcept;
+
+private:
+    std::filesystem::path m_path;
+    std::shared_ptr<MappedFile> m_file;
+    std::vector<Entry> m_entries;
+    const char* m_names = nullptr;
+};
+
+class AssetArchiveWriter : Fixed {
+public:
+    AssetArchiveWriter() = default;
+    ~AssetArchiveWriter() = default;
+
+    // throws EngineError for the duplicate or the wrong name
+    void Add(const std::filesystem::path& name, std::vector<uint8_t>&& data);
+    void AddFile(const std::filesystem::path& name, const std::filesystem::path& realPath);
+
+    AssetArchiveStats Write(const std::filesystem::path& path, const AssetArchiveDesc& desc = AssetArchiveDesc()) const;
+
+private:
+    struct Item {
+        std::string name;
+        uint64_t hash;
+        std::vector<uint8_t> data;
+    };
+
+private:
+    std::vector<Item> m_items;
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <span>
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <utility>
+#include <string_view>
+
+
+// Read only view of the file data without the copy. The owner keeps the data alive
+// (the mapping of the file, the decompressed buffer, ...), the copies of the view share it
+class FileView {
+public:
+    FileView() = default;
+    FileView(std::span<const std::byte> data, std::shared_ptr<const void> owner) noexcept
+        : m_data(data)
+        , m_owner(std::move(owner)) {}
+    ~FileView() = default;
+
+    bool IsEmpty() const noexcept { return m_data.empty(); }
+    size_t Size() const noexcept { return m_data.size(); }
+    std::span<const std::byte> Data() const noexcept { return m_data; }
+    const char* Chars() const noexcept { return reinterpret_cast<const char*>(m_data.data()); }
+    std::string_view View() const noexcept { return std::string_view(Chars(), m_data.size()); }
+
+    // drops the reference to the data
+    void Reset() noexcept {
+        m_data = std::span<const std::byte>();
+        m_owner.reset();
+    }
+
+private:
+    std::span<const std::byte> m_data;
+    std::shared_ptr<const void> m_owner;
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+
+// LZ4 block format (without the frame): the sequences of the literals and the matches
+// with 16-bit offsets, the last 5 bytes are always the literals. The compressor is greedy
+// with one hash probe per position, the blocks are readable by the reference LZ4 decoder
+std::vector<uint8_t> CompressLZ4Block(const uint8_t* data, size_t size);
+// size is the exact size of the decompressed data, returns false for the malformed block
+bool DecompressLZ4Block(const uint8_t* block, size_t blockSize, uint8_t* data, size_t size) noexcept;
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#include "core/common/ctor.h"
+
+
+// Read only memory mapped file
+class MappedFile : Fixed {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // populate - the pages are read into the memory by the call, the later access doesn't wait for the disk
+    bool Open(const std::filesystem::path& path, std::string& error, bool populate = false) noexcept;
+    void Open(const std::filesystem::path& path);
+    void Close() noexcept;
+
+    bool IsOpen() const noexcept { return m_isOpen; }
+    // nullptr for an empty file
+    const uint8_t* Data() const noexcept { return m_data; }
+    size_t Size() const noexcept { return m_size; }
+
+private:
+    bool m_isOpen = false;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+};
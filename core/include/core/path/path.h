@@ -1,20 +1,63 @@
 #pragma once
 
 #include <map>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <future>
 #include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <condition_variable>
 #include "core/common/ctor.h"
+#include "core/path/file_view.h"
 
 
+class AssetArchive;
 class FileManager : Fixed {
+public:
+    // is called on the I/O thread, the error is empty on success
+    using ReadCallback = std::function<void (FileView&& view, const std::string& error)>;
+
+private:
+    // the directory or the archive
+    struct Mount {
+        int32_t priority;
+        std::filesystem::path directory;
+        std::shared_ptr<const AssetArchive> archive;
+    };
+
+    // the real path of the file or the name of the entry in the archive
+    struct ResolvedPath {
+        std::filesystem::path path;
+        std::shared_ptr<const AssetArchive> archive;
+    };
+
+    struct ReadRequest {
+        ResolvedPath resolved;
+        // the error of the path resolving
+        std::string error;
+        ReadCallback callback;
+    };
+
 public:
     FileManager() = default;
-    ~FileManager() = default;
+    ~FileManager();
 
     void AddRootAlias(const std::string& alias, const std::filesystem::path& path);
+    // The relative paths are looked up in the mounts before the current directory and the aliases.
+    // The mount with the greater priority overrides the files of the others, with the same
+    // priority the later mount wins. The mounts can be changed only without the active reads
+    void MountArchive(const std::filesystem::path& path, int32_t priority = 0);
+    void MountDirectory(const std::filesystem::path& path, int32_t priority = 0);
 
     std::filesystem::path CurrentPath() const;
 
+    // fails for the file that is read from the archive, also if a loose file with the same path
+    // is shadowed by the archive mount
     bool GetRealPath(const std::filesystem::path& inPath, std::filesystem::path& outPath, std::string& error) const noexcept;
     bool GetRealPath(const std::filesystem::path& inPath, std::filesystem::path& outPath) const noexcept;
     std::filesystem::path GetRealPath(const std::filesystem::path& inPath) const;
@@ -23,6 +66,32 @@ public:
     bool ReadFullFile(const std::filesystem::path& path, std::string& data) const noexcept;
     std::string ReadFullFile(const std::filesystem::path& path) const;
 
+    // memory mapped view of the whole file without the copy, the view keeps the mapping alive
+    bool MapFile(const std::filesystem::path& path, FileView& view, std::string& error) const noexcept;
+    bool MapFile(const std::filesystem::path& path, FileView& view) const noexcept;
+    FileView MapFile(const std::filesystem::path& path) const;
+
+    // The file is mapped and its pages are read into the memory on the I/O thread, the consumer
+    // doesn't wait for the disk. The requests are served in the order of the calls. The path
+    // is resolved by the caller thread, the aliases can be changed only without the active reads
+    void ReadFileAsync(const std::filesystem::path& path, ReadCallback&& callback);
+    // the future throws EngineError on a failure
+    std::future<FileView> ReadFileAsync(const std::filesystem::path& path);
+
+private:
+    bool Resolve(const std::filesystem::path& path, ResolvedPath& resolved, std::string& error) const noexcept;
+    static FileView MapResolved(const ResolvedPath& resolved, std::string& error, bool populate) noexcept;
+    void IOLoop();
+
 private:
     std::map<std::string, std::filesystem::path> m_aliases;
+    // sorted by the priority, the first mount wins
+    std::vector<Mount> m_mounts;
+
+    bool m_isStopped = false;
+    std::mutex m_ioMutex;
+    std::condition_variable m_ioQueueChanged;
+    std::deque<ReadRequest> m_ioQueue;
+    // is started by the first async read
+    std::thread m_ioThread;
 };
@@ -1,13 +1,22 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include <cstdint>
 
 #include "dg/dg.h"
+#include "dg/math.h"
 #include "core/common/ctor.h"
 #include "core/common/counter.h"
 
 
+struct GeometryLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    // max deviation from the source mesh in the mesh space
+    float error = 0.f;
+};
+
 class Geometry : public Counter<Geometry>, Fixed {
 protected:
     Geometry() = delete;
@@ -17,8 +26,11 @@ protected:
 public:
     uint16_t GetVDeclId() const noexcept { return m_vDeclId; }
 
+    // lodScale - screen pixels per mesh unit at the distance 1 divided by the allowed error in pixels, 0 - LOD is disabled
+    virtual uint8_t SelectLod(const dg::float4x4& /* world */, const dg::float3& /* cameraPosition */, float /* lodScale */) const { return 0; }
+
     virtual void Bind(ContextPtr& context) = 0;
-    virtual uint32_t Draw(ContextPtr& context, uint32_t firstInstanceIndex = 0) = 0;
+    virtual uint32_t Draw(ContextPtr& context, uint32_t firstInstanceIndex = 0, uint8_t lod = 0, uint32_t instanceCount = 1) = 0;
 
 protected:
     uint16_t m_vDeclId;
@@ -33,7 +45,7 @@ public:
 
 public:
     void Bind(ContextPtr& context) final;
-    uint32_t Draw(ContextPtr& context, uint32_t firstInstanceIndex = 0) final;
+    uint32_t Draw(ContextPtr& context, uint32_t firstInstanceIndex = 0, uint8_t lod = 0, uint32_t instanceCount = 1) final;
 
 private:
     std::shared_ptr<VertexBuffer> m_vertexBuffer = nullptr;
@@ -45,14 +57,22 @@ class IndexBuffer;
 class GeometryIndexed final : public Geometry {
 public:
     GeometryIndexed() = delete;
+    // ibCount - the index count of the whole index range including all LODs
     GeometryIndexed(const std::shared_ptr<VertexBuffer>& vb, uint32_t vbOffsetBytes,
         const std::shared_ptr<IndexBuffer>& ib, uint32_t ibOffsetBytes, uint32_t ibCount, bool ibUint32,
         uint16_t vDeclId);
     ~GeometryIndexed() final;
 
 public:
+    // lods[0] is the most detailed level, index ranges are relative to ibOffsetBytes,
+    // center - the center of the mesh for the distance calculation
+    void SetLods(const std::vector<GeometryLod>& lods, const dg::float3& center);
+    uint8_t GetLodCount() const noexcept { return static_cast<uint8_t>(m_lods.size()); }
+
+    uint8_t SelectLod(const dg::float4x4& world, const dg::float3& cameraPosition, float lodScale) const final;
+
     void Bind(ContextPtr& context) final;
-    uint32_t Draw(ContextPtr& context, uint32_t firstInstanceIndex = 0) final;
+    uint32_t Draw(ContextPtr& context, uint32_t firstInstanceIndex = 0, uint8_t lod = 0, uint32_t instanceCount = 1) final;
 
 private:
     std::shared_ptr<VertexBuffer> m_vertexBuffer = nullptr;
@@ -61,4 +81,6 @@ private:
     uint32_t m_indexBufferOffsetBytes = 0;
     uint32_t m_indexBufferCount = 0;
     bool m_indexBufferUint32 = true;
+    dg::float3 m_lodCenter = dg::float3(0, 0, 0);
+    std::vector<GeometryLod> m_lods;
 };
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "dg/math.h"
+
+
+// compact transform of the one instance in the node space: uniform scale, rotation around Y and translation
+struct InstanceTransform {
+    dg::float3 position;
+    float scale = 1.f;
+    float angleY = 0.f;
+};
+
+// the instance transform in the world space, as it is written to the per instance vertex buffer
+struct InstanceMatrices {
+    dg::float4x4 world;
+    dg::float3x3 normal;
+};
+
+// The instance transforms of the node with their world matrices, that are kept between the frames.
+// Set marks only the changed instances, Update expands them, or all instances after the node is moved
+class InstanceList {
+public:
+    InstanceList() = default;
+    ~InstanceList() = default;
+
+    bool IsEmpty() const noexcept { return m_transforms.empty(); }
+    const std::vector<InstanceTransform>& GetTransforms() const noexcept { return m_transforms; }
+    // the matrices of the last Update
+    const std::vector<InstanceMatrices>& GetMatrices() const noexcept { return m_matrices; }
+
+    void Set(std::vector<InstanceTransform>&& transforms);
+    // isNodeDirty - nodeWorld is changed since the last Update, returns the number of the expanded instances
+    size_t Update(const dg::float4x4& nodeWorld, bool isNodeDirty);
+
+private:
+    bool m_hasDirty = false;
+    std::vector<bool> m_isDirty;
+    std::vector<InstanceTransform> m_transforms;
+    std::vector<InstanceMatrices> m_matrices;
+};
@@ -4,6 +4,7 @@
 #include <cstdint>
 
 #include "dg/dg.h"
+#include "dg/math.h"
 #include "core/common/ctor.h"
 #include "core/render/transform_graph.h"
 
@@ -13,6 +14,8 @@ public:
     Scene() = default;
     ~Scene() = default;
 
+    // see Geometry::SelectLod, lodScale = 0 - LOD is disabled
+    void SetLodParams(const dg::float3& cameraPosition, float lodScale);
     TransformUpdateDesc& Update(uint16_t targetsId, uint16_t vDeclIdPerInstance, uint32_t findId);
     uint32_t Draw(ContextPtr& context);
 
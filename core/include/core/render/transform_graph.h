@@ -8,18 +8,25 @@
 #include "core/common/ctor.h"
 #include "core/math/constants.h"
 #include "core/material/material_view.h"
+#include "core/render/instance_transform.h"
 
 
 class Geometry;
 class Material;
 struct DrawNode {
-    DrawNode(const std::shared_ptr<Geometry>& geometry, MaterialView materialView, const dg::float4x4& worldMatrix, const dg::float3x3& normalMatrix, uint32_t id);
+    DrawNode(const std::shared_ptr<Geometry>& geometry, MaterialView materialView, const dg::float4x4& worldMatrix, const dg::float3x3& normalMatrix, uint32_t id, uint8_t lod = 0,
+        const std::vector<InstanceMatrices>* instances = nullptr);
+
+    uint32_t GetInstanceCount() const noexcept { return (instances == nullptr) ? 1 : static_cast<uint32_t>(instances->size()); }
 
     std::shared_ptr<Geometry> geometry;
     MaterialView materialView;
     const dg::float4x4 worldMatrix;
     const dg::float3x3 normalMatrix;
     uint32_t id;
+    uint8_t lod;
+    // nullptr - the one instance with worldMatrix, otherwise all instances are drawn with the one draw call
+    const std::vector<InstanceMatrices>* instances;
 };
 
 class TransformNode;
@@ -29,6 +36,9 @@ struct TransformUpdateDesc {
     uint16_t vDeclIdPerInstance;
     uint32_t lastId;
     uint32_t findId;
+    // see Geometry::SelectLod, 0 - LOD is disabled
+    float lodScale = 0.f;
+    dg::float3 cameraPosition;
     std::shared_ptr<TransformNode> findResult;
     std::vector<DrawNode> nodeList;
 };
@@ -57,6 +67,11 @@ public:
     const dg::float4x4& GetWorldMatrix() const noexcept { return m_world; }
     const dg::float3x3& GetNormalMatrix() const noexcept { return m_normal; }
 
+    // draw the geometry as the instances of the node, an empty list - the one instance with the node transform
+    void SetInstances(std::vector<InstanceTransform>&& instances);
+    void SetInstances(const std::vector<InstanceTransform>& instances);
+    const std::vector<InstanceTransform>& GetInstances() const noexcept { return m_instances.GetTransforms(); }
+
     uint32_t GetId() const noexcept { return m_id; }
     std::shared_ptr<Geometry>& GetGeometry() noexcept { return m_geometry; }
     std::shared_ptr<Material>& GetMaterial() noexcept { return m_material; }
@@ -68,6 +83,8 @@ private:
     std::vector<std::shared_ptr<TransformNode>> m_children;
     std::shared_ptr<Geometry> m_geometry = nullptr;
     std::shared_ptr<Material> m_material = nullptr;
+    // the world matrices of the instances are expanded only for the changed instances or after the node is moved
+    InstanceList m_instances;
     uint32_t m_id = 0;
     bool m_isDirty = true;
     bool m_isVisible = true;
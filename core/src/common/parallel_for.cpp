@@ -0,0 +1,115 @@
+#include "core/common/parallel_for.h"
+
+#include <algorithm>
+
+
+uint32_t ResolveThreadCount(uint32_t threadCount, size_t count) noexcept {
+    if (threadCount == 0) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    return static_cast<uint32_t>(std::min(static_cast<size_t>(threadCount), std::max(count, size_t(1))));
+}
+
+WorkerPool::WorkerPool(uint32_t threadCount) {
+    const size_t maxCount = UINT32_MAX;
+    threadCount = ResolveThreadCount(threadCount, maxCount);
+
+    m_threads.reserve(threadCount - 1);
+    try {
+        for (uint32_t i=1; i!=threadCount; ++i) {
+            m_threads.emplace_back(&WorkerPool::WorkerLoop, this);
+        }
+    } catch(...) {
+        Stop();
+        throw;
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    Stop();
+}
+
+void WorkerPool::ParallelFor(size_t count, const Func& func) {
+    if ((count <= 1) || m_threads.empty()) {
+        for (size_t i=0; i!=count; ++i) {
+            func(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_count = count;
+        m_func = &func;
+        m_nextIndex.store(0);
+        m_activeCount = m_threads.size();
+        m_exception = nullptr;
+        ++m_loopIndex;
+    }
+    m_loopStarted.notify_all();
+    RunLoop();
+
+    std::exception_ptr exception;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_loopFinished.wait(lock, [this] { return (m_activeCount == 0); });
+        m_func = nullptr;
+        std::swap(exception, m_exception);
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void WorkerPool::WorkerLoop() {
+    uint64_t loopIndex = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_loopStarted.wait(lock, [this, loopIndex] { return (m_isStopped || (m_loopIndex != loopIndex)); });
+            if (m_isStopped) {
+                return;
+            }
+            loopIndex = m_loopIndex;
+        }
+
+        RunLoop();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_activeCount == 0) {
+            m_loopFinished.notify_one();
+        }
+    }
+}
+
+void WorkerPool::Stop() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopped = true;
+    }
+    m_loopStarted.notify_all();
+    for (auto& thread: m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+void WorkerPool::RunLoop() noexcept {
+    for (size_t i = m_nextIndex.fetch_add(1); i < m_count; i = m_nextIndex.fetch_add(1)) {
+        try {
+            (*m_func)(i);
+        } catch(...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_exception) {
+                m_exception = std::current_exception();
+            }
+            m_nextIndex.store(m_count);
+        }
+    }
+}
+
+void ParallelFor(size_t count, uint32_t threadCount, const WorkerPool::Func& func) {
+    WorkerPool workers(ResolveThreadCount(threadCount, count));
+    workers.ParallelFor(count, func);
+}
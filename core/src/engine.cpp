@@ -48,7 +48,7 @@ void Engine::Create(EngineDesc&& desc) {
     m_swapChain = m_gAPI->GetSwapChain();
     m_context = m_gAPI->GetContext();
     m_engineFactory = m_gAPI->GetEngineFactory();
-    m_textureManager = std::make_shared<TextureManager>(m_device);
+    m_textureManager = std::make_shared<TextureManager>(m_device, m_context);
     m_materialBuilder = std::make_shared<MaterialBuilder>(m_device, m_context, m_swapChain, m_engineFactory, m_vDeclStorage);
 
     m_application->Create();
@@ -76,6 +76,7 @@ void Engine::Run() {
         }
 
         auto dt = timer.TimePoint();
+        m_textureManager->Update();
         m_application->Update(dt);
 
         m_application->Draw();
@@ -66,3 +66,13 @@ void MaterialView::Bind(ContextPtr& context) {
     context->SetPipelineState(impl->m_pipelineState);
     context->CommitShaderResources(impl->m_binding, dg::RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
 }
+
+void MaterialView::Bind(ContextPtr& context, const MaterialView& prev) {
+    const bool isPipelineChanged = (impl->m_pipelineState.RawPtr() != prev.impl->m_pipelineState.RawPtr());
+    if (isPipelineChanged) {
+        context->SetPipelineState(impl->m_pipelineState);
+    }
+    if (isPipelineChanged || (impl->m_binding.RawPtr() != prev.impl->m_binding.RawPtr())) {
+        context->CommitShaderResources(impl->m_binding, dg::RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    }
+}
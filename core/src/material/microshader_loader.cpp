@@ -2,10 +2,14 @@
 
 #include <set>
 #include <memory>
+#include <future>
+#include <vector>
 #include <utility>
 #include <type_traits>
 
 #include "ucl/ucl.h"
+#include "core/engine.h"
+#include "core/path/path.h"
 #include "core/common/exception.h"
 
 
@@ -24,6 +28,12 @@ namespace {
             ucl_object_unref(obj);
         }
     };
+
+    // parses the file view of FileManager (the mapped file or the archive entry) without the copy to the heap,
+    // the parser copies the strings, so the parsed objects don't refer to the view
+    bool ParseFile(ucl_parser* parser, const FileView& view) {
+        return ucl_parser_add_chunk(parser, reinterpret_cast<const unsigned char*>(view.Data().data()), view.Size());
+    }
 }
 
 void MicroshaderLoader::Load(const MaterialBuilderDesc& desc) {
@@ -45,11 +55,20 @@ void MicroshaderLoader::Load(const MaterialBuilderDesc& desc) {
         requiredExtension = "." + requiredExtension;
     }
 
+    // the microshader files are read on the I/O thread of FileManager, while the schema and the previous files are parsed
+    auto& fileManager = Engine::Get().GetFileManager();
+    std::vector<std::pair<std::filesystem::path, std::future<FileView>>> files;
+    for (const auto& it: std::filesystem::directory_iterator(m_desc.shadersDir)) {
+        if (it.is_regular_file() && (it.path().extension() == requiredExtension)) {
+            files.emplace_back(it.path(), fileManager->ReadFileAsync(it.path()));
+        }
+    }
+
     ParserPtr parser;
     std::unique_ptr<ucl_object_t, UclDeleter> schema;
 
     parser.reset(ucl_parser_new(UCL_PARSER_DEFAULT));
-    if (ucl_parser_add_file(parser.get(), m_desc.shadersSchemaPath.c_str())) {
+    if (ParseFile(parser.get(), fileManager->MapFile(m_desc.shadersSchemaPath))) {
         schema.reset(ucl_parser_get_object(parser.get()));
     } else if(const char *error = ucl_parser_get_error(parser.get()); error != nullptr) {
         throw EngineError("failed open microshader schema file {}, error: {}", m_desc.shadersSchemaPath.c_str(), error);
@@ -69,12 +88,9 @@ void MicroshaderLoader::Load(const MaterialBuilderDesc& desc) {
     // order => groupName
     std::map<int64_t, std::string> vsOrder;
 
-    for(auto& it: std::filesystem::directory_iterator(m_desc.shadersDir)) {
+    for (auto& [path, file]: files) {
         ucl::Ucl root;
-        const auto path = it.path();
-        if (!ReadMicroshader(path, requiredExtension, schema.get(), root)) {
-            continue;
-        }
+        ReadMicroshader(path, file.get(), schema.get(), root);
 
         Microshader ms;
         try {
@@ -215,18 +231,10 @@ MicroshaderLoader::Source MicroshaderLoader::GetSources(uint64_t mask, const msh
     return src;
 }
 
-bool MicroshaderLoader::ReadMicroshader(const std::filesystem::path& filepath, const std::string& requiredExtension, ucl_object_t* schema, ucl::Ucl& section) {
-    if (!std::filesystem::is_regular_file(filepath)) {
-        return false;
-    }
-
-    if (filepath.extension() != requiredExtension) {
-        return false;
-    }
-
+void MicroshaderLoader::ReadMicroshader(const std::filesystem::path& filepath, const FileView& file, ucl_object_t* schema, ucl::Ucl& section) {
     ucl_object_t* rootRaw = nullptr;
     auto parser = ParserPtr(ucl_parser_new(UCL_PARSER_DEFAULT));
-    if (ucl_parser_add_file(parser.get(), filepath.c_str())) {
+    if (ParseFile(parser.get(), file)) {
         rootRaw = ucl_parser_get_object(parser.get());
     } else if(const char *error = ucl_parser_get_error(parser.get()); error != nullptr) {
         throw EngineError("failed open microshader file {}, error: {}", filepath.c_str(), error);
@@ -249,8 +257,6 @@ bool MicroshaderLoader::ReadMicroshader(const std::filesystem::path& filepath, c
     } catch(const std::exception& e) {
         throw EngineError("failed validate microshader file {}, error: {}", filepath.c_str(), e.what());
     }
-
-    return true;
 }
 
 void MicroshaderLoader::ParseMicroshader(const ucl::Ucl& section, Microshader& ms) {
@@ -60,6 +60,8 @@ void PixelMicroshader::Parse(const ucl::Ucl& section) {
             ::Parse(it, cbuffers);
         } else if (it.key() == "textures2D") {
             ::Parse(it, textures2D);
+        } else if (it.key() == "textures2DArray") {
+            ::Parse(it, textures2DArray);
         } else if (it.key() == "source") {
             source = it.string_value();
         } else {
@@ -71,6 +73,7 @@ void PixelMicroshader::Parse(const ucl::Ucl& section) {
 void PixelMicroshader::Append(const PixelMicroshader* value) {
     includes.Append(value->includes);
     textures2D.Append(value->textures2D);
+    textures2DArray.Append(value->textures2DArray);
     psInput.Append(value->psInput);
     psOutput.Append(value->psOutput);
     psLocal.Append(value->psLocal);
@@ -85,6 +88,7 @@ void PixelMicroshader::Generate(const MaterialBuilderDesc& desc, std::string& ou
     psLocal.GenerateStruct("PSLocal", out);
     cbuffers.GenerateCbuffer(desc.cbufferNameGenerator, out);
     textures2D.GenerateTextures(desc.samplerSuffix, out);
+    textures2DArray.GenerateTextureArrays(desc.samplerSuffix, out);
     out.append(source);
 }
 
@@ -84,6 +84,12 @@ void Items::GenerateTextures(const std::string& samplerSuffix, std::string& out)
     }, out);
 }
 
+void Items::GenerateTextureArrays(const std::string& samplerSuffix, std::string& out) {
+    Generate([&samplerSuffix](const Item& item, std::string& out){
+        out.append(fmt::format("Texture2DArray {0};\nSamplerState {0}{1};\n", item, samplerSuffix));
+    }, out);
+}
+
 Decl::Decl(const std::string& name, const std::string& type)
     : name(name)
     , type(type) {
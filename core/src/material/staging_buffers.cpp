@@ -0,0 +1,60 @@
+#include "core/material/staging_buffers.h"
+
+#include <algorithm>
+
+
+uint8_t* StagingBuffers::Acquire(size_t size) {
+    Buffer* result = nullptr;
+    for (auto& buffer: m_buffers) {
+        if (!buffer.isAcquired) {
+            result = &buffer;
+            break;
+        }
+    }
+    if (result == nullptr) {
+        result = &m_buffers.emplace_back();
+    }
+
+    if (result->data.size() < size) {
+        result->data.resize(size);
+    }
+    result->isAcquired = true;
+
+    return result->data.data();
+}
+
+void StagingBuffers::Release(const uint8_t* data) noexcept {
+    for (auto& buffer: m_buffers) {
+        if (buffer.isAcquired && (buffer.data.data() == data)) {
+            buffer.isAcquired = false;
+            return;
+        }
+    }
+}
+
+void StagingBuffers::FreeReleased() noexcept {
+    // the data of the moved buffers keeps its address
+    m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(), [](const Buffer& buffer) {
+        return !buffer.isAcquired;
+    }), m_buffers.end());
+}
+
+size_t StagingBuffers::GetAcquiredCount() const noexcept {
+    size_t result = 0;
+    for (const auto& buffer: m_buffers) {
+        if (buffer.isAcquired) {
+            ++result;
+        }
+    }
+
+    return result;
+}
+
+size_t StagingBuffers::GetMemorySize() const noexcept {
+    size_t result = 0;
+    for (const auto& buffer: m_buffers) {
+        result += buffer.data.size();
+    }
+
+    return result;
+}
@@ -1,8 +1,11 @@
 #include "core/material/texture.h"
 
+#include <cstring>
+
 #include "dg/device.h"
 #include "dg/context.h"
 #include "core/common/exception.h"
+#include "core/material/texture_residency.h"
 
 
 namespace {
@@ -13,30 +16,49 @@ namespace {
     }
 }
 
-DynamicTexture::LockHelper::LockHelper(DevicePtr& device, ContextPtr& context, TexturePtr& texture)
-    : width(texture->GetDesc().Width)
-    , height(texture->GetDesc().Height)
+DynamicTexture::LockHelper::LockHelper(DynamicTexture& texture, ContextPtr& context, const math::Rect& rect, bool generateMips)
+    : x(rect.x)
+    , y(rect.y)
+    , width(rect.w)
+    , height(rect.h)
+    , m_generateMips(generateMips)
     , m_context(context)
-    , m_texture(texture) {
+    , m_texture(texture.Get())
+    , m_owner(&texture) {
 
-    const auto& caps = device->GetDeviceCaps();
+    if (!m_texture) {
+        throw EngineError("DynamicTexture: failed to lock texture for write, texture is evicted, it must be restored before the lock");
+    }
+    const auto& desc = m_texture->GetDesc();
+    if ((width == 0) || (height == 0) || (rect.Right() > desc.Width) || (rect.Bottom() > desc.Height)) {
+        throw EngineError("DynamicTexture: failed to lock texture for write, wrong rect ({}, {}, {}, {}) for texture size ({}, {})",
+            x, y, width, height, desc.Width, desc.Height);
+    }
+
+    const auto& caps = texture.m_device->GetDeviceCaps();
     if (caps.IsGLDevice()) {
-        m_updateData = new uint8_t[width * height * 4];
-        data = m_updateData;
         stride = width * 4;
+        data = texture.m_staging.Acquire(static_cast<size_t>(stride) * static_cast<size_t>(height));
+        m_isMapped = false;
 
     } else if (caps.IsVulkanDevice()) {
         const uint32_t mipLevel = 0;
         const uint32_t arraySlice = 0;
+        dg::Box mapBox;
+        mapBox.MinX = x;
+        mapBox.MinY = y;
+        mapBox.MaxX = x + width;
+        mapBox.MaxY = y + height;
+
         dg::MappedTextureSubresource texData;
-        m_context->MapTextureSubresource(m_texture, mipLevel, arraySlice, dg::MAP_WRITE, dg::MAP_FLAG_DO_NOT_WAIT, nullptr, texData);
+        m_context->MapTextureSubresource(m_texture, mipLevel, arraySlice, dg::MAP_WRITE, dg::MAP_FLAG_DO_NOT_WAIT, &mapBox, texData);
         if (texData.pData == nullptr) {
             throw EngineError("DynamicTexture: failed to lock texture for write");
         }
 
-        m_updateData = nullptr;
         data = reinterpret_cast<uint8_t*>(texData.pData);
         stride = texData.Stride;
+        m_isMapped = true;
 
     } else {
         throw EngineError("DynamicTexture: failed to lock texture for write, unsupported device type {}", caps.DevType);
@@ -47,34 +69,39 @@ DynamicTexture::LockHelper::~LockHelper() {
     const uint32_t mipLevel = 0;
     const uint32_t arraySlice = 0;
 
-    if (m_updateData != nullptr) {
+    if (!m_isMapped) {
         dg::Box DstBox;
-        DstBox.MinX = 0;
-        DstBox.MinY = 0;
-        DstBox.MaxX = width;
-        DstBox.MaxY = height;
+        DstBox.MinX = x;
+        DstBox.MinY = y;
+        DstBox.MaxX = x + width;
+        DstBox.MaxY = y + height;
 
         dg::TextureSubResData subresData;
         subresData.Stride = stride;
         subresData.pData  = data;
 
         m_context->UpdateTexture(m_texture, mipLevel, arraySlice, DstBox, subresData, dg::RESOURCE_STATE_TRANSITION_MODE_TRANSITION, dg::RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
-        delete[] m_updateData;
+        // the texels are copied by UpdateTexture, the buffer can be given to the next lock
+        m_owner->m_staging.Release(data);
     } else {
         m_context->UnmapTextureSubresource(m_texture, mipLevel, arraySlice);
     }
-    m_context->GenerateMips(m_texture->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE));
+    if (m_generateMips) {
+        m_context->GenerateMips(m_texture->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE));
+    }
 }
 
-DynamicTexture::DynamicTexture(dg::IReferenceCounters* refCounters, DevicePtr& device, const dg::TextureDesc& desc)
+DynamicTexture::DynamicTexture(dg::IReferenceCounters* refCounters, DevicePtr& device, const dg::TextureDesc& desc,
+    const std::shared_ptr<TextureResidency>& residency)
     : dg::ObjectBase<dg::IObject>(refCounters)
-    , m_device(device) {
+    , m_device(device)
+    , m_desc(desc)
+    , m_name((desc.Name == nullptr) ? "" : desc.Name)
+    , m_resident(residency, GetMemorySize(), [this]() { m_texture.Release(); m_staging.FreeReleased(); }) {
 
     CheckIsCorrectTextureSize(desc.Width, desc.Height);
-    m_device->CreateTexture(desc, nullptr, &m_texture);
-    if (!m_texture) {
-        throw EngineError("DynamicTexture: failed to create texture");
-    }
+    m_desc.Name = m_name.c_str();
+    CreateTexture();
 }
 
 DynamicTexture::~DynamicTexture() {
@@ -87,23 +114,101 @@ TexturePtr DynamicTexture::Get() const noexcept {
 }
 
 bool DynamicTexture::SetSize(uint32_t width,  uint32_t height) {
-    auto desc = m_texture->GetDesc();
-
-    if ((desc.Width == width) && (desc.Height == height)) {
+    if ((m_desc.Width == width) && (m_desc.Height == height)) {
         return false;
     }
 
-    desc.Width = width;
-    desc.Height = height;
     CheckIsCorrectTextureSize(width, height);
-    m_device->CreateTexture(desc, nullptr, &m_texture);
-    if (!m_texture) {
-        throw EngineError("DynamicTexture: failed to create texture");
-    }
+    m_desc.Width = width;
+    m_desc.Height = height;
+    CreateTexture();
+    m_resident.SetSize(GetMemorySize());
 
     return true;
 }
 
-DynamicTexture::LockHelper DynamicTexture::Lock(ContextPtr& context) {
-    return LockHelper(m_device, context, m_texture);
+bool DynamicTexture::Restore() {
+    return m_resident.Restore([this]() {
+        CreateTexture();
+        return GetMemorySize();
+    });
+}
+
+size_t DynamicTexture::GetMemorySize() const noexcept {
+    const auto& info = m_device->GetTextureFormatInfo(m_desc.Format);
+    const uint32_t texelSize = static_cast<uint32_t>(info.ComponentSize) * static_cast<uint32_t>(info.NumComponents);
+
+    return CalcTextureMemory(m_desc.Width, m_desc.Height, m_desc.MipLevels, texelSize);
+}
+
+DynamicTexture::LockHelper DynamicTexture::Lock(ContextPtr& context, bool generateMips) {
+    const auto& desc = m_desc;
+    return LockHelper(*this, context, math::Rect(0, 0, desc.Width, desc.Height), generateMips);
+}
+
+DynamicTexture::LockHelper DynamicTexture::Lock(ContextPtr& context, const math::Rect& rect, bool generateMips) {
+    return LockHelper(*this, context, rect, generateMips);
+}
+
+void DynamicTexture::Update(ContextPtr& context, const math::Rect& rect, const uint8_t* data, uint32_t stride) {
+    if ((rect.w == 0) || (rect.h == 0)) {
+        return;
+    }
+    if (IsEvicted()) {
+        throw EngineError("DynamicTexture::Update: texture is evicted, it must be restored before the update");
+    }
+
+    const auto& desc = m_desc;
+    if ((rect.Right() > desc.Width) || (rect.Bottom() > desc.Height)) {
+        throw EngineError("DynamicTexture::Update: rect is out of the texture size ({}, {})", desc.Width, desc.Height);
+    }
+
+    const uint32_t mipLevel = 0;
+    const uint32_t arraySlice = 0;
+    dg::Box DstBox;
+    DstBox.MinX = rect.Left();
+    DstBox.MinY = rect.Top();
+    DstBox.MaxX = rect.Right();
+    DstBox.MaxY = rect.Bottom();
+
+    const auto& caps = m_device->GetDeviceCaps();
+    if (caps.IsGLDevice()) {
+        dg::TextureSubResData subresData;
+        subresData.Stride = stride;
+        subresData.pData  = data;
+
+        context->UpdateTexture(m_texture, mipLevel, arraySlice, DstBox, subresData, dg::RESOURCE_STATE_TRANSITION_MODE_TRANSITION, dg::RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    } else if (caps.IsVulkanDevice()) {
+        dg::MappedTextureSubresource texData;
+        context->MapTextureSubresource(m_texture, mipLevel, arraySlice, dg::MAP_WRITE, dg::MAP_FLAG_DO_NOT_WAIT, &DstBox, texData);
+        if (texData.pData == nullptr) {
+            throw EngineError("DynamicTexture::Update: failed to lock texture for write");
+        }
+
+        auto* dst = reinterpret_cast<uint8_t*>(texData.pData);
+        const size_t rowSize = rect.w * 4;
+        for (uint32_t y=0; y!=rect.h; ++y) {
+            std::memcpy(dst + y * texData.Stride, data + y * stride, rowSize);
+        }
+        context->UnmapTextureSubresource(m_texture, mipLevel, arraySlice);
+
+    } else {
+        throw EngineError("DynamicTexture::Update: unsupported device type {}", caps.DevType);
+    }
+}
+
+void DynamicTexture::GenerateMips(ContextPtr& context) {
+    if (IsEvicted()) {
+        throw EngineError("DynamicTexture::GenerateMips: texture is evicted, it must be restored before the update");
+    }
+    context->GenerateMips(m_texture->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE));
+}
+
+void DynamicTexture::CreateTexture() {
+    m_texture.Release();
+    m_device->CreateTexture(m_desc, nullptr, &m_texture);
+    if (!m_texture) {
+        throw EngineError("DynamicTexture: failed to create texture");
+    }
 }
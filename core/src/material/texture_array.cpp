@@ -0,0 +1,119 @@
+#include "core/material/texture_array.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include "core/common/exception.h"
+
+
+namespace {
+
+// copies the image to the top left corner of the slice, the rest is filled by the edge texels
+TextureMip PadImage(const TextureMip& image, uint32_t width, uint32_t height) {
+    TextureMip result;
+    result.width = width;
+    result.height = height;
+    result.texels.resize(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+
+    const size_t srcStride = static_cast<size_t>(image.width) * 4;
+    const size_t dstStride = static_cast<size_t>(width) * 4;
+    for (uint32_t y=0; y!=height; ++y) {
+        const uint8_t* src = &image.texels[std::min(y, image.height - 1) * srcStride];
+        uint8_t* dst = &result.texels[y * dstStride];
+        std::memcpy(dst, src, srcStride);
+        const uint8_t* edge = src + srcStride - 4;
+        for (uint32_t x=image.width; x!=width; ++x) {
+            std::memcpy(dst + static_cast<size_t>(x) * 4, edge, 4);
+        }
+    }
+
+    return result;
+}
+
+// mips count of the full chain down to 1x1
+size_t CalcMipsCount(uint32_t width, uint32_t height) {
+    size_t result = 1;
+    while ((width != 1) || (height != 1)) {
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+        ++result;
+    }
+
+    return result;
+}
+
+}
+
+size_t PackedTextureArray::ByteSize() const noexcept {
+    size_t result = 0;
+    for (const auto& slice: slices) {
+        result += slice.ByteSize();
+    }
+
+    return result;
+}
+
+PackedTextureArray PackTextureArray(const std::vector<const DecodedTexture*>& textures) {
+    if (textures.empty()) {
+        throw EngineError("PackTextureArray: no textures");
+    }
+
+    const auto* first = textures[0];
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool hasMips = false;
+    for (const auto* texture: textures) {
+        if (texture->mips.empty()) {
+            throw EngineError("PackTextureArray: texture doesn't have mip 0");
+        }
+        if ((texture->format != first->format) || (texture->isSRGB != first->isSRGB)) {
+            throw EngineError("PackTextureArray: textures have different formats");
+        }
+        const auto& image = texture->mips[0];
+        if ((image.width == 0) || (image.height == 0)) {
+            throw EngineError("PackTextureArray: texture has zero size");
+        }
+        if ((texture->format != BlockFormat::None) && ((image.width != first->mips[0].width) ||
+            (image.height != first->mips[0].height) || (texture->mips.size() != first->mips.size()))) {
+            throw EngineError("PackTextureArray: compressed textures have different sizes ({}x{} and {}x{}) or mips count",
+                image.width, image.height, first->mips[0].width, first->mips[0].height);
+        }
+        width = std::max(width, image.width);
+        height = std::max(height, image.height);
+        hasMips |= (texture->mips.size() > 1);
+    }
+
+    PackedTextureArray result;
+    result.slices.reserve(textures.size());
+    result.slots.reserve(textures.size());
+    for (size_t i=0; i!=textures.size(); ++i) {
+        const auto* texture = textures[i];
+        const auto& image = texture->mips[0];
+
+        TextureArraySlot slot;
+        slot.slice = static_cast<uint32_t>(i);
+        slot.uvRect = math::RectF(0.f, 0.f,
+            static_cast<float>(image.width) / static_cast<float>(width),
+            static_cast<float>(image.height) / static_cast<float>(height));
+        result.slots.push_back(slot);
+
+        // the compressed textures and the textures of the slice size with the full mip chain are taken as is
+        const size_t mipsCount = hasMips ? CalcMipsCount(width, height) : 1;
+        if ((texture->format != BlockFormat::None) ||
+            ((image.width == width) && (image.height == height) && (texture->mips.size() == mipsCount))) {
+            result.slices.push_back(*texture);
+            continue;
+        }
+
+        DecodedTexture slice;
+        slice.isSRGB = texture->isSRGB;
+        slice.format = texture->format;
+        slice.mips.push_back(PadImage(image, width, height));
+        if (hasMips) {
+            GenerateMips(slice);
+        }
+        result.slices.push_back(std::move(slice));
+    }
+
+    return result;
+}
@@ -0,0 +1,797 @@
+#include "core/material/texture_compressor.h"
+
+#include <cmath>
+#include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "core/common/exception.h"
+#include "core/common/parallel_for.h"
+
+
+namespace {
+
+constexpr const size_t BlockTexels = 16;
+using Block = std::array<std::array<uint8_t, 4>, BlockTexels>;
+template<size_t N> using Point = std::array<float, N>;
+template<size_t N> using Values = std::array<Point<N>, BlockTexels>;
+using Weights = std::array<float, BlockTexels>;
+
+uint32_t GetRefineIterations(CompressionQuality quality) noexcept {
+    switch (quality) {
+    case CompressionQuality::Fast:
+        return 0;
+    case CompressionQuality::Normal:
+        return 1;
+    default:
+        return 3;
+    }
+}
+
+// the texels out of the image repeat the edge texels
+void ReadBlock(const uint8_t* texels, uint32_t width, uint32_t height, uint32_t stride, uint32_t blockX, uint32_t blockY, Block& block) {
+    for (uint32_t y=0; y!=4; ++y) {
+        const uint32_t texelY = std::min(blockY * 4 + y, height - 1);
+        const uint8_t* row = texels + static_cast<size_t>(texelY) * stride;
+        for (uint32_t x=0; x!=4; ++x) {
+            const uint32_t texelX = std::min(blockX * 4 + x, width - 1);
+            std::copy_n(row + static_cast<size_t>(texelX) * 4, 4, block[y * 4 + x].data());
+        }
+    }
+}
+
+void WriteBlock(const Block& block, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t* texels) {
+    for (uint32_t y=0; y!=4; ++y) {
+        const uint32_t texelY = blockY * 4 + y;
+        for (uint32_t x=0; x!=4; ++x) {
+            const uint32_t texelX = blockX * 4 + x;
+            if ((texelX < width) && (texelY < height)) {
+                std::copy_n(block[y * 4 + x].data(), 4, texels + (static_cast<size_t>(texelY) * width + texelX) * 4);
+            }
+        }
+    }
+}
+
+template<size_t N> Values<N> ToValues(const Block& block, uint32_t firstChannel) {
+    Values<N> values;
+    for (size_t i=0; i!=BlockTexels; ++i) {
+        for (size_t c=0; c!=N; ++c) {
+            values[i][c] = static_cast<float>(block[i][firstChannel + c]);
+        }
+    }
+
+    return values;
+}
+
+template<size_t N> float Distance2(const Point<N>& a, const Point<N>& b) noexcept {
+    float result = 0;
+    for (size_t c=0; c!=N; ++c) {
+        result += (a[c] - b[c]) * (a[c] - b[c]);
+    }
+
+    return result;
+}
+
+// The endpoints of the segment, that covers the values: the bounding box diagonal (the channels with
+// the negative covariance to the first channel are flipped) or the extent along the principal axis
+template<size_t N> void FitEndpoints(const Values<N>& values, bool usePrincipalAxis, Point<N>& e0, Point<N>& e1) {
+    Point<N> minValue;
+    Point<N> maxValue;
+    Point<N> mean;
+    minValue.fill(255.f);
+    maxValue.fill(0);
+    mean.fill(0);
+    for (const auto& v: values) {
+        for (size_t c=0; c!=N; ++c) {
+            minValue[c] = std::min(minValue[c], v[c]);
+            maxValue[c] = std::max(maxValue[c], v[c]);
+            mean[c] += v[c] / static_cast<float>(BlockTexels);
+        }
+    }
+
+    std::array<Point<N>, N> covariance;
+    for (auto& row: covariance) {
+        row.fill(0);
+    }
+    for (const auto& v: values) {
+        for (size_t r=0; r!=N; ++r) {
+            for (size_t c=0; c!=N; ++c) {
+                covariance[r][c] += (v[r] - mean[r]) * (v[c] - mean[c]);
+            }
+        }
+    }
+
+    e0 = minValue;
+    e1 = maxValue;
+    if (!usePrincipalAxis) {
+        for (size_t c=1; c!=N; ++c) {
+            if (covariance[0][c] < 0) {
+                std::swap(e0[c], e1[c]);
+            }
+        }
+        return;
+    }
+
+    // power iteration from the bounding box diagonal
+    Point<N> axis;
+    for (size_t c=0; c!=N; ++c) {
+        axis[c] = maxValue[c] - minValue[c];
+    }
+    for (size_t iteration=0; iteration!=8; ++iteration) {
+        Point<N> next;
+        float maxComponent = 0;
+        for (size_t r=0; r!=N; ++r) {
+            next[r] = 0;
+            for (size_t c=0; c!=N; ++c) {
+                next[r] += covariance[r][c] * axis[c];
+            }
+            maxComponent = std::max(maxComponent, std::abs(next[r]));
+        }
+        if (maxComponent < 1e-6f) {
+            return;
+        }
+        for (size_t c=0; c!=N; ++c) {
+            axis[c] = next[c] / maxComponent;
+        }
+    }
+
+    float axisLength2 = 0;
+    for (size_t c=0; c!=N; ++c) {
+        axisLength2 += axis[c] * axis[c];
+    }
+    float minT = 0;
+    float maxT = 0;
+    for (const auto& v: values) {
+        float t = 0;
+        for (size_t c=0; c!=N; ++c) {
+            t += (v[c] - mean[c]) * axis[c];
+        }
+        t /= axisLength2;
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    for (size_t c=0; c!=N; ++c) {
+        e0[c] = std::clamp(mean[c] + axis[c] * minT, 0.f, 255.f);
+        e1[c] = std::clamp(mean[c] + axis[c] * maxT, 0.f, 255.f);
+    }
+}
+
+// the least squares endpoints for the fixed positions of the values on the segment (0 - e0, 1 - e1)
+template<size_t N> bool RefineEndpoints(const Values<N>& values, const Weights& weights, Point<N>& e0, Point<N>& e1) {
+    float a = 0;
+    float b = 0;
+    float c = 0;
+    Point<N> x;
+    Point<N> y;
+    x.fill(0);
+    y.fill(0);
+    for (size_t i=0; i!=BlockTexels; ++i) {
+        const float t = weights[i];
+        const float s = 1.f - t;
+        a += s * s;
+        b += s * t;
+        c += t * t;
+        for (size_t ch=0; ch!=N; ++ch) {
+            x[ch] += s * values[i][ch];
+            y[ch] += t * values[i][ch];
+        }
+    }
+
+    const float det = a * c - b * b;
+    if (std::abs(det) < 1e-6f) {
+        return false;
+    }
+    for (size_t ch=0; ch!=N; ++ch) {
+        e0[ch] = std::clamp((c * x[ch] - b * y[ch]) / det, 0.f, 255.f);
+        e1[ch] = std::clamp((a * y[ch] - b * x[ch]) / det, 0.f, 255.f);
+    }
+
+    return true;
+}
+
+class BitWriter {
+public:
+    BitWriter(uint8_t* data, size_t size) : m_data(data) { std::fill_n(data, size, 0); }
+    void Write(uint32_t value, uint32_t bits) {
+        for (uint32_t i=0; i!=bits; ++i, ++m_pos) {
+            if (((value >> i) & 1) != 0) {
+                m_data[m_pos / 8] |= static_cast<uint8_t>(1 << (m_pos % 8));
+            }
+        }
+    }
+
+private:
+    uint8_t* m_data;
+    size_t m_pos = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data) : m_data(data) {}
+    uint32_t Read(uint32_t bits) {
+        uint32_t value = 0;
+        for (uint32_t i=0; i!=bits; ++i, ++m_pos) {
+            value |= static_cast<uint32_t>((m_data[m_pos / 8] >> (m_pos % 8)) & 1) << i;
+        }
+        return value;
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t m_pos = 0;
+};
+
+// BC1
+
+uint16_t ToRGB565(const Point<3>& color) {
+    const auto r = static_cast<uint16_t>(std::lround(color[0] * 31.f / 255.f));
+    const auto g = static_cast<uint16_t>(std::lround(color[1] * 63.f / 255.f));
+    const auto b = static_cast<uint16_t>(std::lround(color[2] * 31.f / 255.f));
+
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+std::array<uint32_t, 3> FromRGB565(uint16_t value) {
+    const uint32_t r = (value >> 11) & 31;
+    const uint32_t g = (value >> 5) & 63;
+    const uint32_t b = value & 31;
+
+    return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+// c0 > c1 - 4 colors, otherwise 3 colors and transparent black
+std::array<std::array<uint8_t, 4>, 4> GetBC1Palette(uint16_t c0, uint16_t c1) {
+    const auto p0 = FromRGB565(c0);
+    const auto p1 = FromRGB565(c1);
+    std::array<std::array<uint8_t, 4>, 4> palette;
+    for (size_t c=0; c!=3; ++c) {
+        palette[0][c] = static_cast<uint8_t>(p0[c]);
+        palette[1][c] = static_cast<uint8_t>(p1[c]);
+        if (c0 > c1) {
+            palette[2][c] = static_cast<uint8_t>((2 * p0[c] + p1[c] + 1) / 3);
+            palette[3][c] = static_cast<uint8_t>((p0[c] + 2 * p1[c] + 1) / 3);
+        } else {
+            palette[2][c] = static_cast<uint8_t>((p0[c] + p1[c] + 1) / 2);
+            palette[3][c] = 0;
+        }
+    }
+    palette[0][3] = 255;
+    palette[1][3] = 255;
+    palette[2][3] = 255;
+    palette[3][3] = (c0 > c1) ? 255 : 0;
+
+    return palette;
+}
+
+struct BC1Block {
+    uint16_t c0 = 0;
+    uint16_t c1 = 0;
+    uint32_t indices = 0;
+    float error = 0;
+};
+
+// always the 4 colors mode, the equal endpoints use only index 0
+BC1Block EvaluateBC1(uint16_t c0, uint16_t c1, const Values<3>& values) {
+    BC1Block result;
+    result.c0 = std::max(c0, c1);
+    result.c1 = std::min(c0, c1);
+    const auto palette = GetBC1Palette(result.c0, result.c1);
+    const uint32_t count = (result.c0 == result.c1) ? 1 : 4;
+    for (size_t i=0; i!=BlockTexels; ++i) {
+        uint32_t bestIndex = 0;
+        float bestDistance = 0;
+        for (uint32_t index=0; index!=count; ++index) {
+            const Point<3> color = {static_cast<float>(palette[index][0]), static_cast<float>(palette[index][1]), static_cast<float>(palette[index][2])};
+            const float distance = Distance2(values[i], color);
+            if ((index == 0) || (distance < bestDistance)) {
+                bestIndex = index;
+                bestDistance = distance;
+            }
+        }
+        result.indices |= bestIndex << (i * 2);
+        result.error += bestDistance;
+    }
+
+    return result;
+}
+
+void EncodeBC1(const Block& block, CompressionQuality quality, uint8_t* dst) {
+    const auto values = ToValues<3>(block, 0);
+    Point<3> e0;
+    Point<3> e1;
+    FitEndpoints(values, quality != CompressionQuality::Fast, e0, e1);
+    BC1Block best = EvaluateBC1(ToRGB565(e0), ToRGB565(e1), values);
+
+    const float indexWeights[4] = {0, 1.f, 1.f / 3.f, 2.f / 3.f};
+    for (uint32_t iteration=0; (iteration != GetRefineIterations(quality)) && (best.c0 != best.c1); ++iteration) {
+        Weights weights;
+        for (size_t i=0; i!=BlockTexels; ++i) {
+            weights[i] = indexWeights[(best.indices >> (i * 2)) & 3];
+        }
+        if (!RefineEndpoints(values, weights, e0, e1)) {
+            break;
+        }
+        const auto candidate = EvaluateBC1(ToRGB565(e0), ToRGB565(e1), values);
+        if (candidate.error >= best.error) {
+            break;
+        }
+        best = candidate;
+    }
+
+    // steps of the quantized endpoint channels: red, green, blue as (shift, mask)
+    if (quality == CompressionQuality::High) {
+        const std::array<std::pair<uint16_t, uint16_t>, 3> channels = {{{11, 31}, {5, 63}, {0, 31}}};
+        bool isImproved = true;
+        for (uint32_t pass=0; (pass != 2) && isImproved; ++pass) {
+            isImproved = false;
+            for (uint32_t endpoint=0; endpoint!=2; ++endpoint) {
+                for (const auto& [shift, mask]: channels) {
+                    for (int32_t delta: {-1, 1}) {
+                        uint16_t c[2] = {best.c0, best.c1};
+                        const int32_t value = static_cast<int32_t>((c[endpoint] >> shift) & mask) + delta;
+                        if ((value < 0) || (value > static_cast<int32_t>(mask))) {
+                            continue;
+                        }
+                        c[endpoint] = static_cast<uint16_t>((c[endpoint] & ~(mask << shift)) | (static_cast<uint16_t>(value) << shift));
+                        const auto candidate = EvaluateBC1(c[0], c[1], values);
+                        if (candidate.error < best.error) {
+                            best = candidate;
+                            isImproved = true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    dst[0] = static_cast<uint8_t>(best.c0 & 0xFF);
+    dst[1] = static_cast<uint8_t>(best.c0 >> 8);
+    dst[2] = static_cast<uint8_t>(best.c1 & 0xFF);
+    dst[3] = static_cast<uint8_t>(best.c1 >> 8);
+    for (size_t i=0; i!=4; ++i) {
+        dst[4 + i] = static_cast<uint8_t>((best.indices >> (i * 8)) & 0xFF);
+    }
+}
+
+void DecodeBC1(const uint8_t* src, Block& block) {
+    const auto c0 = static_cast<uint16_t>(src[0] | (src[1] << 8));
+    const auto c1 = static_cast<uint16_t>(src[2] | (src[3] << 8));
+    const auto palette = GetBC1Palette(c0, c1);
+    for (size_t i=0; i!=BlockTexels; ++i) {
+        block[i] = palette[(src[4 + i / 4] >> ((i % 4) * 2)) & 3];
+    }
+}
+
+// BC4
+
+// r0 > r1 - 8 values, otherwise 6 values, 0 and 255
+std::array<uint8_t, 8> GetBC4Palette(uint32_t r0, uint32_t r1) {
+    std::array<uint8_t, 8> palette;
+    palette[0] = static_cast<uint8_t>(r0);
+    palette[1] = static_cast<uint8_t>(r1);
+    if (r0 > r1) {
+        for (uint32_t i=2; i!=8; ++i) {
+            palette[i] = static_cast<uint8_t>(((8 - i) * r0 + (i - 1) * r1 + 3) / 7);
+        }
+    } else {
+        for (uint32_t i=2; i!=6; ++i) {
+            palette[i] = static_cast<uint8_t>(((6 - i) * r0 + (i - 1) * r1 + 2) / 5);
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    return palette;
+}
+
+struct BC4Block {
+    uint8_t r0 = 0;
+    uint8_t r1 = 0;
+    uint64_t indices = 0;
+    uint32_t error = 0;
+};
+
+BC4Block EvaluateBC4(uint8_t r0, uint8_t r1, const std::array<uint8_t, BlockTexels>& values) {
+    BC4Block result;
+    result.r0 = r0;
+    result.r1 = r1;
+    const auto palette = GetBC4Palette(r0, r1);
+    for (size_t i=0; i!=BlockTexels; ++i) {
+        uint64_t bestIndex = 0;
+        uint32_t bestDistance = UINT32_MAX;
+        for (uint64_t index=0; index!=palette.size(); ++index) {
+            const int32_t diff = static_cast<int32_t>(values[i]) - static_cast<int32_t>(palette[index]);
+            const auto distance = static_cast<uint32_t>(diff * diff);
+            if (distance < bestDistance) {
+                bestIndex = index;
+                bestDistance = distance;
+            }
+        }
+        result.indices |= bestIndex << (i * 3);
+        result.error += bestDistance;
+    }
+
+    return result;
+}
+
+void EncodeBC4(const Block& block, uint32_t channel, CompressionQuality quality, uint8_t* dst) {
+    std::array<uint8_t, BlockTexels> values;
+    for (size_t i=0; i!=BlockTexels; ++i) {
+        values[i] = block[i][channel];
+    }
+    const auto [minIt, maxIt] = std::minmax_element(values.cbegin(), values.cend());
+    const uint8_t minValue = *minIt;
+    const uint8_t maxValue = *maxIt;
+
+    // the equal endpoints are the 6 values mode, index 0 is exact
+    BC4Block best = EvaluateBC4(maxValue, minValue, values);
+    if ((minValue != maxValue) && (quality != CompressionQuality::Fast)) {
+        // 6 values mode: the endpoints cover the values except 0 and 255, they are in the palette
+        uint8_t innerMin = 255;
+        uint8_t innerMax = 0;
+        for (const auto value: values) {
+            if ((value != 0) && (value != 255)) {
+                innerMin = std::min(innerMin, value);
+                innerMax = std::max(innerMax, value);
+            }
+        }
+        if (innerMin <= innerMax) {
+            const auto candidate = EvaluateBC4(innerMin, innerMax, values);
+            if (candidate.error < best.error) {
+                best = candidate;
+            }
+        }
+
+        Values<1> points;
+        for (size_t i=0; i!=BlockTexels; ++i) {
+            points[i][0] = static_cast<float>(values[i]);
+        }
+        for (uint32_t iteration=0; (iteration != GetRefineIterations(quality)) && (best.r0 > best.r1); ++iteration) {
+            Weights weights;
+            for (size_t i=0; i!=BlockTexels; ++i) {
+                const auto index = static_cast<uint32_t>((best.indices >> (i * 3)) & 7);
+                weights[i] = (index < 2) ? static_cast<float>(index) : (static_cast<float>(index - 1) / 7.f);
+            }
+            Point<1> e0;
+            Point<1> e1;
+            if (!RefineEndpoints(points, weights, e0, e1)) {
+                break;
+            }
+            const auto r0 = static_cast<uint8_t>(std::lround(e0[0]));
+            const auto r1 = static_cast<uint8_t>(std::lround(e1[0]));
+            if (r0 <= r1) {
+                break;
+            }
+            const auto candidate = EvaluateBC4(r0, r1, values);
+            if (candidate.error >= best.error) {
+                break;
+            }
+            best = candidate;
+        }
+    }
+
+    // the inset endpoints are closer to the most values
+    if ((minValue != maxValue) && (quality == CompressionQuality::High)) {
+        for (int32_t d0=0; d0!=4; ++d0) {
+            for (int32_t d1=0; d1!=4; ++d1) {
+                const int32_t r0 = static_cast<int32_t>(maxValue) - d0;
+                const int32_t r1 = static_cast<int32_t>(minValue) + d1;
+                if (r0 > r1) {
+                    const auto candidate = EvaluateBC4(static_cast<uint8_t>(r0), static_cast<uint8_t>(r1), values);
+                    if (candidate.error < best.error) {
+                        best = candidate;
+                    }
+                }
+            }
+        }
+    }
+
+    dst[0] = best.r0;
+    dst[1] = best.r1;
+    for (size_t i=0; i!=6; ++i) {
+        dst[2 + i] = static_cast<uint8_t>((best.indices >> (i * 8)) & 0xFF);
+    }
+}
+
+void DecodeBC4(const uint8_t* src, uint32_t channel, Block& block) {
+    const auto palette = GetBC4Palette(src[0], src[1]);
+    uint64_t indices = 0;
+    for (size_t i=0; i!=6; ++i) {
+        indices |= static_cast<uint64_t>(src[2 + i]) << (i * 8);
+    }
+    for (size_t i=0; i!=BlockTexels; ++i) {
+        block[i][channel] = palette[(indices >> (i * 3)) & 7];
+    }
+}
+
+// BC7, mode 6
+
+constexpr const std::array<uint32_t, 16> BC7Weights = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+// 7 bits per channel and the shared lowest bit
+struct BC7Endpoint {
+    std::array<uint8_t, 4> color;
+    uint8_t pBit;
+
+    uint32_t Value(size_t channel) const noexcept { return static_cast<uint32_t>(color[channel]) * 2 + pBit; }
+};
+
+// pBit > 1 - choose the best one
+BC7Endpoint QuantizeBC7(const Point<4>& value, uint8_t pBit) {
+    BC7Endpoint best{};
+    float bestError = 0;
+    for (uint8_t p=0; p!=2; ++p) {
+        if ((pBit <= 1) && (p != pBit)) {
+            continue;
+        }
+        BC7Endpoint endpoint{};
+        endpoint.pBit = p;
+        float error = 0;
+        for (size_t c=0; c!=4; ++c) {
+            endpoint.color[c] = static_cast<uint8_t>(std::clamp(std::lround((value[c] - static_cast<float>(p)) / 2.f), 0l, 127l));
+            const float diff = static_cast<float>(endpoint.Value(c)) - value[c];
+            error += diff * diff;
+        }
+        if ((pBit <= 1) || (p == 0) || (error < bestError)) {
+            best = endpoint;
+            bestError = error;
+        }
+    }
+
+    return best;
+}
+
+std::array<std::array<uint8_t, 4>, 16> GetBC7Palette(const BC7Endpoint& e0, const BC7Endpoint& e1) {
+    std::array<std::array<uint8_t, 4>, 16> palette;
+    for (size_t i=0; i!=palette.size(); ++i) {
+        for (size_t c=0; c!=4; ++c) {
+            palette[i][c] = static_cast<uint8_t>(((64 - BC7Weights[i]) * e0.Value(c) + BC7Weights[i] * e1.Value(c) + 32) >> 6);
+        }
+    }
+
+    return palette;
+}
+
+struct BC7Block {
+    BC7Endpoint e0;
+    BC7Endpoint e1;
+    std::array<uint8_t, BlockTexels> indices;
+    float error = 0;
+};
+
+BC7Block EvaluateBC7(const BC7Endpoint& e0, const BC7Endpoint& e1, const Values<4>& values) {
+    BC7Block result;
+    result.e0 = e0;
+    result.e1 = e1;
+    const auto palette = GetBC7Palette(e0, e1);
+    for (size_t i=0; i!=BlockTexels; ++i) {
+        uint8_t bestIndex = 0;
+        float bestDistance = 0;
+        for (uint8_t index=0; index!=palette.size(); ++index) {
+            const Point<4> color = {static_cast<float>(palette[index][0]), static_cast<float>(palette[index][1]),
+                static_cast<float>(palette[index][2]), static_cast<float>(palette[index][3])};
+            const float distance = Distance2(values[i], color);
+            if ((index == 0) || (distance < bestDistance)) {
+                bestIndex = index;
+                bestDistance = distance;
+            }
+        }
+        result.indices[i] = bestIndex;
+        result.error += bestDistance;
+    }
+
+    // the highest bit of the index of the anchor texel is implicit zero, the weights are symmetric
+    if (result.indices[0] >= 8) {
+        std::swap(result.e0, result.e1);
+        for (auto& index: result.indices) {
+            index = static_cast<uint8_t>(15 - index);
+        }
+    }
+
+    return result;
+}
+
+// quantizes the endpoints, High tries all combinations of the p-bits
+BC7Block FitBC7(const Point<4>& e0, const Point<4>& e1, const Values<4>& values, CompressionQuality quality) {
+    const uint8_t bestPBit = 2;
+    if (quality != CompressionQuality::High) {
+        return EvaluateBC7(QuantizeBC7(e0, bestPBit), QuantizeBC7(e1, bestPBit), values);
+    }
+
+    BC7Block best;
+    for (uint8_t p=0; p!=4; ++p) {
+        const auto candidate = EvaluateBC7(QuantizeBC7(e0, p & 1), QuantizeBC7(e1, static_cast<uint8_t>(p >> 1)), values);
+        if ((p == 0) || (candidate.error < best.error)) {
+            best = candidate;
+        }
+    }
+
+    return best;
+}
+
+void EncodeBC7(const Block& block, CompressionQuality quality, uint8_t* dst) {
+    const auto values = ToValues<4>(block, 0);
+    Point<4> e0;
+    Point<4> e1;
+    FitEndpoints(values, quality != CompressionQuality::Fast, e0, e1);
+    BC7Block best = FitBC7(e0, e1, values, quality);
+
+    for (uint32_t iteration=0; iteration != GetRefineIterations(quality); ++iteration) {
+        Weights weights;
+        for (size_t i=0; i!=BlockTexels; ++i) {
+            weights[i] = static_cast<float>(BC7Weights[best.indices[i]]) / 64.f;
+        }
+        if (!RefineEndpoints(values, weights, e0, e1)) {
+            break;
+        }
+        const auto candidate = FitBC7(e0, e1, values, quality);
+        if (candidate.error >= best.error) {
+            break;
+        }
+        best = candidate;
+    }
+
+    const uint32_t mode = 6;
+    BitWriter writer(dst, 16);
+    writer.Write(1u << mode, mode + 1);
+    for (size_t c=0; c!=4; ++c) {
+        writer.Write(best.e0.color[c], 7);
+        writer.Write(best.e1.color[c], 7);
+    }
+    writer.Write(best.e0.pBit, 1);
+    writer.Write(best.e1.pBit, 1);
+    for (size_t i=0; i!=BlockTexels; ++i) {
+        writer.Write(best.indices[i], (i == 0) ? 3 : 4);
+    }
+}
+
+void DecodeBC7(const uint8_t* src, Block& block) {
+    const uint32_t mode = 6;
+    BitReader reader(src);
+    if (reader.Read(mode + 1) != (1u << mode)) {
+        throw EngineError("DecompressTexture: only mode 6 of BC7 is supported");
+    }
+
+    BC7Endpoint e0{};
+    BC7Endpoint e1{};
+    for (size_t c=0; c!=4; ++c) {
+        e0.color[c] = static_cast<uint8_t>(reader.Read(7));
+        e1.color[c] = static_cast<uint8_t>(reader.Read(7));
+    }
+    e0.pBit = static_cast<uint8_t>(reader.Read(1));
+    e1.pBit = static_cast<uint8_t>(reader.Read(1));
+    const auto palette = GetBC7Palette(e0, e1);
+    for (size_t i=0; i!=BlockTexels; ++i) {
+        block[i] = palette[reader.Read((i == 0) ? 3 : 4)];
+    }
+}
+
+void CheckSize(const char* name, uint32_t width, uint32_t height) {
+    if ((width == 0) || (height == 0)) {
+        throw EngineError("{}: size of texture must be non-zero", name);
+    }
+}
+
+}
+
+size_t GetBlockSize(BlockFormat format) noexcept {
+    switch (format) {
+    case BlockFormat::BC1:
+    case BlockFormat::BC4:
+        return 8;
+    case BlockFormat::BC5:
+    case BlockFormat::BC7:
+        return 16;
+    default:
+        return 4;
+    }
+}
+
+size_t CalcCompressedSize(BlockFormat format, uint32_t width, uint32_t height) noexcept {
+    if (format == BlockFormat::None) {
+        return static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+    }
+
+    return static_cast<size_t>((width + 3) / 4) * static_cast<size_t>((height + 3) / 4) * GetBlockSize(format);
+}
+
+void CompressTexture(const TextureCompressorDesc& desc, const uint8_t* texels, uint32_t width, uint32_t height, uint32_t stride, uint8_t* blocks) {
+    CheckSize("CompressTexture", width, height);
+    if (desc.format == BlockFormat::None) {
+        throw EngineError("CompressTexture: format of blocks isn't set");
+    }
+
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    const size_t blockSize = GetBlockSize(desc.format);
+    ParallelFor(blocksY, desc.threadCount, [&desc, texels, width, height, stride, blocks, blocksX, blockSize](size_t blockY) {
+        Block block;
+        uint8_t* dst = blocks + blockY * blocksX * blockSize;
+        for (uint32_t blockX=0; blockX!=blocksX; ++blockX, dst+=blockSize) {
+            ReadBlock(texels, width, height, stride, blockX, static_cast<uint32_t>(blockY), block);
+            switch (desc.format) {
+            case BlockFormat::BC1:
+                EncodeBC1(block, desc.quality, dst);
+                break;
+            case BlockFormat::BC4:
+                EncodeBC4(block, 0, desc.quality, dst);
+                break;
+            case BlockFormat::BC5:
+                EncodeBC4(block, 0, desc.quality, dst);
+                EncodeBC4(block, 1, desc.quality, dst + 8);
+                break;
+            default:
+                EncodeBC7(block, desc.quality, dst);
+                break;
+            }
+        }
+    });
+}
+
+void DecompressTexture(BlockFormat format, const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* texels) {
+    CheckSize("DecompressTexture", width, height);
+    if (format == BlockFormat::None) {
+        throw EngineError("DecompressTexture: format of blocks isn't set");
+    }
+
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    const size_t blockSize = GetBlockSize(format);
+    const uint8_t* src = blocks;
+    Block block;
+    for (uint32_t blockY=0; blockY!=blocksY; ++blockY) {
+        for (uint32_t blockX=0; blockX!=blocksX; ++blockX, src+=blockSize) {
+            switch (format) {
+            case BlockFormat::BC1:
+                DecodeBC1(src, block);
+                break;
+            case BlockFormat::BC4:
+                block.fill({0, 0, 0, 255});
+                DecodeBC4(src, 0, block);
+                break;
+            case BlockFormat::BC5:
+                block.fill({0, 0, 0, 255});
+                DecodeBC4(src, 0, block);
+                DecodeBC4(src + 8, 1, block);
+                break;
+            default:
+                DecodeBC7(src, block);
+                break;
+            }
+            WriteBlock(block, width, height, blockX, blockY, texels);
+        }
+    }
+}
+
+void CompressMips(DecodedTexture& texture, const TextureCompressorDesc& desc) {
+    if (texture.format != BlockFormat::None) {
+        throw EngineError("CompressMips: texture is already compressed");
+    }
+    if (desc.format == BlockFormat::None) {
+        return;
+    }
+
+    for (auto& mip: texture.mips) {
+        std::vector<uint8_t> blocks(CalcCompressedSize(desc.format, mip.width, mip.height));
+        CompressTexture(desc, mip.texels.data(), mip.width, mip.height, mip.width * 4, blocks.data());
+        mip.texels = std::move(blocks);
+    }
+    texture.format = desc.format;
+}
+
+double CalcRMSE(const uint8_t* texels, const uint8_t* reference, size_t texelsCount, uint32_t channelsCount) {
+    if (texelsCount == 0) {
+        return 0;
+    }
+
+    uint64_t sum = 0;
+    for (size_t i=0; i!=texelsCount; ++i) {
+        for (size_t c=0; c!=channelsCount; ++c) {
+            const int32_t diff = static_cast<int32_t>(texels[i * 4 + c]) - static_cast<int32_t>(reference[i * 4 + c]);
+            sum += static_cast<uint64_t>(diff * diff);
+        }
+    }
+
+    return std::sqrt(static_cast<double>(sum) / static_cast<double>(texelsCount * channelsCount));
+}
@@ -0,0 +1,175 @@
+#include "core/material/texture_decode_queue.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "core/common/exception.h"
+
+
+TextureDecodeQueue::TextureDecodeQueue(Decoder&& decoder, uint32_t threadCount)
+    : m_decoder(std::move(decoder)) {
+
+    if (!m_decoder) {
+        throw EngineError("TextureDecodeQueue: decoder is empty");
+    }
+    if (threadCount == 0) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    m_threads.reserve(threadCount);
+    for (uint32_t i=0; i!=threadCount; ++i) {
+        m_threads.emplace_back(&TextureDecodeQueue::WorkerLoop, this);
+    }
+}
+
+TextureDecodeQueue::~TextureDecodeQueue() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopped = true;
+    }
+    m_queueChanged.notify_all();
+    for (auto& thread: m_threads) {
+        thread.join();
+    }
+}
+
+uint32_t TextureDecodeQueue::Push(const TextureLoadDesc& desc) {
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        id = m_nextId++;
+        m_items[id] = Item{TextureLoadState::Queued, desc, std::string()};
+        m_queue.push_back(id);
+    }
+    m_queueChanged.notify_one();
+
+    return id;
+}
+
+bool TextureDecodeQueue::Cancel(uint32_t id) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_items.find(id);
+        if (it == m_items.end()) {
+            return false;
+        }
+
+        auto& item = it->second;
+        if ((item.state != TextureLoadState::Queued) && (item.state != TextureLoadState::Decoding) && (item.state != TextureLoadState::Uploading)) {
+            return false;
+        }
+
+        item.state = TextureLoadState::Canceled;
+        m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), id), m_queue.end());
+        m_decoded.erase(std::remove_if(m_decoded.begin(), m_decoded.end(), [id](const auto& v) { return v.first == id; }), m_decoded.end());
+    }
+    m_idle.notify_all();
+
+    return true;
+}
+
+void TextureDecodeQueue::Erase(uint32_t id) {
+    Cancel(id);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_items.erase(id);
+}
+
+bool TextureDecodeQueue::Pop(uint32_t& id, DecodedTexture& texture) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_decoded.empty()) {
+        return false;
+    }
+
+    id = m_decoded.front().first;
+    texture = std::move(m_decoded.front().second);
+    m_decoded.pop_front();
+
+    return true;
+}
+
+void TextureDecodeQueue::Finish(uint32_t id, TextureLoadState state, const std::string& error) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_items.find(id);
+    if ((it != m_items.end()) && (it->second.state == TextureLoadState::Uploading)) {
+        it->second.state = state;
+        it->second.error = error;
+    }
+}
+
+TextureLoadState TextureDecodeQueue::GetState(uint32_t id) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_items.find(id);
+    if (it == m_items.cend()) {
+        return TextureLoadState::None;
+    }
+
+    return it->second.state;
+}
+
+std::string TextureDecodeQueue::GetError(uint32_t id) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_items.find(id);
+    if (it == m_items.cend()) {
+        return std::string();
+    }
+
+    return it->second.error;
+}
+
+void TextureDecodeQueue::WaitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_queue.empty() && (m_activeCount == 0); });
+}
+
+void TextureDecodeQueue::WorkerLoop() {
+    while (true) {
+        uint32_t id;
+        TextureLoadDesc desc;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_queueChanged.wait(lock, [this]() { return m_isStopped || !m_queue.empty(); });
+            if (m_isStopped) {
+                return;
+            }
+
+            id = m_queue.front();
+            m_queue.pop_front();
+            auto& item = m_items[id];
+            item.state = TextureLoadState::Decoding;
+            desc = item.desc;
+            ++m_activeCount;
+        }
+
+        DecodedTexture texture;
+        std::string error;
+        try {
+            texture = m_decoder(desc);
+            texture.isSRGB = desc.isSRGB;
+            if (desc.generateMips) {
+                GenerateMips(texture);
+            }
+            // the textures are decoded in parallel, so the blocks are compressed by one thread
+            const uint32_t threadCount = 1;
+            CompressMips(texture, TextureCompressorDesc{desc.compression, desc.quality, threadCount});
+        } catch(const std::exception& e) {
+            error = e.what();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_activeCount;
+            // the texture can be canceled or erased while it is decoded
+            auto it = m_items.find(id);
+            if ((it != m_items.end()) && (it->second.state == TextureLoadState::Decoding)) {
+                if (error.empty()) {
+                    it->second.state = TextureLoadState::Uploading;
+                    m_decoded.emplace_back(id, std::move(texture));
+                } else {
+                    it->second.state = TextureLoadState::Failed;
+                    it->second.error = error;
+                }
+            }
+        }
+        m_idle.notify_all();
+    }
+}
@@ -0,0 +1,105 @@
+#include "core/material/texture_decoder.h"
+
+#include <cmath>
+#include <array>
+#include <algorithm>
+
+#include "core/common/exception.h"
+
+
+namespace {
+
+// sRGB component to linear
+const std::array<float, 256>& GetLinearTable() {
+    static const auto table = []() {
+        std::array<float, 256> result;
+        for (size_t i=0; i!=result.size(); ++i) {
+            const float v = static_cast<float>(i) / 255.f;
+            result[i] = (v <= 0.04045f) ? (v / 12.92f) : std::pow((v + 0.055f) / 1.055f, 2.4f);
+        }
+        return result;
+    }();
+
+    return table;
+}
+
+// linear value to sRGB component, the table has enough steps to round the dark values correctly
+constexpr const size_t SRGBTableSize = 4096;
+const std::array<uint8_t, SRGBTableSize + 1>& GetSRGBTable() {
+    static const auto table = []() {
+        std::array<uint8_t, SRGBTableSize + 1> result;
+        for (size_t i=0; i!=result.size(); ++i) {
+            const float v = static_cast<float>(i) / static_cast<float>(SRGBTableSize);
+            const float s = (v <= 0.0031308f) ? (v * 12.92f) : (1.055f * std::pow(v, 1.f / 2.4f) - 0.055f);
+            result[i] = static_cast<uint8_t>(std::lround(std::clamp(s, 0.f, 1.f) * 255.f));
+        }
+        return result;
+    }();
+
+    return table;
+}
+
+TextureMip Downsample(const TextureMip& src, bool isSRGB) {
+    TextureMip dst;
+    dst.width = std::max(src.width / 2, 1u);
+    dst.height = std::max(src.height / 2, 1u);
+    dst.texels.resize(static_cast<size_t>(dst.width) * static_cast<size_t>(dst.height) * 4);
+
+    const auto& linear = GetLinearTable();
+    const auto& srgb = GetSRGBTable();
+    const size_t srcStride = static_cast<size_t>(src.width) * 4;
+    uint8_t* pDest = dst.texels.data();
+    for (uint32_t y=0; y!=dst.height; ++y) {
+        const size_t y0 = y * 2;
+        const size_t y1 = std::min(y0 + 1, static_cast<size_t>(src.height - 1));
+        for (uint32_t x=0; x!=dst.width; ++x) {
+            const size_t x0 = x * 2;
+            const size_t x1 = std::min(x0 + 1, static_cast<size_t>(src.width - 1));
+            const uint8_t* texels[4] = {
+                &src.texels[y0 * srcStride + x0 * 4], &src.texels[y0 * srcStride + x1 * 4],
+                &src.texels[y1 * srcStride + x0 * 4], &src.texels[y1 * srcStride + x1 * 4]};
+
+            for (size_t c=0; c!=4; ++c) {
+                if (isSRGB && (c != 3)) {
+                    const float sum = linear[texels[0][c]] + linear[texels[1][c]] + linear[texels[2][c]] + linear[texels[3][c]];
+                    *pDest = srgb[static_cast<size_t>(std::lround(sum * 0.25f * static_cast<float>(SRGBTableSize)))];
+                } else {
+                    const uint32_t sum = static_cast<uint32_t>(texels[0][c]) + texels[1][c] + texels[2][c] + texels[3][c];
+                    *pDest = static_cast<uint8_t>((sum + 2) / 4);
+                }
+                ++pDest;
+            }
+        }
+    }
+
+    return dst;
+}
+
+}
+
+size_t DecodedTexture::ByteSize() const noexcept {
+    size_t result = 0;
+    for (const auto& mip: mips) {
+        result += mip.texels.size();
+    }
+
+    return result;
+}
+
+void GenerateMips(DecodedTexture& texture) {
+    if (texture.mips.empty()) {
+        throw EngineError("GenerateMips: texture doesn't have mip 0");
+    }
+    if (texture.format != BlockFormat::None) {
+        throw EngineError("GenerateMips: texture is compressed");
+    }
+    const auto& image = texture.mips[0];
+    if ((image.width == 0) || (image.height == 0) || (image.texels.size() != static_cast<size_t>(image.width) * static_cast<size_t>(image.height) * 4)) {
+        throw EngineError("GenerateMips: wrong size of mip 0 ({}x{}, {} bytes)", image.width, image.height, image.texels.size());
+    }
+
+    texture.mips.resize(1);
+    while ((texture.mips.back().width != 1) || (texture.mips.back().height != 1)) {
+        texture.mips.push_back(Downsample(texture.mips.back(), texture.isSRGB));
+    }
+}
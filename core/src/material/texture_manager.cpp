@@ -1,20 +1,137 @@
 #include "core/material/texture_manager.h"
 
 #include <new>
+#include <string>
+#include <vector>
 #include <utility>
+#include <iterator>
+#include <exception>
+#include <algorithm>
 #include <type_traits>
 
+#include "dg/image.h"
 #include "dg/device.h"
+#include "dg/context.h"
+#include "dg/texture.h"
 #include "core/material/texture.h"
+#include "core/common/exception.h"
 #include "dg/default_raw_memory_allocator.h"
 
 
-TextureManager::TextureManager(DevicePtr& device)
-    : m_device(device) {
+namespace {
+
+dg::TEXTURE_FORMAT GetTextureFormat(BlockFormat format, bool isSRGB) {
+    switch (format) {
+    case BlockFormat::BC1:
+        return isSRGB ? dg::TEX_FORMAT_BC1_UNORM_SRGB : dg::TEX_FORMAT_BC1_UNORM;
+    case BlockFormat::BC4:
+        return dg::TEX_FORMAT_BC4_UNORM;
+    case BlockFormat::BC5:
+        return dg::TEX_FORMAT_BC5_UNORM;
+    case BlockFormat::BC7:
+        return isSRGB ? dg::TEX_FORMAT_BC7_UNORM_SRGB : dg::TEX_FORMAT_BC7_UNORM;
+    default:
+        return isSRGB ? dg::TEX_FORMAT_RGBA8_UNORM_SRGB : dg::TEX_FORMAT_RGBA8_UNORM;
+    }
+}
+
+// 1x1 gray texture or texture array with one slice
+TextureViewPtr CreatePlaceholder(DevicePtr& device, dg::RESOURCE_DIMENSION type, const char* name) {
+    dg::TextureDesc desc;
+    desc.Name = name;
+    desc.Type = type;
+    desc.Width = 1;
+    desc.Height = 1;
+    desc.ArraySize = 1;
+    desc.Format = dg::TEX_FORMAT_RGBA8_UNORM;
+    desc.MipLevels = 1;
+    desc.Usage = dg::USAGE_IMMUTABLE;
+    desc.BindFlags = dg::BIND_SHADER_RESOURCE;
+
+    const uint8_t gray[4] = {128, 128, 128, 255};
+    dg::TextureSubResData subresData;
+    subresData.pData = gray;
+    subresData.Stride = sizeof(gray);
+    dg::TextureData data;
+    data.pSubResources = &subresData;
+    data.NumSubresources = 1;
+
+    TexturePtr texture;
+    device->CreateTexture(desc, &data, &texture);
+    if (!texture) {
+        throw EngineError("TextureManager: failed to create placeholder texture '{}'", name);
+    }
+
+    return TextureViewPtr(texture->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE));
+}
+
+// decodes mip 0 of the file to RGBA8, on a worker thread
+DecodedTexture DecodeTextureFile(const TextureLoadDesc& desc) {
+    const std::string path = desc.path.string();
+    dg::RefCntAutoPtr<dg::Image> image;
+    dg::CreateImageFromFile(path.c_str(), &image, nullptr);
+    if (!image) {
+        throw EngineError("TextureManager: couldn't decode texture file '{}'", path);
+    }
+
+    const auto& imageDesc = image->GetDesc();
+    const uint32_t components = imageDesc.NumComponents;
+    if ((imageDesc.ComponentType != dg::VT_UINT8) || (components == 0) || (components > 4)) {
+        throw EngineError("TextureManager: unsupported format of texture file '{}', expected 1-4 components of 8 bits", path);
+    }
+
+    TextureMip mip;
+    mip.width = imageDesc.Width;
+    mip.height = imageDesc.Height;
+    mip.texels.resize(static_cast<size_t>(mip.width) * static_cast<size_t>(mip.height) * 4);
+    const auto* src = reinterpret_cast<const uint8_t*>(image->GetData()->GetDataPtr());
+    uint8_t* pDest = mip.texels.data();
+    for (uint32_t y=0; y!=mip.height; ++y) {
+        const uint8_t* row = src + static_cast<size_t>(y) * imageDesc.RowStride;
+        for (uint32_t x=0; x!=mip.width; ++x) {
+            const uint8_t* texel = row + static_cast<size_t>(x) * components;
+            // gray, gray + alpha, RGB, RGBA
+            const bool isGray = (components < 3);
+            pDest[0] = texel[0];
+            pDest[1] = isGray ? texel[0] : texel[1];
+            pDest[2] = isGray ? texel[0] : texel[2];
+            pDest[3] = (components == 2) ? texel[1] : ((components == 4) ? texel[3] : 255);
+            pDest += 4;
+        }
+    }
+
+    DecodedTexture result;
+    result.mips.push_back(std::move(mip));
+
+    return result;
+}
+
+}
+
+TextureManager::TextureManager(DevicePtr& device, ContextPtr& context)
+    : m_device(device)
+    , m_context(context)
+    , m_residency(std::make_shared<TextureResidency>())
+    , m_decodeQueue(std::make_unique<TextureDecodeQueue>(DecodeTextureFile)) {
 
 }
 
 TextureManager::~TextureManager() {
+    // stops the workers before the device
+    m_decodeQueue.reset();
+    m_upload.reset();
+    // the dynamic textures can outlive the manager, they keep the residency
+    for (const auto& [id, loaded]: m_textures) {
+        m_residency->Remove(loaded.residencyId);
+    }
+    m_textures.clear();
+    for (const auto& [id, textureArray]: m_arrays) {
+        m_residency->Remove(textureArray.residencyId);
+    }
+    m_arrays.clear();
+    m_arrayPlaceholder.Release();
+    m_placeholder.Release();
+    m_context.Release();
     m_device.Release();
 }
 
@@ -34,5 +151,366 @@ DynamicTexture* TextureManager::CreateDynamicTexture(dg::TEXTURE_FORMAT format,
     desc.MiscFlags = dg::MISC_TEXTURE_FLAG_GENERATE_MIPS;
     desc.CommandQueueMask = 1;
 
-    return NEW_OBJ(dg::DefaultRawMemoryAllocator::GetAllocator(), "DynamicTexture", DynamicTexture)(m_device, desc);
+    return NEW_OBJ(dg::DefaultRawMemoryAllocator::GetAllocator(), "DynamicTexture", DynamicTexture)(m_device, desc, m_residency);
+}
+
+uint32_t TextureManager::LoadTextureAsync(const TextureLoadDesc& desc) {
+    return m_decodeQueue->Push(desc);
+}
+
+TextureLoadState TextureManager::GetLoadState(uint32_t id) const {
+    return m_decodeQueue->GetState(id);
+}
+
+std::string TextureManager::GetLoadError(uint32_t id) const {
+    return m_decodeQueue->GetError(id);
+}
+
+bool TextureManager::CancelLoad(uint32_t id) {
+    return m_decodeQueue->Cancel(id);
+}
+
+TextureViewPtr TextureManager::GetTextureView(uint32_t id) {
+    auto it = m_textures.find(id);
+    if (it == m_textures.cend()) {
+        return GetPlaceholder();
+    }
+
+    m_residency->Touch(it->second.residencyId);
+    return TextureViewPtr(it->second.texture->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE));
+}
+
+void TextureManager::ReleaseTexture(uint32_t id) {
+    m_decodeQueue->Erase(id);
+    if (auto it = m_textures.find(id); it != m_textures.cend()) {
+        m_residency->Remove(it->second.residencyId);
+        m_textures.erase(it);
+    }
+}
+
+uint32_t TextureManager::LoadTextureArrayAsync(const std::vector<TextureLoadDesc>& descs, const std::string& name) {
+    if (descs.empty()) {
+        throw EngineError("TextureManager: texture array '{}' is empty", name);
+    }
+
+    const uint32_t arrayId = m_nextArrayId++;
+    TextureArray textureArray;
+    textureArray.name = name;
+    textureArray.decoded.resize(descs.size());
+    textureArray.slots.resize(descs.size());
+    for (const auto& desc: descs) {
+        const uint32_t id = m_decodeQueue->Push(desc);
+        textureArray.textureIds.push_back(id);
+        m_arrayTextures[id] = arrayId;
+    }
+    m_arrays.emplace(arrayId, std::move(textureArray));
+
+    return arrayId;
+}
+
+TextureLoadState TextureManager::GetTextureArrayState(uint32_t arrayId) const {
+    if (const auto it = m_arrays.find(arrayId); it != m_arrays.cend()) {
+        return it->second.state;
+    }
+
+    return TextureLoadState::None;
+}
+
+std::string TextureManager::GetTextureArrayError(uint32_t arrayId) const {
+    if (const auto it = m_arrays.find(arrayId); it != m_arrays.cend()) {
+        return it->second.error;
+    }
+
+    return std::string();
+}
+
+TextureArraySlot TextureManager::GetTextureArraySlot(uint32_t arrayId, uint32_t index) const {
+    const auto it = m_arrays.find(arrayId);
+    if ((it == m_arrays.cend()) || (it->second.state != TextureLoadState::Ready) || (index >= it->second.slots.size())) {
+        return TextureArraySlot();
+    }
+
+    return it->second.slots[index];
+}
+
+TextureViewPtr TextureManager::GetTextureArrayView(uint32_t arrayId) {
+    const auto it = m_arrays.find(arrayId);
+    if ((it == m_arrays.cend()) || (it->second.state != TextureLoadState::Ready)) {
+        return GetArrayPlaceholder();
+    }
+
+    m_residency->Touch(it->second.residencyId);
+    return TextureViewPtr(it->second.texture->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE));
+}
+
+void TextureManager::ReleaseTextureArray(uint32_t arrayId) {
+    const auto it = m_arrays.find(arrayId);
+    if (it == m_arrays.cend()) {
+        return;
+    }
+
+    for (const auto id: it->second.textureIds) {
+        m_decodeQueue->Erase(id);
+        m_arrayTextures.erase(id);
+    }
+    m_residency->Remove(it->second.residencyId);
+    m_arrays.erase(it);
+}
+
+void TextureManager::Update() {
+    m_residency->NextFrame();
+    m_lastUploadSize = 0;
+    while (true) {
+        if (!m_upload) {
+            Upload upload;
+            if (!m_decodeQueue->Pop(upload.id, upload.decoded)) {
+                break;
+            }
+            if (TakeArrayTexture(upload.id, upload.decoded)) {
+                continue;
+            }
+            try {
+                const bool isImmutable = false;
+                upload.texture = CreateTexture(upload.decoded, "tex::async" + std::to_string(upload.id), isImmutable);
+            } catch(const std::exception& e) {
+                m_decodeQueue->Finish(upload.id, TextureLoadState::Failed, e.what());
+                continue;
+            }
+            m_upload = std::move(upload);
+        }
+
+        // canceled or released while uploading
+        if (m_decodeQueue->GetState(m_upload->id) != TextureLoadState::Uploading) {
+            m_upload.reset();
+            continue;
+        }
+
+        if ((m_lastUploadSize != 0) && (m_lastUploadSize >= m_uploadBudget)) {
+            break;
+        }
+        m_lastUploadSize += UploadRows(*m_upload, m_uploadBudget - std::min(m_lastUploadSize, m_uploadBudget));
+        if (m_upload->mip == m_upload->decoded.mips.size()) {
+            FinishUpload(*m_upload);
+            m_upload.reset();
+        }
+    }
+
+    UpdateTextureArrays();
+    m_residency->Trim();
+}
+
+TexturePtr TextureManager::CreateStaticTexture(const DecodedTexture& decoded, const std::string& name) {
+    const bool isImmutable = true;
+    return CreateTexture(decoded, name, isImmutable);
+}
+
+// the immutable texture is created with the mips, the default texture is uploaded by UploadRows
+TexturePtr TextureManager::CreateTexture(const DecodedTexture& decoded, const std::string& name, bool isImmutable) {
+    if (decoded.mips.empty()) {
+        throw EngineError("TextureManager: texture '{}' doesn't have mips", name);
+    }
+    const auto& mip0 = decoded.mips[0];
+    if ((decoded.format != BlockFormat::None) && (((mip0.width % 4) != 0) || ((mip0.height % 4) != 0))) {
+        throw EngineError("TextureManager: size of compressed texture '{}' ({}x{}) must be multiple of 4", name, mip0.width, mip0.height);
+    }
+
+    dg::TextureDesc desc;
+    desc.Name = name.c_str();
+    desc.Type = dg::RESOURCE_DIM_TEX_2D;
+    desc.Width = mip0.width;
+    desc.Height = mip0.height;
+    desc.Format = GetTextureFormat(decoded.format, decoded.isSRGB);
+    desc.MipLevels = static_cast<uint32_t>(decoded.mips.size());
+    desc.SampleCount = 1;
+    desc.Usage = isImmutable ? dg::USAGE_IMMUTABLE : dg::USAGE_DEFAULT;
+    desc.BindFlags = dg::BIND_SHADER_RESOURCE;
+    desc.CommandQueueMask = 1;
+
+    std::vector<dg::TextureSubResData> subresources;
+    dg::TextureData data;
+    if (isImmutable) {
+        for (const auto& mip: decoded.mips) {
+            dg::TextureSubResData subresData;
+            subresData.pData = mip.texels.data();
+            subresData.Stride = static_cast<uint32_t>(CalcCompressedSize(decoded.format, mip.width, 1));
+            subresources.push_back(subresData);
+        }
+        data.pSubResources = subresources.data();
+        data.NumSubresources = static_cast<uint32_t>(subresources.size());
+    }
+
+    TexturePtr texture;
+    m_device->CreateTexture(desc, subresources.empty() ? nullptr : &data, &texture);
+    if (!texture) {
+        throw EngineError("TextureManager: failed to create texture '{}' ({}x{})", name, desc.Width, desc.Height);
+    }
+
+    return texture;
+}
+
+bool TextureManager::TakeArrayTexture(uint32_t id, DecodedTexture& decoded) {
+    const auto it = m_arrayTextures.find(id);
+    if (it == m_arrayTextures.cend()) {
+        return false;
+    }
+
+    auto& textureArray = m_arrays.at(it->second);
+    const auto index = static_cast<size_t>(std::distance(textureArray.textureIds.cbegin(),
+        std::find(textureArray.textureIds.cbegin(), textureArray.textureIds.cend(), id)));
+    textureArray.decoded[index] = std::move(decoded);
+    ++textureArray.decodedCount;
+    // the array owns the decoded texture, the load is forgotten
+    m_decodeQueue->Erase(id);
+    m_arrayTextures.erase(it);
+
+    return true;
+}
+
+void TextureManager::UpdateTextureArrays() {
+    for (auto& [arrayId, textureArray]: m_arrays) {
+        if (textureArray.state != TextureLoadState::Queued) {
+            continue;
+        }
+
+        for (const auto id: textureArray.textureIds) {
+            if (m_arrayTextures.find(id) == m_arrayTextures.cend()) {
+                continue;
+            }
+            const auto state = m_decodeQueue->GetState(id);
+            if ((state == TextureLoadState::Failed) || (state == TextureLoadState::Canceled) || (state == TextureLoadState::None)) {
+                textureArray.state = TextureLoadState::Failed;
+                textureArray.error = (state == TextureLoadState::Failed) ? m_decodeQueue->GetError(id) : "texture load is canceled";
+                break;
+            }
+        }
+
+        if ((textureArray.state == TextureLoadState::Queued) && (textureArray.decodedCount == textureArray.textureIds.size())) {
+            try {
+                CreateTextureArray(textureArray);
+                textureArray.state = TextureLoadState::Ready;
+            } catch(const std::exception& e) {
+                textureArray.state = TextureLoadState::Failed;
+                textureArray.error = e.what();
+            }
+        }
+
+        if (textureArray.state != TextureLoadState::Queued) {
+            for (const auto id: textureArray.textureIds) {
+                m_decodeQueue->Erase(id);
+                m_arrayTextures.erase(id);
+            }
+            textureArray.decoded.clear();
+        }
+    }
+}
+
+// the immutable texture array with all slices and mips
+void TextureManager::CreateTextureArray(TextureArray& textureArray) {
+    std::vector<const DecodedTexture*> textures;
+    for (const auto& decoded: textureArray.decoded) {
+        textures.push_back(&decoded);
+    }
+    const auto packed = PackTextureArray(textures);
+
+    const auto& first = packed.slices[0];
+    const auto& mip0 = first.mips[0];
+    if ((first.format != BlockFormat::None) && (((mip0.width % 4) != 0) || ((mip0.height % 4) != 0))) {
+        throw EngineError("TextureManager: size of compressed texture array '{}' ({}x{}) must be multiple of 4", textureArray.name, mip0.width, mip0.height);
+    }
+
+    dg::TextureDesc desc;
+    desc.Name = textureArray.name.c_str();
+    desc.Type = dg::RESOURCE_DIM_TEX_2D_ARRAY;
+    desc.Width = mip0.width;
+    desc.Height = mip0.height;
+    desc.ArraySize = static_cast<uint32_t>(packed.slices.size());
+    desc.Format = GetTextureFormat(first.format, first.isSRGB);
+    desc.MipLevels = static_cast<uint32_t>(first.mips.size());
+    desc.SampleCount = 1;
+    desc.Usage = dg::USAGE_IMMUTABLE;
+    desc.BindFlags = dg::BIND_SHADER_RESOURCE;
+    desc.CommandQueueMask = 1;
+
+    // the subresources of the first slice go first
+    std::vector<dg::TextureSubResData> subresources;
+    for (const auto& slice: packed.slices) {
+        for (const auto& mip: slice.mips) {
+            dg::TextureSubResData subresData;
+            subresData.pData = mip.texels.data();
+            subresData.Stride = static_cast<uint32_t>(CalcCompressedSize(slice.format, mip.width, 1));
+            subresources.push_back(subresData);
+        }
+    }
+    dg::TextureData data;
+    data.pSubResources = subresources.data();
+    data.NumSubresources = static_cast<uint32_t>(subresources.size());
+
+    TexturePtr texture;
+    m_device->CreateTexture(desc, &data, &texture);
+    if (!texture) {
+        throw EngineError("TextureManager: failed to create texture array '{}' ({}x{}x{})", textureArray.name, desc.Width, desc.Height, desc.ArraySize);
+    }
+
+    const size_t memory = packed.ByteSize();
+    textureArray.texture = texture;
+    textureArray.slots = packed.slots;
+    textureArray.residencyId = m_residency->Add(memory, [memory]() { return memory; });
+}
+
+// uploads the rows of the current mip (the rows of the blocks for the compressed texture),
+// that fit into the budget, but at least one row
+size_t TextureManager::UploadRows(Upload& upload, size_t budget) {
+    const auto& mip = upload.decoded.mips[upload.mip];
+    const uint32_t rowHeight = (upload.decoded.format == BlockFormat::None) ? 1 : 4;
+    const uint32_t rowsCount = (mip.height + rowHeight - 1) / rowHeight;
+    const size_t stride = CalcCompressedSize(upload.decoded.format, mip.width, 1);
+    const auto rows = static_cast<uint32_t>(std::clamp(budget / stride, static_cast<size_t>(1), static_cast<size_t>(rowsCount - upload.row)));
+
+    dg::Box box;
+    box.MinX = 0;
+    box.MaxX = mip.width;
+    box.MinY = upload.row * rowHeight;
+    box.MaxY = std::min((upload.row + rows) * rowHeight, mip.height);
+
+    dg::TextureSubResData subresData;
+    subresData.pData = &mip.texels[upload.row * stride];
+    subresData.Stride = static_cast<uint32_t>(stride);
+
+    const uint32_t arraySlice = 0;
+    m_context->UpdateTexture(upload.texture, upload.mip, arraySlice, box, subresData,
+        dg::RESOURCE_STATE_TRANSITION_MODE_TRANSITION, dg::RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    upload.row += rows;
+    if (upload.row == rowsCount) {
+        upload.row = 0;
+        ++upload.mip;
+    }
+
+    return stride * rows;
+}
+
+// the loaded texture is counted in the memory budget, but isn't evicted
+void TextureManager::FinishUpload(Upload& upload) {
+    const size_t memory = upload.decoded.ByteSize();
+    LoadedTexture loaded;
+    loaded.texture = upload.texture;
+    loaded.residencyId = m_residency->Add(memory, [memory]() { return memory; });
+    m_textures[upload.id] = std::move(loaded);
+    m_decodeQueue->Finish(upload.id, TextureLoadState::Ready);
+}
+
+TextureViewPtr& TextureManager::GetPlaceholder() {
+    if (!m_placeholder) {
+        m_placeholder = CreatePlaceholder(m_device, dg::RESOURCE_DIM_TEX_2D, "tex::placeholder");
+    }
+
+    return m_placeholder;
+}
+
+TextureViewPtr& TextureManager::GetArrayPlaceholder() {
+    if (!m_arrayPlaceholder) {
+        m_arrayPlaceholder = CreatePlaceholder(m_device, dg::RESOURCE_DIM_TEX_2D_ARRAY, "tex::placeholder::array");
+    }
+
+    return m_arrayPlaceholder;
 }
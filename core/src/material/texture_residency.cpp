@@ -0,0 +1,155 @@
+#include "core/material/texture_residency.h"
+
+#include <utility>
+#include <algorithm>
+
+#include "core/common/exception.h"
+
+
+size_t CalcTextureMemory(uint32_t width, uint32_t height, uint32_t mipLevels, uint32_t texelSize) noexcept {
+    size_t result = 0;
+    for (uint32_t mip=0; (mipLevels == 0) || (mip != mipLevels); ++mip) {
+        result += static_cast<size_t>(width) * static_cast<size_t>(height) * texelSize;
+        if ((width == 1) && (height == 1)) {
+            break;
+        }
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+
+    return result;
+}
+
+TextureResidency::TextureResidency(size_t budget)
+    : m_budget(budget) {
+
+}
+
+uint32_t TextureResidency::Add(size_t size, Evictor&& evictor) {
+    if (!evictor) {
+        throw EngineError("TextureResidency: evictor is empty");
+    }
+
+    const uint32_t id = m_nextId++;
+    m_entries.push_front(Entry{id, size, m_frame, false, std::move(evictor)});
+    m_index[id] = m_entries.begin();
+    m_usage += size;
+
+    return id;
+}
+
+void TextureResidency::Remove(uint32_t id) {
+    auto it = m_index.find(id);
+    if (it == m_index.cend()) {
+        return;
+    }
+
+    m_usage -= it->second->size;
+    m_entries.erase(it->second);
+    m_index.erase(it);
+}
+
+void TextureResidency::SetSize(uint32_t id, size_t size) {
+    auto it = m_index.find(id);
+    if (it == m_index.cend()) {
+        throw EngineError("TextureResidency: unknown texture id {}", id);
+    }
+
+    auto& entry = *it->second;
+    if (entry.isEvicted) {
+        entry.isEvicted = false;
+        ++m_restores;
+    }
+    m_usage = m_usage - entry.size + size;
+    entry.size = size;
+    Touch(id);
+}
+
+void TextureResidency::Touch(uint32_t id) {
+    auto it = m_index.find(id);
+    if (it == m_index.cend()) {
+        return;
+    }
+
+    it->second->lastUsedFrame = m_frame;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+}
+
+void TextureResidency::Trim() {
+    for (auto it = m_entries.rbegin(); (it != m_entries.rend()) && (m_usage > m_budget); ++it) {
+        // the rest entries are used later
+        if (it->lastUsedFrame + 1 >= m_frame) {
+            break;
+        }
+
+        while ((m_usage > m_budget) && (it->size != 0)) {
+            const size_t size = it->evictor();
+            if (size >= it->size) {
+                break;
+            }
+
+            if (size == 0) {
+                ++m_evictedTextures;
+            } else {
+                ++m_evictedMips;
+            }
+            m_usage -= it->size - size;
+            it->size = size;
+            it->isEvicted = true;
+        }
+    }
+}
+
+TextureResidencyCounters TextureResidency::GetCounters() const noexcept {
+    TextureResidencyCounters counters;
+    counters.budget = m_budget;
+    counters.usage = m_usage;
+    counters.textures = m_index.size();
+    counters.evictedTextures = m_evictedTextures;
+    counters.evictedMips = m_evictedMips;
+    counters.restores = m_restores;
+
+    return counters;
+}
+
+ResidentTexture::ResidentTexture(const std::shared_ptr<TextureResidency>& residency, size_t size, Release&& release)
+    : m_release(std::move(release))
+    , m_residency(residency) {
+
+    if (!m_release) {
+        throw EngineError("ResidentTexture: release callback is empty");
+    }
+    if (m_residency) {
+        m_id = m_residency->Add(size, [this]() {
+            m_release();
+            m_isEvicted = true;
+            return static_cast<size_t>(0);
+        });
+    }
+}
+
+ResidentTexture::~ResidentTexture() {
+    if (m_residency) {
+        m_residency->Remove(m_id);
+    }
+}
+
+bool ResidentTexture::Restore(const Create& create) {
+    if (!m_isEvicted) {
+        if (m_residency) {
+            m_residency->Touch(m_id);
+        }
+        return false;
+    }
+
+    SetSize(create());
+
+    return true;
+}
+
+void ResidentTexture::SetSize(size_t size) {
+    m_isEvicted = false;
+    if (m_residency) {
+        m_residency->SetSize(m_id, size);
+    }
+}
@@ -5,3 +5,108 @@ std::mt19937_64 randomGenerator = std::mt19937_64(0);
 void RandSeed(std::mt19937_64::result_type value) {
     randomGenerator.seed(value);
 }
+
+namespace {
+
+// count of the blocks, that are generated together: the rounds of Philox are independent for the lanes,
+// so the loops over the lanes are vectorized (SSE2/AVX2/NEON) without intrinsics
+constexpr const size_t Lanes = 8;
+
+// blocks[k][i] = RandBlock(seed, stream, counter + i)[k]
+void RandBlocks(uint64_t seed, uint64_t stream, uint64_t counter, uint32_t (&blocks)[4][Lanes]) {
+    constexpr uint32_t m0 = 0xD2511F53;
+    constexpr uint32_t m1 = 0xCD9E8D57;
+    constexpr uint32_t w0 = 0x9E3779B9;
+    constexpr uint32_t w1 = 0xBB67AE85;
+
+    uint32_t c0[Lanes];
+    uint32_t c1[Lanes];
+    uint32_t c2[Lanes];
+    uint32_t c3[Lanes];
+    for (size_t i=0; i!=Lanes; ++i) {
+        c0[i] = static_cast<uint32_t>(counter + i);
+        c1[i] = static_cast<uint32_t>((counter + i) >> 32);
+        c2[i] = static_cast<uint32_t>(stream);
+        c3[i] = static_cast<uint32_t>(stream >> 32);
+    }
+
+    uint32_t k0 = static_cast<uint32_t>(seed);
+    uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+    for (uint32_t round=0; round!=10; ++round) {
+        for (size_t i=0; i!=Lanes; ++i) {
+            const uint64_t p0 = static_cast<uint64_t>(m0) * c0[i];
+            const uint64_t p1 = static_cast<uint64_t>(m1) * c2[i];
+            c0[i] = static_cast<uint32_t>(p1 >> 32) ^ c1[i] ^ k0;
+            c2[i] = static_cast<uint32_t>(p0 >> 32) ^ c3[i] ^ k1;
+            c1[i] = static_cast<uint32_t>(p1);
+            c3[i] = static_cast<uint32_t>(p0);
+        }
+        k0 += w0;
+        k1 += w1;
+    }
+
+    for (size_t i=0; i!=Lanes; ++i) {
+        blocks[0][i] = c0[i];
+        blocks[1][i] = c1[i];
+        blocks[2][i] = c2[i];
+        blocks[3][i] = c3[i];
+    }
+}
+
+}
+
+void RandFill(uint64_t seed, uint64_t stream, uint64_t firstIndex, float* dst, size_t count) {
+    uint64_t index = firstIndex;
+    float* dstEnd = dst + count;
+    // to the beginning of the block
+    for (; (dst != dstEnd) && ((index & 3) != 0); ++dst, ++index) {
+        *dst = Rand<float>(seed, stream, index);
+    }
+
+    uint32_t blocks[4][Lanes];
+    for (; static_cast<size_t>(dstEnd - dst) >= Lanes * 4; dst += Lanes * 4, index += Lanes * 4) {
+        RandBlocks(seed, stream, index >> 2, blocks);
+        for (size_t i=0; i!=Lanes; ++i) {
+            for (size_t k=0; k!=4; ++k) {
+                dst[i * 4 + k] = RandToFloat(blocks[k][i]);
+            }
+        }
+    }
+
+    for (; dst != dstEnd; ++dst, ++index) {
+        *dst = Rand<float>(seed, stream, index);
+    }
+}
+
+void RandFill(uint64_t seed, uint64_t stream, uint64_t firstIndex, dg::float3* dst, size_t count) {
+    uint64_t index = firstIndex;
+    dg::float3* dstEnd = dst + count;
+
+    uint32_t blocks[4][Lanes];
+    for (; static_cast<size_t>(dstEnd - dst) >= Lanes; dst += Lanes, index += Lanes) {
+        RandBlocks(seed, stream, index, blocks);
+        for (size_t i=0; i!=Lanes; ++i) {
+            dst[i] = dg::float3(RandToFloat(blocks[0][i]), RandToFloat(blocks[1][i]), RandToFloat(blocks[2][i]));
+        }
+    }
+
+    for (; dst != dstEnd; ++dst, ++index) {
+        *dst = Rand<dg::float3>(seed, stream, index);
+    }
+}
+
+void LinearRandFill(uint64_t seed, uint64_t stream, uint64_t firstIndex, float minValue, float maxValue, float* dst, size_t count) {
+    RandFill(seed, stream, firstIndex, dst, count);
+    const float range = maxValue - minValue;
+    for (size_t i=0; i!=count; ++i) {
+        dst[i] = minValue + range * dst[i];
+    }
+}
+
+void LinearRandFill(uint64_t seed, uint64_t stream, uint64_t firstIndex, const dg::float3& minValue, const dg::float3& maxValue, dg::float3* dst, size_t count) {
+    RandFill(seed, stream, firstIndex, dst, count);
+    const dg::float3 range = maxValue - minValue;
+    for (size_t i=0; i!=count; ++i) {
+        dst[i] = minValue + range * dst[i];
+    }
+}
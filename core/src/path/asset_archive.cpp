@@ -0,0 +1,316 @@
+#include "core/path/asset_archive.h"
+
+#include <span>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+#include <exception>
+
+#include "fmt/fmt.h"
+#include "core/path/lz4_block.h"
+#include "core/path/mapped_file.h"
+#include "core/common/exception.h"
+
+
+namespace {
+
+// "TPAK"
+constexpr const uint32_t ArchiveMagic = 0x4B415054;
+constexpr const uint32_t ArchiveVersion = 1;
+
+enum class Compression : uint32_t {
+    None = 0,
+    LZ4Block = 1,
+};
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entriesCount;
+    uint32_t namesSize;
+};
+static_assert(sizeof(Header) == 16);
+static_assert(sizeof(AssetArchive::Entry) == 48);
+
+bool EntryLess(const AssetArchive::Entry& entry, uint64_t hash) noexcept {
+    return entry.hash < hash;
+}
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) noexcept {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void WritePadding(std::ofstream& out, uint64_t size) {
+    static const char zeros[256] = {};
+    for (; size != 0; ) {
+        const uint64_t count = std::min(size, static_cast<uint64_t>(sizeof(zeros)));
+        out.write(zeros, static_cast<std::streamsize>(count));
+        size -= count;
+    }
+}
+
+}
+
+bool AssetArchive::Open(const std::filesystem::path& path, std::string& error) noexcept {
+    m_file.reset();
+    m_entries.clear();
+    m_names = nullptr;
+
+    try {
+        auto file = std::make_shared<MappedFile>();
+        if (!file->Open(path, error)) {
+            return false;
+        }
+
+        const uint8_t* data = file->Data();
+        const uint64_t fileSize = file->Size();
+        Header header;
+        if (fileSize < sizeof(header)) {
+            error = fmt::format("AssetArchive: file '{}' is too small", path.c_str());
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if ((header.magic != ArchiveMagic) || (header.version != ArchiveVersion)) {
+            error = fmt::format("AssetArchive: file '{}' has wrong magic or version {}", path.c_str(), header.version);
+            return false;
+        }
+
+        const uint64_t namesOffset = sizeof(header) + static_cast<uint64_t>(header.entriesCount) * sizeof(Entry);
+        if (namesOffset + header.namesSize > fileSize) {
+            error = fmt::format("AssetArchive: index of file '{}' is out of the file", path.c_str());
+            return false;
+        }
+
+        std::vector<Entry> entries(header.entriesCount);
+        std::memcpy(entries.data(), data + sizeof(header), entries.size() * sizeof(Entry));
+        for (size_t i=0; i!=entries.size(); ++i) {
+            const auto& entry = entries[i];
+            const bool isCompressionValid = (entry.compression == static_cast<uint32_t>(Compression::LZ4Block)) ||
+                ((entry.compression == static_cast<uint32_t>(Compression::None)) && (entry.size == entry.originalSize));
+            if ((static_cast<uint64_t>(entry.nameOffset) + entry.nameSize > header.namesSize) ||
+                (entry.offset > fileSize) || (entry.size > fileSize - entry.offset) ||
+                !isCompressionValid || ((i != 0) && (entries[i - 1].hash > entry.hash))) {
+                error = fmt::format("AssetArchive: entry {} of file '{}' is malformed", i, path.c_str());
+                return false;
+            }
+        }
+
+        m_path = path;
+        m_names = reinterpret_cast<const char*>(data + namesOffset);
+        m_entries = std::move(entries);
+        m_file = std::move(file);
+    } catch(const std::exception& e) {
+        error = fmt::format("AssetArchive: couldn't open file '{}', error: {}", path.c_str(), e.what());
+        return false;
+    }
+
+    return true;
+}
+
+void AssetArchive::Open(const std::filesystem::path& path) {
+    std::string error;
+    if (!Open(path, error)) {
+        throw EngineError(error);
+    }
+}
+
+bool AssetArchive::Contains(const std::filesystem::path& name) const noexcept {
+    return (Find(name) != nullptr);
+}
+
+std::vector<std::string> AssetArchive::GetNames() const {
+    std::vector<std::string> result;
+    result.reserve(m_entries.size());
+    for (const auto& entry: m_entries) {
+        result.emplace_back(m_names + entry.nameOffset, entry.nameSize);
+    }
+
+    return result;
+}
+
+bool AssetArchive::Read(const std::filesystem::path& name, FileView& view, std::string& error) const noexcept {
+    const Entry* entry = Find(name);
+    if (entry == nullptr) {
+        error = fmt::format("AssetArchive: not found '{}' in archive '{}'", name.c_str(), m_path.c_str());
+        return false;
+    }
+
+    const auto* data = reinterpret_cast<const std::byte*>(m_file->Data()) + entry->offset;
+    if (entry->compression == static_cast<uint32_t>(Compression::None)) {
+        view = FileView(std::span<const std::byte>(data, entry->size), m_file);
+        return true;
+    }
+
+    try {
+        auto buffer = std::make_shared<std::vector<uint8_t>>(entry->originalSize);
+        if (!DecompressLZ4Block(m_file->Data() + entry->offset, entry->size, buffer->data(), buffer->size())) {
+            error = fmt::format("AssetArchive: data of '{}' in archive '{}' is corrupted", name.c_str(), m_path.c_str());
+            return false;
+        }
+        const auto decompressed = std::span<const std::byte>(reinterpret_cast<const std::byte*>(buffer->data()), buffer->size());
+        view = FileView(decompressed, std::move(buffer));
+    } catch(const std::exception& e) {
+        error = fmt::format("AssetArchive: couldn't read '{}' from archive '{}', error: {}", name.c_str(), m_path.c_str(), e.what());
+        return false;
+    }
+
+    return true;
+}
+
+FileView AssetArchive::Read(const std::filesystem::path& name) const {
+    std::string error;
+    FileView result;
+    if (!Read(name, result, error)) {
+        throw EngineError(error);
+    }
+
+    return result;
+}
+
+std::string AssetArchive::NormalizeName(const std::filesystem::path& name) {
+    if (name.empty() || name.has_root_path()) {
+        return std::string();
+    }
+
+    std::string result = name.lexically_normal().generic_string();
+    if ((result == ".") || (result == "..") || result.starts_with("../")) {
+        return std::string();
+    }
+
+    return result;
+}
+
+uint64_t AssetArchive::HashName(const std::string& name) noexcept {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037u;
+    for (const char c: name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211u;
+    }
+
+    return hash;
+}
+
+const AssetArchive::Entry* AssetArchive::Find(const std::filesystem::path& name) const noexcept {
+    if (m_entries.empty()) {
+        return nullptr;
+    }
+
+    std::string normalized;
+    try {
+        normalized = NormalizeName(name);
+    } catch(const std::exception&) {
+        return nullptr;
+    }
+
+    const uint64_t hash = HashName(normalized);
+    for (auto it = std::lower_bound(m_entries.cbegin(), m_entries.cend(), hash, EntryLess); (it != m_entries.cend()) && (it->hash == hash); ++it) {
+        if ((it->nameSize == normalized.size()) && (std::memcmp(m_names + it->nameOffset, normalized.data(), normalized.size()) == 0)) {
+            return &(*it);
+        }
+    }
+
+    return nullptr;
+}
+
+void AssetArchiveWriter::Add(const std::filesystem::path& name, std::vector<uint8_t>&& data) {
+    std::string normalized = AssetArchive::NormalizeName(name);
+    if (normalized.empty()) {
+        throw EngineError("AssetArchiveWriter: wrong name '{}', expected relative path in the root", name.c_str());
+    }
+
+    const uint64_t hash = AssetArchive::HashName(normalized);
+    m_items.push_back(Item{std::move(normalized), hash, std::move(data)});
+}
+
+void AssetArchiveWriter::AddFile(const std::filesystem::path& name, const std::filesystem::path& realPath) {
+    MappedFile file;
+    file.Open(realPath);
+    Add(name, std::vector<uint8_t>(file.Data(), file.Data() + file.Size()));
+}
+
+AssetArchiveStats AssetArchiveWriter::Write(const std::filesystem::path& path, const AssetArchiveDesc& desc) const {
+    if ((desc.alignment == 0) || ((desc.alignment & (desc.alignment - 1)) != 0)) {
+        throw EngineError("AssetArchiveWriter: alignment {} is not a power of two", desc.alignment);
+    }
+
+    std::vector<const Item*> items(m_items.size());
+    for (size_t i=0; i!=m_items.size(); ++i) {
+        items[i] = &m_items[i];
+    }
+    std::sort(items.begin(), items.end(), [](const Item* a, const Item* b) {
+        return (a->hash != b->hash) ? (a->hash < b->hash) : (a->name < b->name);
+    });
+
+    std::string names;
+    std::vector<AssetArchive::Entry> entries(items.size());
+    std::vector<std::vector<uint8_t>> compressed(items.size());
+    AssetArchiveStats stats;
+    stats.entriesCount = static_cast<uint32_t>(items.size());
+    for (size_t i=0; i!=items.size(); ++i) {
+        const auto* item = items[i];
+        if ((i != 0) && (items[i - 1]->name == item->name)) {
+            throw EngineError("AssetArchiveWriter: duplicate entry '{}'", item->name);
+        }
+
+        auto& entry = entries[i];
+        entry.hash = item->hash;
+        entry.nameOffset = static_cast<uint32_t>(names.size());
+        entry.nameSize = static_cast<uint32_t>(item->name.size());
+        names += item->name;
+        entry.originalSize = item->data.size();
+        entry.size = item->data.size();
+        entry.compression = static_cast<uint32_t>(Compression::None);
+        entry.reserved = 0;
+        stats.originalSize += item->data.size();
+
+        if (desc.compress && !item->data.empty()) {
+            compressed[i] = CompressLZ4Block(item->data.data(), item->data.size());
+            if (static_cast<double>(compressed[i].size()) <= static_cast<double>(item->data.size()) * static_cast<double>(desc.maxCompressionRatio)) {
+                entry.size = compressed[i].size();
+                entry.compression = static_cast<uint32_t>(Compression::LZ4Block);
+                ++stats.compressedCount;
+            } else {
+                compressed[i].clear();
+                compressed[i].shrink_to_fit();
+            }
+        }
+    }
+
+    // the compressed data is packed without the alignment, it's always copied by the reader
+    uint64_t offset = sizeof(Header) + entries.size() * sizeof(AssetArchive::Entry) + names.size();
+    for (auto& entry: entries) {
+        if (entry.compression == static_cast<uint32_t>(Compression::None)) {
+            offset = AlignUp(offset, desc.alignment);
+        }
+        entry.offset = offset;
+        offset += entry.size;
+    }
+    stats.archiveSize = offset;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw EngineError("AssetArchiveWriter: couldn't create file '{}'", path.c_str());
+    }
+
+    const Header header{ArchiveMagic, ArchiveVersion, static_cast<uint32_t>(entries.size()), static_cast<uint32_t>(names.size())};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(AssetArchive::Entry)));
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+    uint64_t written = sizeof(Header) + entries.size() * sizeof(AssetArchive::Entry) + names.size();
+    for (size_t i=0; i!=entries.size(); ++i) {
+        const auto& entry = entries[i];
+        const auto& data = (entry.compression == static_cast<uint32_t>(Compression::None)) ? items[i]->data : compressed[i];
+        WritePadding(out, entry.offset - written);
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        written = entry.offset + entry.size;
+    }
+
+    out.close();
+    if (!out) {
+        throw EngineError("AssetArchiveWriter: couldn't write file '{}'", path.c_str());
+    }
+
+    return stats;
+}
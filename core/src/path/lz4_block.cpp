@@ -0,0 +1,167 @@
+#include "core/path/lz4_block.h"
+
+#include <cstring>
+
+
+namespace {
+
+constexpr const size_t MinMatch = 4;
+// the last match starts at least 12 bytes before the end of the block
+constexpr const size_t MatchStartLimit = 12;
+// the last 5 bytes are the literals
+constexpr const size_t LastLiterals = 5;
+constexpr const size_t MaxOffset = 65535;
+constexpr const uint32_t HashLog = 14;
+
+uint32_t Read32(const uint8_t* data) noexcept {
+    uint32_t result;
+    std::memcpy(&result, data, sizeof(result));
+    return result;
+}
+
+uint32_t Hash(uint32_t sequence) noexcept {
+    return (sequence * 2654435761u) >> (32 - HashLog);
+}
+
+// the length over the 4-bit field of the token: 255 per byte and the rest
+void WriteLength(std::vector<uint8_t>& out, size_t length) {
+    for (; length >= 255; length -= 255) {
+        out.push_back(255);
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+void WriteSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalsCount, size_t offset, size_t matchLength) {
+    const size_t matchCode = (matchLength == 0) ? 0 : (matchLength - MinMatch);
+    const auto token = static_cast<uint8_t>(((literalsCount < 15 ? literalsCount : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+    out.push_back(token);
+    if (literalsCount >= 15) {
+        WriteLength(out, literalsCount - 15);
+    }
+    out.insert(out.end(), literals, literals + literalsCount);
+    if (matchLength == 0) {
+        return;
+    }
+
+    out.push_back(static_cast<uint8_t>(offset & 0xFF));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (matchCode >= 15) {
+        WriteLength(out, matchCode - 15);
+    }
+}
+
+// returns false if the length is out of the block
+bool ReadLength(const uint8_t*& pos, const uint8_t* end, size_t& length) noexcept {
+    while (true) {
+        if (pos == end) {
+            return false;
+        }
+        const uint8_t value = *pos++;
+        length += value;
+        if (value != 255) {
+            return true;
+        }
+    }
+}
+
+}
+
+std::vector<uint8_t> CompressLZ4Block(const uint8_t* data, size_t size) {
+    std::vector<uint8_t> result;
+    result.reserve(size + size / 255 + 16);
+
+    size_t anchor = 0;
+    if (size > MatchStartLimit) {
+        // position + 1 of the last sequence with the hash, 0 - empty
+        std::vector<size_t> table(size_t(1) << HashLog, 0);
+        const size_t matchStartEnd = size - MatchStartLimit;
+        const size_t matchEnd = size - LastLiterals;
+        size_t pos = 0;
+        while (pos < matchStartEnd) {
+            const uint32_t sequence = Read32(data + pos);
+            size_t& entry = table[Hash(sequence)];
+            const size_t candidate = entry;
+            entry = pos + 1;
+            if ((candidate == 0) || (pos - (candidate - 1) > MaxOffset) || (Read32(data + candidate - 1) != sequence)) {
+                ++pos;
+                continue;
+            }
+
+            size_t ref = candidate - 1;
+            size_t length = MinMatch;
+            while ((pos + length < matchEnd) && (data[ref + length] == data[pos + length])) {
+                ++length;
+            }
+            // extends the match back into the literals
+            while ((pos > anchor) && (ref > 0) && (data[pos - 1] == data[ref - 1])) {
+                --pos;
+                --ref;
+                ++length;
+            }
+
+            WriteSequence(result, data + anchor, pos - anchor, pos - ref, length);
+            pos += length;
+            anchor = pos;
+        }
+    }
+
+    const size_t noMatch = 0;
+    WriteSequence(result, data + anchor, size - anchor, noMatch, noMatch);
+
+    return result;
+}
+
+bool DecompressLZ4Block(const uint8_t* block, size_t blockSize, uint8_t* data, size_t size) noexcept {
+    const uint8_t* pos = block;
+    const uint8_t* end = block + blockSize;
+    size_t written = 0;
+    while (pos != end) {
+        const uint8_t token = *pos++;
+        size_t literalsCount = token >> 4;
+        if ((literalsCount == 15) && !ReadLength(pos, end, literalsCount)) {
+            return false;
+        }
+        if ((literalsCount > static_cast<size_t>(end - pos)) || (literalsCount > size - written)) {
+            return false;
+        }
+        // data is nullptr for the empty block
+        if (literalsCount != 0) {
+            std::memcpy(data + written, pos, literalsCount);
+        }
+        pos += literalsCount;
+        written += literalsCount;
+
+        // the last sequence has only the literals
+        if (pos == end) {
+            break;
+        }
+
+        if (end - pos < 2) {
+            return false;
+        }
+        const size_t offset = static_cast<size_t>(pos[0]) | (static_cast<size_t>(pos[1]) << 8);
+        pos += 2;
+        size_t length = token & 0x0F;
+        if ((length == 15) && !ReadLength(pos, end, length)) {
+            return false;
+        }
+        length += MinMatch;
+        if ((offset == 0) || (offset > written) || (length > size - written)) {
+            return false;
+        }
+
+        // the match can overlap the output
+        const uint8_t* src = data + written - offset;
+        uint8_t* dst = data + written;
+        if (offset >= length) {
+            std::memcpy(dst, src, length);
+        } else {
+            for (size_t i=0; i!=length; ++i) {
+                dst[i] = src[i];
+            }
+        }
+        written += length;
+    }
+
+    return (written == size);
+}
@@ -0,0 +1,68 @@
+#include "core/path/mapped_file.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "fmt/fmt.h"
+#include "core/common/exception.h"
+
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::filesystem::path& path, std::string& error, bool populate) noexcept {
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        error = fmt::format("couldn't open file '{}', error: {}", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        error = fmt::format("couldn't get size of file '{}', error: {}", path.c_str(), strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    const auto size = static_cast<size_t>(st.st_size);
+    if (size != 0) {
+        const int flags = populate ? (MAP_PRIVATE | MAP_POPULATE) : MAP_PRIVATE;
+        void* data = mmap(nullptr, size, PROT_READ, flags, fd, 0);
+        if (data == MAP_FAILED) {
+            error = fmt::format("couldn't map file '{}', error: {}", path.c_str(), strerror(errno));
+            close(fd);
+            return false;
+        }
+        m_data = static_cast<const uint8_t*>(data);
+    }
+    // the mapping stays valid after closing the descriptor
+    close(fd);
+
+    m_size = size;
+    m_isOpen = true;
+
+    return true;
+}
+
+void MappedFile::Open(const std::filesystem::path& path) {
+    std::string error;
+    if (!Open(path, error)) {
+        throw EngineError(error);
+    }
+}
+
+void MappedFile::Close() noexcept {
+    if (m_data != nullptr) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+    m_isOpen = false;
+    m_data = nullptr;
+    m_size = 0;
+}
@@ -1,47 +1,72 @@
 #include "core/path/path.h"
 
-#include <cstring>
+#include <span>
+#include <memory>
 #include <numeric>
-#include <fstream>
-#include <errno.h>
 #include <utility>
 #include <iterator>
+#include <algorithm>
+#include <exception>
+#include <system_error>
 #include <functional>
 
 #include "fmt/fmt.h"
+#include "core/path/mapped_file.h"
+#include "core/path/asset_archive.h"
 #include "core/common/exception.h"
 
 
+FileManager::~FileManager() {
+    {
+        std::lock_guard<std::mutex> lock(m_ioMutex);
+        m_isStopped = true;
+    }
+    m_ioQueueChanged.notify_all();
+    if (m_ioThread.joinable()) {
+        m_ioThread.join();
+    }
+}
+
 void FileManager::AddRootAlias(const std::string& alias, const std::filesystem::path& path) {
     m_aliases[alias] = path;
 }
 
+void FileManager::MountArchive(const std::filesystem::path& path, int32_t priority) {
+    auto archive = std::make_shared<AssetArchive>();
+    archive->Open(path);
+
+    const auto it = std::find_if(m_mounts.cbegin(), m_mounts.cend(), [priority](const Mount& mount) { return mount.priority <= priority; });
+    m_mounts.insert(it, Mount{priority, std::filesystem::path(), std::move(archive)});
+}
+
+void FileManager::MountDirectory(const std::filesystem::path& path, int32_t priority) {
+    std::error_code ec;
+    auto directory = std::filesystem::canonical(path, ec);
+    if (ec || !std::filesystem::is_directory(directory, ec)) {
+        throw EngineError("FileManager: couldn't mount directory '{}', it doesn't exist", path.c_str());
+    }
+
+    const auto it = std::find_if(m_mounts.cbegin(), m_mounts.cend(), [priority](const Mount& mount) { return mount.priority <= priority; });
+    m_mounts.insert(it, Mount{priority, std::move(directory), nullptr});
+}
+
 std::filesystem::path FileManager::CurrentPath() const {
     return std::filesystem::current_path();
 }
 
 bool FileManager::GetRealPath(const std::filesystem::path& inPath, std::filesystem::path& outPath, std::string& error) const noexcept {
-    if (inPath.empty()) {
-        error = fmt::format("not found real path for empty path");
+    ResolvedPath resolved;
+    if (!Resolve(inPath, resolved, error)) {
         return false;
     }
-
-    if (std::filesystem::exists(inPath)) {
-        outPath = std::filesystem::canonical(inPath);
-        return true;
-    }
-
-    const auto firstPathElement = inPath.begin();
-    const auto it = m_aliases.find(*firstPathElement);
-    if (it != m_aliases.cend()) {
-        outPath = std::filesystem::canonical(std::accumulate(std::next(firstPathElement), inPath.end(), it->second, std::divides{}));
-        if (std::filesystem::exists(outPath)) {
-            return true;
-        }
+    // the lower mounts aren't checked, their file isn't the one that is read
+    if (resolved.archive != nullptr) {
+        error = fmt::format("not found real path for: {}, it's read from the archive", inPath.c_str());
+        return false;
     }
 
-    error = fmt::format("not found real path for: {}", inPath.c_str());
-    return false;
+    outPath = std::move(resolved.path);
+    return true;
 }
 
 bool FileManager::GetRealPath(const std::filesystem::path& inPath, std::filesystem::path& outPath) const noexcept {
@@ -60,24 +85,18 @@ std::filesystem::path FileManager::GetRealPath(const std::filesystem::path& inPa
 }
 
 bool FileManager::ReadFullFile(const std::filesystem::path& path, std::string& data, std::string& error) const noexcept {
-    std::filesystem::path fullPath;
-    if (!GetRealPath(path, fullPath, error)) {
+    FileView view;
+    if (!MapFile(path, view, error)) {
         return false;
     }
 
-    std::ifstream ifs(fullPath.c_str(), std::ifstream::in);
-    if(!ifs) {
-        error = fmt::format("couldn't open file '{}', error: {}", fullPath.c_str(), strerror(errno));
+    try {
+        data.assign(view.View());
+    } catch(const std::exception& e) {
+        error = fmt::format("couldn't read file '{}', error: {}", path.c_str(), e.what());
         return false;
     }
 
-    ifs.seekg(0, std::ios::end);
-    data.reserve(static_cast<size_t>(ifs.tellg()));
-    ifs.seekg(0, std::ios::beg);
-
-    data.assign((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
-    ifs.close();
-
     return true;
 }
 
@@ -95,3 +114,151 @@ std::string FileManager::ReadFullFile(const std::filesystem::path& path) const {
 
     return result;
 }
+
+bool FileManager::MapFile(const std::filesystem::path& path, FileView& view, std::string& error) const noexcept {
+    ResolvedPath resolved;
+    if (!Resolve(path, resolved, error)) {
+        return false;
+    }
+
+    const bool populate = false;
+    view = MapResolved(resolved, error, populate);
+
+    return error.empty();
+}
+
+bool FileManager::MapFile(const std::filesystem::path& path, FileView& view) const noexcept {
+    std::string error;
+    return MapFile(path, view, error);
+}
+
+FileView FileManager::MapFile(const std::filesystem::path& path) const {
+    std::string error;
+    FileView result;
+    if (!MapFile(path, result, error)) {
+        throw EngineError(error);
+    }
+
+    return result;
+}
+
+void FileManager::ReadFileAsync(const std::filesystem::path& path, ReadCallback&& callback) {
+    ReadRequest request;
+    Resolve(path, request.resolved, request.error);
+    request.callback = std::move(callback);
+
+    {
+        std::lock_guard<std::mutex> lock(m_ioMutex);
+        if (!m_ioThread.joinable()) {
+            m_ioThread = std::thread(&FileManager::IOLoop, this);
+        }
+        m_ioQueue.push_back(std::move(request));
+    }
+    m_ioQueueChanged.notify_one();
+}
+
+std::future<FileView> FileManager::ReadFileAsync(const std::filesystem::path& path) {
+    auto promise = std::make_shared<std::promise<FileView>>();
+    auto result = promise->get_future();
+    ReadFileAsync(path, [promise](FileView&& view, const std::string& error) {
+        if (error.empty()) {
+            promise->set_value(std::move(view));
+        } else {
+            promise->set_exception(std::make_exception_ptr(EngineError(error)));
+        }
+    });
+
+    return result;
+}
+
+bool FileManager::Resolve(const std::filesystem::path& path, ResolvedPath& resolved, std::string& error) const noexcept {
+    if (path.empty()) {
+        error = fmt::format("not found real path for empty path");
+        return false;
+    }
+
+    resolved.archive.reset();
+    std::error_code ec;
+    const auto firstPathElement = path.begin();
+    const auto it = m_aliases.find(*firstPathElement);
+    // the aliased paths skip the mounts
+    if (path.is_relative() && (it == m_aliases.cend())) {
+        for (const auto& mount: m_mounts) {
+            if (mount.archive != nullptr) {
+                if (mount.archive->Contains(path)) {
+                    resolved.path = path;
+                    resolved.archive = mount.archive;
+                    return true;
+                }
+            } else {
+                resolved.path = std::filesystem::canonical(mount.directory / path, ec);
+                if (!ec) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    // canonical fails for the missing path
+    resolved.path = std::filesystem::canonical(path, ec);
+    if (!ec) {
+        return true;
+    }
+
+    if (it != m_aliases.cend()) {
+        resolved.path = std::filesystem::canonical(std::accumulate(std::next(firstPathElement), path.end(), it->second, std::divides{}), ec);
+        if (!ec) {
+            return true;
+        }
+    }
+
+    error = fmt::format("not found real path for: {}", path.c_str());
+    return false;
+}
+
+FileView FileManager::MapResolved(const ResolvedPath& resolved, std::string& error, bool populate) noexcept {
+    FileView result;
+    if (resolved.archive != nullptr) {
+        if (resolved.archive->Read(resolved.path, result, error)) {
+            error.clear();
+        }
+        return result;
+    }
+
+    auto file = std::make_shared<MappedFile>();
+    if (!file->Open(resolved.path, error, populate)) {
+        return result;
+    }
+    error.clear();
+
+    const auto data = std::span<const std::byte>(reinterpret_cast<const std::byte*>(file->Data()), file->Size());
+    return FileView(data, std::move(file));
+}
+
+void FileManager::IOLoop() {
+    while (true) {
+        ReadRequest request;
+        bool isStopped = false;
+        {
+            std::unique_lock<std::mutex> lock(m_ioMutex);
+            m_ioQueueChanged.wait(lock, [this]() { return m_isStopped || !m_ioQueue.empty(); });
+            if (m_ioQueue.empty()) {
+                return;
+            }
+            request = std::move(m_ioQueue.front());
+            m_ioQueue.pop_front();
+            isStopped = m_isStopped;
+        }
+
+        // the rest requests are completed with the error after the stop
+        FileView view;
+        if (isStopped) {
+            request.error = fmt::format("file manager is destroyed before reading '{}'", request.resolved.path.c_str());
+        } else if (request.error.empty()) {
+            // the compressed entries of the archives are decompressed here
+            const bool populate = true;
+            view = MapResolved(request.resolved, request.error, populate);
+        }
+        request.callback(std::move(view), request.error);
+    }
+}
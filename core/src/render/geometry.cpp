@@ -1,9 +1,13 @@
 #include "core/render/geometry.h"
 
+#include <cmath>
+#include <algorithm>
+
 #include "dg/context.h"
 #include "dg/graphics_types.h"
 #include "core/render/index_buffer.h"
 #include "core/render/vertex_buffer.h"
+#include "core/common/exception.h"
 
 
 Geometry::Geometry(uint16_t vDeclId)
@@ -31,16 +35,17 @@ void GeometryUnindexed::Bind(ContextPtr& context) {
     m_vertexBuffer->Bind(context, m_vertexBufferOffsetBytes);
 }
 
-uint32_t GeometryUnindexed::Draw(ContextPtr& context, uint32_t firstInstanceIndex) {
+uint32_t GeometryUnindexed::Draw(ContextPtr& context, uint32_t firstInstanceIndex, uint8_t /* lod */, uint32_t instanceCount) {
     dg::DrawAttribs drawAttrs;
     drawAttrs.NumVertices = m_vertexBufferCount;
+    drawAttrs.NumInstances = instanceCount;
     drawAttrs.FirstInstanceLocation = firstInstanceIndex;
     drawAttrs.Flags = dg::DRAW_FLAG_VERIFY_ALL;
 
     context->Draw(drawAttrs);
 
     // TODO: fix for not triangle
-    return m_vertexBufferCount / 3;
+    return m_vertexBufferCount / 3 * instanceCount;
 }
 
 GeometryIndexed::GeometryIndexed(const std::shared_ptr<VertexBuffer>& vb, uint32_t vbOffsetBytes,
@@ -51,7 +56,8 @@ GeometryIndexed::GeometryIndexed(const std::shared_ptr<VertexBuffer>& vb, uint32
     , m_vertexBufferOffsetBytes(vbOffsetBytes)
     , m_indexBufferOffsetBytes(ibOffsetBytes)
     , m_indexBufferCount(ibCount)
-    , m_indexBufferUint32(ibUint32) {
+    , m_indexBufferUint32(ibUint32)
+    , m_lods{GeometryLod{0, ibCount, 0.f}} {
 
 }
 
@@ -59,20 +65,69 @@ GeometryIndexed::~GeometryIndexed() {
 
 }
 
+void GeometryIndexed::SetLods(const std::vector<GeometryLod>& lods, const dg::float3& center) {
+    if (lods.empty()) {
+        throw EngineError("GeometryIndexed::SetLods: lods is empty");
+    }
+    if (lods.size() > 255) {
+        throw EngineError("GeometryIndexed::SetLods: lods count = {} is too large", lods.size());
+    }
+    for (const auto& lod: lods) {
+        if ((lod.indexCount == 0) || (lod.firstIndex + lod.indexCount > m_indexBufferCount)) {
+            throw EngineError("GeometryIndexed::SetLods: lod index range ({}, {}) is out of index buffer (count = {})",
+                lod.firstIndex, lod.indexCount, m_indexBufferCount);
+        }
+    }
+
+    m_lods = lods;
+    m_lodCenter = center;
+}
+
+uint8_t GeometryIndexed::SelectLod(const dg::float4x4& world, const dg::float3& cameraPosition, float lodScale) const {
+    if ((m_lods.size() < 2) || (lodScale <= 0)) {
+        return 0;
+    }
+
+    const auto center = static_cast<dg::float3>(dg::float4(m_lodCenter, 1.f) * world);
+    const float distance = dg::length(center - cameraPosition);
+    if (distance <= 0) {
+        return 0;
+    }
+
+    // max scale of the world matrix (row vectors)
+    float scale = 0;
+    for (size_t i=0; i!=3; ++i) {
+        scale = std::max(scale, std::sqrt(world[i][0] * world[i][0] + world[i][1] * world[i][1] + world[i][2] * world[i][2]));
+    }
+
+    const float errorScale = scale * lodScale / distance;
+    for (auto lod = static_cast<uint8_t>(m_lods.size() - 1); lod != 0; --lod) {
+        if (m_lods[lod].error * errorScale <= 1.f) {
+            return lod;
+        }
+    }
+
+    return 0;
+}
+
 void GeometryIndexed::Bind(ContextPtr& context) {
     m_vertexBuffer->Bind(context, m_vertexBufferOffsetBytes);
     m_indexBuffer->Bind(context, m_indexBufferOffsetBytes);
 }
 
-uint32_t GeometryIndexed::Draw(ContextPtr& context, uint32_t firstInstanceIndex) {
+uint32_t GeometryIndexed::Draw(ContextPtr& context, uint32_t firstInstanceIndex, uint8_t lod, uint32_t instanceCount) {
+    const auto& lodRange = m_lods[std::min(static_cast<size_t>(lod), m_lods.size() - 1)];
+
     dg::DrawIndexedAttribs drawAttrs;
     drawAttrs.IndexType  = m_indexBufferUint32 ? dg::VT_UINT32 : dg::VT_UINT16;
-    drawAttrs.NumIndices = m_indexBufferCount;
+    drawAttrs.NumIndices = lodRange.indexCount;
+    drawAttrs.FirstIndexLocation = lodRange.firstIndex;
+    drawAttrs.NumInstances = instanceCount;
     drawAttrs.FirstInstanceLocation = firstInstanceIndex;
     drawAttrs.Flags = dg::DRAW_FLAG_VERIFY_ALL;
 
     context->DrawIndexed(drawAttrs);
 
     // TODO: fix for not triangle
-    return m_indexBufferCount / 3;
+    return lodRange.indexCount / 3 * instanceCount;
 }
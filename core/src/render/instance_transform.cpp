@@ -0,0 +1,51 @@
+#include "core/render/instance_transform.h"
+
+#include <cstring>
+#include <utility>
+#include <algorithm>
+
+#include "core/math/normal_matrix.h"
+
+
+// the transforms are compared bitwise
+static_assert(sizeof(InstanceTransform) == sizeof(float) * 5);
+
+void InstanceList::Set(std::vector<InstanceTransform>&& transforms) {
+    // the new instances are dirty
+    m_isDirty.resize(transforms.size(), true);
+    m_hasDirty = m_hasDirty || (transforms.size() > m_transforms.size());
+    const size_t count = std::min(transforms.size(), m_transforms.size());
+    for (size_t i=0; i!=count; ++i) {
+        if (std::memcmp(&transforms[i], &m_transforms[i], sizeof(InstanceTransform)) != 0) {
+            m_isDirty[i] = true;
+            m_hasDirty = true;
+        }
+    }
+
+    m_transforms = std::move(transforms);
+    m_matrices.resize(m_transforms.size());
+}
+
+size_t InstanceList::Update(const dg::float4x4& nodeWorld, bool isNodeDirty) {
+    if (!isNodeDirty && !m_hasDirty) {
+        return 0;
+    }
+
+    size_t result = 0;
+    for (size_t i=0; i!=m_transforms.size(); ++i) {
+        if (!isNodeDirty && !m_isDirty[i]) {
+            continue;
+        }
+
+        const auto& transform = m_transforms[i];
+        auto& matrices = m_matrices[i];
+        matrices.world = dg::float4x4::Scale(transform.scale) * dg::float4x4::RotationY(transform.angleY) *
+            dg::float4x4::Translation(transform.position) * nodeWorld;
+        matrices.normal = MakeNormalMatrix3x3(matrices.world);
+        m_isDirty[i] = false;
+        ++result;
+    }
+    m_hasDirty = false;
+
+    return result;
+}
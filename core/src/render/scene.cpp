@@ -7,6 +7,11 @@
 #include "core/material/material_view.h"
 
 
+void Scene::SetLodParams(const dg::float3& cameraPosition, float lodScale) {
+    m_updateDesc.cameraPosition = cameraPosition;
+    m_updateDesc.lodScale = lodScale;
+}
+
 TransformUpdateDesc& Scene::Update(uint16_t targetsId, uint16_t vDeclIdPerInstance, uint32_t findId) {
     m_updateDesc.nodeList.clear();
     m_updateDesc.targetsId = targetsId;
@@ -22,11 +27,18 @@ uint32_t Scene::Draw(ContextPtr& context) {
     uint32_t primitiveCount = 0;
 
     uint32_t ind = 0;
+    const MaterialView* prevView = nullptr;
     for (auto& node: m_updateDesc.nodeList) {
+        const uint32_t instanceCount = node.GetInstanceCount();
         node.geometry->Bind(context);
-        node.materialView.Bind(context);
-        primitiveCount += node.geometry->Draw(context, ind);
-        ++ind;
+        if (prevView == nullptr) {
+            node.materialView.Bind(context);
+        } else {
+            node.materialView.Bind(context, *prevView);
+        }
+        prevView = &node.materialView;
+        primitiveCount += node.geometry->Draw(context, ind, node.lod, instanceCount);
+        ind += instanceCount;
     }
 
     return primitiveCount;
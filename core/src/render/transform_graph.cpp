@@ -1,17 +1,22 @@
 #include "core/render/transform_graph.h"
 
+#include <utility>
+
 #include "core/render/geometry.h"
 #include "core/common/exception.h"
 #include "core/material/material.h"
 #include "core/math/normal_matrix.h"
 
 
-DrawNode::DrawNode(const std::shared_ptr<Geometry>& geometry, MaterialView materialView, const dg::float4x4& worldMatrix, const dg::float3x3& normalMatrix, uint32_t id)
+DrawNode::DrawNode(const std::shared_ptr<Geometry>& geometry, MaterialView materialView, const dg::float4x4& worldMatrix, const dg::float3x3& normalMatrix, uint32_t id, uint8_t lod,
+    const std::vector<InstanceMatrices>* instances)
     : geometry(geometry)
     , materialView(materialView)
     , worldMatrix(worldMatrix)
     , normalMatrix(normalMatrix)
-    , id(id) {
+    , id(id)
+    , lod(lod)
+    , instances(instances) {
 
 }
 
@@ -44,6 +49,7 @@ std::shared_ptr<TransformNode> TransformNode::Clone(const dg::float4x4& transfor
     if (m_geometry) {
         node->m_geometry = m_geometry;
         node->m_material = m_material;
+        node->m_instances = m_instances;
     }
 
     node->m_children.reserve(m_children.size());
@@ -59,6 +65,7 @@ std::shared_ptr<TransformNode> TransformNode::Clone(const std::weak_ptr<Transfor
     if (m_geometry) {
         node->m_geometry = m_geometry;
         node->m_material = m_material;
+        node->m_instances = m_instances;
     }
 
     node->m_children.reserve(m_children.size());
@@ -106,6 +113,14 @@ void TransformNode::SetTransform(const dg::float4x4& transform) {
     m_baseTransform = transform;
 }
 
+void TransformNode::SetInstances(std::vector<InstanceTransform>&& instances) {
+    m_instances.Set(std::move(instances));
+}
+
+void TransformNode::SetInstances(const std::vector<InstanceTransform>& instances) {
+    m_instances.Set(std::vector<InstanceTransform>(instances));
+}
+
 void TransformNode::Update(TransformUpdateDesc& nodeList, bool isDirty) {
     if (!m_isVisible) {
         return;
@@ -127,9 +142,18 @@ void TransformNode::Update(TransformUpdateDesc& nodeList, bool isDirty) {
         if (m_id == nodeList.findId) {
             nodeList.findResult = shared_from_this();
         }
-        nodeList.nodeList.emplace_back(
-            m_geometry, m_material->GetView(nodeList.frameNum, nodeList.targetsId, m_geometry->GetVDeclId(), nodeList.vDeclIdPerInstance),
-            m_world, m_normal, m_id);
+        if (m_instances.IsEmpty()) {
+            const uint8_t lod = m_geometry->SelectLod(m_world, nodeList.cameraPosition, nodeList.lodScale);
+            nodeList.nodeList.emplace_back(
+                m_geometry, m_material->GetView(nodeList.frameNum, nodeList.targetsId, m_geometry->GetVDeclId(), nodeList.vDeclIdPerInstance),
+                m_world, m_normal, m_id, lod);
+        } else {
+            // instances are spread over the node space, so the node transform can't be used for the LOD selection
+            m_instances.Update(m_world, isDirty);
+            nodeList.nodeList.emplace_back(
+                m_geometry, m_material->GetView(nodeList.frameNum, nodeList.targetsId, m_geometry->GetVDeclId(), nodeList.vDeclIdPerInstance),
+                m_world, m_normal, m_id, 0, &m_instances.GetMatrices());
+        }
     }
 
     for (auto& node : m_children) {
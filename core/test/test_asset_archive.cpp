@@ -0,0 +1,159 @@
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <filesystem>
+
+#include "test/test.h"
+#include "core/path/path.h"
+#include "core/path/lz4_block.h"
+#include "core/common/exception.h"
+#include "core/path/asset_archive.h"
+
+
+namespace {
+
+class AssetArchiveTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_dir = std::filesystem::temp_directory_path() / "terra_asset_archive_test";
+        std::filesystem::create_directories(m_dir / "loose" / "fonts");
+        std::ofstream(m_dir / "loose" / "fonts" / "font.ttf") << "loose font";
+        std::ofstream(m_dir / "loose" / "only_loose.txt") << "only loose";
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_dir);
+    }
+
+    static std::vector<uint8_t> ToBytes(const std::string& value) {
+        return std::vector<uint8_t>(value.cbegin(), value.cend());
+    }
+
+    static std::vector<uint8_t> MakeRepeated(size_t size) {
+        std::vector<uint8_t> result(size);
+        for (size_t i=0; i!=size; ++i) {
+            result[i] = static_cast<uint8_t>((i % 7) * 13 + (i / 1000));
+        }
+
+        return result;
+    }
+
+    static std::vector<uint8_t> MakeRandom(size_t size) {
+        std::vector<uint8_t> result(size);
+        uint32_t state = 12345;
+        for (size_t i=0; i!=size; ++i) {
+            state = state * 1664525u + 1013904223u;
+            result[i] = static_cast<uint8_t>(state >> 24);
+        }
+
+        return result;
+    }
+
+protected:
+    std::filesystem::path m_dir;
+};
+
+TEST_F(AssetArchiveTest, LZ4RoundTrip) {
+    for (const size_t size: {size_t(0), size_t(5), size_t(13), size_t(100), size_t(70000), size_t(300000)}) {
+        for (const auto& data: {MakeRepeated(size), MakeRandom(size), std::vector<uint8_t>(size, 42)}) {
+            const auto block = CompressLZ4Block(data.data(), data.size());
+            std::vector<uint8_t> decompressed(data.size());
+            ASSERT_TRUE(DecompressLZ4Block(block.data(), block.size(), decompressed.data(), decompressed.size())) << size;
+            ASSERT_EQ(decompressed, data) << size;
+        }
+    }
+
+    const auto data = MakeRepeated(10000);
+    auto block = CompressLZ4Block(data.data(), data.size());
+    ASSERT_LT(block.size(), data.size() / 10);
+    std::vector<uint8_t> decompressed(data.size());
+    ASSERT_FALSE(DecompressLZ4Block(block.data(), block.size(), decompressed.data(), decompressed.size() - 1));
+    ASSERT_FALSE(DecompressLZ4Block(block.data(), block.size() - 1, decompressed.data(), decompressed.size()));
+    // the offset out of the decompressed data
+    block = {0x04, 0x10, 0x00};
+    ASSERT_FALSE(DecompressLZ4Block(block.data(), block.size(), decompressed.data(), 8));
+}
+
+TEST_F(AssetArchiveTest, ReadWrite) {
+    const auto repeated = MakeRepeated(50000);
+    const auto random = MakeRandom(5000);
+    AssetArchiveWriter writer;
+    writer.Add("materials/std/base.msh", std::vector<uint8_t>(repeated));
+    writer.Add("./assets/random.bin", std::vector<uint8_t>(random));
+    writer.Add("assets/empty.bin", std::vector<uint8_t>());
+    writer.AddFile("assets/fonts/font.ttf", m_dir / "loose" / "fonts" / "font.ttf");
+    ASSERT_THROW(writer.Add("/absolute.bin", ToBytes("data")), EngineError);
+    ASSERT_THROW(writer.Add("../outside.bin", ToBytes("data")), EngineError);
+
+    const AssetArchiveDesc desc{64, true, 0.9f};
+    const auto stats = writer.Write(m_dir / "data.tpak", desc);
+    ASSERT_EQ(stats.entriesCount, 4);
+    ASSERT_EQ(stats.compressedCount, 1);
+    ASSERT_EQ(stats.archiveSize, std::filesystem::file_size(m_dir / "data.tpak"));
+    ASSERT_LT(stats.archiveSize, stats.originalSize);
+
+    AssetArchive archive;
+    archive.Open(m_dir / "data.tpak");
+    ASSERT_EQ(archive.GetEntriesCount(), 4);
+    ASSERT_TRUE(archive.Contains("assets/random.bin"));
+    ASSERT_TRUE(archive.Contains("assets/fonts/../random.bin"));
+    ASSERT_FALSE(archive.Contains("assets/missing.bin"));
+
+    auto view = archive.Read("materials/std/base.msh");
+    ASSERT_EQ(std::vector<uint8_t>(view.Chars(), view.Chars() + view.Size()), repeated);
+    // the stored entry is the aligned view of the mapped archive
+    view = archive.Read("assets/random.bin");
+    ASSERT_EQ(std::vector<uint8_t>(view.Chars(), view.Chars() + view.Size()), random);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(view.Chars()) % desc.alignment, 0);
+    ASSERT_EQ(archive.Read("assets/fonts/font.ttf").View(), "loose font");
+    ASSERT_TRUE(archive.Read("assets/empty.bin").IsEmpty());
+    ASSERT_THROW(archive.Read("assets/missing.bin"), EngineError);
+
+    AssetArchiveWriter duplicates;
+    duplicates.Add("a.bin", ToBytes("a"));
+    duplicates.Add("./a.bin", ToBytes("b"));
+    ASSERT_THROW(duplicates.Write(m_dir / "duplicates.tpak"), EngineError);
+
+    std::ofstream(m_dir / "wrong.tpak") << "not an archive";
+    std::string error;
+    ASSERT_FALSE(archive.Open(m_dir / "wrong.tpak", error));
+    ASSERT_FALSE(error.empty());
+}
+
+TEST_F(AssetArchiveTest, Mounts) {
+    AssetArchiveWriter writer;
+    writer.Add("fonts/font.ttf", ToBytes("packed font"));
+    writer.Add("only_packed.txt", ToBytes("only packed"));
+    writer.Write(m_dir / "data.tpak");
+
+    FileManager fileManager;
+    fileManager.MountDirectory(m_dir / "loose", 0);
+    fileManager.MountArchive(m_dir / "data.tpak", 0);
+    // the later mount wins with the same priority
+    ASSERT_EQ(fileManager.ReadFullFile("fonts/font.ttf"), "packed font");
+    ASSERT_EQ(fileManager.ReadFullFile("only_packed.txt"), "only packed");
+    ASSERT_EQ(fileManager.ReadFullFile("only_loose.txt"), "only loose");
+    ASSERT_EQ(fileManager.ReadFileAsync("fonts/font.ttf").get().View(), "packed font");
+    // the packed file has no real path
+    std::filesystem::path realPath;
+    ASSERT_FALSE(fileManager.GetRealPath("only_packed.txt", realPath));
+    ASSERT_TRUE(fileManager.GetRealPath("only_loose.txt", realPath));
+    // the loose file is shadowed by the packed one, its path isn't returned
+    std::string error;
+    ASSERT_FALSE(fileManager.GetRealPath("fonts/font.ttf", realPath, error));
+    ASSERT_NE(error.find("archive"), std::string::npos);
+
+    FileManager overrideManager;
+    overrideManager.MountArchive(m_dir / "data.tpak", 0);
+    overrideManager.MountDirectory(m_dir / "loose", 1);
+    ASSERT_EQ(overrideManager.ReadFullFile("fonts/font.ttf"), "loose font");
+    ASSERT_TRUE(overrideManager.GetRealPath("fonts/font.ttf", realPath));
+    ASSERT_EQ(realPath, std::filesystem::canonical(m_dir / "loose" / "fonts" / "font.ttf"));
+    ASSERT_EQ(overrideManager.MapFile("only_packed.txt").View(), "only packed");
+
+    ASSERT_THROW(overrideManager.MountDirectory(m_dir / "missing"), EngineError);
+    ASSERT_THROW(overrideManager.MountArchive(m_dir / "missing.tpak"), EngineError);
+}
+
+}
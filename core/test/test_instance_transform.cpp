@@ -0,0 +1,96 @@
+#include <vector>
+#include <cstddef>
+
+#include "test/test.h"
+#include "core/math/normal_matrix.h"
+#include "core/render/instance_transform.h"
+
+
+namespace {
+
+dg::float4x4 ExpectedWorld(const InstanceTransform& transform, const dg::float4x4& nodeWorld) {
+    return dg::float4x4::Scale(transform.scale) * dg::float4x4::RotationY(transform.angleY) *
+        dg::float4x4::Translation(transform.position) * nodeWorld;
+}
+
+void ExpectMatrices(const InstanceList& list, const dg::float4x4& nodeWorld) {
+    const auto& transforms = list.GetTransforms();
+    const auto& matrices = list.GetMatrices();
+    ASSERT_EQ(transforms.size(), matrices.size());
+    for (size_t i=0; i!=transforms.size(); ++i) {
+        const auto world = ExpectedWorld(transforms[i], nodeWorld);
+        const auto normal = MakeNormalMatrix3x3(world);
+        for (size_t row=0; row!=4; ++row) {
+            for (size_t col=0; col!=4; ++col) {
+                ASSERT_NEAR(matrices[i].world[row][col], world[row][col], 1e-5f);
+            }
+        }
+        for (size_t row=0; row!=3; ++row) {
+            for (size_t col=0; col!=3; ++col) {
+                ASSERT_NEAR(matrices[i].normal[row][col], normal[row][col], 1e-5f);
+            }
+        }
+    }
+}
+
+std::vector<InstanceTransform> MakeTransforms(size_t count) {
+    std::vector<InstanceTransform> result;
+    for (size_t i=0; i!=count; ++i) {
+        const auto value = static_cast<float>(i);
+        result.push_back(InstanceTransform{dg::float3(value, 0.5f * value, -value), 1.f + 0.1f * value, 0.2f * value});
+    }
+
+    return result;
+}
+
+TEST(InstanceList, ExpandChangedInstances) {
+    const auto nodeWorld = dg::float4x4::Translation(1.f, 2.f, 3.f);
+    InstanceList list;
+    ASSERT_TRUE(list.IsEmpty());
+
+    list.Set(MakeTransforms(10));
+    ASSERT_EQ(10, list.Update(nodeWorld, false));
+    ExpectMatrices(list, nodeWorld);
+    // nothing is changed
+    ASSERT_EQ(0, list.Update(nodeWorld, false));
+    list.Set(MakeTransforms(10));
+    ASSERT_EQ(0, list.Update(nodeWorld, false));
+
+    auto transforms = MakeTransforms(10);
+    transforms[3].angleY = 1.f;
+    transforms[7].position = dg::float3(5.f, 6.f, 7.f);
+    list.Set(std::move(transforms));
+    ASSERT_EQ(2, list.Update(nodeWorld, false));
+    ExpectMatrices(list, nodeWorld);
+
+    // the added instances are expanded, the removed are dropped
+    list.Set(MakeTransforms(12));
+    ASSERT_EQ(4, list.Update(nodeWorld, false));
+    ExpectMatrices(list, nodeWorld);
+    list.Set(MakeTransforms(5));
+    ASSERT_EQ(0, list.Update(nodeWorld, false));
+    ASSERT_EQ(5, list.GetMatrices().size());
+    ExpectMatrices(list, nodeWorld);
+}
+
+TEST(InstanceList, ExpandAllAfterNodeMove) {
+    InstanceList list;
+    list.Set(MakeTransforms(6));
+    ASSERT_EQ(6, list.Update(dg::float4x4::Identity(), false));
+
+    const auto nodeWorld = dg::float4x4::RotationY(0.5f) * dg::float4x4::Translation(-2.f, 0.f, 4.f);
+    ASSERT_EQ(6, list.Update(nodeWorld, true));
+    ExpectMatrices(list, nodeWorld);
+    ASSERT_EQ(0, list.Update(nodeWorld, false));
+
+    // the copy keeps the matrices
+    InstanceList copy = list;
+    ASSERT_EQ(0, copy.Update(nodeWorld, false));
+    ExpectMatrices(copy, nodeWorld);
+
+    list.Set(std::vector<InstanceTransform>());
+    ASSERT_TRUE(list.IsEmpty());
+    ASSERT_EQ(0, list.Update(nodeWorld, true));
+}
+
+}
@@ -0,0 +1,136 @@
+#include <cmath>
+#include <memory>
+#include <cstddef>
+#include <algorithm>
+
+#include "test/test.h"
+#include "core/math/generator_type.h"
+#include "core/math/generator_type_operators.h"
+
+
+namespace {
+
+class MathGenerator : public ::testing::Test {
+};
+
+// counts copies of the functor
+struct CopyCounter {
+    CopyCounter(const std::shared_ptr<size_t>& counter) : counter(counter) {}
+    CopyCounter(const CopyCounter& other) : counter(other.counter) { ++(*counter); }
+    CopyCounter(CopyCounter&& other) noexcept = default;
+
+    double operator()(double x, double y) const { return x + y; }
+
+    std::shared_ptr<size_t> counter;
+};
+
+TEST_F(MathGenerator, Evaluate) {
+    math::Generator2D a([](double x, double y) { return x * y; });
+    math::Generator2D b(2.0);
+    auto c = (a + b) + std::max(b, 3.0);
+
+    EXPECT_DOUBLE_EQ(c(2., 3.), 6. + 2. + 3.);
+    EXPECT_DOUBLE_EQ(math::Generator2D()(1., 2.), 0.);
+    EXPECT_DOUBLE_EQ(math::Generator3D(5.f)(1., 2., 3.), 5.);
+}
+
+TEST_F(MathGenerator, CopyIsShared) {
+    auto counter = std::make_shared<size_t>(0);
+    math::Generator2D source{math::Generator2D::Functor(CopyCounter(counter))};
+    const size_t copiesAfterCreate = *counter;
+
+    // deep tree
+    math::Generator2D tree = source;
+    for (int i=0; i!=100; ++i) {
+        tree = tree + source;
+    }
+    EXPECT_DOUBLE_EQ(tree(1., 2.), 101. * 3.);
+
+    math::Generator2D copy = tree;
+    math::Generator2D moved = std::move(copy);
+    math::Generator2D assigned;
+    assigned = moved;
+
+    EXPECT_EQ(*counter, copiesAfterCreate);
+    EXPECT_TRUE(assigned.IsShared(tree));
+    EXPECT_TRUE(moved.IsShared(tree));
+    EXPECT_FALSE(tree.IsShared(source));
+    EXPECT_DOUBLE_EQ(assigned(1., 2.), 101. * 3.);
+}
+
+TEST_F(MathGenerator, GradientFallback) {
+    math::Generator2D a([](double x, double y) { return x * x + 3. * y; });
+    EXPECT_FALSE(a.HasGradient());
+
+    const auto g = a.Gradient(2., 1.);
+    EXPECT_DOUBLE_EQ(g.value, 7.);
+    EXPECT_NEAR(g.dx, 4., 1e-6);
+    EXPECT_NEAR(g.dy, 3., 1e-6);
+    EXPECT_DOUBLE_EQ(math::Generator3D().Gradient(1., 2., 3.).dz, 0.);
+}
+
+TEST_F(MathGenerator, GradientOperators) {
+    math::Generator3D a(
+        [](double x, double y, double z) { return x * y + z; },
+        [](double x, double y, double z) { return math::Gradient3<double>{x * y + z, y, x, 1.}; });
+    math::Generator3D b(
+        [](double x, double, double) { return 2. * x; },
+        [](double x, double, double) { return math::Gradient3<double>{2. * x, 2., 0., 0.}; });
+    ASSERT_TRUE(a.HasGradient());
+
+    const auto sum = (a + b + 1.).Gradient(2., 3., 4.);
+    EXPECT_DOUBLE_EQ(sum.value, 10. + 4. + 1.);
+    EXPECT_DOUBLE_EQ(sum.dx, 5.);
+    EXPECT_DOUBLE_EQ(sum.dy, 2.);
+    EXPECT_DOUBLE_EQ(sum.dz, 1.);
+
+    const auto minValue = std::min(a, b).Gradient(2., 3., 4.);
+    EXPECT_DOUBLE_EQ(minValue.value, 4.);
+    EXPECT_DOUBLE_EQ(minValue.dx, 2.);
+    const auto maxValue = std::max(a, b).Gradient(2., 3., 4.);
+    EXPECT_DOUBLE_EQ(maxValue.dy, 2.);
+
+    // the constant operand has zero derivatives
+    const auto clamped = std::max(b, 100.).Gradient(2., 3., 4.);
+    EXPECT_DOUBLE_EQ(clamped.value, 100.);
+    EXPECT_DOUBLE_EQ(clamped.dx, 0.);
+
+    // without the analytic gradient of an operand the result falls back to central differences
+    math::Generator3D c([](double x, double, double) { return x; });
+    EXPECT_FALSE((a + c).HasGradient());
+    EXPECT_NEAR((a + c).Gradient(2., 3., 4.).dx, 4., 1e-6);
+}
+
+TEST_F(MathGenerator, Bounds) {
+    using Interval = math::Interval<double>;
+    const Interval box{-1., 1.};
+
+    math::Generator2D unknown([](double x, double y) { return x * y; });
+    EXPECT_FALSE(unknown.HasBounds());
+    EXPECT_FALSE(unknown.Bounds(box, box).IsBounded());
+
+    math::Generator2D bounded([](double x, double y) { return x * y; });
+    bounded.SetBounds([](Interval x, Interval y) {
+        return Interval{-std::max(std::abs(x.lower), std::abs(x.upper)) * std::max(std::abs(y.lower), std::abs(y.upper)),
+            std::max(std::abs(x.lower), std::abs(x.upper)) * std::max(std::abs(y.lower), std::abs(y.upper))};
+    });
+
+    const auto sum = (bounded + math::Generator2D(2.0)).Bounds(box, box);
+    EXPECT_DOUBLE_EQ(sum.lower, 1.);
+    EXPECT_DOUBLE_EQ(sum.upper, 3.);
+
+    // the constant narrows the unknown generator from one side
+    const auto clamped = std::max(unknown, 0.5).Bounds(box, box);
+    EXPECT_DOUBLE_EQ(clamped.lower, 0.5);
+    EXPECT_FALSE(clamped.IsBounded());
+
+    const auto minValue = std::min(bounded, unknown).Bounds(box, box);
+    EXPECT_DOUBLE_EQ(minValue.upper, 1.);
+    EXPECT_FALSE((bounded + unknown).HasBounds());
+
+    // the copy keeps the bounds
+    math::Generator2D copy = bounded;
+    EXPECT_DOUBLE_EQ(copy.Bounds(box, Interval{0., 0.5}).upper, 0.5);
+}
+
+}
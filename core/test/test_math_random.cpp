@@ -0,0 +1,113 @@
+#include <array>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include "test/test.h"
+#include "core/math/random.h"
+
+
+namespace {
+
+class MathRandom : public ::testing::Test {
+};
+
+// known answers of Random123 (kat_vectors, philox4x32_10)
+TEST_F(MathRandom, PhiloxKnownAnswers) {
+    using Block = std::array<uint32_t, 4>;
+    EXPECT_EQ(RandBlock(0, 0, 0), (Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    EXPECT_EQ(RandBlock(UINT64_MAX, UINT64_MAX, UINT64_MAX), (Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    EXPECT_EQ(RandBlock(0x299f31d0a4093822, 0x0370734413198a2e, 0x85a308d3243f6a88), (Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+TEST_F(MathRandom, Scalars) {
+    const auto block = RandBlock(5, 3, 10);
+    for (uint64_t i=0; i!=4; ++i) {
+        EXPECT_EQ(Rand<uint32_t>(5, 3, 40 + i), block[i]);
+    }
+    EXPECT_EQ(Rand<uint64_t>(5, 3, 21), (static_cast<uint64_t>(block[3]) << 32) | block[2]);
+
+    // other seed, stream and index
+    EXPECT_NE(Rand<uint64_t>(5, 3, 0), Rand<uint64_t>(6, 3, 0));
+    EXPECT_NE(Rand<uint64_t>(5, 3, 0), Rand<uint64_t>(5, 4, 0));
+    EXPECT_NE(Rand<uint64_t>(5, 3, 0), Rand<uint64_t>(5, 3, 1));
+
+    double sumFloat = 0;
+    double sumDouble = 0;
+    const uint64_t count = 100000;
+    for (uint64_t i=0; i!=count; ++i) {
+        const float f = Rand<float>(1, 2, i);
+        const double d = Rand<double>(1, 2, i);
+        ASSERT_GE(f, 0.f);
+        ASSERT_LT(f, 1.f);
+        ASSERT_GE(d, 0.);
+        ASSERT_LT(d, 1.);
+        sumFloat += static_cast<double>(f);
+        sumDouble += d;
+
+        const float v = LinearRand<float>(1, 2, i, -3.f, 5.f);
+        ASSERT_GE(v, -3.f);
+        ASSERT_LT(v, 5.f);
+    }
+    EXPECT_NEAR(sumFloat / static_cast<double>(count), 0.5, 0.01);
+    EXPECT_NEAR(sumDouble / static_cast<double>(count), 0.5, 0.01);
+}
+
+TEST_F(MathRandom, BatchMatchesScalar) {
+    const std::vector<std::pair<uint64_t, size_t>> ranges = {{0, 0}, {0, 3}, {0, 100}, {1, 31}, {3, 200}, {1001, 67}};
+    for (const auto& [firstIndex, count]: ranges) {
+        std::vector<float> floats(count);
+        std::vector<float> expected;
+        RandFill(7, 11, firstIndex, floats.data(), count);
+        for (size_t i=0; i!=count; ++i) {
+            expected.push_back(Rand<float>(7, 11, firstIndex + i));
+        }
+        ASSERT_EQ(floats, expected);
+
+        std::vector<dg::float3> vectors(count);
+        RandFill(7, 11, firstIndex, vectors.data(), count);
+        std::vector<float> components;
+        expected.clear();
+        for (size_t i=0; i!=count; ++i) {
+            const auto v = Rand<dg::float3>(7, 11, firstIndex + i);
+            expected.insert(expected.end(), {v.x, v.y, v.z});
+            components.insert(components.end(), {vectors[i].x, vectors[i].y, vectors[i].z});
+        }
+        ASSERT_EQ(components, expected);
+
+        LinearRandFill(7, 11, firstIndex, 2.f, 4.f, floats.data(), count);
+        expected.clear();
+        for (size_t i=0; i!=count; ++i) {
+            expected.push_back(LinearRand<float>(7, 11, firstIndex + i, 2.f, 4.f));
+        }
+        ASSERT_EQ(floats, expected);
+    }
+}
+
+// the parts of the sequence are generated by threads, the result doesn't depend on the thread count
+TEST_F(MathRandom, Threads) {
+    const size_t count = 10000;
+    std::vector<float> expected(count);
+    RandFill(42, 0, 0, expected.data(), count);
+
+    for (size_t threadCount=2; threadCount!=5; ++threadCount) {
+        std::vector<float> result(count);
+        std::vector<std::thread> threads;
+        const size_t partSize = (count + threadCount - 1) / threadCount;
+        for (size_t i=0; i!=threadCount; ++i) {
+            threads.emplace_back([&result, count, partSize, i]() {
+                const size_t first = std::min(i * partSize, count);
+                const size_t last = std::min(first + partSize, count);
+                RandFill(42, 0, first, result.data() + first, last - first);
+            });
+        }
+        for (auto& thread: threads) {
+            thread.join();
+        }
+        ASSERT_EQ(result, expected);
+    }
+}
+
+}
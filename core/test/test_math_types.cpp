@@ -66,4 +66,15 @@ TYPED_TEST(MathTypes, PlaneByPointAndTwoVec) {
     EXPECT_PLANE(planeActual, planeExpected);
 }
 
+TYPED_TEST(MathTypes, RectIntersects) {
+    const auto rect = math::RectT<TypeParam>(0, 0, 10, 10);
+
+    EXPECT_TRUE(rect.Intersects(math::RectT<TypeParam>(5, 5, 10, 10)));
+    EXPECT_TRUE(rect.Intersects(math::RectT<TypeParam>(2, 2, 1, 1)));
+    EXPECT_TRUE(math::RectT<TypeParam>(2, 2, 1, 1).Intersects(rect));
+    EXPECT_FALSE(rect.Intersects(math::RectT<TypeParam>(10, 0, 5, 5)));
+    EXPECT_FALSE(rect.Intersects(math::RectT<TypeParam>(-6, 2, 5, 5)));
+    EXPECT_FALSE(rect.Intersects(math::RectT<TypeParam>(2, 11, 5, 5)));
+}
+
 }
@@ -19,4 +19,14 @@ TEST(Items, Generate) {
     ASSERT_EQ("a,b,c,", out);
 }
 
+TEST(Items, GenerateTextureArrays) {
+    Items items;
+    items.SetData({"texB", "texA", "texB"});
+
+    std::string out;
+    items.GenerateTextureArrays("Sampler", out);
+
+    ASSERT_EQ("Texture2DArray texA;\nSamplerState texASampler;\nTexture2DArray texB;\nSamplerState texBSampler;\n", out);
+}
+
 }
@@ -0,0 +1,68 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include "test/test.h"
+#include "core/common/parallel_for.h"
+
+
+namespace {
+
+TEST(ParallelFor, ResolveThreadCount) {
+    ASSERT_EQ(3, ResolveThreadCount(3, 10));
+    ASSERT_EQ(2, ResolveThreadCount(3, 2));
+    ASSERT_EQ(1, ResolveThreadCount(3, 0));
+    ASSERT_EQ(std::min(std::max(std::thread::hardware_concurrency(), 1u), 4u), ResolveThreadCount(0, 4));
+}
+
+TEST(ParallelFor, EachIndexOnce) {
+    for (const uint32_t threadCount: {1u, 2u, 4u, 8u}) {
+        std::vector<std::atomic<uint32_t>> calls(1000);
+        ParallelFor(calls.size(), threadCount, [&calls](size_t index) {
+            calls[index].fetch_add(1);
+        });
+        for (const auto& count: calls) {
+            ASSERT_EQ(1, count.load());
+        }
+    }
+}
+
+TEST(ParallelFor, ReuseWorkers) {
+    WorkerPool workers(4);
+    ASSERT_EQ(4, workers.GetThreadCount());
+
+    for (size_t loop=0; loop!=50; ++loop) {
+        const size_t count = loop % 7;
+        std::vector<std::atomic<uint32_t>> calls(count);
+        workers.ParallelFor(count, [&calls](size_t index) {
+            calls[index].fetch_add(1);
+        });
+        for (const auto& value: calls) {
+            ASSERT_EQ(1, value.load());
+        }
+    }
+}
+
+TEST(ParallelFor, RethrowException) {
+    WorkerPool workers(4);
+    std::atomic<uint32_t> callCount(0);
+    ASSERT_THROW(workers.ParallelFor(1000, [&callCount](size_t index) {
+        callCount.fetch_add(1);
+        if (index == 10) {
+            throw std::runtime_error("test");
+        }
+    }), std::runtime_error);
+    ASSERT_LE(callCount.load(), 1000);
+
+    // the pool works after the exception
+    callCount = 0;
+    workers.ParallelFor(100, [&callCount](size_t) {
+        callCount.fetch_add(1);
+    });
+    ASSERT_EQ(100, callCount.load());
+}
+
+}
@@ -0,0 +1,71 @@
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <fstream>
+#include <filesystem>
+
+#include "test/test.h"
+#include "core/path/path.h"
+#include "core/common/exception.h"
+
+
+namespace {
+
+class FileManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_dir = std::filesystem::temp_directory_path() / "terra_file_manager_test";
+        std::filesystem::create_directories(m_dir);
+        std::ofstream(m_dir / "data.txt") << "file data";
+        std::ofstream(m_dir / "empty.txt");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_dir);
+    }
+
+protected:
+    std::filesystem::path m_dir;
+};
+
+TEST_F(FileManagerTest, MapFile) {
+    FileManager fileManager;
+    fileManager.AddRootAlias("$test", m_dir);
+
+    auto view = fileManager.MapFile("$test/data.txt");
+    ASSERT_EQ(view.View(), "file data");
+    auto copy = view;
+    view.Reset();
+    ASSERT_TRUE(view.IsEmpty());
+    ASSERT_EQ(copy.View(), "file data");
+
+    ASSERT_TRUE(fileManager.MapFile(m_dir / "empty.txt").IsEmpty());
+    ASSERT_EQ(fileManager.ReadFullFile("$test/data.txt"), "file data");
+
+    FileView missing;
+    std::string error;
+    ASSERT_FALSE(fileManager.MapFile("$test/missing.txt", missing, error));
+    ASSERT_FALSE(error.empty());
+}
+
+TEST_F(FileManagerTest, ReadAsync) {
+    FileManager fileManager;
+    auto data = fileManager.ReadFileAsync(m_dir / "data.txt");
+    auto missing = fileManager.ReadFileAsync(m_dir / "missing.txt");
+    ASSERT_EQ(data.get().View(), "file data");
+    ASSERT_THROW(missing.get(), EngineError);
+
+    std::atomic<uint32_t> completed = 0;
+    {
+        FileManager callbackManager;
+        for (uint32_t i=0; i!=10; ++i) {
+            callbackManager.ReadFileAsync(m_dir / "data.txt", [&completed](FileView&& /* view */, const std::string& /* error */) {
+                ++completed;
+            });
+        }
+    }
+    // the destructor completes all requests
+    ASSERT_EQ(completed.load(), 10);
+}
+
+}
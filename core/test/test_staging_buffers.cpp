@@ -0,0 +1,78 @@
+#include <cstdint>
+
+#include "test/test.h"
+#include "core/material/staging_buffers.h"
+
+
+namespace {
+
+TEST(StagingBuffers, ReuseReleased) {
+    StagingBuffers buffers;
+    uint8_t* first = buffers.Acquire(64);
+    ASSERT_NE(first, nullptr);
+    buffers.Release(first);
+
+    ASSERT_EQ(first, buffers.Acquire(32));
+    ASSERT_EQ(1, buffers.GetBufferCount());
+    ASSERT_EQ(64, buffers.GetMemorySize());
+}
+
+TEST(StagingBuffers, AcquiredAreNotShared) {
+    StagingBuffers buffers;
+    uint8_t* first = buffers.Acquire(16);
+    uint8_t* second = buffers.Acquire(16);
+    uint8_t* third = buffers.Acquire(16);
+    ASSERT_NE(first, second);
+    ASSERT_NE(first, third);
+    ASSERT_NE(second, third);
+    ASSERT_EQ(3, buffers.GetBufferCount());
+    ASSERT_EQ(3, buffers.GetAcquiredCount());
+
+    // the released buffer is given to the next lock, the others stay with their owners
+    buffers.Release(second);
+    ASSERT_EQ(2, buffers.GetAcquiredCount());
+    ASSERT_EQ(second, buffers.Acquire(8));
+    ASSERT_EQ(3, buffers.GetBufferCount());
+
+    // the unknown and the second release are ignored
+    const uint8_t unknown = 0;
+    buffers.Release(&unknown);
+    buffers.Release(first);
+    buffers.Release(first);
+    ASSERT_EQ(2, buffers.GetAcquiredCount());
+}
+
+TEST(StagingBuffers, FreeReleased) {
+    StagingBuffers buffers;
+    uint8_t* first = buffers.Acquire(16);
+    uint8_t* second = buffers.Acquire(32);
+    buffers.Release(first);
+
+    // the acquired buffer stays valid
+    buffers.FreeReleased();
+    ASSERT_EQ(1, buffers.GetBufferCount());
+    ASSERT_EQ(32, buffers.GetMemorySize());
+    second[31] = 1;
+    buffers.Release(second);
+    ASSERT_EQ(0, buffers.GetAcquiredCount());
+
+    buffers.FreeReleased();
+    ASSERT_EQ(0, buffers.GetBufferCount());
+    ASSERT_EQ(0, buffers.GetMemorySize());
+}
+
+TEST(StagingBuffers, Grow) {
+    StagingBuffers buffers;
+    uint8_t* data = buffers.Acquire(16);
+    data[15] = 1;
+    buffers.Release(data);
+
+    data = buffers.Acquire(1024);
+    data[1023] = 1;
+    ASSERT_EQ(1, buffers.GetBufferCount());
+    ASSERT_EQ(1024, buffers.GetMemorySize());
+    buffers.Release(data);
+    ASSERT_EQ(0, buffers.GetAcquiredCount());
+}
+
+}
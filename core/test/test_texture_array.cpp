@@ -0,0 +1,87 @@
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "test/test.h"
+#include "core/material/texture_array.h"
+
+
+namespace {
+
+class TextureArray : public ::testing::Test {
+};
+
+DecodedTexture MakeTexture(uint32_t width, uint32_t height, uint8_t value) {
+    DecodedTexture texture;
+    texture.isSRGB = false;
+    TextureMip mip{width, height, std::vector<uint8_t>(static_cast<size_t>(width) * height * 4, value)};
+    // the last texel differs, to check the edge padding
+    mip.texels[mip.texels.size() - 4] = static_cast<uint8_t>(value + 1);
+    texture.mips.push_back(std::move(mip));
+
+    return texture;
+}
+
+TEST_F(TextureArray, Slots) {
+    const auto big = MakeTexture(8, 4, 10);
+    const auto small = MakeTexture(2, 2, 20);
+    const auto packed = PackTextureArray({&big, &small});
+
+    ASSERT_EQ(packed.slices.size(), 2);
+    ASSERT_EQ(packed.slots.size(), 2);
+    ASSERT_EQ(packed.slots[0].slice, 0);
+    ASSERT_EQ(packed.slots[1].slice, 1);
+    ASSERT_FLOAT_EQ(packed.slots[0].uvRect.w, 1.f);
+    ASSERT_FLOAT_EQ(packed.slots[0].uvRect.h, 1.f);
+    ASSERT_FLOAT_EQ(packed.slots[1].uvRect.x, 0.f);
+    ASSERT_FLOAT_EQ(packed.slots[1].uvRect.w, 0.25f);
+    ASSERT_FLOAT_EQ(packed.slots[1].uvRect.h, 0.5f);
+
+    for (const auto& slice: packed.slices) {
+        ASSERT_EQ(slice.mips.size(), 1);
+        ASSERT_EQ(slice.mips[0].width, 8);
+        ASSERT_EQ(slice.mips[0].height, 4);
+    }
+    ASSERT_EQ(packed.ByteSize(), 8 * 4 * 4 * 2);
+
+    // the padding repeats the edge texels of the small texture
+    const auto& texels = packed.slices[1].mips[0].texels;
+    ASSERT_EQ(texels[(0 * 8 + 7) * 4], 20);
+    ASSERT_EQ(texels[(1 * 8 + 1) * 4], 21);
+    ASSERT_EQ(texels[(1 * 8 + 7) * 4], 21);
+    ASSERT_EQ(texels[(3 * 8 + 5) * 4], 21);
+}
+
+TEST_F(TextureArray, Mips) {
+    auto big = MakeTexture(8, 8, 10);
+    GenerateMips(big);
+    const auto small = MakeTexture(4, 2, 20);
+    const auto packed = PackTextureArray({&small, &big});
+
+    ASSERT_EQ(packed.slices.size(), 2);
+    for (const auto& slice: packed.slices) {
+        ASSERT_EQ(slice.mips.size(), 4);
+        ASSERT_EQ(slice.mips[3].width, 1);
+    }
+    ASSERT_EQ(packed.slices[1].mips[0].texels, big.mips[0].texels);
+}
+
+TEST_F(TextureArray, Mismatch) {
+    const auto rgba = MakeTexture(4, 4, 10);
+    auto srgb = MakeTexture(4, 4, 10);
+    srgb.isSRGB = true;
+    ASSERT_ANY_THROW(PackTextureArray({&rgba, &srgb}));
+    ASSERT_ANY_THROW(PackTextureArray({}));
+
+    DecodedTexture bc1;
+    bc1.isSRGB = false;
+    bc1.format = BlockFormat::BC1;
+    bc1.mips.push_back(TextureMip{4, 4, std::vector<uint8_t>(8)});
+    DecodedTexture bc1Big = bc1;
+    bc1Big.mips[0] = TextureMip{8, 4, std::vector<uint8_t>(16)};
+    ASSERT_ANY_THROW(PackTextureArray({&bc1, &rgba}));
+    ASSERT_ANY_THROW(PackTextureArray({&bc1, &bc1Big}));
+    ASSERT_EQ(PackTextureArray({&bc1, &bc1}).slices.size(), 2);
+}
+
+}
@@ -0,0 +1,129 @@
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "test/test.h"
+#include "core/math/random.h"
+#include "core/material/texture_compressor.h"
+
+
+namespace {
+
+class TextureCompressor : public ::testing::Test {
+};
+
+constexpr const BlockFormat Formats[] = {BlockFormat::BC1, BlockFormat::BC4, BlockFormat::BC5, BlockFormat::BC7};
+constexpr const CompressionQuality Qualities[] = {CompressionQuality::Fast, CompressionQuality::Normal, CompressionQuality::High};
+
+// smooth color gradients with the alpha ramp
+std::vector<uint8_t> MakeGradient(uint32_t width, uint32_t height) {
+    std::vector<uint8_t> texels(static_cast<size_t>(width) * height * 4);
+    for (uint32_t y=0; y!=height; ++y) {
+        for (uint32_t x=0; x!=width; ++x) {
+            uint8_t* texel = &texels[(static_cast<size_t>(y) * width + x) * 4];
+            texel[0] = static_cast<uint8_t>(x * 255 / (width - 1));
+            texel[1] = static_cast<uint8_t>(y * 255 / (height - 1));
+            texel[2] = static_cast<uint8_t>(std::lround(127.5 + 127.5 * std::sin(static_cast<double>(x + y) * 0.05)));
+            texel[3] = static_cast<uint8_t>((x + y) * 255 / (width + height - 2));
+        }
+    }
+
+    return texels;
+}
+
+std::vector<uint8_t> MakeNoise(uint32_t width, uint32_t height) {
+    std::vector<uint8_t> texels(static_cast<size_t>(width) * height * 4);
+    for (size_t i=0; i!=texels.size(); ++i) {
+        texels[i] = static_cast<uint8_t>(Rand<uint32_t>(7, 0, i) & 0xFF);
+    }
+
+    return texels;
+}
+
+// RMSE of the channels, that are kept by the format
+double CompressError(const std::vector<uint8_t>& texels, uint32_t width, uint32_t height, BlockFormat format, CompressionQuality quality) {
+    std::vector<uint8_t> blocks(CalcCompressedSize(format, width, height));
+    CompressTexture(TextureCompressorDesc{format, quality, 1}, texels.data(), width, height, width * 4, blocks.data());
+    std::vector<uint8_t> decoded(texels.size());
+    DecompressTexture(format, blocks.data(), width, height, decoded.data());
+
+    const uint32_t channels[] = {3, 1, 2, 4};
+    return CalcRMSE(decoded.data(), texels.data(), static_cast<size_t>(width) * height, channels[static_cast<size_t>(format) - 1]);
+}
+
+TEST_F(TextureCompressor, Sizes) {
+    ASSERT_EQ(CalcCompressedSize(BlockFormat::None, 5, 3), 60);
+    ASSERT_EQ(CalcCompressedSize(BlockFormat::BC1, 8, 8), 32);
+    ASSERT_EQ(CalcCompressedSize(BlockFormat::BC4, 5, 3), 16);
+    ASSERT_EQ(CalcCompressedSize(BlockFormat::BC5, 1, 1), 16);
+    ASSERT_EQ(CalcCompressedSize(BlockFormat::BC7, 12, 4), 48);
+}
+
+TEST_F(TextureCompressor, SolidColor) {
+    // the color is exact in RGB565
+    const std::vector<uint8_t> texels = {8, 4, 16, 255, 8, 4, 16, 255, 8, 4, 16, 255, 8, 4, 16, 255};
+    for (const auto format: Formats) {
+        for (const auto quality: Qualities) {
+            ASSERT_LE(CompressError(texels, 2, 2, format, quality), 0.5) << static_cast<uint32_t>(format);
+        }
+    }
+}
+
+TEST_F(TextureCompressor, GradientError) {
+    const uint32_t size = 64;
+    const auto texels = MakeGradient(size, size);
+    const double maxErrors[] = {4.0, 1.5, 1.5, 3.0};
+    for (const auto format: Formats) {
+        for (const auto quality: Qualities) {
+            const double error = CompressError(texels, size, size, format, quality);
+            ASSERT_LE(error, maxErrors[static_cast<size_t>(format) - 1]) << static_cast<uint32_t>(format) << " " << static_cast<uint32_t>(quality);
+        }
+    }
+}
+
+TEST_F(TextureCompressor, QualityPresets) {
+    const uint32_t size = 32;
+    const auto texels = MakeNoise(size, size);
+    for (const auto format: Formats) {
+        const double fast = CompressError(texels, size, size, format, CompressionQuality::Fast);
+        const double normal = CompressError(texels, size, size, format, CompressionQuality::Normal);
+        const double high = CompressError(texels, size, size, format, CompressionQuality::High);
+        ASSERT_LE(normal, fast) << static_cast<uint32_t>(format);
+        ASSERT_LE(high, normal) << static_cast<uint32_t>(format);
+    }
+}
+
+TEST_F(TextureCompressor, PartialBlocksAndThreads) {
+    const uint32_t width = 37;
+    const uint32_t height = 21;
+    const auto texels = MakeGradient(width, height);
+    for (const auto format: Formats) {
+        std::vector<uint8_t> single(CalcCompressedSize(format, width, height));
+        std::vector<uint8_t> parallel(single.size());
+        CompressTexture(TextureCompressorDesc{format, CompressionQuality::Normal, 1}, texels.data(), width, height, width * 4, single.data());
+        CompressTexture(TextureCompressorDesc{format, CompressionQuality::Normal, 4}, texels.data(), width, height, width * 4, parallel.data());
+        ASSERT_EQ(single, parallel);
+    }
+
+    ASSERT_LE(CompressError(texels, width, height, BlockFormat::BC7, CompressionQuality::Normal), 5.0);
+}
+
+TEST_F(TextureCompressor, Mips) {
+    DecodedTexture texture;
+    texture.isSRGB = false;
+    texture.mips.push_back(TextureMip{16, 8, MakeGradient(16, 8)});
+    GenerateMips(texture);
+    CompressMips(texture, TextureCompressorDesc{BlockFormat::BC5, CompressionQuality::Fast, 0});
+
+    ASSERT_EQ(texture.format, BlockFormat::BC5);
+    ASSERT_EQ(texture.mips.size(), 5);
+    ASSERT_EQ(texture.mips[0].texels.size(), 128);
+    ASSERT_EQ(texture.mips[4].texels.size(), 16);
+    ASSERT_EQ(texture.ByteSize(), 128 + 32 + 16 + 16 + 16);
+
+    ASSERT_ANY_THROW(GenerateMips(texture));
+    ASSERT_ANY_THROW(CompressMips(texture, TextureCompressorDesc()));
+}
+
+}
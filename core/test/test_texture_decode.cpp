@@ -0,0 +1,159 @@
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <condition_variable>
+
+#include "test/test.h"
+#include "core/common/exception.h"
+#include "core/material/texture_decoder.h"
+#include "core/material/texture_decode_queue.h"
+
+
+namespace {
+
+class TextureDecode : public ::testing::Test {
+};
+
+TextureMip MakeMip(uint32_t width, uint32_t height, uint8_t value) {
+    TextureMip mip;
+    mip.width = width;
+    mip.height = height;
+    mip.texels.assign(static_cast<size_t>(width) * static_cast<size_t>(height) * 4, value);
+
+    return mip;
+}
+
+// the size of the image is encoded in the path: "<width>x<height>", "fail" - decoder error
+DecodedTexture FakeDecode(const TextureLoadDesc& desc) {
+    const std::string name = desc.path.string();
+    if (name == "fail") {
+        throw EngineError("FakeDecode: broken file");
+    }
+    const auto pos = name.find('x');
+    DecodedTexture result;
+    result.mips.push_back(MakeMip(static_cast<uint32_t>(std::stoul(name.substr(0, pos))), static_cast<uint32_t>(std::stoul(name.substr(pos + 1))), 200));
+
+    return result;
+}
+
+TEST_F(TextureDecode, MipChain) {
+    DecodedTexture texture;
+    texture.isSRGB = false;
+    texture.mips.push_back(MakeMip(8, 3, 0));
+    GenerateMips(texture);
+
+    ASSERT_EQ(texture.mips.size(), 4);
+    const uint32_t sizes[4][2] = {{8, 3}, {4, 1}, {2, 1}, {1, 1}};
+    for (size_t i=0; i!=texture.mips.size(); ++i) {
+        ASSERT_EQ(texture.mips[i].width, sizes[i][0]);
+        ASSERT_EQ(texture.mips[i].height, sizes[i][1]);
+        ASSERT_EQ(texture.mips[i].texels.size(), sizes[i][0] * sizes[i][1] * 4);
+    }
+    ASSERT_EQ(texture.ByteSize(), (24 + 4 + 2 + 1) * 4);
+
+    // the existing mips are replaced
+    GenerateMips(texture);
+    ASSERT_EQ(texture.mips.size(), 4);
+
+    ASSERT_ANY_THROW(GenerateMips(texture = DecodedTexture()));
+}
+
+TEST_F(TextureDecode, MipFilter) {
+    // black and white columns, alpha is 0 and 255 too
+    DecodedTexture texture;
+    texture.mips.push_back(MakeMip(2, 2, 0));
+    for (size_t y=0; y!=2; ++y) {
+        for (size_t c=0; c!=4; ++c) {
+            texture.mips[0].texels[y * 8 + 4 + c] = 255;
+        }
+    }
+
+    texture.isSRGB = false;
+    GenerateMips(texture);
+    ASSERT_EQ(texture.mips[1].texels, std::vector<uint8_t>({128, 128, 128, 128}));
+
+    // the average of the linear values 0 and 1 is 0.5, it is 188 in sRGB, alpha is linear
+    texture.isSRGB = true;
+    GenerateMips(texture);
+    ASSERT_EQ(texture.mips[1].texels, std::vector<uint8_t>({188, 188, 188, 128}));
+}
+
+TEST_F(TextureDecode, QueueStates) {
+    TextureDecodeQueue queue(FakeDecode, 2);
+    const uint32_t ok = queue.Push(TextureLoadDesc{"16x8", true, true});
+    const uint32_t noMips = queue.Push(TextureLoadDesc{"4x4", false, false});
+    const uint32_t failed = queue.Push(TextureLoadDesc{"fail", true, true});
+    queue.WaitIdle();
+
+    ASSERT_EQ(queue.GetState(ok), TextureLoadState::Uploading);
+    ASSERT_EQ(queue.GetState(noMips), TextureLoadState::Uploading);
+    ASSERT_EQ(queue.GetState(failed), TextureLoadState::Failed);
+    ASSERT_NE(queue.GetError(failed).find("broken file"), std::string::npos);
+    ASSERT_EQ(queue.GetState(100), TextureLoadState::None);
+
+    uint32_t id = 0;
+    DecodedTexture texture;
+    for (size_t i=0; i!=2; ++i) {
+        ASSERT_TRUE(queue.Pop(id, texture));
+        if (id == ok) {
+            ASSERT_EQ(texture.mips.size(), 5);
+            ASSERT_TRUE(texture.isSRGB);
+        } else {
+            ASSERT_EQ(id, noMips);
+            ASSERT_EQ(texture.mips.size(), 1);
+            ASSERT_FALSE(texture.isSRGB);
+        }
+    }
+    ASSERT_FALSE(queue.Pop(id, texture));
+
+    queue.Finish(ok, TextureLoadState::Ready);
+    ASSERT_EQ(queue.GetState(ok), TextureLoadState::Ready);
+    ASSERT_FALSE(queue.Cancel(ok));
+    queue.Erase(ok);
+    ASSERT_EQ(queue.GetState(ok), TextureLoadState::None);
+}
+
+TEST_F(TextureDecode, QueueCancel) {
+    // the decoder waits for the signal, so the first texture is decoding and the next ones are queued
+    std::mutex mutex;
+    std::condition_variable signal;
+    bool isReleased = false;
+    std::atomic<uint32_t> decodedCount(0);
+    TextureDecodeQueue queue([&](const TextureLoadDesc& desc) {
+        std::unique_lock<std::mutex> lock(mutex);
+        signal.wait(lock, [&isReleased]() { return isReleased; });
+        ++decodedCount;
+        return FakeDecode(desc);
+    }, 1);
+
+    const uint32_t decoding = queue.Push(TextureLoadDesc{"2x2", true, true});
+    const uint32_t queued = queue.Push(TextureLoadDesc{"2x2", true, true});
+    const uint32_t kept = queue.Push(TextureLoadDesc{"2x2", true, true});
+    ASSERT_TRUE(queue.Cancel(queued));
+    ASSERT_EQ(queue.GetState(queued), TextureLoadState::Canceled);
+
+    while (queue.GetState(decoding) != TextureLoadState::Decoding) {
+        std::this_thread::yield();
+    }
+    ASSERT_TRUE(queue.Cancel(decoding));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isReleased = true;
+    }
+    signal.notify_all();
+    queue.WaitIdle();
+
+    // the canceled texture in progress is decoded, but dropped, the queued one isn't decoded
+    ASSERT_EQ(decodedCount.load(), 2);
+    uint32_t id = 0;
+    DecodedTexture texture;
+    ASSERT_TRUE(queue.Pop(id, texture));
+    ASSERT_EQ(id, kept);
+    ASSERT_FALSE(queue.Pop(id, texture));
+    ASSERT_EQ(queue.GetState(decoding), TextureLoadState::Canceled);
+}
+
+}
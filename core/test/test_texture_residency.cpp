@@ -0,0 +1,182 @@
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "test/test.h"
+#include "core/common/exception.h"
+#include "core/material/texture_residency.h"
+
+
+namespace {
+
+class TextureResidencyTest : public ::testing::Test {
+};
+
+TEST_F(TextureResidencyTest, CalcMemory) {
+    ASSERT_EQ(CalcTextureMemory(4, 4, 1, 4), 64);
+    ASSERT_EQ(CalcTextureMemory(4, 4, 0, 4), (16 + 4 + 1) * 4);
+    ASSERT_EQ(CalcTextureMemory(8, 2, 0, 1), 16 + 4 + 2 + 1);
+    ASSERT_EQ(CalcTextureMemory(8, 2, 2, 1), 16 + 4);
+}
+
+TEST_F(TextureResidencyTest, EvictLeastRecentlyUsed) {
+    TextureResidency residency(250);
+    std::vector<uint32_t> evicted;
+    auto add = [&residency, &evicted](uint32_t index) {
+        return residency.Add(100, [&evicted, index]() { evicted.push_back(index); return static_cast<size_t>(0); });
+    };
+    const uint32_t t0 = add(0);
+    const uint32_t t1 = add(1);
+    const uint32_t t2 = add(2);
+    ASSERT_EQ(residency.GetCounters().usage, 300);
+
+    // the textures used in the current and the previous frames are kept
+    residency.Trim();
+    residency.NextFrame();
+    residency.Trim();
+    ASSERT_TRUE(evicted.empty());
+
+    residency.NextFrame();
+    residency.Touch(t0);
+    residency.Trim();
+    ASSERT_EQ(evicted, std::vector<uint32_t>({1}));
+
+    auto counters = residency.GetCounters();
+    ASSERT_EQ(counters.budget, 250);
+    ASSERT_EQ(counters.usage, 200);
+    ASSERT_EQ(counters.textures, 3);
+    ASSERT_EQ(counters.evictedTextures, 1);
+
+    // restore of the evicted texture
+    residency.SetSize(t1, 100);
+    residency.NextFrame();
+    residency.NextFrame();
+    residency.Touch(t1);
+    residency.Trim();
+    ASSERT_EQ(evicted, std::vector<uint32_t>({1, 2}));
+    counters = residency.GetCounters();
+    ASSERT_EQ(counters.usage, 200);
+    ASSERT_EQ(counters.restores, 1);
+
+    residency.Remove(t0);
+    residency.Remove(t2);
+    counters = residency.GetCounters();
+    ASSERT_EQ(counters.usage, 100);
+    ASSERT_EQ(counters.textures, 1);
+}
+
+TEST_F(TextureResidencyTest, EvictMips) {
+    // the evictor drops the top mip, until the texture is 4 bytes
+    TextureResidency residency(20);
+    size_t size = CalcTextureMemory(8, 8, 0, 1);
+    uint32_t width = 8;
+    residency.Add(size, [&size, &width]() {
+        if (width > 2) {
+            size -= static_cast<size_t>(width) * width;
+            width /= 2;
+        }
+        return size;
+    });
+    const uint32_t other = residency.Add(10, []() { return static_cast<size_t>(0); });
+
+    residency.NextFrame();
+    residency.NextFrame();
+    residency.Touch(other);
+    residency.Trim();
+    auto counters = residency.GetCounters();
+    ASSERT_EQ(width, 2);
+    ASSERT_EQ(counters.evictedMips, 2);
+    ASSERT_EQ(counters.evictedTextures, 0);
+    ASSERT_EQ(counters.usage, CalcTextureMemory(2, 2, 0, 1) + 10);
+
+    // nothing to evict, the usage stays over the budget
+    residency.SetBudget(5);
+    residency.Trim();
+    ASSERT_EQ(residency.GetCounters().evictedMips, 2);
+    ASSERT_EQ(residency.GetCounters().usage, CalcTextureMemory(2, 2, 0, 1) + 10);
+}
+
+// the owner of the texture, as DynamicTexture
+TEST_F(TextureResidencyTest, RestoreEvictedTexture) {
+    auto residency = std::make_shared<TextureResidency>(50);
+    bool isCreated = true;
+    ResidentTexture texture(residency, 100, [&isCreated]() { isCreated = false; });
+    ASSERT_FALSE(texture.IsEvicted());
+    ASSERT_EQ(residency->GetCounters().usage, 100);
+
+    uint32_t createCount = 0;
+    auto create = [&isCreated, &createCount]() {
+        isCreated = true;
+        ++createCount;
+        return static_cast<size_t>(100);
+    };
+
+    // the resident texture is only marked as used
+    ASSERT_FALSE(texture.Restore(create));
+    ASSERT_EQ(createCount, 0);
+
+    residency->NextFrame();
+    residency->NextFrame();
+    residency->Trim();
+    ASSERT_TRUE(texture.IsEvicted());
+    ASSERT_FALSE(isCreated);
+    ASSERT_EQ(residency->GetCounters().usage, 0);
+    ASSERT_EQ(residency->GetCounters().evictedTextures, 1);
+
+    // the content is lost once
+    ASSERT_TRUE(texture.Restore(create));
+    ASSERT_TRUE(isCreated);
+    ASSERT_FALSE(texture.IsEvicted());
+    ASSERT_FALSE(texture.Restore(create));
+    ASSERT_EQ(createCount, 1);
+    auto counters = residency->GetCounters();
+    ASSERT_EQ(counters.usage, 100);
+    ASSERT_EQ(counters.restores, 1);
+
+    // the restored texture is used in this frame, so it isn't evicted again
+    residency->Trim();
+    ASSERT_FALSE(texture.IsEvicted());
+}
+
+TEST_F(TextureResidencyTest, RestoreFailed) {
+    auto residency = std::make_shared<TextureResidency>(0);
+    ResidentTexture texture(residency, 100, []() {});
+    residency->NextFrame();
+    residency->NextFrame();
+    residency->Trim();
+    ASSERT_TRUE(texture.IsEvicted());
+
+    // the texture stays evicted, the next Restore tries again
+    ASSERT_THROW(texture.Restore([]() -> size_t { throw std::runtime_error("test"); }), std::runtime_error);
+    ASSERT_TRUE(texture.IsEvicted());
+    ASSERT_TRUE(texture.Restore([]() { return static_cast<size_t>(100); }));
+    ASSERT_EQ(residency->GetCounters().usage, 100);
+}
+
+TEST_F(TextureResidencyTest, ResizeEvictedTexture) {
+    auto residency = std::make_shared<TextureResidency>(0);
+    {
+        ResidentTexture texture(residency, 100, []() {});
+        residency->NextFrame();
+        residency->NextFrame();
+        residency->Trim();
+        ASSERT_TRUE(texture.IsEvicted());
+
+        // the resized texture is created again
+        texture.SetSize(40);
+        ASSERT_FALSE(texture.IsEvicted());
+        ASSERT_EQ(residency->GetCounters().usage, 40);
+        ASSERT_FALSE(texture.Restore([]() { return static_cast<size_t>(100); }));
+    }
+    ASSERT_EQ(residency->GetCounters().usage, 0);
+    ASSERT_EQ(residency->GetCounters().textures, 0);
+
+    // without the residency the texture is never evicted
+    ResidentTexture texture(nullptr, 100, []() {});
+    ASSERT_FALSE(texture.Restore([]() { return static_cast<size_t>(100); }));
+    ASSERT_THROW(ResidentTexture(residency, 100, ResidentTexture::Release()), EngineError);
+}
+
+}
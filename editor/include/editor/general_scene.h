@@ -1,15 +1,28 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+#include <cstdint>
+#include <utility>
 
 #include "dg/dg.h"
 #include "core/common/ctor.h"
+#include "core/math/generator_type_fwd.h"
 
 
+class Scatter;
 class StdScene;
+class Material;
+class Geometry;
+struct ScatterDesc;
+class TransformNode;
 class StdMaterial;
 class StdMaterialGrass;
 class GeneralScene : Fixed {
+    struct ScatterNode {
+        std::shared_ptr<Scatter> scatter;
+        std::shared_ptr<TransformNode> node;
+    };
 public:
     GeneralScene() = default;
     ~GeneralScene() = default;
@@ -21,19 +34,27 @@ public:
 
 private:
     void CreateTextures();
+    // replaces the placeholders by the uploaded textures
+    void BindLoadedTextures();
+    void BindBillboardTextures();
     void GenerateGround();
     void GenerateTrees();
     void GenerateGrass();
     void GenerateGrassBillboard();
+    void AddScatter(const std::shared_ptr<Geometry>& geometry, const std::shared_ptr<Material>& material,
+        const ScatterDesc& desc, const math::Generator2D& density);
 
 private:
     // textures
     TextureViewPtr m_TextureGround;
-    TextureViewPtr m_TextureGrass0;
-    TextureViewPtr m_TextureGrass1;
-    TextureViewPtr m_TextureFlower0;
+    // texture array of the billboards: grass0, grass1, flower0
+    TextureViewPtr m_TextureBillboards;
     TextureViewPtr m_TextureGrassBlade0;
     TextureViewPtr m_TextureGrassBlade1;
+    // id of the async load and the texture view, that is waiting for it
+    std::vector<std::pair<uint32_t, TextureViewPtr*>> m_loadingTextures;
+    uint32_t m_billboardArrayId = 0;
+    bool m_isBillboardsLoaded = false;
 
     // materials
     std::shared_ptr<StdMaterial> m_matGroud;
@@ -44,5 +65,6 @@ private:
     std::shared_ptr<StdMaterial> m_matGrassBillboard1;
     std::shared_ptr<StdMaterial> m_matGrassBillboard2;
 
+    std::vector<ScatterNode> m_scatters;
     std::shared_ptr<StdScene> m_scene;
 };
@@ -13,6 +13,7 @@
 #include "platforms/platforms.h"
 #include "middleware/imgui/gui.h"
 #include "editor/editor_scene_controller.h"
+#include "core/material/texture_manager.h"
 #include "core/material/material_builder.h"
 #include "editor/general_scene_controller.h"
 #include "core/material/material_builder_desc.h"
@@ -34,6 +35,11 @@ void Editor::Create() {
 
     auto fileManager = engine.GetFileManager();
     // fileManager->AddRootAlias("$shader", fileManager->CurrentPath() / "materials");
+    // the packed assets (terra_packer) override the loose files, the loose files are used without the archive
+    const auto archivePath = fileManager->CurrentPath() / "assets.tpak";
+    if (std::filesystem::exists(archivePath)) {
+        fileManager->MountArchive(archivePath);
+    }
 
     MaterialBuilderDesc materialDesc;
     materialDesc.samplerSuffix = "Sampler";
@@ -82,7 +88,11 @@ void Editor::Update(double deltaTime) {
     m_performanceCounter.Add(timer.TimePoint());
 
     if (m_performanceCounter.Index() % 30 == 0) {
-        engine.GetWindow()->SetTitle(fmt::format("fps = {:.1f}, update = {:.1f}", engine.GetFps(), m_performanceCounter.Avg() * 1000.).c_str());
+        const auto textures = engine.GetTextureManager()->GetResidencyCounters();
+        const double mb = 1024. * 1024.;
+        engine.GetWindow()->SetTitle(fmt::format("fps = {:.1f}, update = {:.1f}, textures = {:.1f}/{:.0f} MB, evicted = {}",
+            engine.GetFps(), m_performanceCounter.Avg() * 1000., static_cast<double>(textures.usage) / mb, static_cast<double>(textures.budget) / mb,
+            textures.evictedTextures).c_str());
     }
 }
 
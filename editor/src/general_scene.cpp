@@ -1,6 +1,10 @@
 #include "editor/general_scene.h"
 
+#include <cmath>
+#include <vector>
 #include <cstdint>
+#include <utility>
+#include <iterator>
 
 #include "dg/texture.h"
 #include "core/engine.h"
@@ -9,14 +13,15 @@
 #include "dg/graphics_types.h"
 #include "dg/rasterizer_state.h"
 #include "core/math/constants.h"
-#include "dg/texture_utilities.h"
 #include "core/render/vertexes.h"
 #include "core/render/geometry.h"
 #include "core/render/vertex_buffer.h"
 #include "core/render/transform_graph.h"
+#include "core/material/texture_manager.h"
 #include "middleware/std_render/std_scene.h"
 #include "middleware/std_render/std_material.h"
 #include "middleware/generator/mesh_generator.h"
+#include "middleware/generator/scatter/scatter.h"
 
 
 void GeneralScene::Create(const std::shared_ptr<StdScene>& scene) {
@@ -30,6 +35,15 @@ void GeneralScene::Create(const std::shared_ptr<StdScene>& scene) {
 }
 
 void GeneralScene::Update(double /* deltaTime */) {
+    if (!m_loadingTextures.empty() || !m_isBillboardsLoaded) {
+        BindLoadedTextures();
+    }
+    // regenerates only the tiles with the changed density
+    for (auto& item: m_scatters) {
+        if (item.scatter->Update() != 0) {
+            item.node->SetInstances(item.scatter->GetInstances());
+        }
+    }
     m_scene->Update();
 }
 
@@ -38,40 +52,76 @@ void GeneralScene::Draw() {
 }
 
 void GeneralScene::CreateTextures() {
-    auto& device = Engine::Get().GetDevice();
+    auto& textureManager = Engine::Get().GetTextureManager();
+    const std::pair<const char*, TextureViewPtr*> textures[] = {
+        {"assets/ground.jpg", &m_TextureGround},
+        {"assets/blade_0.png", &m_TextureGrassBlade0},
+        {"assets/blade_1.jpg", &m_TextureGrassBlade1},
+    };
+
+    for (const auto& [path, view]: textures) {
+        TextureLoadDesc desc;
+        desc.path = path;
+        desc.isSRGB = true;
+        const uint32_t id = textureManager->LoadTextureAsync(desc);
+        // the placeholder until the texture is uploaded
+        *view = textureManager->GetTextureView(id);
+        m_loadingTextures.emplace_back(id, view);
+    }
 
-    dg::TextureLoadInfo loadInfo;
-    loadInfo.IsSRGB = true;
+    // the billboards share one texture array, the order is the order of the billboard materials
+    std::vector<TextureLoadDesc> billboards(3);
+    billboards[0].path = "assets/grass0.png";
+    billboards[1].path = "assets/grass1.png";
+    billboards[2].path = "assets/flower0.png";
+    m_billboardArrayId = textureManager->LoadTextureArrayAsync(billboards, "tex::billboards");
+    m_TextureBillboards = textureManager->GetTextureArrayView(m_billboardArrayId);
+}
 
-    {
-        TexturePtr Tex;
-        CreateTextureFromFile("assets/ground.jpg", loadInfo, device, &Tex);
-        m_TextureGround = Tex->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE);
-    }
-    {
-        TexturePtr Tex;
-        CreateTextureFromFile("assets/grass0.png", loadInfo, device, &Tex);
-        m_TextureGrass0 = Tex->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE);
+void GeneralScene::BindLoadedTextures() {
+    auto& textureManager = Engine::Get().GetTextureManager();
+    bool isChanged = false;
+    for (auto it = m_loadingTextures.begin(); it != m_loadingTextures.end();) {
+        const auto state = textureManager->GetLoadState(it->first);
+        if (state == TextureLoadState::Ready) {
+            *it->second = textureManager->GetTextureView(it->first);
+            isChanged = true;
+        } else if ((state != TextureLoadState::Failed) && (state != TextureLoadState::Canceled) && (state != TextureLoadState::None)) {
+            ++it;
+            continue;
+        }
+        // the failed textures keep the placeholder
+        it = m_loadingTextures.erase(it);
     }
-    {
-        TexturePtr Tex;
-        CreateTextureFromFile("assets/grass1.png", loadInfo, device, &Tex);
-        m_TextureGrass1 = Tex->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE);
+
+    if (!m_isBillboardsLoaded) {
+        const auto state = textureManager->GetTextureArrayState(m_billboardArrayId);
+        if (state == TextureLoadState::Ready) {
+            m_TextureBillboards = textureManager->GetTextureArrayView(m_billboardArrayId);
+            BindBillboardTextures();
+        }
+        if (state != TextureLoadState::Queued) {
+            m_isBillboardsLoaded = true;
+        }
     }
-    {
-        TexturePtr Tex;
-        CreateTextureFromFile("assets/flower0.png", loadInfo, device, &Tex);
-        m_TextureFlower0 = Tex->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE);
+
+    if (!isChanged) {
+        return;
     }
-    {
-        TexturePtr Tex;
-        CreateTextureFromFile("assets/blade_0.png", loadInfo, device, &Tex);
-        m_TextureGrassBlade0 = Tex->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE);
+    m_matGroud->SetBaseTexture(m_TextureGround);
+    m_matGrass->SetBaseTexture(m_TextureGrassBlade1);
+}
+
+void GeneralScene::BindBillboardTextures() {
+    if (!m_matGrassBillboard0) {
+        return;
     }
-    {
-        TexturePtr Tex;
-        CreateTextureFromFile("assets/blade_1.jpg", loadInfo, device, &Tex);
-        m_TextureGrassBlade1 = Tex->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE);
+
+    auto& textureManager = Engine::Get().GetTextureManager();
+    const std::shared_ptr<StdMaterial> materials[] = {m_matGrassBillboard0, m_matGrassBillboard1, m_matGrassBillboard2};
+    for (size_t i=0; i!=std::size(materials); ++i) {
+        const auto slot = textureManager->GetTextureArraySlot(m_billboardArrayId, static_cast<uint32_t>(i));
+        materials[i]->SetBaseTextureArray(m_TextureBillboards, slot);
     }
 }
 
@@ -92,7 +142,6 @@ void GeneralScene::GenerateGround() {
 
 void GeneralScene::GenerateTrees() {
     auto& device = Engine::Get().GetDevice();
-    RandSeed(17);
 
     auto tree = std::make_shared<TransformNode>();
 
@@ -102,8 +151,11 @@ void GeneralScene::GenerateTrees() {
     m_matTrunk->AmbientDiffuse(true);
     m_matTrunk->SetBaseColor(139, 69, 19);
 
+    ShapeBuilder treeBuilder(device);
+    treeBuilder.SetLods(MeshLodDesc());
+
     CylinderShape trunkShape({5, 1}, math::Axis::Y);
-    auto trunkGeometry = ShapeBuilder(device).Join({&trunkShape}, "trunk");
+    auto trunkGeometry = treeBuilder.Join({&trunkShape}, "trunk");
 
     auto matModelTrunk = dg::float4x4::Scale(0.5, 4, 0.5) * dg::float4x4::Translation(0, 2, 0);
     tree->NewChild(trunkGeometry, m_matTrunk, matModelTrunk);
@@ -115,21 +167,21 @@ void GeneralScene::GenerateTrees() {
     m_matCrown->SetBaseColor(0, 128, 0);
 
     SphereShape crownShape({10, 5}, math::Axis::Y);
-    auto crownGeometry = ShapeBuilder(device).Join({&crownShape}, "crown");
+    auto crownGeometry = treeBuilder.Join({&crownShape}, "crown");
 
     auto matModelCrown = dg::float4x4::Scale(4, 8, 4) * dg::float4x4::Translation(0, 7, 0);
     tree->NewChild(crownGeometry, m_matCrown, matModelCrown);
 
-    RandSeed(5);
-    for (auto i=0; i!=100; ++i) {
-        auto matModelPosition = dg::float4x4::Translation(LinearRand(dg::float3(-100, 0, -100), dg::float3(100, 0, 100)));
-        m_scene->AddChild(tree->Clone(matModelPosition));
+    constexpr const size_t treeCount = 100;
+    std::vector<dg::float3> positions(treeCount);
+    LinearRandFill(5, 0, 0, dg::float3(-100, 0, -100), dg::float3(100, 0, 100), positions.data(), positions.size());
+    for (const auto& position: positions) {
+        m_scene->AddChild(tree->Clone(dg::float4x4::Translation(position)));
     }
 }
 
 void GeneralScene::GenerateGrass() {
     auto& device = Engine::Get().GetDevice();
-    RandSeed(177);
 
     m_matGrass = std::make_shared<StdMaterialGrass>("mat::grass");
     m_matGrass->SetCullMode(dg::CULL_MODE_NONE);
@@ -139,18 +191,24 @@ void GeneralScene::GenerateGrass() {
     // m_matGrass->SetBaseTexture(m_TextureGrassBlade0);
     // m_matGrass->SetAlphaThreshold(0.2f);
 
+    // the one point, the blades are its instances
     VertexBufferBuilder vbBuilder;
-    auto vb = vbBuilder.AddRange<VertexP>(1 * 10 * 1000);
-    float halfWidt = 150.f;
-    for (auto* vbIt = vb.Begin(); vbIt != vb.End(); ++vbIt) {
-        auto vecPos = LinearRand(dg::float3(-halfWidt, 0.f, -halfWidt), dg::float3(halfWidt, 0.f, halfWidt));
-        *vbIt = VertexP{vecPos};
-    }
+    auto vb = vbBuilder.AddRange<VertexP>(1);
+    *vb.Begin() = VertexP{dg::float3(0, 0, 0)};
 
     uint32_t vbOffsetBytes = 0;
-    auto geometry = std::make_shared<GeometryUnindexed>(vbBuilder.Build(device, "grass points"), vbOffsetBytes, vb.Count(), vb.GetVDeclId());
+    auto geometry = std::make_shared<GeometryUnindexed>(vbBuilder.Build(device, "grass point"), vbOffsetBytes, vb.Count(), vb.GetVDeclId());
 
-    m_scene->NewChild(geometry, m_matGrass);
+    ScatterDesc desc;
+    float halfWidt = 150.f;
+    desc.region = math::RectF(-halfWidt, -halfWidt, 2.f * halfWidt, 2.f * halfWidt);
+    desc.minDistance = 2.f;
+    desc.tileSize = 32.f;
+    desc.seed = 177;
+    // grass clumps
+    auto density = math::Generator2D([](double x, double z) { return 0.5 + 0.5 * std::sin(x * 0.05) * std::cos(z * 0.05); });
+
+    AddScatter(geometry, m_matGrass, desc, density);
 }
 
 void GeneralScene::GenerateGrassBillboard() {
@@ -169,38 +227,43 @@ void GeneralScene::GenerateGrassBillboard() {
 
     auto bush = ShapeBuilder(device).Join({&plane1, &plane2, &plane3}, "Bush");
 
+    // the materials differ only by the slot in the shared texture array, so they get the same pipeline
     m_matGrassBillboard0 = std::make_shared<StdMaterial>("mat::grass0");
-    m_matGrassBillboard0->SetCullMode(dg::CULL_MODE_NONE);
-    m_matGrassBillboard0->SetBaseTexture(m_TextureGrass0);
-    m_matGrassBillboard0->SetBaseTextureAddressMode(dg::TEXTURE_ADDRESS_CLAMP);
-    m_matGrassBillboard0->SetAlphaThreshold(0.2f);
-
     m_matGrassBillboard1 = std::make_shared<StdMaterial>("mat::grass1");
-    m_matGrassBillboard1->SetCullMode(dg::CULL_MODE_NONE);
-    m_matGrassBillboard1->SetBaseTexture(m_TextureGrass1);
-    m_matGrassBillboard1->SetBaseTextureAddressMode(dg::TEXTURE_ADDRESS_CLAMP);
-    m_matGrassBillboard1->SetAlphaThreshold(0.2f);
-
     m_matGrassBillboard2 = std::make_shared<StdMaterial>("mat::flower");
-    m_matGrassBillboard2->SetCullMode(dg::CULL_MODE_NONE);
-    m_matGrassBillboard2->SetBaseTexture(m_TextureFlower0);
-    m_matGrassBillboard2->SetBaseTextureAddressMode(dg::TEXTURE_ADDRESS_CLAMP);
-    m_matGrassBillboard2->SetAlphaThreshold(0.2f);
-
-    RandSeed(15);
-    auto material = m_matGrassBillboard0;
-    auto multiplier = 10;
-    for (int i=0; i!=multiplier * 1000; ++i) {
-        auto matScale = dg::float4x4::Scale(LinearRand(0.3f, 1.f));
-
-        auto vecPos = LinearRand(dg::float3(-100.f, 0.f, -100.f), dg::float3(100.f, 0.f, 100.f));
-        auto matModelPosition = dg::float4x4::Translation(vecPos);
-
-        if (i == multiplier * 450) {
-            material = m_matGrassBillboard1;
-        } else  if (i == multiplier * 900) {
-            material = m_matGrassBillboard2;
-        }
-        m_scene->NewChild(bush, material, matScale * matModelPosition);
+    for (auto* material: {m_matGrassBillboard0.get(), m_matGrassBillboard1.get(), m_matGrassBillboard2.get()}) {
+        material->SetCullMode(dg::CULL_MODE_NONE);
+        material->SetBaseTextureAddressMode(dg::TEXTURE_ADDRESS_CLAMP);
+        material->SetAlphaThreshold(0.2f);
     }
+    BindBillboardTextures();
+
+    ScatterDesc desc;
+    desc.region = math::RectF(-100.f, -100.f, 200.f, 200.f);
+    desc.tileSize = 25.f;
+    desc.minScale = 0.3f;
+    desc.maxScale = 1.f;
+    auto density = math::Generator2D(1.0);
+
+    desc.minDistance = 2.5f;
+    desc.seed = 15;
+    AddScatter(bush, m_matGrassBillboard0, desc, density);
+    desc.seed = 16;
+    AddScatter(bush, m_matGrassBillboard1, desc, density);
+
+    desc.minDistance = 5.f;
+    desc.seed = 17;
+    AddScatter(bush, m_matGrassBillboard2, desc, density);
+}
+
+void GeneralScene::AddScatter(const std::shared_ptr<Geometry>& geometry, const std::shared_ptr<Material>& material,
+    const ScatterDesc& desc, const math::Generator2D& density) {
+
+    auto scatter = std::make_shared<Scatter>(desc);
+    scatter->SetDensity(density);
+    scatter->Update();
+
+    auto node = m_scene->NewChild(geometry, material);
+    node->SetInstances(scatter->GetInstances());
+    m_scatters.push_back(ScatterNode{scatter, node});
 }
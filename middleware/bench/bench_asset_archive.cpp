@@ -0,0 +1,121 @@
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <fcntl.h>
+#include <cstdint>
+#include <fstream>
+#include <unistd.h>
+#include <filesystem>
+
+#include "core/path/path.h"
+#include "core/common/timer.h"
+#include "core/math/random.h"
+#include "core/path/asset_archive.h"
+
+
+namespace {
+
+// the page cache of the file is dropped, the dentry and inode caches stay warm,
+// so the loose files time is the lower bound of the real cold start
+void DropFileCache(const std::filesystem::path& path) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd != -1) {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+// text-like content: the shaders, the configs and the fonts are compressed 2-4x
+std::vector<uint8_t> MakeFileData(uint32_t fileIndex, size_t size) {
+    std::vector<uint8_t> result(size);
+    for (size_t i=0; i!=size; ++i) {
+        const uint32_t word = static_cast<uint32_t>(i / 6);
+        const bool isNoise = (Rand<float>(fileIndex, word, 0) < 0.3f);
+        const uint32_t value = isNoise ? static_cast<uint32_t>(Rand<float>(fileIndex, word, i) * 64.f) : (word % 23);
+        result[i] = static_cast<uint8_t>('0' + value);
+    }
+
+    return result;
+}
+
+uint64_t ReadAll(const FileManager& fileManager, const std::vector<std::filesystem::path>& names) {
+    uint64_t checksum = 0;
+    for (const auto& name: names) {
+        const auto view = fileManager.MapFile(name);
+        for (size_t i=0; i<view.Size(); i+=4096) {
+            checksum += static_cast<uint8_t>(view.Chars()[i]);
+        }
+    }
+
+    return checksum;
+}
+
+}
+
+int main() {
+    constexpr const uint32_t filesCount = 2000;
+    constexpr const uint32_t rounds = 5;
+    const auto dir = std::filesystem::temp_directory_path() / "terra_bench_asset_archive";
+    const auto looseDir = dir / "loose";
+    std::filesystem::remove_all(dir);
+
+    std::vector<std::filesystem::path> names;
+    AssetArchiveWriter writer;
+    uint64_t totalSize = 0;
+    for (uint32_t i=0; i!=filesCount; ++i) {
+        const auto name = std::filesystem::path("assets") / ("dir" + std::to_string(i % 20)) / ("file" + std::to_string(i) + ".bin");
+        const auto size = static_cast<size_t>(1024 + std::lround(Rand<float>(i, 1, 2) * 31744.f));
+        auto data = MakeFileData(i, size);
+        std::filesystem::create_directories((looseDir / name).parent_path());
+        std::ofstream(looseDir / name, std::ios::binary).write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        writer.Add(name, std::move(data));
+        names.push_back(name);
+        totalSize += size;
+    }
+
+    const auto compressedPath = dir / "compressed.tpak";
+    const auto storedPath = dir / "stored.tpak";
+    const auto compressedStats = writer.Write(compressedPath, AssetArchiveDesc{16, true, 0.9f});
+    const auto storedStats = writer.Write(storedPath, AssetArchiveDesc{4096, false, 0.9f});
+    std::printf("%u files, %ju bytes, compressed archive %ju bytes, stored archive %ju bytes\n", filesCount,
+        static_cast<uintmax_t>(totalSize), static_cast<uintmax_t>(compressedStats.archiveSize), static_cast<uintmax_t>(storedStats.archiveSize));
+
+    const char* modeNames[] = {"loose files", "compressed archive", "stored archive"};
+    Timer timer;
+    for (size_t mode=0; mode!=3; ++mode) {
+        double coldTime = 0;
+        double warmTime = 0;
+        uint64_t checksum = 0;
+        for (uint32_t round=0; round!=rounds; ++round) {
+            if (mode == 0) {
+                for (const auto& name: names) {
+                    DropFileCache(looseDir / name);
+                }
+            } else {
+                DropFileCache((mode == 1) ? compressedPath : storedPath);
+            }
+
+            for (size_t pass=0; pass!=2; ++pass) {
+                timer.Start();
+                // the mount is a part of the startup
+                FileManager fileManager;
+                if (mode == 0) {
+                    fileManager.MountDirectory(looseDir);
+                } else {
+                    fileManager.MountArchive((mode == 1) ? compressedPath : storedPath);
+                }
+                checksum += ReadAll(fileManager, names);
+                ((pass == 0) ? coldTime : warmTime) += timer.TimePoint();
+            }
+        }
+
+        std::printf("%-18s: cold %.1f ms, warm %.1f ms, %.0f files/s cold (checksum %ju)\n", modeNames[mode],
+            coldTime * 1000. / rounds, warmTime * 1000. / rounds, static_cast<double>(filesCount) * rounds / coldTime, static_cast<uintmax_t>(checksum));
+    }
+
+    std::filesystem::remove_all(dir);
+
+    return 0;
+}
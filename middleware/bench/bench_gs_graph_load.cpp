@@ -0,0 +1,51 @@
+#include <memory>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <filesystem>
+
+#include "core/common/timer.h"
+#include "middleware/gschema/graph/gs_graph.h"
+#include "middleware/gschema/graph/gs_class_storage.h"
+
+
+int main() {
+    auto classStorage = std::make_shared<gs::ClassStorage>();
+
+    // ~10k nodes: a chain of adds, each add sums the previous node and a new constant
+    const uint16_t pairsCount = 5000;
+    gs::Graph graph(classStorage, static_cast<uint16_t>(pairsCount * 2));
+
+    Timer timer;
+    timer.Start();
+    uint16_t prevNodeId = graph.AddNode("Constant");
+    for (uint16_t i=1; i!=pairsCount; ++i) {
+        uint16_t constantId = graph.AddNode("Constant");
+        graph.SetEmbeddedValue(constantId, 0, static_cast<float>(i));
+        uint16_t addId = graph.AddNode("Add");
+        graph.AddLink(prevNodeId, 0, addId, 0);
+        graph.AddLink(constantId, 0, addId, 1);
+        prevNodeId = addId;
+    }
+    const double buildTime = timer.TimePoint();
+    std::printf("build by AddNode/AddLink: %u nodes, %.3f s\n", static_cast<uint32_t>(graph.CountNodes()), buildTime);
+
+    const auto path = std::filesystem::temp_directory_path() / "bench_gs_graph_load.gsgr";
+    timer.Start();
+    graph.SaveToFile(path);
+    const double saveTime = timer.TimePoint();
+    std::printf("save: %ju bytes, %.3f ms\n", static_cast<uintmax_t>(std::filesystem::file_size(path)), saveTime * 1000.);
+
+    const uint32_t iterations = 20;
+    double loadTime = 0;
+    for (uint32_t i=0; i!=iterations; ++i) {
+        gs::Graph loaded(classStorage, 16);
+        timer.Start();
+        loaded.LoadFromFile(path);
+        loadTime += timer.TimePoint();
+    }
+    std::printf("load from file: %.3f ms\n", loadTime * 1000. / static_cast<double>(iterations));
+    std::filesystem::remove(path);
+
+    return 0;
+}
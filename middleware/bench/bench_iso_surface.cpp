@@ -0,0 +1,65 @@
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <cstdint>
+#include <algorithm>
+
+#include "core/common/timer.h"
+#include "core/math/generator_type.h"
+#include "middleware/generator/texture/perlin.h"
+#include "middleware/generator/mesh/iso_surface_shape.h"
+
+
+int main() {
+    Perlin perlin;
+    perlin.SetFrequency(2.0);
+    perlin.SetOctaveCount(4);
+    const auto input = perlin.Result();
+
+    IsoSurfaceDesc desc;
+    desc.origin = dg::float3(-1.f, -1.f, -1.f);
+    desc.size = dg::float3(2.f, 2.f, 2.f);
+    desc.cells = dg::uint3(256, 256, 256);
+    desc.chunkSize = 32;
+    const double voxels = 256. * 256. * 256.;
+    std::printf("Perlin (4 octaves) iso-surface: 256^3 voxels, chunk size %u\n", desc.chunkSize);
+
+    const uint32_t threadCounts[2] = {1, std::max(std::thread::hardware_concurrency(), 1u)};
+    double times[2] = {0, 0};
+    Timer timer;
+    for (uint32_t i=0; i!=2; ++i) {
+        desc.threadCount = threadCounts[i];
+        IsoSurfaceShape shape(desc);
+        timer.Start();
+        shape.Generate(input);
+        times[i] = timer.TimePoint();
+        std::printf("threads %u: %.3f s, %.2f Mvoxels/s, %zu vertexes, %zu triangles\n",
+            threadCounts[i], times[i], voxels / times[i] / 1000000., shape.LenghtVertex(), shape.LenghtIndex() / 3);
+    }
+    std::printf("parallel speedup: %.2fx\n", times[0] / times[1]);
+
+    // sparse volume: a single ball in the center, most chunks are far from its surface
+    math::Generator3D ball([](double x, double y, double z) -> double { return std::sqrt(x * x + y * y + z * z) - 1.; });
+    ball.SetBounds([](math::Interval<double> x, math::Interval<double> y, math::Interval<double> z) {
+        const auto distance = math::IntervalHypot(x, y, z);
+        return math::Interval<double>{distance.lower - 1., distance.upper - 1.};
+    });
+    const auto& sparseInput = ball;
+    desc.origin = dg::float3(-4.f, -4.f, -4.f);
+    desc.size = dg::float3(8.f, 8.f, 8.f);
+    desc.threadCount = 0;
+    std::printf("sparse ball iso-surface: 256^3 voxels\n");
+    for (uint32_t i=0; i!=2; ++i) {
+        desc.useBounds = (i == 1);
+        IsoSurfaceShape shape(desc);
+        timer.Start();
+        shape.Generate(sparseInput);
+        times[i] = timer.TimePoint();
+        std::printf("bounds %s: %.3f s, %.2f Mvoxels/s, skipped chunks %u/%u, %zu triangles\n",
+            desc.useBounds ? "on" : "off", times[i], voxels / times[i] / 1000000.,
+            shape.GetSkippedChunkCount(), shape.GetChunkCount(), shape.LenghtIndex() / 3);
+    }
+    std::printf("bounds speedup: %.2fx\n", times[0] / times[1]);
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <cmath>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <utility>
+
+#include "core/common/timer.h"
+#include "core/math/random.h"
+#include "core/render/vertexes.h"
+#include "middleware/generator/mesh/mesh_optimizer.h"
+#include "middleware/generator/mesh/uv_grid_generator.h"
+
+
+int main() {
+    // 708 * 708 * 2 = 1002528 triangles
+    const uint32_t segments = 708;
+    UVGridGenerator generator(dg::uint2(segments, segments));
+    std::vector<VertexPNC> vertexes(generator.LenghtVertex());
+    std::vector<uint32_t> indexes(generator.LenghtIndex());
+    generator.FillVertex(vertexes.data());
+    generator.FillIndex(indexes.data(), 0);
+    for (auto& v: vertexes) {
+        const float height = 0.05f * std::sin(v.uv.x * 17.f) * std::cos(v.uv.y * 11.f);
+        v.position = dg::float3(v.uv.x, height, v.uv.y);
+    }
+
+    // the grid is already in the cache friendly order, the shuffled triangles are the worst case
+    RandSeed(1);
+    const size_t triangleCount = indexes.size() / 3;
+    for (size_t i=triangleCount - 1; i!=0; --i) {
+        const size_t j = LinearRand<size_t>(0, i);
+        for (size_t k=0; k!=3; ++k) {
+            std::swap(indexes[i * 3 + k], indexes[j * 3 + k]);
+        }
+    }
+    const auto sourceVertexes = vertexes;
+    const auto sourceIndexes = indexes;
+
+    const uint32_t cacheSize = 16;
+    std::printf("source: %zu vertexes, %zu triangles, ACMR %.3f, ATVR %.3f\n", vertexes.size(), triangleCount,
+        static_cast<double>(MeshOptimizer::CalcACMR(indexes.data(), indexes.size(), cacheSize)),
+        static_cast<double>(MeshOptimizer::CalcATVR(indexes.data(), indexes.size(), vertexes.size(), cacheSize)));
+
+    Timer timer;
+    timer.Start();
+    MeshOptimizer::OptimizeVertexCache(indexes.data(), indexes.size(), vertexes.size());
+    const double vertexCacheTime = timer.TimePoint();
+    std::printf("vertex cache: %.3f s, %.2f Mtri/s, ACMR %.3f\n", vertexCacheTime, static_cast<double>(triangleCount) / vertexCacheTime * 1e-6,
+        static_cast<double>(MeshOptimizer::CalcACMR(indexes.data(), indexes.size(), cacheSize)));
+
+    timer.Start();
+    MeshOptimizer::OptimizeOverdraw(indexes.data(), indexes.size(), vertexes.data(), vertexes.size(), cacheSize, 1.05f);
+    const double overdrawTime = timer.TimePoint();
+    std::printf("overdraw: %.3f s, %.2f Mtri/s, ACMR %.3f\n", overdrawTime, static_cast<double>(triangleCount) / overdrawTime * 1e-6,
+        static_cast<double>(MeshOptimizer::CalcACMR(indexes.data(), indexes.size(), cacheSize)));
+
+    timer.Start();
+    MeshOptimizer::OptimizeVertexFetch(vertexes.data(), vertexes.size(), indexes.data(), indexes.size());
+    const double vertexFetchTime = timer.TimePoint();
+    std::printf("vertex fetch: %.3f s, %.2f Mtri/s\n", vertexFetchTime, static_cast<double>(triangleCount) / vertexFetchTime * 1e-6);
+
+    // all passes through Optimize, as ShapeBuilder runs them
+    vertexes = sourceVertexes;
+    indexes = sourceIndexes;
+    MeshOptimizer optimizer;
+    timer.Start();
+    const auto stats = optimizer.Optimize(vertexes.data(), vertexes.size(), indexes.data(), indexes.size());
+    const double optimizeTime = timer.TimePoint();
+    std::printf("optimize: %.3f s, %.2f Mtri/s, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", optimizeTime, static_cast<double>(triangleCount) / optimizeTime * 1e-6,
+        static_cast<double>(stats.acmrBefore), static_cast<double>(stats.acmrAfter),
+        static_cast<double>(stats.atvrBefore), static_cast<double>(stats.atvrAfter));
+
+    return 0;
+}
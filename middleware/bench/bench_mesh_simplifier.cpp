@@ -0,0 +1,47 @@
+#include <cmath>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+
+#include "core/common/timer.h"
+#include "core/render/vertexes.h"
+#include "middleware/generator/mesh/mesh_simplifier.h"
+#include "middleware/generator/mesh/uv_grid_generator.h"
+
+
+int main() {
+    // 708 * 708 * 2 = 1002528 triangles
+    const uint32_t segments = 708;
+    UVGridGenerator generator(dg::uint2(segments, segments));
+    std::vector<VertexPNC> vertexes(generator.LenghtVertex());
+    std::vector<uint32_t> indexes(generator.LenghtIndex());
+    generator.FillVertex(vertexes.data());
+    generator.FillIndex(indexes.data(), 0);
+    for (auto& v: vertexes) {
+        const float height = 0.05f * std::sin(v.uv.x * 17.f) * std::cos(v.uv.y * 11.f) + 0.01f * std::sin(v.uv.x * 97.f + v.uv.y * 53.f);
+        v.position = dg::float3(v.uv.x, height, v.uv.y);
+    }
+
+    std::printf("source: %zu vertexes, %zu triangles\n", vertexes.size(), indexes.size() / 3);
+
+    Timer timer;
+    timer.Start();
+    std::vector<uint32_t> result(indexes.size());
+    float error = 0;
+    const size_t count = MeshSimplifier::Simplify(vertexes.data(), vertexes.size(), indexes.data(), indexes.size(),
+        result.data(), indexes.size() / 10, 0.01f, &error);
+    const double simplifyTime = timer.TimePoint();
+    std::printf("simplify to 10%%: %zu triangles, error %f, %.3f s, %.2f Mtri/s\n",
+        count / 3, static_cast<double>(error), simplifyTime, static_cast<double>(indexes.size() / 3) / simplifyTime * 1e-6);
+
+    MeshLodDesc desc;
+    timer.Start();
+    const auto lods = MeshSimplifier::BuildLods(vertexes.data(), vertexes.size(), indexes.data(), indexes.size(), desc);
+    const double lodsTime = timer.TimePoint();
+    std::printf("lod chain: %.3f s\n", lodsTime);
+    for (size_t i=0; i!=lods.size(); ++i) {
+        std::printf("  lod %zu: %zu triangles, error %f\n", i + 1, lods[i].indexes.size() / 3, static_cast<double>(lods[i].error));
+    }
+
+    return 0;
+}
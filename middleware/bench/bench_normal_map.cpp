@@ -0,0 +1,45 @@
+#include <cstdio>
+#include <cstdint>
+
+#include "core/common/timer.h"
+#include "core/math/generator_type.h"
+#include "middleware/generator/texture/perlin.h"
+#include "middleware/generator/texture/section_plane.h"
+#include "middleware/generator/texture/normal_map_baker.h"
+
+
+int main() {
+    Perlin perlin;
+    perlin.SetFrequency(4.0);
+    perlin.SetOctaveCount(6);
+    SectionPlaneX0Y sectionPlane;
+    sectionPlane.SetInput(perlin.Result());
+    const auto height = sectionPlane.Result();
+
+    NormalMapBakerDesc desc;
+    desc.region = math::RectF(-1.f, -1.f, 2.f, 2.f);
+    desc.size = math::Size(1024, 1024);
+    desc.heightScale = 0.1f;
+    NormalMapBaker baker(desc);
+    const double texels = static_cast<double>(desc.size.w) * static_cast<double>(desc.size.h);
+    std::printf("Perlin (6 octaves) normal map: %ux%u texels\n", desc.size.w, desc.size.h);
+
+    Timer timer;
+    const uint32_t iterations = 3;
+    double times[2] = {0, 0};
+    const NormalMapMode modes[2] = {NormalMapMode::FiniteDifferences, NormalMapMode::Analytic};
+    const char* names[2] = {"finite differences", "analytic gradient"};
+    for (uint32_t i=0; i!=2; ++i) {
+        baker.SetMode(modes[i]);
+        for (uint32_t j=0; j!=iterations; ++j) {
+            timer.Start();
+            baker.Bake(height);
+            times[i] += timer.TimePoint();
+        }
+        times[i] /= static_cast<double>(iterations);
+        std::printf("%s: %.3f s, %.2f Mtexels/s\n", names[i], times[i], texels / times[i] / 1000000.);
+    }
+    std::printf("speedup: %.2fx\n", times[0] / times[1]);
+
+    return 0;
+}
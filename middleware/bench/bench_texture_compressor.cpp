@@ -0,0 +1,53 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <cstdint>
+
+#include "core/common/timer.h"
+#include "core/math/random.h"
+#include "core/material/texture_compressor.h"
+
+
+int main() {
+    // gray fBm-like noise as the output of Generator2dToTexture
+    constexpr const uint32_t size = 1024;
+    std::vector<uint8_t> texels(static_cast<size_t>(size) * size * 4);
+    for (uint32_t y=0; y!=size; ++y) {
+        for (uint32_t x=0; x!=size; ++x) {
+            const double v = std::sin(static_cast<double>(x) * 0.02) * std::cos(static_cast<double>(y) * 0.03) * 0.7 +
+                static_cast<double>(Rand<float>(1, y, x)) * 0.3;
+            const auto component = static_cast<uint8_t>(std::lround((v * 0.5 + 0.5) * 255.));
+            for (size_t c=0; c!=4; ++c) {
+                texels[(static_cast<size_t>(y) * size + x) * 4 + c] = (c == 3) ? 255 : component;
+            }
+        }
+    }
+    std::printf("%ux%u RGBA8 gray texture, %zu bytes\n", size, size, texels.size());
+
+    const BlockFormat formats[] = {BlockFormat::BC1, BlockFormat::BC4, BlockFormat::BC5, BlockFormat::BC7};
+    const char* formatNames[] = {"BC1", "BC4", "BC5", "BC7"};
+    const CompressionQuality qualities[] = {CompressionQuality::Fast, CompressionQuality::Normal, CompressionQuality::High};
+    const char* qualityNames[] = {"fast", "normal", "high"};
+    const uint32_t channels[] = {3, 1, 2, 4};
+    std::vector<uint8_t> decoded(texels.size());
+    Timer timer;
+    for (size_t f=0; f!=4; ++f) {
+        std::vector<uint8_t> blocks(CalcCompressedSize(formats[f], size, size));
+        for (size_t q=0; q!=3; ++q) {
+            double times[2] = {0, 0};
+            const uint32_t threadCounts[2] = {1, 0};
+            for (size_t t=0; t!=2; ++t) {
+                timer.Start();
+                CompressTexture(TextureCompressorDesc{formats[f], qualities[q], threadCounts[t]}, texels.data(), size, size, size * 4, blocks.data());
+                times[t] = timer.TimePoint();
+            }
+            DecompressTexture(formats[f], blocks.data(), size, size, decoded.data());
+            const double rmse = CalcRMSE(decoded.data(), texels.data(), static_cast<size_t>(size) * size, channels[f]);
+            std::printf("%s %-6s: %zu bytes (%.0fx smaller), rmse %.3f, 1 thread %.1f Mtexels/s, all threads %.1f Mtexels/s\n",
+                formatNames[f], qualityNames[q], blocks.size(), static_cast<double>(texels.size()) / static_cast<double>(blocks.size()), rmse,
+                static_cast<double>(size * size) / times[0] / 1000000., static_cast<double>(size * size) / times[1] / 1000000.);
+        }
+    }
+
+    return 0;
+}
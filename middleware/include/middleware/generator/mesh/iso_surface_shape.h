@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/math/types.h"
+#include "core/common/ctor.h"
+#include "core/math/generator_type.h"
+#include "middleware/generator/mesh/shape_generator.h"
+
+
+struct IsoSurfaceDesc {
+    // min corner of the volume in the generator space
+    dg::float3 origin = dg::float3(-1.f, -1.f, -1.f);
+    // size of the volume in the generator space
+    dg::float3 size = dg::float3(2.f, 2.f, 2.f);
+    // count of cells (voxels) along each axis
+    dg::uint3 cells = dg::uint3(64, 64, 64);
+    // side of the chunk in cells, chunks are meshed in parallel
+    uint32_t chunkSize = 32;
+    // values above the level are solid, the surface normals look to the lower values
+    float isoLevel = 0;
+    // 0 - std::thread::hardware_concurrency
+    uint32_t threadCount = 0;
+    // skip the chunks, which are proved to be above or below isoLevel by math::Generator3::Bounds
+    bool useBounds = true;
+};
+
+struct VertexPNC;
+// Marching cubes mesh of the iso-surface of Generator3D.
+// The volume is split into chunks, that are meshed in parallel.
+// Every vertex belongs to one chunk (the owner of the cube edge), so the seams between chunks
+// are welded without duplicated vertexes and the result doesn't depend on chunkSize.
+// The normals are calculated by math::Generator3::Gradient, so the analytic gradient is used if the input has one.
+// The chunks, where math::Generator3::Bounds proves that there is no surface, are skipped without sampling.
+class IsoSurfaceShape : public IShapeGenerator, Noncopyable {
+public:
+    IsoSurfaceShape() = delete;
+    IsoSurfaceShape(const IsoSurfaceDesc& desc);
+    ~IsoSurfaceShape();
+
+    const IsoSurfaceDesc& GetDesc() const noexcept { return m_desc; }
+    uint32_t GetChunkCount() const noexcept { return m_chunkCount.x * m_chunkCount.y * m_chunkCount.z; }
+    // count of chunks without the surface, that were skipped without sampling by the last Generate
+    uint32_t GetSkippedChunkCount() const noexcept { return m_skippedChunkCount; }
+
+    // meshes the volume, replaces the previous mesh
+    void Generate(const math::Generator3D& input);
+
+    size_t LenghtVertex() const final;
+    size_t LenghtIndex() const final;
+    void FillVertex(VertexPNC* vertexes) const final;
+    void FillIndex(uint32_t* indexes, uint32_t vertexStartIndex) const final;
+
+private:
+    struct Chunk;
+    void GenerateVertexes(const math::Generator3D& input, Chunk& chunk) const;
+    void GenerateIndexes(Chunk& chunk) const;
+    uint32_t FindVertex(uint32_t x, uint32_t y, uint32_t z, uint32_t axis) const;
+    uint64_t GetEdgeKey(uint32_t x, uint32_t y, uint32_t z, uint32_t axis) const noexcept;
+
+private:
+    IsoSurfaceDesc m_desc;
+    dg::uint3 m_chunkCount;
+    uint32_t m_skippedChunkCount = 0;
+    size_t m_vertexCount = 0;
+    size_t m_indexCount = 0;
+    std::vector<Chunk> m_chunks;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+struct MeshOptimizerDesc {
+    bool vertexCache = true;
+    bool overdraw = true;
+    bool vertexFetch = true;
+    // FIFO cache size for simulation and for overdraw cluster boundaries
+    uint32_t cacheSize = 16;
+    // max allowed ACMR degradation for overdraw reordering (1.05 - 5%)
+    float overdrawThreshold = 1.05f;
+};
+
+struct MeshOptimizerStats {
+    float acmrBefore = 0.f;
+    float acmrAfter = 0.f;
+    float atvrBefore = 0.f;
+    float atvrAfter = 0.f;
+};
+
+struct VertexPNC;
+class MeshOptimizer {
+public:
+    MeshOptimizer() = default;
+    MeshOptimizer(const MeshOptimizerDesc& desc);
+    ~MeshOptimizer() = default;
+
+    const MeshOptimizerDesc& GetDesc() const noexcept { return m_desc; }
+
+    // All passes are deterministic and work in place, vertexCount is not changed
+    MeshOptimizerStats Optimize(VertexPNC* vertexes, size_t vertexCount, uint32_t* indexes, size_t indexCount) const;
+
+public:
+    // Average cache miss ratio: cache misses / triangle count (from 0.5 to 3.0)
+    static float CalcACMR(const uint32_t* indexes, size_t indexCount, uint32_t cacheSize);
+    // Average transformed vertex ratio: cache misses / referenced vertex count (1.0 is optimal)
+    static float CalcATVR(const uint32_t* indexes, size_t indexCount, size_t vertexCount, uint32_t cacheSize);
+
+    // Tom Forsyth "Linear-Speed Vertex Cache Optimisation"
+    static void OptimizeVertexCache(uint32_t* indexes, size_t indexCount, size_t vertexCount);
+    // Splits triangles into clusters on cache boundaries and sorts clusters from outside to inside
+    static void OptimizeOverdraw(uint32_t* indexes, size_t indexCount, const VertexPNC* vertexes, size_t vertexCount,
+        uint32_t cacheSize, float threshold);
+    // Reorders vertexes in order of first use, unused vertexes are moved to the end
+    static void OptimizeVertexFetch(VertexPNC* vertexes, size_t vertexCount, uint32_t* indexes, size_t indexCount);
+
+private:
+    MeshOptimizerDesc m_desc;
+};
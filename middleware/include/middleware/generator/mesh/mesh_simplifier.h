@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+
+struct MeshLodDesc {
+    // max LOD count including the source mesh
+    uint8_t maxLevels = 4;
+    // target index count for the next level = current index count * ratio
+    float ratio = 0.5f;
+    // max error for the each level, relative to the mesh extent
+    float targetError = 0.02f;
+};
+
+struct MeshLod {
+    std::vector<uint32_t> indexes;
+    // absolute error (in the mesh space) relative to the source mesh
+    float error = 0.f;
+};
+
+struct VertexPNC;
+class MeshSimplifier {
+public:
+    // Quadric error metric edge collapse (Garland & Heckbert), vertexes are collapsed into existing ones,
+    // so the result is an index buffer for the same vertex buffer.
+    // Vertexes with identical positions and different attributes (uv seams) are locked,
+    // border vertexes are collapsed along the border only.
+    // The collapse error is the distance to the planes of the collapsed triangles (RMS weighted by the areas),
+    // targetError is relative to the mesh extent, resultError (optional) is relative too.
+    // Returns the result index count
+    static size_t Simplify(const VertexPNC* vertexes, size_t vertexCount, const uint32_t* indexes, size_t indexCount,
+        uint32_t* destination, size_t targetIndexCount, float targetError, float* resultError = nullptr);
+
+    // Levels after the source mesh (level 0 is not included), stops when the mesh can't be simplified more
+    static std::vector<MeshLod> BuildLods(const VertexPNC* vertexes, size_t vertexCount, const uint32_t* indexes, size_t indexCount,
+        const MeshLodDesc& desc);
+
+    // Max distance along axes of bounding box
+    static float CalcExtent(const VertexPNC* vertexes, size_t vertexCount, const uint32_t* indexes, size_t indexCount);
+};
@@ -4,6 +4,8 @@
 #include <initializer_list>
 
 #include "dg/dg.h"
+#include "middleware/generator/mesh/mesh_optimizer.h"
+#include "middleware/generator/mesh/mesh_simplifier.h"
 
 
 class Geometry;
@@ -14,8 +16,23 @@ public:
     ShapeBuilder(const DevicePtr& device);
     ~ShapeBuilder();
 
+    // Enable post-process optimization for the next Join calls
+    void SetOptimization(const MeshOptimizerDesc& desc);
+    void ResetOptimization();
+    // Stats for the last Join call with enabled optimization
+    const MeshOptimizerStats& GetOptimizationStats() const noexcept { return m_optimizationStats; }
+
+    // Enable LOD chain generation for the next Join calls, LODs are stored in the same index buffer
+    void SetLods(const MeshLodDesc& desc);
+    void ResetLods();
+
     std::shared_ptr<Geometry> Join(const std::initializer_list<const IShapeGenerator*>& shapes, const char* name = nullptr);
 
 private:
     DevicePtr m_device;
+    bool m_optimize = false;
+    MeshOptimizer m_optimizer;
+    MeshOptimizerStats m_optimizationStats;
+    bool m_buildLods = false;
+    MeshLodDesc m_lodDesc;
 };
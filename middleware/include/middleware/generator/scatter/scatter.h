@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "dg/math.h"
+#include "core/math/types.h"
+#include "core/common/ctor.h"
+#include "core/math/generator_type.h"
+#include "core/render/instance_transform.h"
+
+
+struct ScatterDesc {
+    // region in the XZ plane (rect x - X axis, rect y - Z axis)
+    math::RectF region = math::RectF(-100.f, -100.f, 200.f, 200.f);
+    // min distance between instances, must be less than or equal to tileSize
+    float minDistance = 1.f;
+    float tileSize = 16.f;
+    float minScale = 1.f;
+    float maxScale = 1.f;
+    // candidate count around the each active point (Bridson)
+    uint32_t attempts = 30;
+    uint64_t seed = 0;
+    // 0 - std::thread::hardware_concurrency
+    uint32_t threadCount = 0;
+};
+
+// Tiled Poisson-disk sampling of instances in the region, the density (in range [0, 1]) thins out the Poisson-disk set.
+// The Poisson-disk set depends on the desc only, so the result doesn't depend on the order of density updates
+// and a partial update is equal to the full one.
+class Scatter : Fixed {
+    struct Point {
+        dg::float2 position;
+        // the point is kept if density > threshold
+        float threshold;
+        float scale;
+        float angleY;
+    };
+
+    struct Tile {
+        math::RectF rect;
+        std::vector<Point> points;
+        std::vector<InstanceTransform> instances;
+        // the points that passed the density test, to detect the tiles without changes
+        std::vector<bool> keptMask;
+        bool isDirty = true;
+        bool isGenerated = false;
+    };
+
+public:
+    Scatter() = delete;
+    Scatter(const ScatterDesc& desc);
+    ~Scatter() = default;
+
+public:
+    const ScatterDesc& GetDesc() const noexcept { return m_desc; }
+    uint32_t GetTileCountX() const noexcept { return m_tileCountX; }
+    uint32_t GetTileCountY() const noexcept { return m_tileCountY; }
+
+    // marks all tiles as dirty
+    void SetDensity(const math::Generator2D& density);
+    // marks as dirty only the tiles that intersect the rect (in the region space), where the density has changed
+    void SetDensity(const math::Generator2D& density, const math::RectF& changedRect);
+
+    // regenerates the dirty tiles, returns the number of tiles whose instances have changed
+    uint32_t Update();
+
+    // increases when instances of any tile have changed
+    uint32_t GetVersion() const noexcept { return m_version; }
+    const std::vector<InstanceTransform>& GetTileInstances(uint32_t tileX, uint32_t tileY) const;
+    // instances of all tiles for the one instanced draw
+    const std::vector<InstanceTransform>& GetInstances();
+
+private:
+    void GeneratePoints(size_t tileIndex);
+    bool UpdateInstances(Tile& tile) const;
+
+private:
+    ScatterDesc m_desc;
+    uint32_t m_tileCountX = 0;
+    uint32_t m_tileCountY = 0;
+    uint32_t m_version = 0;
+    bool m_pointsReady = false;
+    bool m_instancesReady = false;
+    math::Generator2D m_density;
+    std::vector<Tile> m_tiles;
+    std::vector<InstanceTransform> m_instances;
+};
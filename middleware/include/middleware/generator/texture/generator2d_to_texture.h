@@ -1,9 +1,14 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "dg/dg.h"
 #include "core/math/types.h"
 #include "core/common/ctor.h"
 #include "core/math/generator_type.h"
+#include "core/material/texture_compressor.h"
+#include "middleware/generator/texture/texel_baker.h"
 
 
 class DynamicTexture;
@@ -13,6 +18,8 @@ public:
     ~Generator2dToTexture();
 
     TexturePtr Result();
+    // the texture of the last Result without a bake, the evicted texture is restored from the baked texels
+    TexturePtr Current();
 
     math::Size GetTextureSize() const { return m_textureSize; }
     void SetTextureSize(const math::Size v);
@@ -20,14 +27,30 @@ public:
     math::RectF GetGeneratorRect() const { return m_generatorRect; }
     void SetGeneratorRect(const math::RectF v);
 
+    // BlockFormat::None (default) - RGBA8 dynamic texture with the partial uploads, otherwise the baked texels
+    // are compressed on the CPU to the immutable texture, that is recreated on every change. BC1 keeps the gray output,
+    // BC4 keeps only the red channel and samples as (r, 0, 0, 1), so it fits only the shaders that read r.
+    // The compressed texture size must be multiple of 4
+    void SetCompression(const TextureCompressorDesc& desc);
+
+    // the samples are shared with the other users of the cache, see TexelBaker
+    void SetCache(const std::shared_ptr<GeneratorTileCache>& cache, const TileLattice& lattice);
+
     math::Generator2D GetInput() const { return m_input; }
-    void SetInput(const math::Generator2D& v) { m_input = v; }
+    void SetInput(const math::Generator2D& v);
+    // the input has changed only in the changedRect (in the generator space), the rest texels are reused
+    void SetInput(const math::Generator2D& v, const math::RectF& changedRect);
 
 private:
-    void FillTexture(dg::RefCntAutoPtr<DynamicTexture>& texture) const;
+    void UploadTexture(dg::RefCntAutoPtr<DynamicTexture>& texture, const std::vector<math::Rect>& rects) const;
+    void UploadAll();
+    TexturePtr CompressedResult();
 
 private:
+    TexelBaker m_baker;
     dg::RefCntAutoPtr<DynamicTexture> m_texture;
+    TexturePtr m_compressed;
+    TextureCompressorDesc m_compression = TextureCompressorDesc{BlockFormat::None, CompressionQuality::Normal, 0};
     math::Size m_textureSize = math::Size(128);
     math::RectF m_generatorRect = math::RectF(-5.f, -5.f, 10.f, 10.f);
     math::Generator2D m_input;
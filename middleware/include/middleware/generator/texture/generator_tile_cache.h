@@ -0,0 +1,115 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "core/math/types.h"
+#include "core/common/ctor.h"
+#include "core/math/generator_type.h"
+
+
+struct GeneratorTileCacheDesc {
+    // memory of the tile samples, in bytes
+    size_t maxMemory = 64 * 1024 * 1024;
+    // side of the square tile in samples, must be even
+    uint32_t tileSize = 64;
+};
+
+// grid of the generator samples: sample (x, y) of LOD is taken at origin + (x, y) * step * 2^lod,
+// so sample (x, y) of LOD n + 1 is sample (2x, 2y) of LOD n
+struct TileLattice {
+    double originX = 0;
+    double originY = 0;
+    double step = 1.;
+};
+
+struct GeneratorTileCacheCounters {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    // misses that are built from the cached tiles of the finer LOD, without sampling the generator
+    uint64_t downsampled = 0;
+    uint64_t evictions = 0;
+    size_t tiles = 0;
+    size_t memory = 0;
+};
+
+// LRU of the float tiles of Generator2D samples, shared between the consumers, that sample the same generator
+// over overlapping regions (node previews, bakes). The key is (generator identity, lattice, tile, LOD).
+// The entry holds a copy of the generator, so the identity can't be reused by another generator
+// while its tiles are in the cache. All methods are thread-safe, the generator is sampled outside the lock,
+// so the concurrent misses of the same tile can sample it twice.
+class GeneratorTileCache : Fixed {
+public:
+    // count of the finer LODs, that are searched for the downsampling
+    static constexpr const uint32_t MaxDownsampleLevels = 3;
+
+    // samples of the tile from top to bottom, the row stride is tileSize
+    using Tile = std::shared_ptr<const std::vector<float>>;
+
+private:
+    struct Key {
+        const void* generatorId;
+        TileLattice lattice;
+        int32_t tileX;
+        int32_t tileY;
+        uint32_t lod;
+
+        bool operator==(const Key& other) const noexcept;
+    };
+
+    struct KeyHasher {
+        size_t operator()(const Key& key) const noexcept;
+    };
+
+    struct Entry {
+        Key key;
+        Tile tile;
+        // keeps the generator identity
+        math::Generator2D generator;
+    };
+
+public:
+    GeneratorTileCache() = delete;
+    GeneratorTileCache(const GeneratorTileCacheDesc& desc);
+    ~GeneratorTileCache() = default;
+
+public:
+    const GeneratorTileCacheDesc& GetDesc() const noexcept { return m_desc; }
+
+    // the tile is sampled on a miss, or downsampled if the finer LODs of the whole tile are in the cache
+    Tile GetTile(const math::Generator2D& input, const TileLattice& lattice, int32_t tileX, int32_t tileY, uint32_t lod);
+    // copies the samples [x, x + size.w) * [y, y + size.h) of LOD to dst, the row stride is size.w
+    void Sample(const math::Generator2D& input, const TileLattice& lattice, uint32_t lod, int32_t x, int32_t y, math::Size size, float* dst);
+
+    // removes all tiles of the generator
+    void Invalidate(const math::Generator2D& input);
+    void Clear();
+
+    GeneratorTileCacheCounters GetCounters() const;
+
+private:
+    Tile Find(const Key& key);
+    Tile TryDownsample(const Key& key);
+    Tile DownsampleLocked(const Key& key, uint32_t levels) const;
+    Tile SampleTile(const math::Generator2D& input, const Key& key) const;
+    void Insert(const Key& key, const Tile& tile, const math::Generator2D& input);
+    void Evict();
+    size_t TileMemory() const noexcept;
+
+private:
+    GeneratorTileCacheDesc m_desc;
+    mutable std::mutex m_mutex;
+    size_t m_memory = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_downsampled = 0;
+    uint64_t m_evictions = 0;
+    // front - most recently used
+    std::list<Entry> m_entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHasher> m_index;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "core/common/ctor.h"
+#include "core/math/generator_type.h"
+
+
+// Splits the gradient of the input into the partial derivatives,
+// uses the analytic gradient of the input if it has one
+class GradientSplit : Fixed {
+public:
+    GradientSplit() = default;
+    ~GradientSplit() = default;
+
+    math::Generator3D DX() const;
+    math::Generator3D DY() const;
+    math::Generator3D DZ() const;
+
+    math::Generator3D GetInput() const { return m_input; }
+    void SetInput(const math::Generator3D v) { m_input = v; }
+
+private:
+    math::Generator3D m_input;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "core/math/types.h"
+#include "core/common/ctor.h"
+#include "core/math/generator_type.h"
+
+
+enum class NormalMapMode : uint8_t {
+    // math::Generator2::Gradient, the analytic gradient of the generator in one pass,
+    // falls back to central differences if the generator has no analytic gradient
+    Analytic = 0,
+    // central differences with the half texel step, 5 evaluations of the generator per texel
+    FiniteDifferences = 1,
+};
+
+struct NormalMapBakerDesc {
+    // region in the generator space
+    math::RectF region = math::RectF(0, 0, 1.f, 1.f);
+    // count of texels
+    math::Size size = math::Size(256, 256);
+    // multiplier of the height derivatives, bigger values give steeper normals
+    float heightScale = 1.f;
+    NormalMapMode mode = NormalMapMode::Analytic;
+};
+
+// Bakes the height generator to RGBA8 texels: RGB - tangent space normal, A - height mapped from [-1, 1]
+class NormalMapBaker : Fixed {
+public:
+    NormalMapBaker() = delete;
+    NormalMapBaker(const NormalMapBakerDesc& desc);
+    ~NormalMapBaker() = default;
+
+    const NormalMapBakerDesc& GetDesc() const noexcept { return m_desc; }
+    void SetMode(NormalMapMode mode) noexcept { m_desc.mode = mode; }
+
+    void Bake(const math::Generator2D& input);
+
+    const uint32_t* GetTexels() const noexcept { return m_texels.data(); }
+    // in bytes
+    uint32_t GetStride() const noexcept { return m_desc.size.w * sizeof(uint32_t); }
+
+private:
+    NormalMapBakerDesc m_desc;
+    std::vector<uint32_t> m_texels;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/math/types.h"
+#include "core/common/ctor.h"
+#include "core/math/generator_type.h"
+#include "middleware/generator/texture/generator_tile_cache.h"
+
+
+// CPU side of Generator2dToTexture: keeps the baked RGBA8 texels between bakes and finds the regions,
+// that need to be uploaded to the texture.
+// Panning the generator rect by a whole number of texels shifts the texels and samples only the exposed strips.
+// A copy of the uploaded texels is kept, only the tiles that differ from it are uploaded, also after a shift.
+// With a cache the samples are taken from GeneratorTileCache, if the texel size is lattice.step * 2^lod
+// and the generator rect is aligned to the lattice, otherwise the input is sampled directly.
+class TexelBaker : Fixed {
+public:
+    static constexpr const uint32_t TileSize = 32;
+
+    TexelBaker() = default;
+    ~TexelBaker() = default;
+
+public:
+    // nullptr - sample the input directly
+    void SetCache(const std::shared_ptr<GeneratorTileCache>& cache, const TileLattice& lattice);
+    // the next bake samples and uploads all texels
+    void Reset() noexcept;
+    // the input has changed in the whole generator rect
+    void Invalidate() noexcept;
+    // the input has changed only in the changedRect (in the generator space)
+    void Invalidate(const math::RectF& changedRect) noexcept;
+
+    // returns the texel rects for upload, empty if nothing has changed
+    const std::vector<math::Rect>& Bake(const math::Generator2D& input, const math::RectF& generatorRect, math::Size size);
+
+    const uint32_t* GetTexels() const noexcept { return m_texels.data(); }
+    const uint32_t* GetTexels(const math::Rect& rect) const noexcept { return &m_texels[rect.y * m_size.w + rect.x]; }
+    // in bytes
+    uint32_t GetStride() const noexcept { return m_size.w * sizeof(uint32_t); }
+    // count of sampled texels by the last bake
+    size_t GetSampledCount() const noexcept { return m_sampledCount; }
+
+private:
+    bool TryGetShift(const math::RectF& generatorRect, int32_t& dx, int32_t& dy) const;
+    void Shift(int32_t dx, int32_t dy);
+    bool TryGetLatticeOffset(uint32_t& lod, int32_t& x, int32_t& y) const;
+    void Sample(const math::Generator2D& input, const math::Rect& rect);
+    // compares the tile with the uploaded texels, copies it to them if it differs
+    bool UpdateUploadedTile(const math::Rect& rect);
+    math::Rect GetTileRect(uint32_t tileX, uint32_t tileY) const;
+
+private:
+    bool m_isBaked = false;
+    bool m_invalidateAll = false;
+    std::vector<math::RectF> m_changedRects;
+
+    size_t m_sampledCount = 0;
+    math::Size m_size;
+    math::RectF m_generatorRect;
+    uint32_t m_tileCountX = 0;
+    uint32_t m_tileCountY = 0;
+    std::vector<uint32_t> m_texels;
+    // the copy of the texture texels, Shift moves only m_texels
+    std::vector<uint32_t> m_uploaded;
+    std::vector<math::Rect> m_uploadRects;
+
+    TileLattice m_lattice;
+    std::vector<float> m_cacheSamples;
+    std::shared_ptr<GeneratorTileCache> m_cache;
+};
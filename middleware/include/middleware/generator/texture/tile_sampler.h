@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "core/math/types.h"
+#include "core/common/ctor.h"
+#include "core/math/generator_type.h"
+
+
+struct TileSamplerDesc {
+    // region in the generator space
+    math::RectF region = math::RectF(-5.f, -5.f, 10.f, 10.f);
+    // count of samples
+    math::Size size = math::Size(1024);
+    // side of the square tile in samples
+    uint32_t tileSize = 256;
+    // 0 - std::thread::hardware_concurrency
+    uint32_t threadCount = 0;
+};
+
+class WorkerPool;
+// Samples a generator over a large region by horizontal bands of tiles, the tiles of a band are sampled in parallel.
+// Only one band (size.w * tileSize samples) is kept in memory, so the size of the region is not limited by RAM.
+// Sample (x, y) is taken at region.LeftTop() + (x, y) * region.Size() / size, as in TexelBaker
+class TileSampler : Fixed {
+public:
+    // rows of the band from top to bottom, the row stride is size.w, y - index of the first row
+    using BandSink = std::function<void (const float* rows, uint32_t y, uint32_t rowsCount)>;
+
+    TileSampler() = delete;
+    TileSampler(const TileSamplerDesc& desc);
+    ~TileSampler();
+
+public:
+    const TileSamplerDesc& GetDesc() const noexcept { return m_desc; }
+    uint32_t GetBandCount() const noexcept { return m_bandCount; }
+    // threads that sample the tiles of a band, with the calling thread, they are reused by all bands
+    uint32_t GetThreadCount() const noexcept;
+    // count of samples by the last Sample call
+    uint64_t GetSampledCount() const noexcept { return m_sampledCount; }
+
+    // bands are passed to the sink from top to bottom, or from bottom to top if bottomUp
+    void Sample(const math::Generator2D& input, const BandSink& sink, bool bottomUp = false);
+
+private:
+    void SampleTile(const math::Generator2D& input, uint32_t tileX, uint32_t bandY, uint32_t rowsCount);
+
+private:
+    TileSamplerDesc m_desc;
+    uint32_t m_tileCountX = 0;
+    uint32_t m_bandCount = 0;
+    uint64_t m_sampledCount = 0;
+    std::vector<float> m_band;
+    std::unique_ptr<WorkerPool> m_workers;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 #include <cstdint>
 #include <string_view>
@@ -25,11 +26,29 @@ public:
     Draw(TexturePtr& texBackground);
     ~Draw();
 
+    // heat overlay and tooltip with node profiles, works if GS_PROFILE_ENABLE
+    bool IsShowProfile() const noexcept { return m_showProfile; }
+    void SetShowProfile(bool value) noexcept { m_showProfile = value; }
+    // screen rect of the node editor canvas, nodes outside it are culled
+    void SetViewport(const math::RectF& screenRect) noexcept { m_viewport = screenRect; }
+    // nodes are drawn collapsed, if the zoom (screen pixels per canvas unit) is less than this value
+    void SetCollapseZoom(float value) noexcept { m_collapseZoom = value; }
+
+    // viewport in screen coordinates, visibleRect is the same area in canvas coordinates
+    static bool IsCollapsedZoom(const math::RectF& viewport, const math::RectF& visibleRect, float collapseZoom) noexcept;
+    // rects in canvas coordinates, the empty nodeRect is the unknown bounds of the node that was not drawn yet,
+    // the empty visibleRect is the unknown viewport
+    static NodeLod CalcNodeLod(const math::RectF& nodeRect, const math::RectF& visibleRect, bool isCollapsedZoom) noexcept;
+
 // Draw graph
 public:
     void OnStartDrawGraph() final;
     void OnFinishDrawGraph() final;
 
+    NodeLod GetNodeLod(uintptr_t id) final;
+    void OnDrawCollapsedNode(uintptr_t id, std::string_view displayName, const std::vector<IDraw::Pin>& inputPins,
+        const std::vector<IDraw::Pin>& outputPins, bool isValid) final;
+
     void OnStartDrawNode(uintptr_t id, std::string_view displayName) final;
     void OnFinishDrawNode(bool isValid, std::string_view errorMessage) final;
 
@@ -37,6 +56,7 @@ public:
     void OnDrawMiniPreview(TypeId valueTypeId, const cpgf::GVariant& value, uint8_t valueVersion) final;
     void OnDrawOutputPins(const std::vector<IDraw::Pin>& pins) final;
     void OnDrawLink(uintptr_t linkId, uintptr_t srcPinId, uintptr_t dstPinId) final;
+    void OnDrawNodeProfile(const NodeProfile& profile) final;
 
     // nodeId == 0 for disable preview
     void OnDrawFullPreview(uint16_t nodeId, TypeId valueTypeId, const cpgf::GVariant& value, uint8_t valueVersion) final;
@@ -47,14 +67,28 @@ public:
     ButtonsState OnDrawPinProperty(std::string_view displayName, TypeInstance* typeInstance, bool disabled) final;
     void OnFinishDrawNodeProperty() final;
 
+private:
+    DrawNode& GetDrawNode(uintptr_t id);
+
 // tmp data for draw frame
 private:
+    bool m_isCollapsedZoom = false;
+    // in canvas coordinates
+    math::RectF m_visibleRect;
     uint8_t m_alpha = 0;
     uint16_t m_previewNodeId = 0;
     DrawNode* m_node = nullptr;
+    uintptr_t m_hoveredNodeId = 0;
+    uint64_t m_frameMaxTimeNs = 0;
+    std::string m_profileTooltip;
 
 // persistent data
 private:
+    bool m_showProfile = false;
+    float m_collapseZoom = 0.5f;
+    math::RectF m_viewport;
+    // max average node time of the previous frame, for the heat scale
+    uint64_t m_maxTimeNs = 0;
     // key = nodeIndex
     std::vector<DrawNode> m_nodes;
     math::SizeF m_texBackgroundSize;
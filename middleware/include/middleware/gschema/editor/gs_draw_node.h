@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 #include <cstdint>
 #include <string_view>
@@ -30,6 +31,16 @@ public:
     void OnDrawInputPins(const std::vector<IDraw::Pin>& pins);
     void OnDrawPreview(TypeId valueTypeId, const cpgf::GVariant& value, uint8_t valueVersion);
     void OnDrawOutputPins(const std::vector<IDraw::Pin>& pins);
+    // header with anchors for links, without pin widgets and preview
+    void OnDrawCollapsedNode(uintptr_t id, std::string_view displayName, const std::vector<IDraw::Pin>& inputPins,
+        const std::vector<IDraw::Pin>& outputPins, bool isValid, uint8_t alpha);
+    // the node is outside the visible area, keeps the state (preview, sizes) until it becomes visible again
+    void OnCulled() noexcept { m_drawed = true; }
+    // heat in [0, 1] - share of the slowest node time
+    void OnDrawProfile(float heat);
+    std::string GetProfileTooltip(const NodeProfile& profile) const;
+
+    uintptr_t GetNodeId() const noexcept { return m_nodeId; }
 
 private:
     uintptr_t m_nodeId = 0;
@@ -43,9 +54,11 @@ private:
     float m_headerBottom = 0.f;
     float m_inputPinsWidth = 0.f;
     float m_outputPinsWidth = 0.f;
+    math::RectF m_nodeRect;
 
 private:
     static constexpr const float m_iconSideSize = 24.f;
+    static constexpr const float m_anchorSideSize = 6.f;
     static constexpr const math::SizeF m_previewSize = math::SizeF(128.f);
 };
 
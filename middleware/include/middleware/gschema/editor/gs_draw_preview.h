@@ -28,15 +28,22 @@ public:
     void Reset();
     void Draw(TypeId typeId, const cpgf::GVariant& value, uint8_t valueVersion, gui::ImageStyle& style, math::SizeF drawSize);
 
+    // texture bakes of generators, they are counted only if GS_PROFILE_ENABLE
+    uint32_t BakesCount() const noexcept { return m_bakesCount; }
+    uint64_t LastBakeTimeNs() const noexcept { return m_lastBakeTimeNs; }
+
 private:
     bool IsNeedUpdateTexture(uint8_t valueVersion);
     void FillTexture(const math::Generator2D& v);
+    void DrawTexture(math::SizeF drawSize, gui::ImageStyle& style);
 
 private:
     bool m_fullPreview = false;
+    bool m_isFilled = false;
     uint8_t m_frameCounter = 0;
     uint8_t m_valueVersion = 0;
-    TextureViewPtr m_texture;
+    uint32_t m_bakesCount = 0;
+    uint64_t m_lastBakeTimeNs = 0;
     Generator2dToTexture* m_generator = nullptr;
 };
 
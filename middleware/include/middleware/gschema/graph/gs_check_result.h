@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+
+namespace gs {
+
+// Result of the graph validation, the Test* and Check* functions of Graph are based on it
+enum class CheckResult : uint8_t {
+    Ok = 0,
+    ZeroId = 1,
+    NodeIdOutOfRange = 2,
+    NodeRemoved = 3,
+    NotEmbeddedPin = 4,
+    NotInputPin = 5,
+    NotOutputPin = 6,
+    PinIndexOutOfRange = 7,
+    SameNode = 8,
+    Cycle = 9,
+    LinkExists = 10,
+    LinkNotExists = 11,
+    IncompatibleTypes = 12,
+};
+
+constexpr std::string_view ToString(CheckResult value) noexcept {
+    switch (value) {
+    case CheckResult::Ok:
+        return "ok";
+    case CheckResult::ZeroId:
+        return "id must be more than 0";
+    case CheckResult::NodeIdOutOfRange:
+        return "node id is out of range";
+    case CheckResult::NodeRemoved:
+        return "node is removed";
+    case CheckResult::NotEmbeddedPin:
+        return "pin is not embedded";
+    case CheckResult::NotInputPin:
+        return "pin is not input";
+    case CheckResult::NotOutputPin:
+        return "pin is not output";
+    case CheckResult::PinIndexOutOfRange:
+        return "pin index is out of range";
+    case CheckResult::SameNode:
+        return "nodes cannot be equivalent";
+    case CheckResult::Cycle:
+        return "graph after add this link is not acyclic";
+    case CheckResult::LinkExists:
+        return "link already exist";
+    case CheckResult::LinkNotExists:
+        return "link does not exist";
+    case CheckResult::IncompatibleTypes:
+        return "types are not compatible";
+    }
+
+    return "unknown";
+}
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <typeindex>
 #include <string_view>
@@ -20,6 +21,7 @@ class MetaClass;
 class MetaProperty;
 class TypeInstanceEdit;
 class TypesConvertStorage;
+// Immutable after Create, all const methods are safe to call from several threads
 class Class : Fixed {
 public:
     Class() = default;
@@ -52,8 +54,11 @@ public:
     // will return nullptr if convertation is not possible
     ConvertFunc GetFuncConvertToDefaultType(uint8_t pinIndex, TypeId typeId) const;
 
-    void* CreateInstance();
-    void DestroyInstance(void* instance);
+    size_t GetInstanceSize() const noexcept;
+    size_t GetInstanceAlignment() const noexcept;
+    // memory is owned by the caller (see GraphArena::AllocateInstance)
+    void* CreateInstance(void* memory) const;
+    void DestroyInstance(void* instance) const;
 
     cpgf::GVariant GetValue(uint8_t pinIndex, const void* instance) const;
     void SetValue(uint8_t pinIndex, void* instance, const cpgf::GVariant& value) const;
@@ -10,6 +10,8 @@
 namespace gs {
 
 class Class;
+// Immutable after the constructor, can be shared by graphs evaluated in different threads.
+// TypeInstanceEdit objects of the classes are for the editor UI and are not thread-safe
 class ClassStorage : Fixed {
 public:
     ClassStorage();
@@ -4,6 +4,7 @@
 #include <string_view>
 
 #include "core/common/ctor.h"
+#include "middleware/gschema/graph/gs_profile.h"
 #include "middleware/gschema/graph/gs_types_decl.h"
 
 
@@ -23,10 +24,23 @@ public:
         std::string_view displayName;
     };
 
+    enum class NodeLod : uint8_t {
+        // outside the visible area, the node is not drawn
+        Hidden = 0,
+        // only the header and anchors for links, without pin widgets and preview
+        Collapsed = 1,
+        Full = 2,
+    };
+
 public:
     virtual void OnStartDrawGraph() = 0;
     virtual void OnFinishDrawGraph() = 0;
 
+    // called for each node before drawing, the drawer knows the node bounds and the visible area
+    virtual NodeLod GetNodeLod(uintptr_t id) = 0;
+    virtual void OnDrawCollapsedNode(uintptr_t id, std::string_view displayName, const std::vector<Pin>& inputPins,
+        const std::vector<Pin>& outputPins, bool isValid) = 0;
+
     virtual void OnStartDrawNode(uintptr_t id, std::string_view displayName) = 0;
     virtual void OnFinishDrawNode(bool isValid, std::string_view errorMessage) = 0;
 
@@ -34,6 +48,8 @@ public:
     virtual void OnDrawMiniPreview(TypeId valueTypeId, const cpgf::GVariant& value, uint8_t valueVersion) = 0;
     virtual void OnDrawOutputPins(const std::vector<Pin>& pins) = 0;
     virtual void OnDrawLink(uintptr_t linkId, uintptr_t srcPinId, uintptr_t dstPinId) = 0;
+    // called after OnFinishDrawNode, only if GS_PROFILE_ENABLE
+    virtual void OnDrawNodeProfile(const NodeProfile& profile) = 0;
 
     // nodeId == 0 for disable preview
     virtual void OnDrawFullPreview(uint16_t nodeId, TypeId valueTypeId, const cpgf::GVariant& value, uint8_t valueVersion) = 0;
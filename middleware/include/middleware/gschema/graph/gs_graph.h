@@ -1,21 +1,29 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+#include <cstddef>
 #include <cstdint>
 #include <typeinfo>
+#include <filesystem>
 #include <type_traits>
 #include <string_view>
 
 #include "cpgf/variant.h"
 #include "core/common/ctor.h"
 #include "middleware/gschema/graph/gs_types.h"
+#include "middleware/gschema/graph/gs_profile.h"
+#include "middleware/gschema/graph/gs_graph_arena.h"
+#include "middleware/gschema/graph/gs_check_result.h"
+#include "middleware/gschema/graph/gs_result_cache.h"
 
 
 namespace gs {
 
-class Node;
 class IDraw;
 class ClassStorage;
+// A graph is not thread-safe, but separate graphs sharing one ClassStorage
+// can be edited and updated concurrently, one thread per graph
 class Graph : Fixed {
 public:
     Graph() = delete;
@@ -28,9 +36,23 @@ public:
     void DrawNodeProperty(uint16_t nodeId, IDraw* drawer);
 
     uint16_t CountNodes() const noexcept { return m_capacity - m_free; }
+    // heap allocations of nodes, pins and instances (for tests and profiling)
+    ArenaCounters GetAllocationCounters() const noexcept;
+
+    // memoization of node outputs by a content hash of their inputs, it is disabled by default.
+    // Use it for graphs of pure nodes: outputs depend only on the embedded and input values
+    void EnableResultCache(size_t maxEntries, size_t maxMemory);
+    void DisableResultCache();
+    ResultCacheCounters GetResultCacheCounters() const noexcept;
+
+    // evaluation counters of the node, they are zero if the profiling is compiled out (GS_PROFILE_ENABLE)
+    NodeProfile GetNodeProfile(uint16_t nodeId) const;
+    void ResetProfiles() noexcept;
 
     const cpgf::GVariant& GetOutputValue(uint32_t pinId) const;
     const cpgf::GVariant& GetOutputValue(uint16_t nodeId, uint8_t outputPinOffset) const;
+    // the value of the universal type is unwrapped, returns the base type id of the value (Float, Generator2d, ...)
+    TypeId GetOutputBaseValue(uint16_t nodeId, uint8_t outputPinOffset, cpgf::GVariant& value) const;
 
     template<typename T>
         void SetEmbeddedValue(uint32_t pinId, const T& value) {
@@ -49,9 +71,22 @@ public:
             SetInputValueImpl(nodeId, inputPinOffset, cpgf::copyVariantFromCopyable(value), GetTypeId<T>());
         }
 
+    // binary schema: class names, nodes with embedded and input values, links
+    void Save(std::vector<uint8_t>& data) const;
+    void SaveToFile(const std::filesystem::path& path) const;
+    // replaces all nodes of the graph in one pass, node ids are kept, on error the graph stays empty
+    void Load(const uint8_t* data, size_t size);
+    void LoadFromFile(const std::filesystem::path& path);
+
     uint16_t AddNode(uint16_t classIndex);
     uint16_t AddNode(std::string_view name);
 
+    // error-code based checks, they do not throw and are cheap enough for per-frame calls from the editor,
+    // they only read the graph and can be called from several threads while the graph is not changed
+    CheckResult ValidateRemoveNode(uint16_t nodeId) const noexcept;
+    CheckResult ValidateAddLink(uint32_t srcPinId, uint32_t dstPinId) const noexcept;
+    CheckResult ValidateRemoveLink(uint64_t linkId) const noexcept;
+
     bool TestRemoveNode(uint16_t nodeId) const noexcept;
     void RemoveNode(uint16_t nodeId);
 
@@ -69,7 +104,24 @@ private:
     void SetInputValueImpl(uint32_t pinId, const cpgf::GVariant& value, TypeId typeId);
     void SetInputValueImpl(uint16_t nodeId, uint8_t inputPinOffset, const cpgf::GVariant& value, TypeId typeId);
 
+    void LoadImpl(const uint8_t* data, size_t size);
+    void RemoveAllNodes();
+    void ResizeNodeBuffers();
+#if GS_PROFILE_ENABLE
+    // returns next node index for update
+    uint16_t UpdateNodeStateWithProfile(uint16_t nodeIndex);
+#endif
     void SortNodesByDependency();
+    // iterative, deep chains of nodes do not overflow the stack
+    void CalcOrder(uint16_t nodeIndex, uint16_t mark) noexcept;
+    // true if dstNode depends on srcNode by links, only reads the graph
+    bool ExistsPath(uint16_t srcNodeIndex, uint16_t dstNodeIndex) const noexcept;
+    uint16_t NextVisitMark() noexcept;
+
+    CheckResult ValidateNodeId(uint16_t nodeId) const noexcept;
+    CheckResult ValidateEmbeddedPinId(uint32_t pinId) const noexcept;
+    CheckResult ValidateInputPinId(uint32_t pinId) const noexcept;
+    CheckResult ValidateOutputPinId(uint32_t pinId) const noexcept;
 
     void CheckIsValidNodeId(uint16_t nodeId) const;
     void CheckIsValidEmbeddedPinId(uint32_t pinId) const;
@@ -81,12 +133,28 @@ private:
     void CheckRemoveLink(uint64_t linkId) const;
 
 private:
+    struct StackItem {
+        uint16_t nodeIndex;
+        uint8_t pinIndex;
+    };
+
     uint16_t m_free = 0;
     uint16_t m_capacity = 0;
     uint16_t m_firstFreeIndex = 0;
     uint16_t m_firstCalcIndex = 0;
-    Node* m_nodes = nullptr;
-    uint16_t* m_indeciesForOrder = nullptr;
+    uint16_t m_lastVisitMark = 0;
+    std::vector<uint16_t> m_indeciesForOrder;
+    // capacity is reserved for all nodes, CalcOrder does not allocate
+    std::vector<StackItem> m_stack;
+    // key = nodeIndex, IDraw::NodeLod of the current frame
+    std::vector<uint8_t> m_drawLods;
+#if GS_PROFILE_ENABLE
+    // key = nodeIndex
+    std::vector<NodeProfile> m_profiles;
+#endif
+    NodeStorage m_nodes;
+    GraphArena m_arena;
+    std::unique_ptr<ResultCache> m_resultCache;
     std::shared_ptr<ClassStorage> m_classStorage;
 };
 
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/common/ctor.h"
+#include "middleware/gschema/graph/gs_node.h"
+
+
+namespace gs {
+
+struct ArenaCounters {
+    // heap allocations, they happen only when the arena has no free memory
+    uint32_t nodeChunks = 0;
+    uint32_t pinBlocks = 0;
+    uint32_t instanceSlabs = 0;
+    // requests to the arena, including reused memory
+    uint32_t pinAllocations = 0;
+    uint32_t instanceAllocations = 0;
+};
+
+// Nodes are stored in chunks of fixed size, growth does not move existing nodes
+class NodeStorage : Fixed {
+public:
+    static constexpr const uint32_t ChunkShift = 6;
+    static constexpr const uint32_t ChunkSize = uint32_t(1) << ChunkShift;
+
+public:
+    NodeStorage() = default;
+    ~NodeStorage();
+
+    uint32_t Capacity() const noexcept { return static_cast<uint32_t>(m_chunks.size()) << ChunkShift; }
+    uint32_t ChunksCount() const noexcept { return static_cast<uint32_t>(m_chunks.size()); }
+
+    // adds chunks for nodeCount nodes, calls Node::Init for new nodes
+    void Reserve(uint32_t nodeCount);
+
+    // pointer-like access, as for a plain Node array
+    Node& operator[](uint16_t index) const noexcept {
+        return m_chunks[index >> ChunkShift][index & (ChunkSize - 1)];
+    }
+
+private:
+    std::vector<Node*> m_chunks;
+};
+
+class Class;
+class ClassStorage;
+// Per graph memory for pins and class instances.
+// Pins are carved from contiguous blocks, instances are placed in per class slabs.
+// Released memory goes to free lists and is reused by the next allocations of the same size or class
+class GraphArena : Fixed {
+    struct FreeList {
+        void Push(void* memory) noexcept;
+        void* Pop() noexcept;
+
+        void* head = nullptr;
+    };
+
+    struct ClassSlabs {
+        FreeList freeList;
+        std::byte* current = nullptr;
+        uint32_t used = 0;
+        uint32_t size = 0;
+        size_t slotSize = 0;
+        size_t alignment = 0;
+    };
+
+    struct Slab {
+        void* memory = nullptr;
+        size_t alignment = 0;
+    };
+
+public:
+    static constexpr const uint32_t FirstSlabSize = 8;
+    static constexpr const uint32_t MaxSlabSize = 256;
+
+public:
+    GraphArena() = delete;
+    // the first pin block is sized from the average pins count of the classes
+    GraphArena(const ClassStorage* classStorage, uint16_t initialNodeCount);
+    ~GraphArena();
+
+    ArenaCounters GetCounters() const noexcept { return m_counters; }
+
+    // returns default constructed pins
+    Pin* AllocatePins(uint16_t count);
+    // destroys pins, count must be the same as for AllocatePins
+    void DeallocatePins(Pin* pins, uint16_t count) noexcept;
+
+    // returns uninitialized memory for the class instance (see Class::CreateInstance)
+    void* AllocateInstance(const Class* cls);
+    // the instance must be already destroyed
+    void DeallocateInstance(const Class* cls, void* memory) noexcept;
+
+private:
+    Pin* AllocatePinBlock(uint32_t size);
+
+private:
+    const Class* m_classesBegin = nullptr;
+    ArenaCounters m_counters;
+
+    Pin* m_pinBlock = nullptr;
+    uint32_t m_pinBlockUsed = 0;
+    uint32_t m_pinBlockSize = 0;
+    std::vector<Pin*> m_pinBlocks;
+    // index - pins count
+    std::vector<FreeList> m_freePins;
+
+    // index - class index in ClassStorage
+    std::vector<ClassSlabs> m_classSlabs;
+    std::vector<Slab> m_slabs;
+};
+
+}
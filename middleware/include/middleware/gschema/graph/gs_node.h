@@ -1,12 +1,15 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <cstddef>
 #include <cstdint>
 #include <typeindex>
 
 #include "cpgf/variant.h"
 #include "core/common/ctor.h"
 #include "middleware/gschema/graph/gs_types_decl.h"
+#include "middleware/gschema/graph/gs_check_result.h"
 #include "middleware/gschema/graph/gs_types_convert_func.h"
 
 
@@ -38,7 +41,11 @@ struct Pin : Fixed {
 
 class IDraw;
 class Class;
-class Node : Noncopyable {
+class GraphArena;
+class TypeInstance;
+class NodeStorage;
+class ResultCache;
+class Node : Fixed {
     enum class ChangeState : uint8_t {
         NotChanged = 0,
         NeedUpdateInputs = 1,
@@ -54,15 +61,18 @@ class Node : Noncopyable {
 
 public:
     Node() = default;
-    Node(Node&& o) noexcept;
-    Node& operator=(Node&& o) noexcept;
+    ~Node() = default;
 
     void Init(uint16_t id) noexcept;
-    void Create(Class* cls);
-    void Reset(uint16_t nextIndex);
+    // pins and instance memory are taken from the arena
+    void Create(Class* cls, GraphArena& arena);
+    void Reset(uint16_t nextIndex, GraphArena& arena);
 
 public:
+    const Class* GetClass() const noexcept { return m_class; }
     uint16_t GetNextIndex() const noexcept { return m_nextIndex; }
+    // changes when the output values are recalculated
+    uint8_t GetOutputValueVersion() const noexcept { return m_outputValueVersion; }
     bool IsRemoved() const noexcept { return (m_pins == nullptr); }
 
     // valid for input pins
@@ -85,7 +95,7 @@ public:
     uint8_t EmbeddedPinsEndIndex() const noexcept { return m_countEmbeddedPins; }
     const Pin* EmbeddedPinsBegin() const noexcept { return &m_pins[EmbeddedPinsBeginIndex()]; }
     const Pin* EmbeddedPinsEnd() const noexcept { return &m_pins[EmbeddedPinsEndIndex()]; }
-    void CheckIsValidEmbeddedPinId(uint32_t pinId) const;
+    CheckResult ValidateEmbeddedPinId(uint32_t pinId) const noexcept;
     void CheckIsValidEmbeddedPinType(uint8_t pinIndex, std::type_index typeIndex) const;
 
     uint32_t GetInputPinId(uint8_t offset) const noexcept;
@@ -95,7 +105,7 @@ public:
     uint8_t InputPinsEndIndex() const noexcept { return m_countEmbeddedPins + m_countInputPins; }
     const Pin* InputPinsBegin() const noexcept { return &m_pins[InputPinsBeginIndex()]; }
     const Pin* InputPinsEnd() const noexcept { return &m_pins[InputPinsEndIndex()]; }
-    void CheckIsValidInputPinId(uint32_t pinId) const;
+    CheckResult ValidateInputPinId(uint32_t pinId) const noexcept;
 
     uint32_t GetOutputPinId(uint8_t offset) const noexcept;
     bool IsOutputPinIndex(uint8_t index) const noexcept { return ((OutputPinsBeginIndex() >= index) && (index < OutputPinsEndIndex())); }
@@ -104,31 +114,47 @@ public:
     uint8_t OutputPinsEndIndex() const noexcept { return static_cast<uint8_t>(m_countEmbeddedPins + m_countInputPins + m_countOutputPins); }
     const Pin* OutputPinsBegin() const noexcept { return &m_pins[OutputPinsBeginIndex()]; }
     const Pin* OutputPinsEnd() const noexcept { return &m_pins[OutputPinsBeginIndex()] + OutputPinsCount(); }
-    void CheckIsValidOutputPinId(uint32_t pinId) const;
+    CheckResult ValidateOutputPinId(uint32_t pinId) const noexcept;
 
     uint8_t AllPinsBeginIndex() const noexcept { return 0; }
     uint8_t AllPinsEndIndex() const noexcept { return static_cast<uint8_t>(m_countEmbeddedPins + m_countInputPins + m_countOutputPins); }
 
 public:
     void ResetOrder() noexcept;
-    uint16_t GetOrderNumber(Node* nodes) noexcept;
+    // topological order (longest path from the source nodes), it is kept between the sorts of Graph
+    uint16_t GetOrder() const noexcept { return m_order; }
+    void SetOrder(uint16_t order) noexcept { m_order = order; }
     void SetNextCalcIndex(uint16_t nodeIndex) noexcept { m_nextIndex = nodeIndex; }
 
 public:
-    void ResetAcyclicityChecked() noexcept;
-    bool CheckAcyclicity(Node* nodes, uint16_t dstNodeId) noexcept;
+    // the mark of the last graph traversal that visited the node
+    bool IsVisited(uint16_t mark) const noexcept { return (m_visitMark == mark); }
+    void SetVisited(uint16_t mark) noexcept { m_visitMark = mark; }
 
 public:
     void ResetChangeState() noexcept;
+    // outputs are recalculated at the next update, the id of the outputs is dropped
+    void InvalidateOutputs() noexcept;
     // return next node index for update
-    uint16_t UpdateState(Node* nodes);
+    // with resultCache outputs are taken from the cache if the same inputs have been calculated before
+    uint16_t UpdateState(const NodeStorage& nodes, ResultCache* resultCache);
+    // id of the current outputs in the result cache (see ResultCache), 0 if unknown
+    uint64_t GetOutputId() const noexcept { return m_outputId; }
 
 public:
     const cpgf::GVariant& GetOutputValue(uint8_t pinIndex) const;
+    // the value of the universal type is unwrapped, returns the base type id of the value
+    TypeId GetOutputBaseValue(uint8_t pinIndex, cpgf::GVariant& value) const;
     void SetInputValue(uint8_t pinIndex, TypeId typeId, const cpgf::GVariant& value);
     void SetEmbeddedValue(uint8_t pinIndex, const cpgf::GVariant& value);
     void ResetToDefault(uint8_t pinIndex);
 
+public:
+    // values of embedded and not connected input pins as raw fields (see IPrimitiveType::ToBits)
+    // returns false if the value is not saved: the pin is connected or its type is not editable
+    bool SaveValue(uint8_t pinIndex, TypeId& typeId, std::vector<uint64_t>& fields) const;
+    void LoadValue(uint8_t pinIndex, TypeId typeId, const uint64_t* fields, size_t count);
+
 public:
     void AttachToInputPin(uint8_t inputPinIndex, uint32_t attachedPinID, TypeId attachedPinType);
     void DetachFromInputPin(uint8_t inputPinIndex);
@@ -148,10 +174,23 @@ private:
     void AttachToInputPinCalcType(uint8_t inputPinIndex, TypeId attachedPinType);
     void DetachFromInputPinCalcType(uint8_t inputPinIndex);
     void TryChange(uint8_t pinIndex);
+    // ids, types and default values of the pins of the created node
+    void InitPins();
+    // the key of the result cache: the class, the embedded and input values and the output ids
+    // of the attached nodes, returns false if some value cannot be a part of the key
+    bool CalcInputsKey(const NodeStorage& nodes, std::vector<uint64_t>& key) const;
+    // returns true if some output value is changed
+    bool CalcOutputs();
+    // type instance of the pin for the conversion of the values, it isn't initialized
+    // with the pin value, because it's shared by all graphs with the same ClassStorage
+    const TypeInstance* GetTypeInstance(uint8_t pinIndex, TypeId typeId) const;
+    // the value of the embedded or input pin as the type of the type instance
+    cpgf::GVariant GetEditValue(uint8_t pinIndex) const;
 
 public:
     TypeId GetValueForPreview(cpgf::GVariant& value);
     void DrawGraph(IDraw* drawer);
+    void DrawCollapsedGraph(IDraw* drawer);
     void DrawNodePreview(IDraw* drawer);
     void DrawNodeProperty(IDraw* drawer);
 
@@ -167,14 +206,13 @@ private:
     ValidFlags m_validFlags = ValidFlags::Valid;
     ChangeState m_changeState = ChangeState::NotChanged;
 
-    union {
-        uint16_t m_order = 0;
-        bool m_isAcyclicityChecked;
-    };
+    uint16_t m_order = 0;
 
     // index in Graph::m_nodes (next free node or next node for calc)
     uint16_t m_nextIndex = 0;
+    uint16_t m_visitMark = 0;
 
+    uint64_t m_outputId = 0;
     Pin* m_pins = nullptr;
     Class* m_class = nullptr;
     void* m_instance = nullptr;
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+
+// set by the build (TERRA_GS_PROFILE_ENABLE option), with 0 the profiling code is compiled out
+#ifndef GS_PROFILE_ENABLE
+#  define GS_PROFILE_ENABLE 0
+#endif
+
+namespace gs {
+
+struct NodeProfile {
+    uint64_t AvgTimeNs() const noexcept { return (evaluations == 0) ? 0 : (totalTimeNs / evaluations); }
+
+    // recalculations of the node outputs in Graph::UpdateState, including the outputs restored from the result cache
+    uint32_t evaluations = 0;
+    uint64_t lastTimeNs = 0;
+    uint64_t totalTimeNs = 0;
+    // approximate size of the values copied to the output pins (see GetTypeSize)
+    uint64_t outputBytes = 0;
+};
+
+}
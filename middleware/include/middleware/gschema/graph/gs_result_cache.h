@@ -0,0 +1,83 @@
+#pragma once
+
+#include <list>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "cpgf/variant.h"
+#include "core/common/ctor.h"
+#include "middleware/gschema/graph/gs_types_decl.h"
+
+
+namespace gs {
+
+struct ResultCacheCounters {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t memory = 0;
+};
+
+struct Pin;
+// LRU of node output values, the key is the content of the node inputs (see Node::CalcInputsKey): the class,
+// the embedded and input values and the ids of the outputs of the attached nodes. The key is compared
+// on each hit, so a collision of the hashes doesn't return the outputs of other inputs. The entry id is unique
+// in the cache, it identifies the output values for the keys of the dependent nodes.
+// Size is bounded by the number of entries and by the memory of the entries with their values
+// (see CalcValueMemory), the captured state of the generator functors is not counted
+class ResultCache : Fixed {
+    struct Value {
+        cpgf::GVariant value;
+        TypeId typeId;
+    };
+
+    struct Entry {
+        uint64_t id;
+        size_t hash;
+        size_t memory;
+        std::vector<uint64_t> key;
+        std::vector<Value> values;
+    };
+
+public:
+    ResultCache() = delete;
+    ResultCache(size_t maxEntries, size_t maxMemory);
+    ~ResultCache() = default;
+
+    // the buffer for Node::CalcInputsKey, it is reused by all nodes of the graph
+    std::vector<uint64_t>& GetKeyBuffer() noexcept { return m_keyBuffer; }
+
+    // Returns the id of the entry with the same key or 0, the entry becomes the most recently used.
+    // If the id isn't currentId (the id of the values in the pins), the cached values are copied to the output pins
+    uint64_t Restore(const std::vector<uint64_t>& key, uint64_t currentId, Pin* outputPins, uint8_t count);
+    // returns the id of the new entry, 0 if the values are greater than the memory limit
+    uint64_t Insert(const std::vector<uint64_t>& key, const Pin* outputPins, uint8_t count);
+    void Clear();
+
+    ResultCacheCounters GetCounters() const noexcept;
+
+    // memory of the variant with the value and of the objects owned by it
+    static size_t CalcValueMemory(const cpgf::GVariant& value, TypeId typeId, bool isUniversal);
+
+private:
+    void Evict();
+
+private:
+    size_t m_maxEntries = 0;
+    size_t m_maxMemory = 0;
+    size_t m_memory = 0;
+    uint64_t m_nextId = 1;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+    std::vector<uint64_t> m_keyBuffer;
+    // front - most recently used
+    std::list<Entry> m_entries;
+    // key - hash of Entry::key
+    std::unordered_map<size_t, std::list<Entry>::iterator> m_index;
+};
+
+}
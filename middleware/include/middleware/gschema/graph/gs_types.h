@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <variant>
 #include <typeindex>
@@ -73,5 +74,7 @@ TypeId GetNextBaseType(TypeId typeId);
 
 bool IsValidPinType(std::type_index typeIndex);
 bool IsEnableUI(TypeId typeId);
+// size of the value of the type, for generators only the size of the wrapper is counted
+size_t GetTypeSize(TypeId typeId);
 
 }
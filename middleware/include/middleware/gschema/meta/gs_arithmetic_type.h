@@ -1,5 +1,6 @@
 #pragma once
 
+#include <bit>
 #include <limits>
 #include <cstdint>
 #include <charconv>
@@ -95,6 +96,14 @@ public:
         return cpgf::createVariant<T>(m_value, true);
     }
 
+    uint64_t ValueToBits(const cpgf::GVariant& value) const final {
+        return ToRawBits(ApplyLimits(cpgf::fromVariant<T>(value)));
+    }
+
+    cpgf::GVariant ValueFromBits(uint64_t value) const final {
+        return cpgf::createVariant<T>(ApplyLimits(FromRawBits(value)), true);
+    }
+
 public:
     bool IsEnumType() const noexcept final {
         return false;
@@ -187,7 +196,39 @@ public:
         }
     }
 
+    uint64_t ToBits() const final {
+        return ToRawBits(m_value);
+    }
+
+    void FromBits(uint64_t value) final {
+        ApplyLimitsAndSet(FromRawBits(value));
+    }
+
 private:
+    static uint64_t ToRawBits(T value) noexcept {
+        if constexpr (std::is_same_v<T, float>) {
+            return std::bit_cast<uint32_t>(value);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return std::bit_cast<uint64_t>(static_cast<double>(value));
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return value ? 1 : 0;
+        } else {
+            return static_cast<uint64_t>(static_cast<std::make_unsigned_t<T>>(value));
+        }
+    }
+
+    static T FromRawBits(uint64_t value) noexcept {
+        if constexpr (std::is_same_v<T, float>) {
+            return std::bit_cast<float>(static_cast<uint32_t>(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return static_cast<T>(std::bit_cast<double>(value));
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return (value != 0);
+        } else {
+            return static_cast<T>(static_cast<std::make_unsigned_t<T>>(value));
+        }
+    }
+
     void RecalcStep() {
         if constexpr (std::is_floating_point_v<T>) {
             T step = static_cast<T>((m_maxValue - m_minValue) / static_cast<T>(1000));
@@ -197,18 +238,21 @@ private:
         }
     }
 
-    void ApplyLimitsAndSet(T value) {
-        m_state |= StateFlags::ValueChanged;
-
+    T ApplyLimits(T value) const {
         if (m_limitFunc != nullptr) {
-            m_value = m_limitFunc(value);
+            return m_limitFunc(value);
         } else if (m_minValue > value) {
-            m_value = m_minValue;
+            return m_minValue;
         } else if (m_maxValue < value) {
-            m_value = m_maxValue;
-        } else {
-            m_value = value;
+            return m_maxValue;
         }
+
+        return value;
+    }
+
+    void ApplyLimitsAndSet(T value) {
+        m_state |= StateFlags::ValueChanged;
+        m_value = ApplyLimits(value);
     }
 
 private:
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 #include <typeindex>
 #include <type_traits>
 
@@ -31,6 +32,9 @@ public:
 
     virtual void SetValue(const cpgf::GVariant& value) = 0;
     virtual cpgf::GVariant GetValue() const = 0;
+    // the value to/from CountItem() fields without the state of the object (see IPrimitiveTypeEdit)
+    virtual void ValueToBits(const cpgf::GVariant& value, uint64_t* fields) const = 0;
+    virtual cpgf::GVariant ValueFromBits(const uint64_t* fields) const = 0;
 
     size_t CountItem() const;
     IPrimitiveType* GetItemValue(size_t index) const;
@@ -71,6 +75,22 @@ public:
 
         return cpgf::createVariant<T>(tmp, true);
     }
+
+    void ValueToBits(const cpgf::GVariant& value, uint64_t* fields) const final {
+        const T tmp = cpgf::fromVariant<T>(value);
+        for(const auto& property: m_properties) {
+            *fields++ = property.primitiveType->ValueToBits(cpgf::createVariant<ItemType>(tmp[property.index], true));
+        }
+    }
+
+    cpgf::GVariant ValueFromBits(const uint64_t* fields) const final {
+        T tmp;
+        for(const auto& property: m_properties) {
+            tmp[property.index] = cpgf::fromVariant<ItemType>(property.primitiveType->ValueFromBits(*fields++));
+        }
+
+        return cpgf::createVariant<T>(tmp, true);
+    }
 };
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 // based on cpgf/gmetadefine.h
 
+#include <new>
 #include <limits>
 #include <vector>
 #include <cstdint>
@@ -249,13 +250,13 @@ private:
     MetaType* m_metaType = nullptr;
 };
 
-template<typename T> void* Ctor() {
-    return reinterpret_cast<void*>(new T());
+template<typename T> void* Ctor(void* memory) {
+    return reinterpret_cast<void*>(new (memory) T());
 }
 
 template<typename T> void Dtor(void* instance) {
     T* tInstance = reinterpret_cast<T*>(instance);
-    delete tInstance;
+    tInstance->~T();
 }
 
 }
@@ -284,7 +285,8 @@ detail::DefineClass DefineClass(std::string_view className, std::string_view dis
         baseClass = MetaStorage::GetInstance().GetBaseClass(std::type_index(typeid(BaseType0)));
     }
 
-    auto* metaClass = new MetaClass(&detail::Ctor<ClassType>, &detail::Dtor<ClassType>, className, displayName, baseClass);
+    auto* metaClass = new MetaClass(&detail::Ctor<ClassType>, &detail::Dtor<ClassType>, sizeof(ClassType), alignof(ClassType),
+        className, displayName, baseClass);
     return detail::DefineClass(std::type_index(typeid(ClassType)), metaClass);
 }
 
@@ -66,6 +66,14 @@ public:
         return cpgf::createVariant<T>(static_cast<T>(m_value), true);
     }
 
+    uint64_t ValueToBits(const cpgf::GVariant& value) const final {
+        return static_cast<MetaEnum::ValueType>(cpgf::fromVariant<T>(value));
+    }
+
+    cpgf::GVariant ValueFromBits(uint64_t value) const final {
+        return cpgf::createVariant<T>(static_cast<T>(value), true);
+    }
+
 public:
     bool IsEnumType() const noexcept final {
         return true;
@@ -102,6 +110,15 @@ public:
         m_state |= StateFlags::ValueChanged;
     }
 
+    uint64_t ToBits() const final {
+        return m_value;
+    }
+
+    void FromBits(uint64_t value) final {
+        m_value = value;
+        m_state |= StateFlags::ValueChanged;
+    }
+
 private:
     MetaEnum::ValueType m_value = 0;
 
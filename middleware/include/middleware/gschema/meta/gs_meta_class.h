@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <string>
+#include <cstddef>
 #include <typeindex>
 #include <string_view>
 
@@ -16,13 +17,15 @@ class TypeInstanceEdit;
 class MetaPropertyDataBase;
 class MetaClass : Fixed {
 public:
-    using TCtor = void* (*)();
+    // constructs the instance in the memory
+    using TCtor = void* (*)(void* memory);
     using TDtor = void (*)(void*);
     using TIsPinEnableInGUI = bool (*)(void* instance, std::string_view name);
 
 public:
     MetaClass() = default;
-    MetaClass(TCtor ctor, TDtor dtor, std::string_view name, std::string_view displayName, MetaClass* baseClass = nullptr);
+    MetaClass(TCtor ctor, TDtor dtor, size_t instanceSize, size_t instanceAlignment,
+        std::string_view name, std::string_view displayName, MetaClass* baseClass = nullptr);
     ~MetaClass();
 
     bool IsBaseClass() const { return m_ctor == nullptr; }
@@ -30,9 +33,17 @@ public:
     std::string_view GetName() const { return m_name; }
     std::string_view GetDisplayName() const { return m_displayName; }
 
+    size_t GetInstanceSize() const noexcept { return m_instanceSize; }
+    size_t GetInstanceAlignment() const noexcept { return m_instanceAlignment; }
+
+    // allocates the memory on the heap
     void* CreateInstance() const;
     void DestroyInstance(void* instance) const;
 
+    // memory (GetInstanceSize bytes with GetInstanceAlignment) is owned by the caller
+    void* ConstructInstance(void* memory) const;
+    void DestructInstance(void* instance) const;
+
     void SetIsPinEnableInGUI(TIsPinEnableInGUI func);
     bool IsPinEnableInGUI(void* instance, std::string_view name) const;
 
@@ -43,6 +54,8 @@ private:
     MetaClass* m_baseClass = nullptr;
     TCtor m_ctor = nullptr;
     TDtor m_dtor = nullptr;
+    size_t m_instanceSize = 0;
+    size_t m_instanceAlignment = 0;
     TIsPinEnableInGUI m_isPinEnableInGUI = nullptr;
     std::string m_name;
     std::string m_displayName;
@@ -12,6 +12,9 @@ namespace gs {
 class MetaType;
 class MetaEnum;
 class MetaClass;
+// Filled by the define callbacks (see DEFINE_CLASS/DEFINE_TYPE) in RunDefineCallbacks, after that the storage is frozen:
+// Add* methods throw and the getters are safe to call from several threads.
+// RunDefineCallbacks runs the callbacks once, concurrent calls wait for the first one
 class MetaStorage : Fixed {
 private:
     MetaStorage();
@@ -30,6 +33,7 @@ public:
     void AddDefineTypesCallback(TDefineCallback func);
     void AddDefineClassesCallback(TDefineCallback func);
     void RunDefineCallbacks();
+    bool IsFrozen() const noexcept;
 
 public:
     MetaClass* GetBaseClass(std::type_index id) const;
@@ -47,7 +51,7 @@ public:
 
 private:
     struct Impl;
-    Pimpl<Impl, 272, 8> impl;
+    Pimpl<Impl, 280, 8> impl;
 };
 
 }
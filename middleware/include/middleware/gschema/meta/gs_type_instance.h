@@ -1,6 +1,8 @@
 #pragma once
 
+#include <vector>
 #include <cstddef>
+#include <cstdint>
 #include <typeindex>
 
 #include "core/common/ctor.h"
@@ -29,6 +31,12 @@ public:
     size_t Count() const;
     IPrimitiveType* GetValue(size_t index) const;
 
+    // Count() fields of the value are appended, the state of the instance isn't used,
+    // so the instance shared by the graphs can be used from different threads
+    void ValueToBits(const cpgf::GVariant& value, std::vector<uint64_t>& fields) const;
+    // count must be equal to Count()
+    cpgf::GVariant ValueFromBits(const uint64_t* fields, size_t count) const;
+
 protected:
     IPrimitiveTypeEdit* m_primitiveType = nullptr;
     CompositeType* m_compositeType = nullptr;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 #include <typeindex>
 #include <string_view>
 
@@ -26,6 +27,10 @@ struct IPrimitiveType {
     virtual void Dec() = 0;
     virtual std::string ToString() const = 0;
     virtual void FromString(const std::string& value) = 0;
+
+    // raw value bits for binary serialization
+    virtual uint64_t ToBits() const = 0;
+    virtual void FromBits(uint64_t value) = 0;
 };
 
 struct IPrimitiveTypeEdit : IPrimitiveType {
@@ -36,6 +41,11 @@ struct IPrimitiveTypeEdit : IPrimitiveType {
     virtual bool IsChanged() const = 0;
     virtual void SetValue(const cpgf::GVariant& value) = 0;
     virtual cpgf::GVariant GetValue() const = 0;
+
+    // conversions of the value without the state of the object, they can be called
+    // for the type shared by the graphs from different threads
+    virtual uint64_t ValueToBits(const cpgf::GVariant& value) const = 0;
+    virtual cpgf::GVariant ValueFromBits(uint64_t value) const = 0;
 };
 
 }
@@ -6,6 +6,7 @@
 
 #include "dg/dg.h"
 #include "core/common/ctor.h"
+#include "core/path/file_view.h"
 
 
 class RenderWindow;
@@ -41,6 +42,8 @@ private:
     PipelineStatePtr m_ps;
     BufferPtr m_cameraCB;
     TextureViewPtr m_fontTex;
+    // the font files, that are used by the font atlas
+    std::vector<FileView> m_fontFiles;
     ShaderResourceBindingPtr m_fontBinding;
     std::vector<ShaderResourceBindingPtr> m_bindings;
     uint32_t m_numberUsedBindings = 0;
@@ -6,6 +6,7 @@
 #include "dg/dg.h"
 #include "core/math/types.h"
 #include "core/material/material.h"
+#include "core/material/texture_array.h"
 #include "middleware/std_render/structures.h"
 
 
@@ -31,6 +32,8 @@ public:
     void SetBaseTextureDesc(const dg::SamplerDesc& desc);
     void SetBaseTextureAddressMode(dg::TEXTURE_ADDRESS_MODE mode);
     void SetBaseTexture(TextureViewPtr& texture);
+    // the texture array can be shared by several materials, the slot selects the texture of the material
+    void SetBaseTextureArray(TextureViewPtr& texture, const TextureArraySlot& slot);
 
     void SetAlphaThreshold(float value);
 
@@ -27,6 +27,8 @@ public:
 public:
     std::shared_ptr<Camera>& GetCamera() noexcept { return m_camera; }
     void SetCamera(const std::shared_ptr<Camera>& camera) { m_camera = camera; }
+    // allowed geometry error in pixels for LOD selection, 0 - LOD is disabled
+    void SetLodPixelError(float value) noexcept { m_lodPixelError = value; }
     TextureViewPtr GetColorTexture();
 
     void StartSearchingNodeInPoint(uint32_t x, uint32_t y);
@@ -46,6 +48,7 @@ private:
     uint32_t m_gsCameraVarId = 0;
     uint16_t m_vDeclIdPerInstance = 0;
     uint16_t m_vDeclIdPerInstancePicker = 0;
+    float m_lodPixelError = 1.f;
     dg::ShaderCamera m_shaderCamera;
     std::shared_ptr<Camera> m_camera;
     std::unique_ptr<RenderTarget> m_renderTarget;
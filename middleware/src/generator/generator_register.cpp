@@ -11,6 +11,7 @@
 #include "middleware/generator/texture/cylinders.h"
 #include "middleware/generator/texture/noise_types.h"
 #include "middleware/generator/texture/chess_cubes.h"
+#include "middleware/generator/texture/gradient_split.h"
 #include "middleware/generator/texture/coherent_noise.h"
 
 
@@ -123,4 +124,11 @@ DEFINE_CLASSES_IMPL(detail::GeneratorFuncs) {
         .AddEmbeddedPinArithmetic("CellularJitter", &CoherentNoise::GetCellularJitter, &CoherentNoise::SetCellularJitter, "Cellular jitter").Min(0.f).Max(1.f).Step(0.05f)
         .AddEmbeddedPinArithmetic("PingPongStrength", &CoherentNoise::GetPingPongStrength, &CoherentNoise::SetPingPongStrength, "PingPong strength").Step(0.1f)
     ;
+
+    DefineClass<GradientSplit>("GradientSplit", "Gradient")
+        .AddInputPin("Input", &GradientSplit::GetInput, &GradientSplit::SetInput, "Input")
+        .AddOutputPin("DX", &GradientSplit::DX, "dX")
+        .AddOutputPin("DY", &GradientSplit::DY, "dY")
+        .AddOutputPin("DZ", &GradientSplit::DZ, "dZ")
+    ;
 }
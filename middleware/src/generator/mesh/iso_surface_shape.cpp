@@ -0,0 +1,395 @@
+#include "middleware/generator/mesh/iso_surface_shape.h"
+
+#include <array>
+#include <algorithm>
+
+#include "core/render/vertexes.h"
+#include "core/common/exception.h"
+#include "core/common/parallel_for.h"
+
+
+namespace {
+
+// the bounds and the samples may differ in rounding of the same math, the chunk is skipped only with this margin
+constexpr const double BOUNDS_MARGIN = 1e-9;
+
+// cube corner c has coordinates (c & 1, (c >> 1) & 1, (c >> 2) & 1)
+constexpr uint32_t CornerOffset(uint32_t corner, uint32_t axis) {
+    return (corner >> axis) & 1;
+}
+
+struct CubeEdge {
+    uint8_t corner0;
+    uint8_t corner1;
+    uint8_t axis;
+};
+
+// edges along x, y, z, corner0 is the lower corner
+constexpr std::array<CubeEdge, 12> CUBE_EDGES = {{
+    {0, 1, 0}, {2, 3, 0}, {4, 5, 0}, {6, 7, 0},
+    {0, 2, 1}, {1, 3, 1}, {4, 6, 1}, {5, 7, 1},
+    {0, 4, 2}, {1, 5, 2}, {2, 6, 2}, {3, 7, 2},
+}};
+
+struct CubeCase {
+    uint8_t triangleCount = 0;
+    // 3 cube edges per triangle
+    uint8_t edges[15] = {};
+};
+
+uint8_t FindCubeEdge(uint32_t corner0, uint32_t corner1) {
+    for (uint8_t i=0; i!=CUBE_EDGES.size(); ++i) {
+        const auto& edge = CUBE_EDGES[i];
+        if (((edge.corner0 == corner0) && (edge.corner1 == corner1)) || ((edge.corner0 == corner1) && (edge.corner1 == corner0))) {
+            return i;
+        }
+    }
+
+    return 0;
+}
+
+// Builds the marching cubes table instead of the classic hand-written one.
+// The iso-line on every cube face goes from the edge, where the face contour (counterclockwise from outside the cube)
+// enters the solid corners, to the next crossed edge of the contour. So the ambiguous faces always separate the solid corners,
+// the neighbour cubes see the shared face in the opposite direction and build the same segments in the opposite order,
+// which gives a closed and consistently oriented surface. The segments are joined into loops and the loops are triangulated as fans.
+std::array<CubeCase, 256> BuildCubeCases() {
+    std::array<std::array<uint8_t, 4>, 6> faces;
+    for (uint32_t axis=0; axis!=3; ++axis) {
+        const uint32_t u = (axis + 1) % 3;
+        const uint32_t v = (axis + 2) % 3;
+        for (uint32_t side=0; side!=2; ++side) {
+            auto& face = faces[axis * 2 + side];
+            const uint32_t uv[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+            for (uint32_t i=0; i!=4; ++i) {
+                face[i] = static_cast<uint8_t>((side << axis) | (uv[i][0] << u) | (uv[i][1] << v));
+            }
+            // the (u, v) order is counterclockwise around +axis
+            if (side == 0) {
+                std::reverse(face.begin(), face.end());
+            }
+        }
+    }
+
+    std::array<CubeCase, 256> cases;
+    for (uint32_t caseIndex=0; caseIndex!=256; ++caseIndex) {
+        auto isSolid = [caseIndex](uint32_t corner) { return ((caseIndex >> corner) & 1) != 0; };
+
+        // next edge of the iso-line for every crossed edge, 0xFF - the edge is not crossed
+        std::array<uint8_t, 12> nextEdge;
+        nextEdge.fill(0xFF);
+        for (const auto& face: faces) {
+            uint8_t crossedEdges[4];
+            bool isEnter[4];
+            uint32_t crossedCount = 0;
+            for (uint32_t i=0; i!=4; ++i) {
+                const uint32_t corner0 = face[i];
+                const uint32_t corner1 = face[(i + 1) % 4];
+                if (isSolid(corner0) != isSolid(corner1)) {
+                    crossedEdges[crossedCount] = FindCubeEdge(corner0, corner1);
+                    isEnter[crossedCount] = isSolid(corner1);
+                    ++crossedCount;
+                }
+            }
+            for (uint32_t i=0; i!=crossedCount; ++i) {
+                if (isEnter[i]) {
+                    nextEdge[crossedEdges[i]] = crossedEdges[(i + 1) % crossedCount];
+                }
+            }
+        }
+
+        auto& cubeCase = cases[caseIndex];
+        std::array<bool, 12> visited = {};
+        for (uint8_t first=0; first!=12; ++first) {
+            if ((nextEdge[first] == 0xFF) || visited[first]) {
+                continue;
+            }
+
+            uint8_t loop[12];
+            uint32_t loopLength = 0;
+            for (uint8_t edge=first; !visited[edge]; edge=nextEdge[edge]) {
+                visited[edge] = true;
+                loop[loopLength++] = edge;
+            }
+            for (uint32_t i=1; i + 1 < loopLength; ++i) {
+                uint8_t* triangle = &cubeCase.edges[cubeCase.triangleCount * 3];
+                triangle[0] = loop[0];
+                triangle[1] = loop[i];
+                triangle[2] = loop[i + 1];
+                ++cubeCase.triangleCount;
+            }
+        }
+    }
+
+    return cases;
+}
+
+const std::array<CubeCase, 256>& GetCubeCases() {
+    static const auto cases = BuildCubeCases();
+    return cases;
+}
+
+}
+
+struct IsoSurfaceShape::Chunk {
+    // in cells
+    dg::uint3 begin;
+    dg::uint3 cells;
+    // cube case for every cell
+    std::vector<uint8_t> cases;
+    // sorted keys of the owned edges, one vertex per edge
+    std::vector<uint64_t> edgeKeys;
+    std::vector<VertexPNC> vertexes;
+    // vertex indexes relative to the first vertex of the shape
+    std::vector<uint32_t> indexes;
+    uint32_t vertexOffset = 0;
+    bool isSkipped = false;
+};
+
+IsoSurfaceShape::IsoSurfaceShape(const IsoSurfaceDesc& desc)
+    : m_desc(desc) {
+
+    if ((desc.cells.x == 0) || (desc.cells.y == 0) || (desc.cells.z == 0)) {
+        throw EngineError("IsoSurfaceShape: cells must be greater than zero");
+    }
+    if (desc.chunkSize == 0) {
+        throw EngineError("IsoSurfaceShape: chunkSize must be greater than zero");
+    }
+    if (!(desc.size.x > 0) || !(desc.size.y > 0) || !(desc.size.z > 0)) {
+        throw EngineError("IsoSurfaceShape: size must be greater than zero");
+    }
+
+    m_chunkCount = dg::uint3(
+        (desc.cells.x + desc.chunkSize - 1) / desc.chunkSize,
+        (desc.cells.y + desc.chunkSize - 1) / desc.chunkSize,
+        (desc.cells.z + desc.chunkSize - 1) / desc.chunkSize);
+}
+
+IsoSurfaceShape::~IsoSurfaceShape() = default;
+
+void IsoSurfaceShape::Generate(const math::Generator3D& input) {
+    m_chunks.clear();
+    m_chunks.resize(GetChunkCount());
+    for (uint32_t z=0; z!=m_chunkCount.z; ++z) {
+        for (uint32_t y=0; y!=m_chunkCount.y; ++y) {
+            for (uint32_t x=0; x!=m_chunkCount.x; ++x) {
+                auto& chunk = m_chunks[(z * m_chunkCount.y + y) * m_chunkCount.x + x];
+                chunk.begin = dg::uint3(x * m_desc.chunkSize, y * m_desc.chunkSize, z * m_desc.chunkSize);
+                chunk.cells = dg::uint3(
+                    std::min(m_desc.chunkSize, m_desc.cells.x - chunk.begin.x),
+                    std::min(m_desc.chunkSize, m_desc.cells.y - chunk.begin.y),
+                    std::min(m_desc.chunkSize, m_desc.cells.z - chunk.begin.z));
+            }
+        }
+    }
+
+    // the workers are shared by both passes
+    WorkerPool workers(ResolveThreadCount(m_desc.threadCount, m_chunks.size()));
+    workers.ParallelFor(m_chunks.size(), [this, &input](size_t index) {
+        GenerateVertexes(input, m_chunks[index]);
+    });
+
+    m_vertexCount = 0;
+    m_skippedChunkCount = 0;
+    for (auto& chunk: m_chunks) {
+        if (chunk.isSkipped) {
+            ++m_skippedChunkCount;
+        }
+        chunk.vertexOffset = static_cast<uint32_t>(m_vertexCount);
+        m_vertexCount += chunk.vertexes.size();
+    }
+    if (m_vertexCount > UINT32_MAX) {
+        throw EngineError("IsoSurfaceShape: vertex count {} is out of uint32 range", m_vertexCount);
+    }
+
+    // the triangles of a chunk use the vertexes of the neighbour chunks, so they are built after all vertexes
+    workers.ParallelFor(m_chunks.size(), [this](size_t index) {
+        GenerateIndexes(m_chunks[index]);
+    });
+
+    m_indexCount = 0;
+    for (auto& chunk: m_chunks) {
+        m_indexCount += chunk.indexes.size();
+    }
+}
+
+size_t IsoSurfaceShape::LenghtVertex() const {
+    return m_vertexCount;
+}
+
+size_t IsoSurfaceShape::LenghtIndex() const {
+    return m_indexCount;
+}
+
+void IsoSurfaceShape::FillVertex(VertexPNC* vertexes) const {
+    for (const auto& chunk: m_chunks) {
+        vertexes = std::copy(chunk.vertexes.cbegin(), chunk.vertexes.cend(), vertexes);
+    }
+}
+
+void IsoSurfaceShape::FillIndex(uint32_t* indexes, uint32_t vertexStartIndex) const {
+    for (const auto& chunk: m_chunks) {
+        for (const auto index: chunk.indexes) {
+            *indexes = index + vertexStartIndex;
+            ++indexes;
+        }
+    }
+}
+
+void IsoSurfaceShape::GenerateVertexes(const math::Generator3D& input, Chunk& chunk) const {
+    const dg::uint3 corners(chunk.cells.x + 1, chunk.cells.y + 1, chunk.cells.z + 1);
+    const double stepX = static_cast<double>(m_desc.size.x) / static_cast<double>(m_desc.cells.x);
+    const double stepY = static_cast<double>(m_desc.size.y) / static_cast<double>(m_desc.cells.y);
+    const double stepZ = static_cast<double>(m_desc.size.z) / static_cast<double>(m_desc.cells.z);
+    // the same global corner gives the same coordinates in all chunks
+    auto toX = [this, stepX](uint32_t x) { return static_cast<double>(m_desc.origin.x) + static_cast<double>(x) * stepX; };
+    auto toY = [this, stepY](uint32_t y) { return static_cast<double>(m_desc.origin.y) + static_cast<double>(y) * stepY; };
+    auto toZ = [this, stepZ](uint32_t z) { return static_cast<double>(m_desc.origin.z) + static_cast<double>(z) * stepZ; };
+
+    const double isoLevel = static_cast<double>(m_desc.isoLevel);
+    if (m_desc.useBounds && input.HasBounds()) {
+        // the closed box of the chunk contains all its corners, including the ones shared with the neighbours
+        auto toInterval = [](double a, double b) { return math::Interval<double>{std::min(a, b), std::max(a, b)}; };
+        const auto bounds = input.Bounds(
+            toInterval(toX(chunk.begin.x), toX(chunk.begin.x + chunk.cells.x)),
+            toInterval(toY(chunk.begin.y), toY(chunk.begin.y + chunk.cells.y)),
+            toInterval(toZ(chunk.begin.z), toZ(chunk.begin.z + chunk.cells.z)));
+        if ((bounds.lower > isoLevel + BOUNDS_MARGIN) || (bounds.upper < isoLevel - BOUNDS_MARGIN)) {
+            chunk.isSkipped = true;
+            return;
+        }
+    }
+
+    std::vector<double> values(static_cast<size_t>(corners.x) * static_cast<size_t>(corners.y) * static_cast<size_t>(corners.z));
+    auto cornerIndex = [&corners](uint32_t x, uint32_t y, uint32_t z) -> size_t {
+        return (static_cast<size_t>(z) * corners.y + y) * corners.x + x;
+    };
+    for (uint32_t z=0; z!=corners.z; ++z) {
+        const double gz = toZ(chunk.begin.z + z);
+        for (uint32_t y=0; y!=corners.y; ++y) {
+            const double gy = toY(chunk.begin.y + y);
+            double* pDest = &values[cornerIndex(0, y, z)];
+            for (uint32_t x=0; x!=corners.x; ++x) {
+                *pDest = input(toX(chunk.begin.x + x), gy, gz);
+                ++pDest;
+            }
+        }
+    }
+
+    chunk.cases.resize(static_cast<size_t>(chunk.cells.x) * static_cast<size_t>(chunk.cells.y) * static_cast<size_t>(chunk.cells.z));
+    uint8_t* pCase = chunk.cases.data();
+    for (uint32_t z=0; z!=chunk.cells.z; ++z) {
+        for (uint32_t y=0; y!=chunk.cells.y; ++y) {
+            for (uint32_t x=0; x!=chunk.cells.x; ++x) {
+                uint32_t cubeCase = 0;
+                for (uint32_t corner=0; corner!=8; ++corner) {
+                    const double value = values[cornerIndex(
+                        x + CornerOffset(corner, 0), y + CornerOffset(corner, 1), z + CornerOffset(corner, 2))];
+                    if (value > isoLevel) {
+                        cubeCase |= (1u << corner);
+                    }
+                }
+                *pCase = static_cast<uint8_t>(cubeCase);
+                ++pCase;
+            }
+        }
+    }
+
+    // the chunk owns the edges, which start inside it, and the edges on the volume max faces
+    const uint32_t ownedCorners[3] = {
+        (chunk.begin.x + chunk.cells.x == m_desc.cells.x) ? corners.x : chunk.cells.x,
+        (chunk.begin.y + chunk.cells.y == m_desc.cells.y) ? corners.y : chunk.cells.y,
+        (chunk.begin.z + chunk.cells.z == m_desc.cells.z) ? corners.z : chunk.cells.z,
+    };
+    const uint32_t cells[3] = {chunk.cells.x, chunk.cells.y, chunk.cells.z};
+    chunk.edgeKeys.clear();
+    chunk.vertexes.clear();
+    for (uint32_t z=0; z!=ownedCorners[2]; ++z) {
+        for (uint32_t y=0; y!=ownedCorners[1]; ++y) {
+            for (uint32_t x=0; x!=ownedCorners[0]; ++x) {
+                const uint32_t corner[3] = {x, y, z};
+                const double value0 = values[cornerIndex(x, y, z)];
+                for (uint32_t axis=0; axis!=3; ++axis) {
+                    if (corner[axis] == cells[axis]) {
+                        continue;
+                    }
+                    const double value1 = values[cornerIndex(x + (axis == 0 ? 1 : 0), y + (axis == 1 ? 1 : 0), z + (axis == 2 ? 1 : 0))];
+                    if ((value0 > isoLevel) == (value1 > isoLevel)) {
+                        continue;
+                    }
+
+                    const double t = (isoLevel - value0) / (value1 - value0);
+                    double px = toX(chunk.begin.x + x);
+                    double py = toY(chunk.begin.y + y);
+                    double pz = toZ(chunk.begin.z + z);
+                    if (axis == 0) {
+                        px += t * stepX;
+                    } else if (axis == 1) {
+                        py += t * stepY;
+                    } else {
+                        pz += t * stepZ;
+                    }
+
+                    const auto gradient = input.Gradient(px, py, pz);
+                    dg::float3 normal(-static_cast<float>(gradient.dx), -static_cast<float>(gradient.dy), -static_cast<float>(gradient.dz));
+                    const float normalLength = dg::length(normal);
+                    normal = (normalLength > 0) ? (normal / normalLength) : dg::float3(0, 1.f, 0);
+
+                    VertexPNC vertex;
+                    vertex.position = dg::float3(static_cast<float>(px), static_cast<float>(py), static_cast<float>(pz));
+                    vertex.normal = normal;
+                    vertex.uv = dg::float2(
+                        (vertex.position.x - m_desc.origin.x) / m_desc.size.x,
+                        (vertex.position.z - m_desc.origin.z) / m_desc.size.z);
+                    chunk.vertexes.push_back(vertex);
+                    chunk.edgeKeys.push_back(GetEdgeKey(chunk.begin.x + x, chunk.begin.y + y, chunk.begin.z + z, axis));
+                }
+            }
+        }
+    }
+}
+
+void IsoSurfaceShape::GenerateIndexes(Chunk& chunk) const {
+    const auto& cubeCases = GetCubeCases();
+    chunk.indexes.clear();
+    if (chunk.isSkipped) {
+        return;
+    }
+
+    const uint8_t* pCase = chunk.cases.data();
+    for (uint32_t z=0; z!=chunk.cells.z; ++z) {
+        for (uint32_t y=0; y!=chunk.cells.y; ++y) {
+            for (uint32_t x=0; x!=chunk.cells.x; ++x) {
+                const auto& cubeCase = cubeCases[*pCase];
+                ++pCase;
+                for (uint32_t i=0; i!=cubeCase.triangleCount * 3u; ++i) {
+                    const auto& edge = CUBE_EDGES[cubeCase.edges[i]];
+                    chunk.indexes.push_back(FindVertex(
+                        chunk.begin.x + x + CornerOffset(edge.corner0, 0),
+                        chunk.begin.y + y + CornerOffset(edge.corner0, 1),
+                        chunk.begin.z + z + CornerOffset(edge.corner0, 2),
+                        edge.axis));
+                }
+            }
+        }
+    }
+    chunk.cases = std::vector<uint8_t>();
+}
+
+uint32_t IsoSurfaceShape::FindVertex(uint32_t x, uint32_t y, uint32_t z, uint32_t axis) const {
+    const uint32_t chunkX = std::min(x / m_desc.chunkSize, m_chunkCount.x - 1);
+    const uint32_t chunkY = std::min(y / m_desc.chunkSize, m_chunkCount.y - 1);
+    const uint32_t chunkZ = std::min(z / m_desc.chunkSize, m_chunkCount.z - 1);
+    const auto& owner = m_chunks[(chunkZ * m_chunkCount.y + chunkY) * m_chunkCount.x + chunkX];
+
+    // the edge is crossed, so the owner has the vertex
+    const auto it = std::lower_bound(owner.edgeKeys.cbegin(), owner.edgeKeys.cend(), GetEdgeKey(x, y, z, axis));
+    return owner.vertexOffset + static_cast<uint32_t>(it - owner.edgeKeys.cbegin());
+}
+
+uint64_t IsoSurfaceShape::GetEdgeKey(uint32_t x, uint32_t y, uint32_t z, uint32_t axis) const noexcept {
+    const auto cornersX = static_cast<uint64_t>(m_desc.cells.x) + 1;
+    const auto cornersY = static_cast<uint64_t>(m_desc.cells.y) + 1;
+
+    return ((static_cast<uint64_t>(z) * cornersY + y) * cornersX + x) * 3 + axis;
+}
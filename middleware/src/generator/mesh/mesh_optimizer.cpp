@@ -0,0 +1,417 @@
+#include "middleware/generator/mesh/mesh_optimizer.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#include "core/render/vertexes.h"
+
+
+namespace {
+
+// Forsyth scoring parameters, see https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+constexpr uint32_t MaxCacheSize = 32;
+constexpr float CacheDecayPower = 1.5f;
+constexpr float LastTriScore = 0.75f;
+constexpr float ValenceBoostScale = 2.0f;
+constexpr float ValenceBoostPower = 0.5f;
+constexpr size_t InvalidTriangle = std::numeric_limits<size_t>::max();
+
+float VertexScore(int32_t cachePosition, uint32_t remainingTriangles) {
+    if (remainingTriangles == 0) {
+        return -1.f;
+    }
+
+    float score = 0.f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // the vertices of the last triangle get a fixed score to avoid a strip like traversal
+            score = LastTriScore;
+        } else {
+            const float scaler = 1.f / static_cast<float>(MaxCacheSize - 3);
+            score = std::pow(1.f - static_cast<float>(cachePosition - 3) * scaler, CacheDecayPower);
+        }
+    }
+
+    // bonus for vertices with few remaining triangles, so that lone triangles are not left behind
+    score += ValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ValenceBoostPower);
+
+    return score;
+}
+
+// returns the number of cache misses for triangle
+class FifoCache {
+public:
+    FifoCache(size_t vertexCount, uint32_t cacheSize)
+        : m_cacheSize(cacheSize)
+        , m_timestamp(cacheSize + 1)
+        , m_timestamps(vertexCount, 0) {
+
+    }
+
+    void Reset() {
+        m_timestamp += m_cacheSize + 1;
+    }
+
+    uint32_t Add(uint32_t index) {
+        if (m_timestamp - m_timestamps[index] > m_cacheSize) {
+            m_timestamps[index] = m_timestamp++;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    uint32_t AddTriangle(const uint32_t* indexes) {
+        return Add(indexes[0]) + Add(indexes[1]) + Add(indexes[2]);
+    }
+
+private:
+    size_t m_cacheSize;
+    size_t m_timestamp;
+    std::vector<size_t> m_timestamps;
+};
+
+size_t CalcVertexCount(const uint32_t* indexes, size_t indexCount) {
+    uint32_t maxIndex = 0;
+    for (size_t i=0; i!=indexCount; ++i) {
+        maxIndex = std::max(maxIndex, indexes[i]);
+    }
+
+    return (indexCount == 0) ? 0 : static_cast<size_t>(maxIndex) + 1;
+}
+
+size_t CalcCacheMisses(const uint32_t* indexes, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+    size_t misses = 0;
+    FifoCache cache(vertexCount, cacheSize);
+    for (size_t i=0; i!=indexCount; ++i) {
+        misses += cache.Add(indexes[i]);
+    }
+
+    return misses;
+}
+
+}
+
+MeshOptimizer::MeshOptimizer(const MeshOptimizerDesc& desc)
+    : m_desc(desc) {
+
+}
+
+MeshOptimizerStats MeshOptimizer::Optimize(VertexPNC* vertexes, size_t vertexCount, uint32_t* indexes, size_t indexCount) const {
+    MeshOptimizerStats stats;
+    stats.acmrBefore = CalcACMR(indexes, indexCount, m_desc.cacheSize);
+    stats.atvrBefore = CalcATVR(indexes, indexCount, vertexCount, m_desc.cacheSize);
+
+    if (m_desc.vertexCache) {
+        OptimizeVertexCache(indexes, indexCount, vertexCount);
+    }
+    if (m_desc.overdraw) {
+        OptimizeOverdraw(indexes, indexCount, vertexes, vertexCount, m_desc.cacheSize, m_desc.overdrawThreshold);
+    }
+    if (m_desc.vertexFetch) {
+        OptimizeVertexFetch(vertexes, vertexCount, indexes, indexCount);
+    }
+
+    stats.acmrAfter = CalcACMR(indexes, indexCount, m_desc.cacheSize);
+    stats.atvrAfter = CalcATVR(indexes, indexCount, vertexCount, m_desc.cacheSize);
+
+    return stats;
+}
+
+float MeshOptimizer::CalcACMR(const uint32_t* indexes, size_t indexCount, uint32_t cacheSize) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return 0.f;
+    }
+
+    const size_t misses = CalcCacheMisses(indexes, indexCount, CalcVertexCount(indexes, indexCount), cacheSize);
+    return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
+
+float MeshOptimizer::CalcATVR(const uint32_t* indexes, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+    vertexCount = std::max(vertexCount, CalcVertexCount(indexes, indexCount));
+    std::vector<bool> used(vertexCount, false);
+    size_t usedCount = 0;
+    for (size_t i=0; i!=indexCount; ++i) {
+        if (!used[indexes[i]]) {
+            used[indexes[i]] = true;
+            ++usedCount;
+        }
+    }
+    if (usedCount == 0) {
+        return 0.f;
+    }
+
+    const size_t misses = CalcCacheMisses(indexes, indexCount, vertexCount, cacheSize);
+    return static_cast<float>(misses) / static_cast<float>(usedCount);
+}
+
+void MeshOptimizer::OptimizeVertexCache(uint32_t* indexes, size_t indexCount, size_t vertexCount) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+    vertexCount = std::max(vertexCount, CalcVertexCount(indexes, indexCount));
+
+    // vertex -> triangles adjacency, the first remaining[v] items of the vertex range are not emitted triangles
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (size_t i=0; i!=triangleCount * 3; ++i) {
+        ++remaining[indexes[i]];
+    }
+
+    std::vector<size_t> offsets(vertexCount + 1, 0);
+    for (size_t v=0; v!=vertexCount; ++v) {
+        offsets[v + 1] = offsets[v] + remaining[v];
+    }
+
+    std::vector<size_t> adjacency(triangleCount * 3);
+    std::vector<size_t> fill(offsets.cbegin(), offsets.cend() - 1);
+    for (size_t t=0; t!=triangleCount; ++t) {
+        for (size_t k=0; k!=3; ++k) {
+            adjacency[fill[indexes[t * 3 + k]]++] = t;
+        }
+    }
+
+    std::vector<int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v=0; v!=vertexCount; ++v) {
+        vertexScore[v] = VertexScore(-1, remaining[v]);
+    }
+
+    auto triangleScore = [indexes, &vertexScore](size_t t) -> float {
+        return vertexScore[indexes[t * 3 + 0]] + vertexScore[indexes[t * 3 + 1]] + vertexScore[indexes[t * 3 + 2]];
+    };
+
+    size_t bestTriangle = 0;
+    float bestScore = triangleScore(0);
+    for (size_t t=1; t!=triangleCount; ++t) {
+        if (const float score = triangleScore(t); score > bestScore) {
+            bestScore = score;
+            bestTriangle = t;
+        }
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> result(triangleCount * 3);
+    uint32_t cache[MaxCacheSize + 3];
+    uint32_t newCache[MaxCacheSize + 3];
+    size_t cacheCount = 0;
+    size_t nextNotEmitted = 0;
+
+    for (size_t outTriangle=0; outTriangle!=triangleCount; ++outTriangle) {
+        if (bestTriangle == InvalidTriangle) {
+            // cache is exhausted, continue from the first not emitted triangle
+            while (emitted[nextNotEmitted]) {
+                ++nextNotEmitted;
+            }
+            bestTriangle = nextNotEmitted;
+        }
+
+        emitted[bestTriangle] = true;
+        const uint32_t* triangle = &indexes[bestTriangle * 3];
+        size_t newCacheCount = 0;
+        for (size_t k=0; k!=3; ++k) {
+            const uint32_t v = triangle[k];
+            result[outTriangle * 3 + k] = v;
+
+            // remove emitted triangle from adjacency
+            auto* first = &adjacency[offsets[v]];
+            auto* last = first + remaining[v];
+            auto* it = std::find(first, last, bestTriangle);
+            if (it != last) {
+                std::swap(*it, *(last - 1));
+                --remaining[v];
+            }
+
+            if (std::find(newCache, newCache + newCacheCount, v) == newCache + newCacheCount) {
+                newCache[newCacheCount++] = v;
+            }
+        }
+
+        // LRU: triangle vertices go to the front
+        for (size_t i=0; i!=cacheCount; ++i) {
+            const uint32_t v = cache[i];
+            if ((v != triangle[0]) && (v != triangle[1]) && (v != triangle[2])) {
+                newCache[newCacheCount++] = v;
+            }
+        }
+
+        for (size_t i=0; i!=newCacheCount; ++i) {
+            const uint32_t v = newCache[i];
+            const int32_t position = (i < MaxCacheSize) ? static_cast<int32_t>(i) : -1;
+            cachePosition[v] = position;
+            vertexScore[v] = VertexScore(position, remaining[v]);
+        }
+
+        cacheCount = std::min(newCacheCount, static_cast<size_t>(MaxCacheSize));
+        std::copy(newCache, newCache + cacheCount, cache);
+
+        // search best triangle between triangles adjacent to cache
+        bestTriangle = InvalidTriangle;
+        bestScore = -1.f;
+        for (size_t i=0; i!=cacheCount; ++i) {
+            const uint32_t v = cache[i];
+            for (size_t j=offsets[v]; j!=offsets[v] + remaining[v]; ++j) {
+                const size_t t = adjacency[j];
+                const float score = triangleScore(t);
+                if ((score > bestScore) || ((!std::isless(score, bestScore)) && (t < bestTriangle))) {
+                    bestScore = score;
+                    bestTriangle = t;
+                }
+            }
+        }
+    }
+
+    std::copy(result.cbegin(), result.cend(), indexes);
+}
+
+void MeshOptimizer::OptimizeOverdraw(uint32_t* indexes, size_t indexCount, const VertexPNC* vertexes, size_t vertexCount,
+    uint32_t cacheSize, float threshold) {
+
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2) {
+        return;
+    }
+    vertexCount = std::max(vertexCount, CalcVertexCount(indexes, indexCount));
+
+    // hard boundaries - all triangle vertices missed the cache, reordering here does not change ACMR
+    std::vector<size_t> hardClusters;
+    FifoCache cache(vertexCount, cacheSize);
+    for (size_t t=0; t!=triangleCount; ++t) {
+        if (cache.AddTriangle(&indexes[t * 3]) == 3) {
+            hardClusters.push_back(t);
+        }
+    }
+    hardClusters.push_back(triangleCount);
+
+    // soft boundaries - split hard clusters while the local ACMR is not worse than the cluster ACMR * threshold
+    std::vector<size_t> clusters;
+    for (size_t c=0; c!=hardClusters.size() - 1; ++c) {
+        const size_t begin = hardClusters[c];
+        const size_t end = hardClusters[c + 1];
+
+        cache.Reset();
+        size_t clusterMisses = 0;
+        for (size_t t=begin; t!=end; ++t) {
+            clusterMisses += cache.AddTriangle(&indexes[t * 3]);
+        }
+        const float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+        cache.Reset();
+        clusters.push_back(begin);
+        size_t start = begin;
+        size_t misses = 0;
+        for (size_t t=begin; t!=end; ++t) {
+            misses += cache.AddTriangle(&indexes[t * 3]);
+            const float acmr = static_cast<float>(misses) / static_cast<float>(t - start + 1);
+            if ((t + 1 != end) && (acmr <= clusterThreshold)) {
+                clusters.push_back(t + 1);
+                start = t + 1;
+                misses = 0;
+                cache.Reset();
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    // mesh centroid
+    double meshCenter[3] = {0, 0, 0};
+    for (size_t i=0; i!=triangleCount * 3; ++i) {
+        const auto& pos = vertexes[indexes[i]].position;
+        meshCenter[0] += static_cast<double>(pos.x);
+        meshCenter[1] += static_cast<double>(pos.y);
+        meshCenter[2] += static_cast<double>(pos.z);
+    }
+    for (size_t k=0; k!=3; ++k) {
+        meshCenter[k] /= static_cast<double>(triangleCount * 3);
+    }
+
+    // sort key - dot(cluster centroid - mesh centroid, cluster normal), outward facing clusters are drawn first
+    struct Cluster {
+        size_t begin;
+        size_t end;
+        double sortKey;
+    };
+    std::vector<Cluster> sortedClusters;
+    sortedClusters.reserve(clusters.size() - 1);
+    for (size_t c=0; c!=clusters.size() - 1; ++c) {
+        double center[3] = {0, 0, 0};
+        double normal[3] = {0, 0, 0};
+        double area = 0;
+        for (size_t t=clusters[c]; t!=clusters[c + 1]; ++t) {
+            const auto& p0 = vertexes[indexes[t * 3 + 0]].position;
+            const auto& p1 = vertexes[indexes[t * 3 + 1]].position;
+            const auto& p2 = vertexes[indexes[t * 3 + 2]].position;
+
+            const double e1[3] = {
+                static_cast<double>(p1.x - p0.x), static_cast<double>(p1.y - p0.y), static_cast<double>(p1.z - p0.z)};
+            const double e2[3] = {
+                static_cast<double>(p2.x - p0.x), static_cast<double>(p2.y - p0.y), static_cast<double>(p2.z - p0.z)};
+            const double n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+            const double triangleArea = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+            center[0] += static_cast<double>(p0.x + p1.x + p2.x) * triangleArea / 3.;
+            center[1] += static_cast<double>(p0.y + p1.y + p2.y) * triangleArea / 3.;
+            center[2] += static_cast<double>(p0.z + p1.z + p2.z) * triangleArea / 3.;
+            normal[0] += n[0];
+            normal[1] += n[1];
+            normal[2] += n[2];
+            area += triangleArea;
+        }
+
+        double sortKey = 0;
+        const double normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if ((area > 0) && (normalLength > 0)) {
+            for (size_t k=0; k!=3; ++k) {
+                sortKey += (center[k] / area - meshCenter[k]) * normal[k] / normalLength;
+            }
+        }
+
+        sortedClusters.push_back(Cluster{clusters[c], clusters[c + 1], sortKey});
+    }
+
+    std::stable_sort(sortedClusters.begin(), sortedClusters.end(), [](const Cluster& a, const Cluster& b) {
+        return a.sortKey > b.sortKey;
+    });
+
+    std::vector<uint32_t> result;
+    result.reserve(triangleCount * 3);
+    for (const auto& cluster: sortedClusters) {
+        result.insert(result.end(), indexes + cluster.begin * 3, indexes + cluster.end * 3);
+    }
+
+    std::copy(result.cbegin(), result.cend(), indexes);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(VertexPNC* vertexes, size_t vertexCount, uint32_t* indexes, size_t indexCount) {
+    if ((vertexCount == 0) || (indexCount == 0)) {
+        return;
+    }
+
+    constexpr uint32_t notMapped = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap(vertexCount, notMapped);
+    uint32_t nextIndex = 0;
+    for (size_t i=0; i!=indexCount; ++i) {
+        uint32_t& newIndex = remap[indexes[i]];
+        if (newIndex == notMapped) {
+            newIndex = nextIndex++;
+        }
+        indexes[i] = newIndex;
+    }
+
+    // unused vertexes keep their relative order at the end of buffer
+    for (size_t v=0; v!=vertexCount; ++v) {
+        if (remap[v] == notMapped) {
+            remap[v] = nextIndex++;
+        }
+    }
+
+    std::vector<VertexPNC> result(vertexCount);
+    for (size_t v=0; v!=vertexCount; ++v) {
+        result[remap[v]] = vertexes[v];
+    }
+
+    std::copy(result.cbegin(), result.cend(), vertexes);
+}
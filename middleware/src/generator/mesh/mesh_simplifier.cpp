@@ -0,0 +1,451 @@
+#include "middleware/generator/mesh/mesh_simplifier.h"
+
+#include <array>
+#include <cmath>
+#include <tuple>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+
+#include "core/common/hash.h"
+#include "core/render/vertexes.h"
+
+
+namespace {
+
+// extra weight for the planes perpendicular to the border edges
+constexpr double BorderWeight = 10.;
+// min cos of the angle between triangle normals before and after collapse
+constexpr double MinNormalCos = 0.25;
+// the minimum index count reduction for the next LOD level
+constexpr float MinLodReduction = 0.9f;
+constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+struct Quadric {
+    static Quadric FromPlane(double nx, double ny, double nz, double d, double weight) {
+        Quadric q;
+        q.a00 = nx * nx * weight;
+        q.a01 = nx * ny * weight;
+        q.a02 = nx * nz * weight;
+        q.a11 = ny * ny * weight;
+        q.a12 = ny * nz * weight;
+        q.a22 = nz * nz * weight;
+        q.b0 = nx * d * weight;
+        q.b1 = ny * d * weight;
+        q.b2 = nz * d * weight;
+        q.c = d * d * weight;
+        q.weight = weight;
+
+        return q;
+    }
+
+    void Add(const Quadric& other) {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a11 += other.a11;
+        a12 += other.a12;
+        a22 += other.a22;
+        b0 += other.b0;
+        b1 += other.b1;
+        b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+    }
+
+    // (p^T * A * p) + (2 * b^T * p) + c, divided by the sum of the plane weights,
+    // so it is the weighted mean of the squared distances to the planes and doesn't depend on the triangle areas
+    double Error(const dg::float3& pos) const {
+        if (weight <= 0) {
+            return 0;
+        }
+
+        const auto x = static_cast<double>(pos.x);
+        const auto y = static_cast<double>(pos.y);
+        const auto z = static_cast<double>(pos.z);
+
+        const double rx = a00 * x + a01 * y + a02 * z;
+        const double ry = a01 * x + a11 * y + a12 * z;
+        const double rz = a02 * x + a12 * y + a22 * z;
+
+        return std::abs(rx * x + ry * y + rz * z + 2. * (b0 * x + b1 * y + b2 * z) + c) / weight;
+    }
+
+    double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+    double b0 = 0, b1 = 0, b2 = 0;
+    double c = 0;
+    // sum of the plane weights (triangle areas and border edge lengths squared)
+    double weight = 0;
+};
+
+struct Collapse {
+    uint32_t v0;
+    uint32_t v1;
+    double cost;
+};
+
+std::array<double, 3> TriangleNormal(const dg::float3& p0, const dg::float3& p1, const dg::float3& p2) {
+    const double e1[3] = {
+        static_cast<double>(p1.x - p0.x), static_cast<double>(p1.y - p0.y), static_cast<double>(p1.z - p0.z)};
+    const double e2[3] = {
+        static_cast<double>(p2.x - p0.x), static_cast<double>(p2.y - p0.y), static_cast<double>(p2.z - p0.z)};
+
+    return {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+}
+
+double Dot(const std::array<double, 3>& a, const std::array<double, 3>& b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+uint64_t EdgeKey(uint32_t a, uint32_t b) {
+    return (static_cast<uint64_t>(a) << 32) | static_cast<uint64_t>(b);
+}
+
+bool HasEdge(const std::vector<uint64_t>& sortedEdges, uint32_t a, uint32_t b) {
+    return std::binary_search(sortedEdges.cbegin(), sortedEdges.cend(), EdgeKey(a, b));
+}
+
+// the edge a->b is a border edge, if there is no opposite edge b->a
+bool IsBorderEdge(const std::vector<uint64_t>& sortedBorderEdges, uint32_t a, uint32_t b) {
+    return HasEdge(sortedBorderEdges, a, b) || HasEdge(sortedBorderEdges, b, a);
+}
+
+// returns sorted directed border edges (a->b without b->a) by canonical vertexes
+std::vector<uint64_t> FindBorderEdges(const std::vector<uint32_t>& canonical, const std::vector<uint32_t>& triangles) {
+    // undirected edge + direction flag
+    std::vector<std::pair<uint64_t, bool>> edges;
+    edges.reserve(triangles.size());
+    for (size_t i=0; i!=triangles.size(); i+=3) {
+        for (size_t k=0; k!=3; ++k) {
+            const uint32_t a = canonical[triangles[i + k]];
+            const uint32_t b = canonical[triangles[i + (k + 1) % 3]];
+            if (a != b) {
+                edges.emplace_back(EdgeKey(std::min(a, b), std::max(a, b)), a < b);
+            }
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    std::vector<uint64_t> result;
+    for (size_t i=0; i!=edges.size();) {
+        size_t j = i + 1;
+        bool hasOpposite = false;
+        for (; (j != edges.size()) && (edges[j].first == edges[i].first); ++j) {
+            hasOpposite |= (edges[j].second != edges[i].second);
+        }
+
+        if (!hasOpposite) {
+            const auto a = static_cast<uint32_t>(edges[i].first >> 32);
+            const auto b = static_cast<uint32_t>(edges[i].first & 0xFFFFFFFF);
+            result.push_back(edges[i].second ? EdgeKey(a, b) : EdgeKey(b, a));
+        }
+        i = j;
+    }
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+// vertexes with identical positions are mapped to the first of them
+std::vector<uint32_t> BuildCanonical(const VertexPNC* vertexes, size_t vertexCount, std::vector<bool>& isSeam) {
+    using Key = std::array<float, 3>;
+    std::unordered_map<Key, uint32_t, ContainerHasher<Key>> positions;
+    positions.reserve(vertexCount);
+
+    std::vector<uint32_t> canonical(vertexCount);
+    isSeam.assign(vertexCount, false);
+    for (uint32_t v=0; v!=static_cast<uint32_t>(vertexCount); ++v) {
+        const auto& pos = vertexes[v].position;
+        auto [it, inserted] = positions.emplace(Key{pos.x, pos.y, pos.z}, v);
+        canonical[v] = it->second;
+        if (!inserted) {
+            isSeam[v] = true;
+            isSeam[it->second] = true;
+        }
+    }
+
+    return canonical;
+}
+
+}
+
+size_t MeshSimplifier::Simplify(const VertexPNC* vertexes, size_t vertexCount, const uint32_t* indexes, size_t indexCount,
+    uint32_t* destination, size_t targetIndexCount, float targetError, float* resultError) {
+
+    if (resultError != nullptr) {
+        *resultError = 0.f;
+    }
+
+    indexCount = indexCount / 3 * 3;
+    std::vector<uint32_t> current(indexes, indexes + indexCount);
+    if ((indexCount <= targetIndexCount) || (vertexCount == 0)) {
+        std::copy(current.cbegin(), current.cend(), destination);
+        return indexCount;
+    }
+
+    const double extent = static_cast<double>(CalcExtent(vertexes, vertexCount, indexes, indexCount));
+    const double maxCost = std::pow(static_cast<double>(targetError) * extent, 2.);
+
+    std::vector<bool> isSeam;
+    const auto canonical = BuildCanonical(vertexes, vertexCount, isSeam);
+    // face and border quadrics, by canonical vertex
+    std::vector<Quadric> quadrics(vertexCount);
+    {
+        const auto borderEdges = FindBorderEdges(canonical, current);
+        for (size_t i=0; i!=indexCount; i+=3) {
+            const uint32_t tri[3] = {canonical[current[i + 0]], canonical[current[i + 1]], canonical[current[i + 2]]};
+            const auto& p0 = vertexes[tri[0]].position;
+            const auto n = TriangleNormal(p0, vertexes[tri[1]].position, vertexes[tri[2]].position);
+            const double doubleArea = std::sqrt(Dot(n, n));
+            if (doubleArea <= 0) {
+                continue;
+            }
+
+            const std::array<double, 3> normal = {n[0] / doubleArea, n[1] / doubleArea, n[2] / doubleArea};
+            const double d = -(normal[0] * static_cast<double>(p0.x) + normal[1] * static_cast<double>(p0.y) + normal[2] * static_cast<double>(p0.z));
+            const auto faceQuadric = Quadric::FromPlane(normal[0], normal[1], normal[2], d, doubleArea * 0.5);
+            for (size_t k=0; k!=3; ++k) {
+                quadrics[tri[k]].Add(faceQuadric);
+            }
+
+            for (size_t k=0; k!=3; ++k) {
+                const uint32_t a = tri[k];
+                const uint32_t b = tri[(k + 1) % 3];
+                if ((a == b) || !HasEdge(borderEdges, a, b)) {
+                    continue;
+                }
+
+                const auto& pa = vertexes[a].position;
+                const auto& pb = vertexes[b].position;
+                const std::array<double, 3> e = {
+                    static_cast<double>(pb.x - pa.x), static_cast<double>(pb.y - pa.y), static_cast<double>(pb.z - pa.z)};
+                std::array<double, 3> bn = {
+                    e[1] * normal[2] - e[2] * normal[1], e[2] * normal[0] - e[0] * normal[2], e[0] * normal[1] - e[1] * normal[0]};
+                const double bnLength = std::sqrt(Dot(bn, bn));
+                if (bnLength <= 0) {
+                    continue;
+                }
+                for (auto& value: bn) {
+                    value /= bnLength;
+                }
+
+                const double bd = -(bn[0] * static_cast<double>(pa.x) + bn[1] * static_cast<double>(pa.y) + bn[2] * static_cast<double>(pa.z));
+                const auto borderQuadric = Quadric::FromPlane(bn[0], bn[1], bn[2], bd, Dot(e, e) * BorderWeight);
+                quadrics[a].Add(borderQuadric);
+                quadrics[b].Add(borderQuadric);
+            }
+        }
+    }
+
+    double maxAppliedCost = 0;
+    std::vector<Collapse> collapses;
+    std::vector<Collapse> bestCollapse(vertexCount);
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool> isBorder(vertexCount);
+    std::vector<bool> passLocked(vertexCount);
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+
+    while (current.size() > targetIndexCount) {
+        const auto borderEdges = FindBorderEdges(canonical, current);
+        std::fill(isBorder.begin(), isBorder.end(), false);
+        for (const auto key: borderEdges) {
+            isBorder[static_cast<uint32_t>(key >> 32)] = true;
+            isBorder[static_cast<uint32_t>(key & 0xFFFFFFFF)] = true;
+        }
+
+        // vertex -> triangles
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (const auto v: current) {
+            ++adjacencyOffsets[v + 1];
+        }
+        for (size_t v=0; v!=vertexCount; ++v) {
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        }
+        adjacency.resize(current.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffsets.cbegin(), adjacencyOffsets.cend() - 1);
+            for (size_t i=0; i!=current.size(); ++i) {
+                adjacency[fill[current[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        // the cheapest collapse for the each source vertex
+        std::fill(bestCollapse.begin(), bestCollapse.end(), Collapse{InvalidIndex, InvalidIndex, 0});
+        for (size_t i=0; i!=current.size(); i+=3) {
+            for (size_t k=0; k!=3; ++k) {
+                const uint32_t i0 = current[i + k];
+                const uint32_t i1 = current[i + (k + 1) % 3];
+                const uint32_t c0 = canonical[i0];
+                const uint32_t c1 = canonical[i1];
+                for (const auto& [from, to, cFrom, cTo]: {std::make_tuple(i0, i1, c0, c1), std::make_tuple(i1, i0, c1, c0)}) {
+                    if ((cFrom == cTo) || isSeam[from]) {
+                        continue;
+                    }
+                    if (isBorder[cFrom] && !IsBorderEdge(borderEdges, cFrom, cTo)) {
+                        continue;
+                    }
+
+                    Quadric q = quadrics[cFrom];
+                    q.Add(quadrics[cTo]);
+                    const double cost = q.Error(vertexes[to].position);
+                    auto& best = bestCollapse[from];
+                    if ((best.v0 == InvalidIndex) || (cost < best.cost) || ((!(best.cost < cost)) && (to < best.v1))) {
+                        best = Collapse{from, to, cost};
+                    }
+                }
+            }
+        }
+
+        collapses.clear();
+        for (const auto& collapse: bestCollapse) {
+            if ((collapse.v0 != InvalidIndex) && (collapse.cost <= maxCost)) {
+                collapses.push_back(collapse);
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+            if (a.cost < b.cost) {
+                return true;
+            }
+            if (b.cost < a.cost) {
+                return false;
+            }
+            return a.v0 < b.v0;
+        });
+
+        for (uint32_t v=0; v!=static_cast<uint32_t>(vertexCount); ++v) {
+            remap[v] = v;
+        }
+        std::fill(passLocked.begin(), passLocked.end(), false);
+
+        const size_t trianglesToRemove = (current.size() - targetIndexCount + 2) / 3;
+        size_t removedTriangles = 0;
+        size_t appliedCollapses = 0;
+        for (const auto& collapse: collapses) {
+            if (removedTriangles >= trianglesToRemove) {
+                break;
+            }
+            if (passLocked[collapse.v0] || passLocked[collapse.v1]) {
+                continue;
+            }
+
+            const uint32_t c1 = canonical[collapse.v1];
+            const auto& p1 = vertexes[collapse.v1].position;
+            size_t collapsedTriangles = 0;
+            bool isFlipped = false;
+            for (uint32_t j=adjacencyOffsets[collapse.v0]; j!=adjacencyOffsets[collapse.v0 + 1]; ++j) {
+                const uint32_t* tri = &current[adjacency[j] * 3];
+                if ((canonical[tri[0]] == c1) || (canonical[tri[1]] == c1) || (canonical[tri[2]] == c1)) {
+                    ++collapsedTriangles;
+                    continue;
+                }
+
+                const auto& pa = vertexes[tri[0]].position;
+                const auto& pb = vertexes[tri[1]].position;
+                const auto& pc = vertexes[tri[2]].position;
+                const auto oldNormal = TriangleNormal(pa, pb, pc);
+                const auto newNormal = TriangleNormal(
+                    (tri[0] == collapse.v0) ? p1 : pa, (tri[1] == collapse.v0) ? p1 : pb, (tri[2] == collapse.v0) ? p1 : pc);
+                // reject flips and large rotations (cos < 0.25), they make slivers
+                if (Dot(oldNormal, newNormal) <= MinNormalCos * std::sqrt(Dot(oldNormal, oldNormal) * Dot(newNormal, newNormal))) {
+                    isFlipped = true;
+                    break;
+                }
+            }
+            if (isFlipped) {
+                continue;
+            }
+
+            // lock the one-ring, the adjacency of the locked vertexes stays valid until the end of the pass
+            for (uint32_t j=adjacencyOffsets[collapse.v0]; j!=adjacencyOffsets[collapse.v0 + 1]; ++j) {
+                const uint32_t* tri = &current[adjacency[j] * 3];
+                passLocked[tri[0]] = true;
+                passLocked[tri[1]] = true;
+                passLocked[tri[2]] = true;
+            }
+
+            remap[collapse.v0] = collapse.v1;
+            quadrics[c1].Add(quadrics[canonical[collapse.v0]]);
+            maxAppliedCost = std::max(maxAppliedCost, collapse.cost);
+            removedTriangles += collapsedTriangles;
+            ++appliedCollapses;
+        }
+
+        if (appliedCollapses == 0) {
+            break;
+        }
+
+        size_t writeIndex = 0;
+        for (size_t i=0; i!=current.size(); i+=3) {
+            const uint32_t a = remap[current[i + 0]];
+            const uint32_t b = remap[current[i + 1]];
+            const uint32_t c = remap[current[i + 2]];
+            if ((canonical[a] != canonical[b]) && (canonical[b] != canonical[c]) && (canonical[a] != canonical[c])) {
+                current[writeIndex++] = a;
+                current[writeIndex++] = b;
+                current[writeIndex++] = c;
+            }
+        }
+        current.resize(writeIndex);
+    }
+
+    if ((resultError != nullptr) && (extent > 0)) {
+        *resultError = static_cast<float>(std::sqrt(maxAppliedCost) / extent);
+    }
+
+    std::copy(current.cbegin(), current.cend(), destination);
+    return current.size();
+}
+
+std::vector<MeshLod> MeshSimplifier::BuildLods(const VertexPNC* vertexes, size_t vertexCount, const uint32_t* indexes, size_t indexCount,
+    const MeshLodDesc& desc) {
+
+    std::vector<MeshLod> result;
+    const float extent = CalcExtent(vertexes, vertexCount, indexes, indexCount);
+    std::vector<uint32_t> current(indexes, indexes + indexCount);
+    float error = 0.f;
+    for (uint8_t level=1; level<desc.maxLevels; ++level) {
+        const auto targetIndexCount = static_cast<size_t>(static_cast<float>(current.size()) * desc.ratio) / 3 * 3;
+        if (targetIndexCount == 0) {
+            break;
+        }
+
+        MeshLod lod;
+        lod.indexes.resize(current.size());
+        float levelError = 0.f;
+        const size_t count = Simplify(vertexes, vertexCount, current.data(), current.size(), lod.indexes.data(),
+            targetIndexCount, desc.targetError, &levelError);
+        if ((count == 0) || (static_cast<float>(count) > static_cast<float>(current.size()) * MinLodReduction)) {
+            break;
+        }
+
+        lod.indexes.resize(count);
+        error += levelError * extent;
+        lod.error = error;
+        current = lod.indexes;
+        result.push_back(std::move(lod));
+    }
+
+    return result;
+}
+
+float MeshSimplifier::CalcExtent(const VertexPNC* vertexes, size_t vertexCount, const uint32_t* indexes, size_t indexCount) {
+    if ((vertexCount == 0) || (indexCount == 0)) {
+        return 0.f;
+    }
+
+    float minPos[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+    float maxPos[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+    for (size_t i=0; i!=indexCount; ++i) {
+        const auto& pos = vertexes[indexes[i]].position;
+        const float values[3] = {pos.x, pos.y, pos.z};
+        for (size_t k=0; k!=3; ++k) {
+            minPos[k] = std::min(minPos[k], values[k]);
+            maxPos[k] = std::max(maxPos[k], values[k]);
+        }
+    }
+
+    return std::max({maxPos[0] - minPos[0], maxPos[1] - minPos[1], maxPos[2] - minPos[2]});
+}
@@ -1,6 +1,9 @@
 #include "middleware/generator/mesh/shape_builder.h"
 
+#include <vector>
+#include <cstddef>
 #include <cstdint>
+#include <algorithm>
 
 #include "dg/device.h" // IWYU pragma: keep
 #include "core/render/geometry.h"
@@ -19,26 +22,91 @@ ShapeBuilder::~ShapeBuilder() {
     m_device.Release();
 }
 
+void ShapeBuilder::SetOptimization(const MeshOptimizerDesc& desc) {
+    m_optimize = true;
+    m_optimizer = MeshOptimizer(desc);
+}
+
+void ShapeBuilder::ResetOptimization() {
+    m_optimize = false;
+    m_optimizationStats = MeshOptimizerStats();
+}
+
+void ShapeBuilder::SetLods(const MeshLodDesc& desc) {
+    m_buildLods = true;
+    m_lodDesc = desc;
+}
+
+void ShapeBuilder::ResetLods() {
+    m_buildLods = false;
+}
+
 std::shared_ptr<Geometry> ShapeBuilder::Join(const std::initializer_list<const IShapeGenerator*>& shapes, const char* name) {
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (auto& shape : shapes) {
+        vertexCount += shape->LenghtVertex();
+        indexCount += shape->LenghtIndex();
+    }
+
     VertexBufferBuilder vbBuilder;
     IndexBufferBuilder ibBuilder;
+    auto vb = vbBuilder.AddRange<VertexPNC>(vertexCount);
+    auto ib = ibBuilder.AddRange<uint32_t>(indexCount);
 
     uint32_t vertexStartIndex = 0;
-    uint32_t indexCount = 0;
+    uint32_t indexStartIndex = 0;
     for (auto& shape : shapes) {
-        auto vb = vbBuilder.AddRange<VertexPNC>(shape->LenghtVertex());
-        shape->FillVertex(vb.Begin());
+        shape->FillVertex(vb.Begin() + vertexStartIndex);
+        shape->FillIndex(ib.Begin() + indexStartIndex, vertexStartIndex);
 
-        auto ib = ibBuilder.AddRange<uint32_t>(shape->LenghtIndex());
-        shape->FillIndex(ib.Begin(), vertexStartIndex);
+        vertexStartIndex += static_cast<uint32_t>(shape->LenghtVertex());
+        indexStartIndex += static_cast<uint32_t>(shape->LenghtIndex());
+    }
+
+    if (m_optimize) {
+        m_optimizationStats = m_optimizer.Optimize(vb.Begin(), vb.Count(), ib.Begin(), ib.Count());
+    }
+
+    std::vector<MeshLod> lods;
+    if (m_buildLods) {
+        lods = MeshSimplifier::BuildLods(vb.Begin(), vb.Count(), ib.Begin(), ib.Count(), m_lodDesc);
+    }
 
-        vertexStartIndex += vb.Count();
-        indexCount += ib.Count();
+    dg::float3 center(0, 0, 0);
+    if (!lods.empty() && (vb.Count() != 0)) {
+        dg::float3 minPos = vb.Begin()->position;
+        dg::float3 maxPos = vb.Begin()->position;
+        for (const auto* it = vb.Begin(); it != vb.End(); ++it) {
+            minPos = dg::min(minPos, it->position);
+            maxPos = dg::max(maxPos, it->position);
+        }
+        center = (minPos + maxPos) * 0.5f;
+    }
+
+    // ib is invalid after the next AddRange
+    const uint32_t lod0IndexCount = ib.Count();
+    uint32_t ibCount = lod0IndexCount;
+    std::vector<GeometryLod> geometryLods = {GeometryLod{0, lod0IndexCount, 0.f}};
+    for (auto& lod: lods) {
+        if (m_optimize && m_optimizer.GetDesc().vertexCache) {
+            MeshOptimizer::OptimizeVertexCache(lod.indexes.data(), lod.indexes.size(), vertexCount);
+        }
+
+        auto lodIb = ibBuilder.AddRange<uint32_t>(lod.indexes.size());
+        std::copy(lod.indexes.cbegin(), lod.indexes.cend(), lodIb.Begin());
+        geometryLods.push_back(GeometryLod{ibCount, lodIb.Count(), lod.error});
+        ibCount += lodIb.Count();
     }
 
     bool isUint32 = true;
     uint32_t vbOffsetBytes = 0;
     uint32_t ibOffsetBytes = 0;
-    return std::make_shared<GeometryIndexed>(vbBuilder.Build(m_device, name), vbOffsetBytes,
-        ibBuilder.Build(m_device, name), ibOffsetBytes, indexCount, isUint32, VertexPNC::GetVDeclId());
+    auto geometry = std::make_shared<GeometryIndexed>(vbBuilder.Build(m_device, name), vbOffsetBytes,
+        ibBuilder.Build(m_device, name), ibOffsetBytes, ibCount, isUint32, VertexPNC::GetVDeclId());
+    if (geometryLods.size() > 1) {
+        geometry->SetLods(geometryLods, center);
+    }
+
+    return geometry;
 }
@@ -0,0 +1,290 @@
+#include "middleware/generator/scatter/scatter.h"
+
+#include <cmath>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+
+#include "core/math/random.h"
+#include "core/math/constants.h"
+#include "core/common/exception.h"
+#include "core/common/parallel_for.h"
+
+
+namespace {
+
+// Background grid of the Bridson's algorithm with cell size = minDistance / sqrt(2), each cell contains at most one point
+class PointGrid : Fixed {
+public:
+    PointGrid(const math::RectF& rect, float minDistance)
+        : m_rect(rect)
+        , m_minDistanceSq(minDistance * minDistance)
+        , m_invCellSize(std::sqrt(2.f) / minDistance)
+        , m_width(static_cast<int32_t>(std::ceil(rect.w * m_invCellSize)) + 1)
+        , m_height(static_cast<int32_t>(std::ceil(rect.h * m_invCellSize)) + 1)
+        , m_cells(static_cast<size_t>(m_width) * static_cast<size_t>(m_height), InvalidIndex) {
+
+    }
+
+    bool Contains(const dg::float2& p) const noexcept {
+        return (p.x >= m_rect.Left()) && (p.x < m_rect.Right()) && (p.y >= m_rect.Top()) && (p.y < m_rect.Bottom());
+    }
+
+    bool IsFree(const dg::float2& p) const noexcept {
+        const int32_t cx = CellX(p.x);
+        const int32_t cy = CellY(p.y);
+        for (int32_t y=std::max(cy - 2, 0); y<=std::min(cy + 2, m_height - 1); ++y) {
+            for (int32_t x=std::max(cx - 2, 0); x<=std::min(cx + 2, m_width - 1); ++x) {
+                const uint32_t index = m_cells[static_cast<size_t>(y * m_width + x)];
+                if (index == InvalidIndex) {
+                    continue;
+                }
+                const dg::float2 d = m_points[index] - p;
+                if ((d.x * d.x + d.y * d.y) < m_minDistanceSq) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // p must be inside the rect
+    void Add(const dg::float2& p) {
+        m_cells[static_cast<size_t>(CellY(p.y) * m_width + CellX(p.x))] = static_cast<uint32_t>(m_points.size());
+        m_points.push_back(p);
+    }
+
+private:
+    int32_t CellX(float x) const noexcept { return std::clamp(static_cast<int32_t>((x - m_rect.x) * m_invCellSize), 0, m_width - 1); }
+    int32_t CellY(float y) const noexcept { return std::clamp(static_cast<int32_t>((y - m_rect.y) * m_invCellSize), 0, m_height - 1); }
+
+private:
+    static constexpr const uint32_t InvalidIndex = ~uint32_t(0);
+
+    math::RectF m_rect;
+    float m_minDistanceSq;
+    float m_invCellSize;
+    int32_t m_width;
+    int32_t m_height;
+    std::vector<uint32_t> m_cells;
+    std::vector<dg::float2> m_points;
+};
+
+bool IsIntersected(const math::RectF& a, const math::RectF& b) {
+    return (a.Left() < b.Right()) && (b.Left() < a.Right()) && (a.Top() < b.Bottom()) && (b.Top() < a.Bottom());
+}
+
+}
+
+Scatter::Scatter(const ScatterDesc& desc)
+    : m_desc(desc)
+    , m_density(1.0) {
+
+    if (!(desc.minDistance > 0)) {
+        throw EngineError("Scatter: minDistance must be greater than zero");
+    }
+    if (desc.tileSize < desc.minDistance) {
+        throw EngineError("Scatter: tileSize ({}) must be greater than or equal to minDistance ({})", desc.tileSize, desc.minDistance);
+    }
+    if ((desc.region.w < 0) || (desc.region.h < 0)) {
+        throw EngineError("Scatter: region size must be non-negative");
+    }
+    if (desc.maxScale < desc.minScale) {
+        throw EngineError("Scatter: maxScale must be greater than or equal to minScale");
+    }
+
+    m_tileCountX = static_cast<uint32_t>(std::ceil(desc.region.w / desc.tileSize));
+    m_tileCountY = static_cast<uint32_t>(std::ceil(desc.region.h / desc.tileSize));
+    m_tiles.resize(static_cast<size_t>(m_tileCountX) * static_cast<size_t>(m_tileCountY));
+    for (uint32_t ty=0; ty!=m_tileCountY; ++ty) {
+        for (uint32_t tx=0; tx!=m_tileCountX; ++tx) {
+            const float x = desc.region.x + static_cast<float>(tx) * desc.tileSize;
+            const float y = desc.region.y + static_cast<float>(ty) * desc.tileSize;
+            m_tiles[ty * m_tileCountX + tx].rect = math::RectF(x, y,
+                std::min(desc.tileSize, desc.region.Right() - x), std::min(desc.tileSize, desc.region.Bottom() - y));
+        }
+    }
+}
+
+void Scatter::SetDensity(const math::Generator2D& density) {
+    m_density = density;
+    for (auto& tile: m_tiles) {
+        tile.isDirty = true;
+    }
+}
+
+void Scatter::SetDensity(const math::Generator2D& density, const math::RectF& changedRect) {
+    m_density = density;
+    for (auto& tile: m_tiles) {
+        if (IsIntersected(tile.rect, changedRect)) {
+            tile.isDirty = true;
+        }
+    }
+}
+
+uint32_t Scatter::Update() {
+    std::vector<size_t> dirtyTiles;
+    for (size_t i=0; i!=m_tiles.size(); ++i) {
+        if (m_tiles[i].isDirty) {
+            dirtyTiles.push_back(i);
+        }
+    }
+    if (m_pointsReady && dirtyTiles.empty()) {
+        return 0;
+    }
+
+    // the workers are shared by the phases of the generation and the update of the instances
+    WorkerPool workers(ResolveThreadCount(m_desc.threadCount, m_tiles.size()));
+    if (!m_pointsReady) {
+        // Tiles are split into 4 phases (2x2 pattern), tiles of the one phase aren't neighbors and are generated in parallel,
+        // each tile takes into account the points of the neighbor tiles from the previous phases
+        std::vector<size_t> tileIndexes;
+        tileIndexes.reserve(m_tiles.size() / 4 + 1);
+        for (uint32_t phase=0; phase!=4; ++phase) {
+            tileIndexes.clear();
+            for (uint32_t ty=(phase >> 1u); ty<m_tileCountY; ty+=2) {
+                for (uint32_t tx=(phase & 1u); tx<m_tileCountX; tx+=2) {
+                    tileIndexes.push_back(ty * m_tileCountX + tx);
+                }
+            }
+            workers.ParallelFor(tileIndexes.size(), [this, &tileIndexes](size_t index) { GeneratePoints(tileIndexes[index]); });
+        }
+        m_pointsReady = true;
+    }
+
+    std::atomic<uint32_t> changedCount(0);
+    workers.ParallelFor(dirtyTiles.size(), [this, &dirtyTiles, &changedCount](size_t index) {
+        if (UpdateInstances(m_tiles[dirtyTiles[index]])) {
+            changedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    const uint32_t result = changedCount.load();
+    if (result != 0) {
+        ++m_version;
+        m_instancesReady = false;
+    }
+
+    return result;
+}
+
+const std::vector<InstanceTransform>& Scatter::GetTileInstances(uint32_t tileX, uint32_t tileY) const {
+    if ((tileX >= m_tileCountX) || (tileY >= m_tileCountY)) {
+        throw EngineError("Scatter::GetTileInstances: tile ({}, {}) is out of range ({}, {})", tileX, tileY, m_tileCountX, m_tileCountY);
+    }
+
+    return m_tiles[tileY * m_tileCountX + tileX].instances;
+}
+
+const std::vector<InstanceTransform>& Scatter::GetInstances() {
+    if (!m_instancesReady) {
+        size_t count = 0;
+        for (const auto& tile: m_tiles) {
+            count += tile.instances.size();
+        }
+        m_instances.clear();
+        m_instances.reserve(count);
+        for (const auto& tile: m_tiles) {
+            m_instances.insert(m_instances.end(), tile.instances.cbegin(), tile.instances.cend());
+        }
+        m_instancesReady = true;
+    }
+
+    return m_instances;
+}
+
+void Scatter::GeneratePoints(size_t tileIndex) {
+    auto& tile = m_tiles[tileIndex];
+    const float minDistance = m_desc.minDistance;
+    const auto tileX = static_cast<uint32_t>(tileIndex % m_tileCountX);
+    const auto tileY = static_cast<uint32_t>(tileIndex / m_tileCountX);
+
+    // the stream of the tile, the points don't depend on the order of the tiles and the thread count
+    const uint64_t stream = (static_cast<uint64_t>(tileY) << 32) | tileX;
+    uint64_t counter = 0;
+    auto rand = [seed = m_desc.seed, stream, &counter]() { return Rand<float>(seed, stream, counter++); };
+
+    // the grid covers the neighbor points, that can be closer than minDistance to the tile points
+    PointGrid grid(tile.rect + math::RectOffsetF(minDistance), minDistance);
+    for (uint32_t y=(tileY == 0 ? 0 : tileY - 1); y<=std::min(tileY + 1, m_tileCountY - 1); ++y) {
+        for (uint32_t x=(tileX == 0 ? 0 : tileX - 1); x<=std::min(tileX + 1, m_tileCountX - 1); ++x) {
+            if ((x == tileX) && (y == tileY)) {
+                continue;
+            }
+            for (const auto& point: m_tiles[y * m_tileCountX + x].points) {
+                if (grid.Contains(point.position)) {
+                    grid.Add(point.position);
+                }
+            }
+        }
+    }
+
+    tile.points.clear();
+    std::vector<dg::float2> active;
+    auto tryAdd = [this, &tile, &grid, &active, &rand](const dg::float2& p) {
+        if ((p.x < tile.rect.Left()) || (p.x >= tile.rect.Right()) || (p.y < tile.rect.Top()) || (p.y >= tile.rect.Bottom()) || !grid.IsFree(p)) {
+            return false;
+        }
+        grid.Add(p);
+        active.push_back(p);
+        const float threshold = rand();
+        const float scale = m_desc.minScale + (m_desc.maxScale - m_desc.minScale) * rand();
+        const float angleY = TwoPI<float>() * rand();
+        tile.points.push_back(Point{p, threshold, scale, angleY});
+
+        return true;
+    };
+
+    // several starting points, because the neighbor points can split the free space of the tile
+    for (uint32_t i=0; i!=m_desc.attempts; ++i) {
+        if (!tryAdd(dg::float2(tile.rect.x + rand() * tile.rect.w, tile.rect.y + rand() * tile.rect.h))) {
+            continue;
+        }
+
+        while (!active.empty()) {
+            const size_t activeIndex = std::min(static_cast<size_t>(rand() * static_cast<float>(active.size())), active.size() - 1);
+            const dg::float2 center = active[activeIndex];
+            bool found = false;
+            for (uint32_t k=0; k!=m_desc.attempts; ++k) {
+                const float angle = TwoPI<float>() * rand();
+                const float radius = minDistance * (1.f + rand());
+                if (tryAdd(center + dg::float2(std::cos(angle), std::sin(angle)) * radius)) {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                active[activeIndex] = active.back();
+                active.pop_back();
+            }
+        }
+    }
+}
+
+bool Scatter::UpdateInstances(Tile& tile) const {
+    tile.isDirty = false;
+
+    std::vector<bool> keptMask(tile.points.size(), false);
+    for (size_t i=0; i!=tile.points.size(); ++i) {
+        const auto& point = tile.points[i];
+        const double density = m_density(static_cast<double>(point.position.x), static_cast<double>(point.position.y));
+        keptMask[i] = (density > static_cast<double>(point.threshold));
+    }
+
+    if (tile.isGenerated && (keptMask == tile.keptMask)) {
+        return false;
+    }
+
+    tile.instances.clear();
+    for (size_t i=0; i!=tile.points.size(); ++i) {
+        if (keptMask[i]) {
+            const auto& point = tile.points[i];
+            tile.instances.push_back(InstanceTransform{dg::float3(point.position.x, 0, point.position.y), point.scale, point.angleY});
+        }
+    }
+    tile.keptMask = std::move(keptMask);
+    tile.isGenerated = true;
+
+    return true;
+}
@@ -1,14 +1,34 @@
 #include "middleware/generator/texture/chess_cubes.h"
 
+#include <cmath>
+
 #include "core/math/numbers.h"
 #include "core/math/generator_type.h"
 
 
 math::Generator3D ChessCubes::Result() const {
-    return math::Generator3D([frequency = static_cast<double>(m_frequency)](double x, double y, double z) -> double {
+    math::Generator3D result([frequency = static_cast<double>(m_frequency)](double x, double y, double z) -> double {
         auto ix = math::ToInt32Continuous(x * frequency);
         auto iy = math::ToInt32Continuous(y * frequency);
         auto iz = math::ToInt32Continuous(z * frequency);
         return ((ix & 1) ^ (iy & 1) ^ (iz & 1)) ? -1.: 1.;
     });
+    // the box inside one cube has the value of the cube
+    result.SetBounds([frequency = static_cast<double>(m_frequency)](
+        math::Interval<double> x, math::Interval<double> y, math::Interval<double> z) -> math::Interval<double> {
+        auto isOneCube = [frequency](const math::Interval<double>& v) {
+            return v.IsBounded() && (std::abs((v.upper - v.lower) * frequency) < 1.) &&
+                (math::ToInt32Continuous(v.lower * frequency) == math::ToInt32Continuous(v.upper * frequency));
+        };
+        if (!isOneCube(x) || !isOneCube(y) || !isOneCube(z)) {
+            return math::Interval<double>{-1., 1.};
+        }
+
+        auto ix = math::ToInt32Continuous(x.lower * frequency);
+        auto iy = math::ToInt32Continuous(y.lower * frequency);
+        auto iz = math::ToInt32Continuous(z.lower * frequency);
+        return math::Interval<double>::Point(((ix & 1) ^ (iy & 1) ^ (iz & 1)) ? -1.: 1.);
+    });
+
+    return result;
 }
@@ -1,17 +1,20 @@
 #include "middleware/generator/texture/cylinders.h"
 
 #include <cmath>
-#include <algorithm>
 
 #include "core/math/generator_type.h"
+#include "generator/texture/ring_wave.h"
 
 
 math::Generator3D Cylinders::Result() const {
-    return math::Generator3D([frequency = m_frequency](double x, double, double z) -> double {
-        double distToCenter = std::hypot(x, z) * static_cast<double>(frequency);
-        double distToInnerSphere = distToCenter - std::floor(distToCenter);  // [0, 1)
-        double distToOuterSphere = 1. - distToInnerSphere;                   // (0, 1]
-        double nearestDist = std::min(distToInnerSphere, distToOuterSphere); // [0, 0.5]
-        return 1. - 4. * nearestDist;                                        // [-1, 1]
+    math::Generator3D result([frequency = m_frequency](double x, double, double z) -> double {
+        return RingWave(std::hypot(x, z) * static_cast<double>(frequency));
     });
+    result.SetBounds([frequency = std::abs(static_cast<double>(m_frequency))](
+        math::Interval<double> x, math::Interval<double>, math::Interval<double> z) -> math::Interval<double> {
+        auto distance = math::IntervalHypot(x, z);
+        return RingWaveBounds(math::Interval<double>{distance.lower * frequency, distance.upper * frequency});
+    });
+
+    return result;
 }
@@ -1,8 +1,9 @@
 #include "middleware/generator/texture/generator2d_to_texture.h"
 
 #include <memory>
+#include <vector>
+#include <cstddef>
 #include <cstdint>
-#include <algorithm>
 
 #include "dg/device.h"
 #include "core/engine.h"
@@ -34,18 +35,46 @@ Generator2dToTexture::Generator2dToTexture() {
 }
 
 Generator2dToTexture::~Generator2dToTexture() {
+    m_compressed.Release();
     m_texture.Release();
 }
 
 TexturePtr Generator2dToTexture::Result() {
+    if (m_compression.format != BlockFormat::None) {
+        return CompressedResult();
+    }
+
     if (!m_texture) {
         m_texture = Engine::Get().GetTextureManager()->CreateDynamicTexture(
             dg::TEX_FORMAT_RGBA8_UNORM, m_textureSize.w, m_textureSize.h, "tex::Generator2dToTexture");
+        m_baker.Reset();
+    } else if (m_texture->SetSize(m_textureSize.w, m_textureSize.h)) {
+        m_baker.Reset();
+    }
+
+    // the texture was evicted by the memory budget, the baked texels are uploaded again
+    const bool isRestored = m_texture->Restore();
+    const auto& rects = m_baker.Bake(m_input, m_generatorRect, m_textureSize);
+    if (isRestored) {
+        UploadAll();
     } else {
-        m_texture->SetSize(m_textureSize.w, m_textureSize.h);
+        UploadTexture(m_texture, rects);
+    }
+
+    return m_texture->Get();
+}
+
+TexturePtr Generator2dToTexture::Current() {
+    if (m_compression.format != BlockFormat::None) {
+        return m_compressed ? m_compressed : Result();
+    }
+    if (!m_texture) {
+        return Result();
     }
 
-    FillTexture(m_texture);
+    if (m_texture->Restore()) {
+        UploadAll();
+    }
 
     return m_texture->Get();
 }
@@ -64,24 +93,58 @@ void Generator2dToTexture::SetGeneratorRect(const math::RectF v) {
     m_generatorRect = v;
 }
 
-void Generator2dToTexture::FillTexture(dg::RefCntAutoPtr<DynamicTexture>& texture) const {
-    auto lock = texture->Lock(Engine::Get().GetContext());
-    double uDelta  = m_generatorRect.Width() / static_cast<double>(lock.width);
-    double vDelta  = m_generatorRect.Height() / static_cast<double>(lock.height);
-    double v = m_generatorRect.y;
-
-    for (uint32_t y=0; y!=lock.height; ++y) {
-        auto* pDest = reinterpret_cast<uint32_t*>(lock.data + lock.stride * y);
-        double u = m_generatorRect.x;
-        for (uint32_t x=0; x!=lock.width; ++x) {
-            double d = std::min(std::max((m_input(u, v) + 1.) * 255. * 0.5, 0.), 255.);
-            auto component = static_cast<uint8_t>(std::min(std::max(static_cast<int>(d), 0), 255));
-            *pDest = math::Color4(component, component, component).value;
-
-            // Go to the next point.
-            ++pDest;
-            u += uDelta;
-        }
-        v += vDelta;
+void Generator2dToTexture::SetCompression(const TextureCompressorDesc& desc) {
+    m_compression = desc;
+    m_compressed.Release();
+    m_texture.Release();
+    m_baker.Reset();
+}
+
+void Generator2dToTexture::SetCache(const std::shared_ptr<GeneratorTileCache>& cache, const TileLattice& lattice) {
+    m_baker.SetCache(cache, lattice);
+}
+
+void Generator2dToTexture::SetInput(const math::Generator2D& v) {
+    m_input = v;
+    m_baker.Invalidate();
+}
+
+void Generator2dToTexture::SetInput(const math::Generator2D& v, const math::RectF& changedRect) {
+    m_input = v;
+    m_baker.Invalidate(changedRect);
+}
+
+void Generator2dToTexture::UploadTexture(dg::RefCntAutoPtr<DynamicTexture>& texture, const std::vector<math::Rect>& rects) const {
+    if (rects.empty()) {
+        return;
+    }
+
+    auto& context = Engine::Get().GetContext();
+    for (const auto& rect: rects) {
+        texture->Update(context, rect, reinterpret_cast<const uint8_t*>(m_baker.GetTexels(rect)), m_baker.GetStride());
     }
+    texture->GenerateMips(context);
+}
+
+void Generator2dToTexture::UploadAll() {
+    const auto& desc = m_texture->Get()->GetDesc();
+    UploadTexture(m_texture, {math::Rect(0, 0, desc.Width, desc.Height)});
+}
+
+TexturePtr Generator2dToTexture::CompressedResult() {
+    const auto& rects = m_baker.Bake(m_input, m_generatorRect, m_textureSize);
+    if (m_compressed && rects.empty()) {
+        return m_compressed;
+    }
+
+    const auto* texels = reinterpret_cast<const uint8_t*>(m_baker.GetTexels());
+    const size_t size = static_cast<size_t>(m_textureSize.w) * static_cast<size_t>(m_textureSize.h) * 4;
+    DecodedTexture decoded;
+    decoded.isSRGB = false;
+    decoded.mips.push_back(TextureMip{m_textureSize.w, m_textureSize.h, std::vector<uint8_t>(texels, texels + size)});
+    GenerateMips(decoded);
+    CompressMips(decoded, m_compression);
+    m_compressed = Engine::Get().GetTextureManager()->CreateStaticTexture(decoded, "tex::Generator2dToTexture");
+
+    return m_compressed;
 }
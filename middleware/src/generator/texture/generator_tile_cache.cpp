@@ -0,0 +1,246 @@
+#include "middleware/generator/texture/generator_tile_cache.h"
+
+#include <bit>
+#include <cmath>
+#include <utility>
+#include <algorithm>
+
+#include "core/common/hash.h"
+#include "core/common/exception.h"
+
+
+namespace {
+
+int32_t FloorDiv(int32_t value, uint32_t divider) {
+    const auto d = static_cast<int64_t>(divider);
+    const auto v = static_cast<int64_t>(value);
+
+    return static_cast<int32_t>((v >= 0) ? (v / d) : ((v - d + 1) / d));
+}
+
+}
+
+bool GeneratorTileCache::Key::operator==(const Key& other) const noexcept {
+    // bitwise compare of the lattice, the cache doesn't merge the lattices, that differ by a rounding error
+    return (generatorId == other.generatorId) &&
+        (std::bit_cast<uint64_t>(lattice.originX) == std::bit_cast<uint64_t>(other.lattice.originX)) &&
+        (std::bit_cast<uint64_t>(lattice.originY) == std::bit_cast<uint64_t>(other.lattice.originY)) &&
+        (std::bit_cast<uint64_t>(lattice.step) == std::bit_cast<uint64_t>(other.lattice.step)) &&
+        (tileX == other.tileX) && (tileY == other.tileY) && (lod == other.lod);
+}
+
+size_t GeneratorTileCache::KeyHasher::operator()(const Key& key) const noexcept {
+    size_t hash = std::hash<const void*>()(key.generatorId);
+    HashCombine(hash, std::bit_cast<uint64_t>(key.lattice.originX));
+    HashCombine(hash, std::bit_cast<uint64_t>(key.lattice.originY));
+    HashCombine(hash, std::bit_cast<uint64_t>(key.lattice.step));
+    HashCombine(hash, key.tileX);
+    HashCombine(hash, key.tileY);
+    HashCombine(hash, key.lod);
+
+    return hash;
+}
+
+GeneratorTileCache::GeneratorTileCache(const GeneratorTileCacheDesc& desc)
+    : m_desc(desc) {
+
+    if ((desc.tileSize == 0) || ((desc.tileSize % 2) != 0)) {
+        throw EngineError("GeneratorTileCache: tileSize must be even and greater than zero, current value {}", desc.tileSize);
+    }
+}
+
+GeneratorTileCache::Tile GeneratorTileCache::GetTile(const math::Generator2D& input, const TileLattice& lattice, int32_t tileX, int32_t tileY, uint32_t lod) {
+    if (!(lattice.step > 0)) {
+        throw EngineError("GeneratorTileCache: lattice step must be greater than zero, current value {}", lattice.step);
+    }
+
+    const Key key{input.GetId(), lattice, tileX, tileY, lod};
+    if (auto tile = Find(key); tile) {
+        return tile;
+    }
+
+    auto tile = TryDownsample(key);
+    if (!tile) {
+        tile = SampleTile(input, key);
+    }
+    Insert(key, tile, input);
+
+    return tile;
+}
+
+void GeneratorTileCache::Sample(const math::Generator2D& input, const TileLattice& lattice, uint32_t lod, int32_t x, int32_t y, math::Size size, float* dst) {
+    if ((size.w == 0) || (size.h == 0)) {
+        return;
+    }
+
+    const uint32_t tileSize = m_desc.tileSize;
+    const int64_t right = static_cast<int64_t>(x) + static_cast<int64_t>(size.w);
+    const int64_t bottom = static_cast<int64_t>(y) + static_cast<int64_t>(size.h);
+    const int32_t tileMinX = FloorDiv(x, tileSize);
+    const int32_t tileMinY = FloorDiv(y, tileSize);
+    const int32_t tileMaxX = FloorDiv(static_cast<int32_t>(right - 1), tileSize);
+    const int32_t tileMaxY = FloorDiv(static_cast<int32_t>(bottom - 1), tileSize);
+
+    for (int32_t tileY=tileMinY; tileY<=tileMaxY; ++tileY) {
+        const int64_t tileTop = static_cast<int64_t>(tileY) * tileSize;
+        const int64_t rowBegin = std::max(tileTop, static_cast<int64_t>(y));
+        const int64_t rowEnd = std::min(tileTop + tileSize, bottom);
+        for (int32_t tileX=tileMinX; tileX<=tileMaxX; ++tileX) {
+            const int64_t tileLeft = static_cast<int64_t>(tileX) * tileSize;
+            const int64_t columnBegin = std::max(tileLeft, static_cast<int64_t>(x));
+            const int64_t columnEnd = std::min(tileLeft + tileSize, right);
+            const auto columnCount = static_cast<size_t>(columnEnd - columnBegin);
+
+            const auto tile = GetTile(input, lattice, tileX, tileY, lod);
+            for (int64_t row=rowBegin; row!=rowEnd; ++row) {
+                const float* src = tile->data() + static_cast<size_t>(row - tileTop) * tileSize + static_cast<size_t>(columnBegin - tileLeft);
+                float* pDest = dst + static_cast<size_t>(row - y) * size.w + static_cast<size_t>(columnBegin - x);
+                std::copy_n(src, columnCount, pDest);
+            }
+        }
+    }
+}
+
+void GeneratorTileCache::Invalidate(const math::Generator2D& input) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const void* generatorId = input.GetId();
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->key.generatorId == generatorId) {
+            m_index.erase(it->key);
+            m_memory -= TileMemory();
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void GeneratorTileCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+    m_memory = 0;
+}
+
+GeneratorTileCacheCounters GeneratorTileCache::GetCounters() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    GeneratorTileCacheCounters counters;
+    counters.hits = m_hits;
+    counters.misses = m_misses;
+    counters.downsampled = m_downsampled;
+    counters.evictions = m_evictions;
+    counters.tiles = m_index.size();
+    counters.memory = m_memory;
+
+    return counters;
+}
+
+GeneratorTileCache::Tile GeneratorTileCache::Find(const Key& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it == m_index.cend()) {
+        ++m_misses;
+        return Tile();
+    }
+
+    ++m_hits;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+    return it->second->tile;
+}
+
+GeneratorTileCache::Tile GeneratorTileCache::TryDownsample(const Key& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto tile = DownsampleLocked(key, MaxDownsampleLevels);
+    if (tile) {
+        ++m_downsampled;
+    }
+
+    return tile;
+}
+
+// sample (x, y) of the tile is sample (2x, 2y) of LOD - 1, so it is taken from 4 tiles of LOD - 1,
+// that are found in the cache or downsampled from the finer LODs
+GeneratorTileCache::Tile GeneratorTileCache::DownsampleLocked(const Key& key, uint32_t levels) const {
+    if ((key.lod == 0) || (levels == 0)) {
+        return Tile();
+    }
+
+    Tile children[4];
+    for (int32_t i=0; i!=4; ++i) {
+        const Key childKey{key.generatorId, key.lattice, key.tileX * 2 + (i & 1), key.tileY * 2 + (i >> 1), key.lod - 1};
+        if (auto it = m_index.find(childKey); it != m_index.cend()) {
+            children[i] = it->second->tile;
+        } else {
+            children[i] = DownsampleLocked(childKey, levels - 1);
+        }
+        if (!children[i]) {
+            return Tile();
+        }
+    }
+
+    const uint32_t tileSize = m_desc.tileSize;
+    const uint32_t halfSize = tileSize / 2;
+    auto tile = std::make_shared<std::vector<float>>(static_cast<size_t>(tileSize) * static_cast<size_t>(tileSize));
+    for (uint32_t y=0; y!=tileSize; ++y) {
+        for (uint32_t x=0; x!=tileSize; ++x) {
+            const size_t childIndex = static_cast<size_t>(x / halfSize) + static_cast<size_t>(y / halfSize) * 2;
+            const size_t srcIndex = static_cast<size_t>((y * 2) % tileSize) * tileSize + static_cast<size_t>((x * 2) % tileSize);
+            (*tile)[static_cast<size_t>(y) * tileSize + x] = (*children[childIndex])[srcIndex];
+        }
+    }
+
+    return tile;
+}
+
+GeneratorTileCache::Tile GeneratorTileCache::SampleTile(const math::Generator2D& input, const Key& key) const {
+    const uint32_t tileSize = m_desc.tileSize;
+    // the multiplication by 2^lod is exact, so the samples match the samples of the finer LOD bit to bit
+    const double step = std::ldexp(key.lattice.step, static_cast<int>(key.lod));
+    const int64_t left = static_cast<int64_t>(key.tileX) * tileSize;
+    const int64_t top = static_cast<int64_t>(key.tileY) * tileSize;
+
+    auto tile = std::make_shared<std::vector<float>>(static_cast<size_t>(tileSize) * static_cast<size_t>(tileSize));
+    float* pDest = tile->data();
+    for (uint32_t y=0; y!=tileSize; ++y) {
+        const double v = key.lattice.originY + static_cast<double>(top + y) * step;
+        for (uint32_t x=0; x!=tileSize; ++x) {
+            const double u = key.lattice.originX + static_cast<double>(left + x) * step;
+            *pDest = static_cast<float>(input(u, v));
+            ++pDest;
+        }
+    }
+
+    return tile;
+}
+
+void GeneratorTileCache::Insert(const Key& key, const Tile& tile, const math::Generator2D& input) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (TileMemory() > m_desc.maxMemory) {
+        return;
+    }
+
+    // the tile was inserted by a concurrent miss
+    if (auto it = m_index.find(key); it != m_index.cend()) {
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return;
+    }
+
+    m_entries.push_front(Entry{key, tile, input});
+    m_index[key] = m_entries.begin();
+    m_memory += TileMemory();
+    Evict();
+}
+
+void GeneratorTileCache::Evict() {
+    while (m_memory > m_desc.maxMemory) {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+        m_memory -= TileMemory();
+        ++m_evictions;
+    }
+}
+
+size_t GeneratorTileCache::TileMemory() const noexcept {
+    return static_cast<size_t>(m_desc.tileSize) * static_cast<size_t>(m_desc.tileSize) * sizeof(float);
+}
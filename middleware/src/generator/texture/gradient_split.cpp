@@ -0,0 +1,20 @@
+#include "middleware/generator/texture/gradient_split.h"
+
+
+math::Generator3D GradientSplit::DX() const {
+    return math::Generator3D([input = m_input](double x, double y, double z) -> double {
+        return input.Gradient(x, y, z).dx;
+    });
+}
+
+math::Generator3D GradientSplit::DY() const {
+    return math::Generator3D([input = m_input](double x, double y, double z) -> double {
+        return input.Gradient(x, y, z).dy;
+    });
+}
+
+math::Generator3D GradientSplit::DZ() const {
+    return math::Generator3D([input = m_input](double x, double y, double z) -> double {
+        return input.Gradient(x, y, z).dz;
+    });
+}
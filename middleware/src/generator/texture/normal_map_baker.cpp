@@ -0,0 +1,61 @@
+#include "middleware/generator/texture/normal_map_baker.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include "core/common/exception.h"
+
+
+namespace {
+
+uint32_t EncodeTexel(double value, double dx, double dy, double heightScale) {
+    const double nx = -dx * heightScale;
+    const double ny = -dy * heightScale;
+    const double invLength = 1. / std::sqrt(nx * nx + ny * ny + 1.);
+
+    return math::Color4(
+        static_cast<float>((nx * invLength + 1.) * 0.5),
+        static_cast<float>((ny * invLength + 1.) * 0.5),
+        static_cast<float>((invLength + 1.) * 0.5),
+        static_cast<float>((value + 1.) * 0.5)).value;
+}
+
+}
+
+NormalMapBaker::NormalMapBaker(const NormalMapBakerDesc& desc)
+    : m_desc(desc) {
+
+    if ((desc.size.w == 0) || (desc.size.h == 0)) {
+        throw EngineError("NormalMapBaker: size must be greater than zero");
+    }
+    if (!(desc.region.w > 0) || !(desc.region.h > 0)) {
+        throw EngineError("NormalMapBaker: region size must be greater than zero");
+    }
+
+    m_texels.resize(static_cast<size_t>(desc.size.w) * static_cast<size_t>(desc.size.h));
+}
+
+void NormalMapBaker::Bake(const math::Generator2D& input) {
+    const double uDelta = static_cast<double>(m_desc.region.Width()) / static_cast<double>(m_desc.size.w);
+    const double vDelta = static_cast<double>(m_desc.region.Height()) / static_cast<double>(m_desc.size.h);
+    const double heightScale = static_cast<double>(m_desc.heightScale);
+    const double uStep = uDelta * 0.5;
+    const double vStep = vDelta * 0.5;
+
+    for (uint32_t y=0; y!=m_desc.size.h; ++y) {
+        auto* pDest = &m_texels[y * m_desc.size.w];
+        const double v = static_cast<double>(m_desc.region.y) + static_cast<double>(y) * vDelta;
+        for (uint32_t x=0; x!=m_desc.size.w; ++x) {
+            const double u = static_cast<double>(m_desc.region.x) + static_cast<double>(x) * uDelta;
+            if (m_desc.mode == NormalMapMode::Analytic) {
+                const auto g = input.Gradient(u, v);
+                *pDest = EncodeTexel(g.value, g.dx, g.dy, heightScale);
+            } else {
+                const double dx = (input(u + uStep, v) - input(u - uStep, v)) / uDelta;
+                const double dy = (input(u, v + vStep) - input(u, v - vStep)) / vDelta;
+                *pDest = EncodeTexel(input(u, v), dx, dy, heightScale);
+            }
+            ++pDest;
+        }
+    }
+}
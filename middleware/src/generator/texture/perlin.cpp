@@ -1,6 +1,7 @@
 #include "middleware/generator/texture/perlin.h"
 
 #include <cmath>
+#include <utility>
 #include <algorithm>
 
 #include "core/math/generator_type.h"
@@ -321,6 +322,17 @@ inline double SCurve5(double a) {
     return (6.0 * a5) - (15.0 * a4) + (10.0 * a3);
 }
 
+/// Derivative of SCurve3.
+inline double SCurve3Derivative(double a) {
+    return 6.0 * a * (1.0 - a);
+}
+
+/// Derivative of SCurve5.
+inline double SCurve5Derivative(double a) {
+    double a2 = a * a;
+    return 30.0 * a2 * (a2 - 2.0 * a + 1.0);
+}
+
   inline double MakeInt32Range(double n) {
     if (n >= 1073741824.0) {
       return (2.0 * fmod (n, 1073741824.0)) - 1073741824.0;
@@ -340,7 +352,7 @@ const int SHIFT_NOISE_GEN = 8;
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
 #pragma GCC diagnostic ignored "-Wsign-conversion"
-double GradientNoise3D(double fx, double fy, double fz, int ix, int iy, int iz, int seed) {
+inline int GradientVectorIndex(int ix, int iy, int iz, int seed) {
     // Randomly generate a gradient vector given the integer coordinates of the
     // input value.  This implementation generates a random number and uses it
     // as an index into a normalized-vector lookup table.
@@ -352,6 +364,12 @@ double GradientNoise3D(double fx, double fy, double fz, int ix, int iy, int iz,
     vectorIndex ^= (vectorIndex >> SHIFT_NOISE_GEN);
     vectorIndex &= 0xff;
 
+    return vectorIndex;
+}
+
+double GradientNoise3D(double fx, double fy, double fz, int ix, int iy, int iz, int seed) {
+    int vectorIndex = GradientVectorIndex(ix, iy, iz, seed);
+
     double xvGradient = RANDOM_VECTORS[(vectorIndex << 2)    ];
     double yvGradient = RANDOM_VECTORS[(vectorIndex << 2) + 1];
     double zvGradient = RANDOM_VECTORS[(vectorIndex << 2) + 2];
@@ -370,6 +388,22 @@ double GradientNoise3D(double fx, double fy, double fz, int ix, int iy, int iz,
     + (zvGradient * zvPoint)) * 2.12;
 }
 
+// GradientNoise3D with its derivatives, the noise is linear inside the cell,
+// so the derivatives are the scaled gradient vector
+math::Gradient3<double> GradientNoise3DDerivatives(double fx, double fy, double fz, int ix, int iy, int iz, int seed) {
+    int vectorIndex = GradientVectorIndex(ix, iy, iz, seed);
+
+    double xvGradient = RANDOM_VECTORS[(vectorIndex << 2)    ] * 2.12;
+    double yvGradient = RANDOM_VECTORS[(vectorIndex << 2) + 1] * 2.12;
+    double zvGradient = RANDOM_VECTORS[(vectorIndex << 2) + 2] * 2.12;
+
+    double value = (xvGradient * (fx - (double)ix))
+        + (yvGradient * (fy - (double)iy))
+        + (zvGradient * (fz - (double)iz));
+
+    return math::Gradient3<double>{value, xvGradient, yvGradient, zvGradient};
+}
+
 int IntValueNoise3D(int x, int y, int z, int seed) {
     // All constants are primes and must remain prime in order for this noise
     // function to work correctly.
@@ -437,9 +471,95 @@ double GradientCoherentNoise3D (double x, double y, double z, int seed, NoiseQua
     return LinearInterp(iy0, iy1, zs);
 }
 
+/// Performs linear interpolation between two values with derivatives.
+///
+/// @param n0 The first value.
+/// @param n1 The second value.
+/// @param a The alpha value.
+/// @param da The derivative of the alpha value along the axis @a axis.
+/// @param axis The axis of the interpolation (0 - x, 1 - y, 2 - z).
+inline math::Gradient3<double> LinearInterpDerivatives(
+    const math::Gradient3<double>& n0, const math::Gradient3<double>& n1, double a, double da, int axis) {
+
+    math::Gradient3<double> result{
+        LinearInterp(n0.value, n1.value, a),
+        LinearInterp(n0.dx, n1.dx, a),
+        LinearInterp(n0.dy, n1.dy, a),
+        LinearInterp(n0.dz, n1.dz, a)};
+
+    double dAlpha = da * (n1.value - n0.value);
+    switch (axis) {
+    case 0:
+        result.dx += dAlpha;
+        break;
+    case 1:
+        result.dy += dAlpha;
+        break;
+    default:
+        result.dz += dAlpha;
+        break;
+    }
+
+    return result;
+}
+
+// GradientCoherentNoise3D with its analytic derivatives, values match GradientCoherentNoise3D
+math::Gradient3<double> GradientCoherentNoise3DDerivatives(double x, double y, double z, int seed, NoiseQuality noiseQuality) {
+    int x0 = (x > 0.0? (int)x: (int)x - 1);
+    int x1 = x0 + 1;
+    int y0 = (y > 0.0? (int)y: (int)y - 1);
+    int y1 = y0 + 1;
+    int z0 = (z > 0.0? (int)z: (int)z - 1);
+    int z1 = z0 + 1;
+
+    double xa = (x - (double)x0);
+    double ya = (y - (double)y0);
+    double za = (z - (double)z0);
+    double xs = xa, ys = ya, zs = za;
+    double dxs = 1.0, dys = 1.0, dzs = 1.0;
+    switch (noiseQuality) {
+    case NoiseQuality::BestSpeed:
+        break;
+    case NoiseQuality::Default:
+        xs = SCurve3(xa);
+        ys = SCurve3(ya);
+        zs = SCurve3(za);
+        dxs = SCurve3Derivative(xa);
+        dys = SCurve3Derivative(ya);
+        dzs = SCurve3Derivative(za);
+        break;
+    case NoiseQuality::BestQuality:
+        xs = SCurve5(xa);
+        ys = SCurve5(ya);
+        zs = SCurve5(za);
+        dxs = SCurve5Derivative(xa);
+        dys = SCurve5Derivative(ya);
+        dzs = SCurve5Derivative(za);
+        break;
+    }
+
+    math::Gradient3<double> n0, n1, ix0, ix1, iy0, iy1;
+    n0   = GradientNoise3DDerivatives(x, y, z, x0, y0, z0, seed);
+    n1   = GradientNoise3DDerivatives(x, y, z, x1, y0, z0, seed);
+    ix0  = LinearInterpDerivatives(n0, n1, xs, dxs, 0);
+    n0   = GradientNoise3DDerivatives(x, y, z, x0, y1, z0, seed);
+    n1   = GradientNoise3DDerivatives(x, y, z, x1, y1, z0, seed);
+    ix1  = LinearInterpDerivatives(n0, n1, xs, dxs, 0);
+    iy0  = LinearInterpDerivatives(ix0, ix1, ys, dys, 1);
+    n0   = GradientNoise3DDerivatives(x, y, z, x0, y0, z1, seed);
+    n1   = GradientNoise3DDerivatives(x, y, z, x1, y0, z1, seed);
+    ix0  = LinearInterpDerivatives(n0, n1, xs, dxs, 0);
+    n0   = GradientNoise3DDerivatives(x, y, z, x0, y1, z1, seed);
+    n1   = GradientNoise3DDerivatives(x, y, z, x1, y1, z1, seed);
+    ix1  = LinearInterpDerivatives(n0, n1, xs, dxs, 0);
+    iy1  = LinearInterpDerivatives(ix0, ix1, ys, dys, 1);
+
+    return LinearInterpDerivatives(iy0, iy1, zs, dzs, 2);
+}
+
 math::Generator3D Perlin::Result() const {
 
-    return math::Generator3D([frequency = m_frequency, lacunarity = m_lacunarity
+    math::Generator3D::Functor func = [frequency = m_frequency, lacunarity = m_lacunarity
         , persistence = m_persistence, octaveCount = m_octaveCount,
         seed = m_seed, quality = m_quality](double x, double y, double z) -> double {
 
@@ -474,7 +594,56 @@ math::Generator3D Perlin::Result() const {
 
     return value;
 
+    };
+
+    math::Generator3D::GradientFunctor gradient = [frequency = m_frequency, lacunarity = m_lacunarity
+        , persistence = m_persistence, octaveCount = m_octaveCount,
+        seed = m_seed, quality = m_quality](double x, double y, double z) -> math::Gradient3<double> {
+
+    math::Gradient3<double> result;
+    // d(octave input) / d(x) = frequency * lacunarity ^ curOctave
+    double scale = frequency;
+    double curPersistence = 1.0;
+
+    x *= frequency;
+    y *= frequency;
+    z *= frequency;
+
+    for (int curOctave = 0; curOctave < octaveCount; curOctave++) {
+        int seedOctave = (seed + curOctave) & 0xffffffff;
+        auto signal = GradientCoherentNoise3DDerivatives(MakeInt32Range(x), MakeInt32Range(y), MakeInt32Range(z), seedOctave, quality);
+        double derivativeScale = curPersistence * scale;
+        result.value += signal.value * curPersistence;
+        result.dx += signal.dx * derivativeScale;
+        result.dy += signal.dy * derivativeScale;
+        result.dz += signal.dz * derivativeScale;
+
+        x *= lacunarity;
+        y *= lacunarity;
+        z *= lacunarity;
+        scale *= lacunarity;
+        curPersistence *= persistence;
+    }
+
+    return result;
+
+    };
+
+    math::Generator3D result(std::move(func), std::move(gradient));
+    // The octave is interpolated from 2.12 * dot(g, p - corner) with the unit gradient g and the non-negative weights w.
+    // So |octave| <= 2.12 * sum(w * |p - corner|) <= 2.12 * sqrt(sum(w * |p - corner|^2)) <= 2.12 * sqrt(3 / 4),
+    // it is more than the libnoise estimation [-1, 1], which isn't strict
+    double maxValue = 0;
+    double curPersistence = 1.0;
+    for (int curOctave = 0; curOctave < m_octaveCount; curOctave++) {
+        maxValue += std::abs(curPersistence) * 2.12 * std::sqrt(0.75);
+        curPersistence *= m_persistence;
+    }
+    result.SetBounds([maxValue](math::Interval<double>, math::Interval<double>, math::Interval<double>) {
+        return math::Interval<double>{-maxValue, maxValue};
     });
+
+    return result;
 }
 
 #pragma GCC diagnostic pop
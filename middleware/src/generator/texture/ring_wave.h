@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+
+#include "core/math/interval.h"
+
+
+// 1 - 4 * (distance to the nearest integer) of the scaled distance, [-1, 1], used by Spheres and Cylinders
+inline double RingWave(double distance) {
+    double distToInnerSphere = distance - std::floor(distance);          // [0, 1)
+    double distToOuterSphere = 1. - distToInnerSphere;                   // (0, 1]
+    double nearestDist = std::min(distToInnerSphere, distToOuterSphere); // [0, 0.5]
+    return 1. - 4. * nearestDist;                                        // [-1, 1]
+}
+
+// range of RingWave over the distances, the wave is monotonic between the integers and the half-integers
+inline math::Interval<double> RingWaveBounds(const math::Interval<double>& distance) {
+    if (!distance.IsBounded()) {
+        return math::Interval<double>{-1., 1.};
+    }
+
+    const double a = RingWave(distance.lower);
+    const double b = RingWave(distance.upper);
+    math::Interval<double> result{std::min(a, b), std::max(a, b)};
+    // the nearest integer and half-integer above the lower distance
+    if (std::ceil(distance.lower) <= distance.upper) {
+        result.upper = 1.;
+    }
+    if (std::ceil(distance.lower - 0.5) + 0.5 <= distance.upper) {
+        result.lower = -1.;
+    }
+
+    return result;
+}
@@ -1,8 +1,23 @@
 #include "middleware/generator/texture/section_plane.h"
 
+#include <utility>
+
 
 math::Generator2D SectionPlaneX0Y::Result() const {
-    return math::Generator2D([input = m_input, offset = m_offset](double x, double y) -> double {
+    math::Generator2D::Functor func = [input = m_input, offset = m_offset](double x, double y) -> double {
         return input(x, y, offset);
-    });
+    };
+    math::Generator2D result = m_input.HasGradient() ?
+        math::Generator2D(std::move(func), [input = m_input, offset = m_offset](double x, double y) -> math::Gradient2<double> {
+            const auto g = input.Gradient(x, y, offset);
+            return math::Gradient2<double>{g.value, g.dx, g.dy};
+        }) :
+        math::Generator2D(std::move(func));
+    if (m_input.HasBounds()) {
+        result.SetBounds([input = m_input, offset = m_offset](math::Interval<double> x, math::Interval<double> y) -> math::Interval<double> {
+            return input.Bounds(x, y, math::Interval<double>::Point(static_cast<double>(offset)));
+        });
+    }
+
+    return result;
 }
@@ -1,17 +1,40 @@
 #include "middleware/generator/texture/spheres.h"
 
 #include <cmath>
+#include <utility>
 #include <algorithm>
 
 #include "core/math/generator_type.h"
+#include "generator/texture/ring_wave.h"
 
 
 math::Generator3D Spheres::Result() const {
-    return math::Generator3D([frequency = m_frequency](double x, double y, double z) -> double {
-        double distToCenter = std::hypot(x, y, z) * static_cast<double>(frequency);
-        double distToInnerSphere = distToCenter - std::floor(distToCenter);  // [0, 1)
-        double distToOuterSphere = 1. - distToInnerSphere;                   // (0, 1]
-        double nearestDist = std::min(distToInnerSphere, distToOuterSphere); // [0, 0.5]
-        return 1. - 4. * nearestDist;                                        // [-1, 1]
+    math::Generator3D::Functor func = [frequency = m_frequency](double x, double y, double z) -> double {
+        return RingWave(std::hypot(x, y, z) * static_cast<double>(frequency));
+    };
+
+    math::Generator3D::GradientFunctor gradient = [frequency = m_frequency](double x, double y, double z) -> math::Gradient3<double> {
+        double radius = std::hypot(x, y, z);
+        double distToCenter = radius * static_cast<double>(frequency);
+        double distToInnerSphere = distToCenter - std::floor(distToCenter);
+        double distToOuterSphere = 1. - distToInnerSphere;
+        bool isInnerNearest = (distToInnerSphere < distToOuterSphere);
+        double value = 1. - 4. * (isInnerNearest ? distToInnerSphere : distToOuterSphere);
+        if (!(radius > 0.)) {
+            return math::Gradient3<double>{value, 0., 0., 0.};
+        }
+
+        // d(radius)/dp = p / radius
+        double scale = (isInnerNearest ? -4. : 4.) * static_cast<double>(frequency) / radius;
+        return math::Gradient3<double>{value, x * scale, y * scale, z * scale};
+    };
+
+    math::Generator3D result(std::move(func), std::move(gradient));
+    result.SetBounds([frequency = std::abs(static_cast<double>(m_frequency))](
+        math::Interval<double> x, math::Interval<double> y, math::Interval<double> z) -> math::Interval<double> {
+        auto distance = math::IntervalHypot(x, y, z);
+        return RingWaveBounds(math::Interval<double>{distance.lower * frequency, distance.upper * frequency});
     });
+
+    return result;
 }
@@ -0,0 +1,285 @@
+#include "middleware/generator/texture/texel_baker.h"
+
+#include <cmath>
+#include <algorithm>
+
+
+namespace {
+
+bool IsSameRect(const math::RectF& a, const math::RectF& b) {
+    return math::IsEqual(a.x, b.x) && math::IsEqual(a.y, b.y) && math::IsEqual(a.w, b.w) && math::IsEqual(a.h, b.h);
+}
+
+// shift in texels, if it is a whole number
+bool GetWholeShift(float from, float to, double texelSize, int32_t& shift) {
+    const double value = static_cast<double>(to - from) / texelSize;
+    const double rounded = std::round(value);
+    if (std::abs(value - rounded) > 1e-3) {
+        return false;
+    }
+    shift = static_cast<int32_t>(rounded);
+
+    return true;
+}
+
+uint32_t ToTexel(double value) {
+    double d = std::min(std::max((value + 1.) * 255. * 0.5, 0.), 255.);
+    auto component = static_cast<uint8_t>(std::min(std::max(static_cast<int>(d), 0), 255));
+
+    return math::Color4(component, component, component).value;
+}
+
+}
+
+void TexelBaker::SetCache(const std::shared_ptr<GeneratorTileCache>& cache, const TileLattice& lattice) {
+    m_cache = cache;
+    m_lattice = lattice;
+    m_isBaked = false;
+}
+
+void TexelBaker::Reset() noexcept {
+    m_isBaked = false;
+    m_invalidateAll = false;
+    m_changedRects.clear();
+}
+
+void TexelBaker::Invalidate() noexcept {
+    m_invalidateAll = true;
+    m_changedRects.clear();
+}
+
+void TexelBaker::Invalidate(const math::RectF& changedRect) noexcept {
+    if (!m_invalidateAll) {
+        m_changedRects.push_back(changedRect);
+    }
+}
+
+const std::vector<math::Rect>& TexelBaker::Bake(const math::Generator2D& input, const math::RectF& generatorRect, math::Size size) {
+    m_sampledCount = 0;
+    m_uploadRects.clear();
+
+    if (!m_isBaked || (size != m_size)) {
+        m_size = size;
+        m_generatorRect = generatorRect;
+        m_tileCountX = (size.w + TileSize - 1) / TileSize;
+        m_tileCountY = (size.h + TileSize - 1) / TileSize;
+        m_texels.resize(static_cast<size_t>(size.w) * static_cast<size_t>(size.h));
+
+        Sample(input, math::Rect(0, 0, size.w, size.h));
+        m_uploaded = m_texels;
+        m_uploadRects.push_back(math::Rect(0, 0, size.w, size.h));
+        m_isBaked = true;
+        m_invalidateAll = false;
+        m_changedRects.clear();
+
+        return m_uploadRects;
+    }
+
+    // the texels to sample: true - the whole tile is sampled
+    std::vector<bool> dirtyTiles(static_cast<size_t>(m_tileCountX) * static_cast<size_t>(m_tileCountY), m_invalidateAll);
+    bool shifted = false;
+    if (!IsSameRect(generatorRect, m_generatorRect)) {
+        int32_t dx = 0;
+        int32_t dy = 0;
+        if (TryGetShift(generatorRect, dx, dy)) {
+            Shift(dx, dy);
+            m_generatorRect = generatorRect;
+            // exposed strips
+            const auto w = static_cast<int32_t>(m_size.w);
+            const auto h = static_cast<int32_t>(m_size.h);
+            if (dx != 0) {
+                const auto stripWidth = static_cast<uint32_t>(std::abs(dx));
+                Sample(input, math::Rect((dx > 0) ? static_cast<uint32_t>(w - dx) : 0, 0, stripWidth, m_size.h));
+            }
+            if (dy != 0) {
+                const auto stripHeight = static_cast<uint32_t>(std::abs(dy));
+                const auto stripX = static_cast<uint32_t>(std::max(-dx, 0));
+                const auto stripWidth = static_cast<uint32_t>(w - std::abs(dx));
+                Sample(input, math::Rect(stripX, (dy > 0) ? static_cast<uint32_t>(h - dy) : 0, stripWidth, stripHeight));
+            }
+            shifted = true;
+        } else {
+            m_generatorRect = generatorRect;
+            std::fill(dirtyTiles.begin(), dirtyTiles.end(), true);
+        }
+    }
+
+    const double texelWidth = static_cast<double>(m_generatorRect.w) / static_cast<double>(m_size.w);
+    const double texelHeight = static_cast<double>(m_generatorRect.h) / static_cast<double>(m_size.h);
+    for (const auto& rect: m_changedRects) {
+        const double minX = std::floor(static_cast<double>(rect.Left() - m_generatorRect.x) / texelWidth);
+        const double maxX = std::ceil(static_cast<double>(rect.Right() - m_generatorRect.x) / texelWidth);
+        const double minY = std::floor(static_cast<double>(rect.Top() - m_generatorRect.y) / texelHeight);
+        const double maxY = std::ceil(static_cast<double>(rect.Bottom() - m_generatorRect.y) / texelHeight);
+        if ((maxX < 0) || (maxY < 0) || (minX >= static_cast<double>(m_size.w)) || (minY >= static_cast<double>(m_size.h))) {
+            continue;
+        }
+        const auto tileMinX = static_cast<uint32_t>(std::max(minX, 0.)) / TileSize;
+        const auto tileMinY = static_cast<uint32_t>(std::max(minY, 0.)) / TileSize;
+        const auto tileMaxX = std::min(static_cast<uint32_t>(maxX) / TileSize, m_tileCountX - 1);
+        const auto tileMaxY = std::min(static_cast<uint32_t>(maxY) / TileSize, m_tileCountY - 1);
+        for (uint32_t ty=tileMinY; ty<=tileMaxY; ++ty) {
+            for (uint32_t tx=tileMinX; tx<=tileMaxX; ++tx) {
+                dirtyTiles[ty * m_tileCountX + tx] = true;
+            }
+        }
+    }
+    m_invalidateAll = false;
+    m_changedRects.clear();
+
+    // after a shift all tiles are compared with the texture, the texels of the tile can stay the same
+    for (uint32_t ty=0; ty!=m_tileCountY; ++ty) {
+        for (uint32_t tx=0; tx!=m_tileCountX; ++tx) {
+            const size_t tileIndex = ty * m_tileCountX + tx;
+            const auto tileRect = GetTileRect(tx, ty);
+            if (dirtyTiles[tileIndex]) {
+                Sample(input, tileRect);
+            }
+            if ((dirtyTiles[tileIndex] || shifted) && UpdateUploadedTile(tileRect)) {
+                m_uploadRects.push_back(tileRect);
+            }
+        }
+    }
+
+    return m_uploadRects;
+}
+
+bool TexelBaker::TryGetShift(const math::RectF& generatorRect, int32_t& dx, int32_t& dy) const {
+    if (!math::IsEqual(generatorRect.w, m_generatorRect.w) || !math::IsEqual(generatorRect.h, m_generatorRect.h)) {
+        return false;
+    }
+
+    const double texelWidth = static_cast<double>(m_generatorRect.w) / static_cast<double>(m_size.w);
+    const double texelHeight = static_cast<double>(m_generatorRect.h) / static_cast<double>(m_size.h);
+    if (!GetWholeShift(m_generatorRect.x, generatorRect.x, texelWidth, dx) || !GetWholeShift(m_generatorRect.y, generatorRect.y, texelHeight, dy)) {
+        return false;
+    }
+
+    // nothing to reuse
+    return (std::abs(dx) < static_cast<int32_t>(m_size.w)) && (std::abs(dy) < static_cast<int32_t>(m_size.h));
+}
+
+// new texel (x, y) = old texel (x + dx, y + dy)
+void TexelBaker::Shift(int32_t dx, int32_t dy) {
+    const auto w = static_cast<int32_t>(m_size.w);
+    const auto h = static_cast<int32_t>(m_size.h);
+    const auto rowLength = static_cast<size_t>(w - std::abs(dx));
+    const int32_t dstX = std::max(-dx, 0);
+    const int32_t srcX = std::max(dx, 0);
+
+    auto moveRow = [this, w, rowLength, dstX, srcX](int32_t dstY, int32_t srcY) {
+        auto* dst = &m_texels[static_cast<size_t>(dstY * w + dstX)];
+        const auto* src = &m_texels[static_cast<size_t>(srcY * w + srcX)];
+        std::copy_n(src, rowLength, dst);
+    };
+
+    // the order of rows and texels prevents overwriting of the source texels
+    if (dy > 0) {
+        for (int32_t y=0; y!=h - dy; ++y) {
+            moveRow(y, y + dy);
+        }
+    } else if (dy < 0) {
+        for (int32_t y=h - 1; y!=-dy - 1; --y) {
+            moveRow(y, y + dy);
+        }
+    } else if (dx > 0) {
+        for (int32_t y=0; y!=h; ++y) {
+            moveRow(y, y);
+        }
+    } else if (dx < 0) {
+        for (int32_t y=0; y!=h; ++y) {
+            auto* row = &m_texels[static_cast<size_t>(y * w)];
+            std::copy_backward(row, row + rowLength, row + w);
+        }
+    }
+}
+
+// offset of the generator rect in the samples of the lattice LOD
+bool TexelBaker::TryGetLatticeOffset(uint32_t& lod, int32_t& x, int32_t& y) const {
+    const double texelWidth = static_cast<double>(m_generatorRect.w) / static_cast<double>(m_size.w);
+    const double texelHeight = static_cast<double>(m_generatorRect.h) / static_cast<double>(m_size.h);
+    if ((std::abs(texelWidth - texelHeight) > texelWidth * 1e-6) || !(m_lattice.step > 0)) {
+        return false;
+    }
+
+    const double level = std::log2(texelWidth / m_lattice.step);
+    const double roundedLevel = std::round(level);
+    if ((std::abs(level - roundedLevel) > 1e-6) || (roundedLevel < 0) || (roundedLevel > 30.)) {
+        return false;
+    }
+    lod = static_cast<uint32_t>(roundedLevel);
+
+    const double step = std::ldexp(m_lattice.step, static_cast<int>(lod));
+    const double offsetX = (static_cast<double>(m_generatorRect.x) - m_lattice.originX) / step;
+    const double offsetY = (static_cast<double>(m_generatorRect.y) - m_lattice.originY) / step;
+    const double roundedX = std::round(offsetX);
+    const double roundedY = std::round(offsetY);
+    constexpr const double maxOffset = static_cast<double>(1 << 30);
+    if ((std::abs(offsetX - roundedX) > 1e-3) || (std::abs(offsetY - roundedY) > 1e-3) ||
+        (std::abs(roundedX) > maxOffset) || (std::abs(roundedY) > maxOffset)) {
+        return false;
+    }
+    x = static_cast<int32_t>(roundedX);
+    y = static_cast<int32_t>(roundedY);
+
+    return true;
+}
+
+void TexelBaker::Sample(const math::Generator2D& input, const math::Rect& rect) {
+    m_sampledCount += static_cast<size_t>(rect.w) * static_cast<size_t>(rect.h);
+
+    uint32_t lod = 0;
+    int32_t offsetX = 0;
+    int32_t offsetY = 0;
+    if ((m_cache != nullptr) && TryGetLatticeOffset(lod, offsetX, offsetY)) {
+        m_cacheSamples.resize(static_cast<size_t>(rect.w) * static_cast<size_t>(rect.h));
+        m_cache->Sample(input, m_lattice, lod, offsetX + static_cast<int32_t>(rect.x), offsetY + static_cast<int32_t>(rect.y),
+            math::Size(rect.w, rect.h), m_cacheSamples.data());
+
+        const float* src = m_cacheSamples.data();
+        for (uint32_t y=rect.Top(); y!=rect.Bottom(); ++y) {
+            auto* pDest = &m_texels[y * m_size.w + rect.Left()];
+            for (uint32_t x=0; x!=rect.w; ++x) {
+                *pDest = ToTexel(static_cast<double>(*src));
+                ++pDest;
+                ++src;
+            }
+        }
+        return;
+    }
+
+    const double uDelta = static_cast<double>(m_generatorRect.Width()) / static_cast<double>(m_size.w);
+    const double vDelta = static_cast<double>(m_generatorRect.Height()) / static_cast<double>(m_size.h);
+
+    for (uint32_t y=rect.Top(); y!=rect.Bottom(); ++y) {
+        auto* pDest = &m_texels[y * m_size.w + rect.Left()];
+        const double v = static_cast<double>(m_generatorRect.y) + static_cast<double>(y) * vDelta;
+        for (uint32_t x=rect.Left(); x!=rect.Right(); ++x) {
+            const double u = static_cast<double>(m_generatorRect.x) + static_cast<double>(x) * uDelta;
+            *pDest = ToTexel(input(u, v));
+            ++pDest;
+        }
+    }
+}
+
+bool TexelBaker::UpdateUploadedTile(const math::Rect& rect) {
+    bool isChanged = false;
+    for (uint32_t y=rect.Top(); y!=rect.Bottom(); ++y) {
+        const size_t offset = static_cast<size_t>(y) * static_cast<size_t>(m_size.w) + rect.Left();
+        const auto src = m_texels.cbegin() + static_cast<ptrdiff_t>(offset);
+        const auto dst = m_uploaded.begin() + static_cast<ptrdiff_t>(offset);
+        if (isChanged || !std::equal(src, src + rect.w, dst)) {
+            std::copy_n(src, rect.w, dst);
+            isChanged = true;
+        }
+    }
+
+    return isChanged;
+}
+
+math::Rect TexelBaker::GetTileRect(uint32_t tileX, uint32_t tileY) const {
+    const uint32_t x = tileX * TileSize;
+    const uint32_t y = tileY * TileSize;
+
+    return math::Rect(x, y, std::min(TileSize, m_size.w - x), std::min(TileSize, m_size.h - y));
+}
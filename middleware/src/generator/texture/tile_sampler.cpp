@@ -0,0 +1,66 @@
+#include "middleware/generator/texture/tile_sampler.h"
+
+#include <algorithm>
+
+#include "core/common/exception.h"
+#include "core/common/parallel_for.h"
+
+
+TileSampler::TileSampler(const TileSamplerDesc& desc)
+    : m_desc(desc) {
+
+    if ((desc.size.w == 0) || (desc.size.h == 0)) {
+        throw EngineError("TileSampler: size must be greater than zero");
+    }
+    if (desc.tileSize == 0) {
+        throw EngineError("TileSampler: tileSize must be greater than zero");
+    }
+    if (!(desc.region.w > 0) || !(desc.region.h > 0)) {
+        throw EngineError("TileSampler: region size must be greater than zero");
+    }
+
+    m_tileCountX = (desc.size.w + desc.tileSize - 1) / desc.tileSize;
+    m_bandCount = (desc.size.h + desc.tileSize - 1) / desc.tileSize;
+    m_workers = std::make_unique<WorkerPool>(ResolveThreadCount(desc.threadCount, m_tileCountX));
+}
+
+TileSampler::~TileSampler() = default;
+
+uint32_t TileSampler::GetThreadCount() const noexcept {
+    return m_workers->GetThreadCount();
+}
+
+void TileSampler::Sample(const math::Generator2D& input, const BandSink& sink, bool bottomUp) {
+    m_sampledCount = 0;
+    m_band.resize(static_cast<size_t>(m_desc.size.w) * static_cast<size_t>(m_desc.tileSize));
+
+    for (uint32_t i=0; i!=m_bandCount; ++i) {
+        const uint32_t bandIndex = bottomUp ? (m_bandCount - i - 1) : i;
+        const uint32_t bandY = bandIndex * m_desc.tileSize;
+        const uint32_t rowsCount = std::min(m_desc.tileSize, m_desc.size.h - bandY);
+
+        m_workers->ParallelFor(m_tileCountX, [this, &input, bandY, rowsCount](size_t tileX) {
+            SampleTile(input, static_cast<uint32_t>(tileX), bandY, rowsCount);
+        });
+        m_sampledCount += static_cast<uint64_t>(m_desc.size.w) * static_cast<uint64_t>(rowsCount);
+
+        sink(m_band.data(), bandY, rowsCount);
+    }
+}
+
+void TileSampler::SampleTile(const math::Generator2D& input, uint32_t tileX, uint32_t bandY, uint32_t rowsCount) {
+    const double uDelta = static_cast<double>(m_desc.region.Width()) / static_cast<double>(m_desc.size.w);
+    const double vDelta = static_cast<double>(m_desc.region.Height()) / static_cast<double>(m_desc.size.h);
+    const uint32_t left = tileX * m_desc.tileSize;
+    const uint32_t right = std::min(left + m_desc.tileSize, m_desc.size.w);
+
+    for (uint32_t row=0; row!=rowsCount; ++row) {
+        float* pDest = &m_band[static_cast<size_t>(row) * static_cast<size_t>(m_desc.size.w) + left];
+        const double v = static_cast<double>(m_desc.region.y) + static_cast<double>(bandY + row) * vDelta;
+        for (uint32_t x=left; x!=right; ++x) {
+            const double u = static_cast<double>(m_desc.region.x) + static_cast<double>(x) * uDelta;
+            *pDest = static_cast<float>(input(u, v));
+            ++pDest;
+        }
+    }
+}
@@ -110,20 +110,73 @@ Draw::~Draw() {
 
 void Draw::OnStartDrawGraph() {
     m_alpha = static_cast<uint8_t>(ImGui::GetStyle().Alpha * 255.0f);
+    m_hoveredNodeId = static_cast<uintptr_t>(ne::GetHoveredNode().Get());
+    m_maxTimeNs = m_frameMaxTimeNs;
+    m_frameMaxTimeNs = 0;
+    m_profileTooltip.clear();
+
+    if ((m_viewport.w > 0.f) && (m_viewport.h > 0.f)) {
+        const auto canvasLeftTop = gui::ToPointF(ne::ScreenToCanvas(gui::ToImGui(m_viewport.LeftTop())));
+        const auto canvasRightBottom = gui::ToPointF(ne::ScreenToCanvas(gui::ToImGui(m_viewport.RightBottom())));
+        m_visibleRect = math::RectF(canvasLeftTop, canvasRightBottom);
+        m_isCollapsedZoom = IsCollapsedZoom(m_viewport, m_visibleRect, m_collapseZoom);
+    } else {
+        m_visibleRect = math::RectF();
+        m_isCollapsedZoom = false;
+    }
+
     for (auto& node: m_nodes) {
         node.OnStartDrawGraph();
     }
 }
 
 void Draw::OnFinishDrawGraph() {
+    if (!m_profileTooltip.empty()) {
+        ne::Suspend();
+        ImGui::BeginTooltip();
+        ImGui::TextUnformatted(m_profileTooltip.c_str());
+        ImGui::EndTooltip();
+        ne::Resume();
+    }
 }
 
-void Draw::OnStartDrawNode(uintptr_t id, std::string_view displayName) {
-    auto nodeIndex = id - 1;
-    if (nodeIndex >= m_nodes.size()) {
-        m_nodes.resize(nodeIndex + 1);
+bool Draw::IsCollapsedZoom(const math::RectF& viewport, const math::RectF& visibleRect, float collapseZoom) noexcept {
+    return (visibleRect.w > 0.f) && ((viewport.w / visibleRect.w) < collapseZoom);
+}
+
+IDraw::NodeLod Draw::CalcNodeLod(const math::RectF& nodeRect, const math::RectF& visibleRect, bool isCollapsedZoom) noexcept {
+    // the node is drawn in full to get its bounds
+    if ((nodeRect.w <= 0.f) || (nodeRect.h <= 0.f) || (visibleRect.w <= 0.f) || (visibleRect.h <= 0.f)) {
+        return NodeLod::Full;
     }
-    m_node = &m_nodes[nodeIndex];
+
+    if (!visibleRect.Intersects(nodeRect)) {
+        return NodeLod::Hidden;
+    }
+
+    return isCollapsedZoom ? NodeLod::Collapsed : NodeLod::Full;
+}
+
+IDraw::NodeLod Draw::GetNodeLod(uintptr_t id) {
+    const auto nodeId = ne::NodeId(id);
+    const auto nodeRect = math::RectF(gui::ToPointF(ne::GetNodePosition(nodeId)), gui::ToSizeF(ne::GetNodeSize(nodeId)));
+    const NodeLod lod = CalcNodeLod(nodeRect, m_visibleRect, m_isCollapsedZoom);
+    if (lod == NodeLod::Hidden) {
+        GetDrawNode(id).OnCulled();
+    }
+
+    return lod;
+}
+
+void Draw::OnDrawCollapsedNode(uintptr_t id, std::string_view displayName, const std::vector<IDraw::Pin>& inputPins,
+    const std::vector<IDraw::Pin>& outputPins, bool isValid) {
+
+    m_node = &GetDrawNode(id);
+    m_node->OnDrawCollapsedNode(id, displayName, inputPins, outputPins, isValid, m_alpha);
+}
+
+void Draw::OnStartDrawNode(uintptr_t id, std::string_view displayName) {
+    m_node = &GetDrawNode(id);
     m_node->OnStartDrawNode(id, displayName, m_alpha, (m_previewNodeId == id));
 }
 
@@ -147,6 +200,26 @@ void Draw::OnDrawLink(uintptr_t linkId, uintptr_t srcPinId, uintptr_t dstPinId)
     ne::Link(ne::LinkId(linkId), ne::PinId(srcPinId), ne::PinId(dstPinId));
 }
 
+void Draw::OnDrawNodeProfile(const NodeProfile& profile) {
+    if (!m_showProfile) {
+        return;
+    }
+
+    const uint64_t avgTimeNs = profile.AvgTimeNs();
+    m_frameMaxTimeNs = std::max(m_frameMaxTimeNs, avgTimeNs);
+    const float heat = (m_maxTimeNs == 0) ? 0.f :
+        std::min(static_cast<float>(avgTimeNs) / static_cast<float>(m_maxTimeNs), 1.f);
+    m_node->OnDrawProfile(heat);
+
+    if ((m_hoveredNodeId != 0) && (m_node->GetNodeId() == m_hoveredNodeId)) {
+        m_profileTooltip = m_node->GetProfileTooltip(profile);
+        if ((m_preview != nullptr) && (m_previewNodeId == m_hoveredNodeId) && (m_preview->BakesCount() != 0)) {
+            m_profileTooltip += fmt::format("\nfull preview bakes: {}, last time: {:.3f} ms",
+                m_preview->BakesCount(), static_cast<double>(m_preview->LastBakeTimeNs()) / 1000000.);
+        }
+    }
+}
+
 void Draw::OnDrawFullPreview(uint16_t nodeId, TypeId valueTypeId, const cpgf::GVariant& value, uint8_t valueVersion) {
     if (m_preview == nullptr) {
         m_preview = new DrawPreview(true);
@@ -203,4 +276,13 @@ void Draw::OnFinishDrawNodeProperty() {
     ImGui::Columns(1);
 }
 
+DrawNode& Draw::GetDrawNode(uintptr_t id) {
+    auto nodeIndex = id - 1;
+    if (nodeIndex >= m_nodes.size()) {
+        m_nodes.resize(nodeIndex + 1);
+    }
+
+    return m_nodes[nodeIndex];
+}
+
 }
@@ -4,6 +4,7 @@
 #include <utility>
 #include <algorithm>
 
+#include "fmt/fmt.h"
 #include "imgui/imgui.h"
 #include "imgui/node_editor.h"
 #include "middleware/imgui/image.h"
@@ -27,6 +28,7 @@ DrawNode::DrawNode(DrawNode&& o) noexcept {
     std::swap(m_headerBottom, o.m_headerBottom);
     std::swap(m_inputPinsWidth, o.m_inputPinsWidth);
     std::swap(m_outputPinsWidth, o.m_outputPinsWidth);
+    std::swap(m_nodeRect, o.m_nodeRect);
 }
 
 DrawNode::~DrawNode() {
@@ -121,6 +123,7 @@ void DrawNode::OnFinishDrawNode(bool isValid, std::string_view errorMessage, voi
 
     ne::EndNode();
     auto nodeRect = math::RectF(gui::ToPointF(ImGui::GetItemRectMin()), gui::ToPointF(ImGui::GetItemRectMax()));
+    m_nodeRect = nodeRect;
 
     if (!ImGui::IsItemVisible()) {
         return;
@@ -247,4 +250,81 @@ void DrawNode::OnDrawOutputPins(const std::vector<IDraw::Pin>& pins) {
     m_outputPinsWidth = gui::EndVertical().Width();
 }
 
+void DrawNode::OnDrawCollapsedNode(uintptr_t id, std::string_view displayName, const std::vector<IDraw::Pin>& inputPins,
+    const std::vector<IDraw::Pin>& outputPins, bool isValid, uint8_t alpha) {
+
+    m_nodeId = id;
+    m_drawed = true;
+    m_alpha = alpha;
+
+    ne::BeginNode(ne::NodeId(id));
+    gui::BeginHorizontal();
+
+    gui::BeginVertical();
+    for (const auto& pin: inputPins) {
+        ne::BeginPin(ne::PinId(pin.id), ne::PinKind::Input);
+            gui::Dummy(math::SizeF(m_anchorSideSize));
+        ne::EndPin();
+    }
+    gui::EndVertical();
+
+    gui::LabelStyle labelStyle;
+    labelStyle.margin.left = 4.f;
+    labelStyle.margin.right = 4.f;
+    gui::Label(displayName, labelStyle);
+
+    gui::BeginVertical();
+    for (const auto& pin: outputPins) {
+        ne::BeginPin(ne::PinId(pin.id), ne::PinKind::Output);
+            gui::Dummy(math::SizeF(m_anchorSideSize));
+        ne::EndPin();
+    }
+    gui::EndVertical();
+
+    gui::EndHorizontal();
+    ne::EndNode();
+    m_nodeRect = math::RectF(gui::ToPointF(ImGui::GetItemRectMin()), gui::ToPointF(ImGui::GetItemRectMax()));
+
+    if (!ImGui::IsItemVisible()) {
+        return;
+    }
+
+    const auto color = isValid ? math::Color(0, 125, 0, m_alpha).value : math::Color(125, 0, 0, m_alpha).value;
+    auto drawList = ne::GetNodeBackgroundDrawList(ne::NodeId(m_nodeId));
+    drawList->AddRectFilled(gui::ToImGui(m_nodeRect.LeftTop()), gui::ToImGui(m_nodeRect.RightBottom()),
+        color, ne::GetStyle().NodeRounding);
+}
+
+void DrawNode::OnDrawProfile(float heat) {
+    if (!m_drawed) {
+        return;
+    }
+
+    // from green for fast nodes to red for the slowest one
+    const auto red = static_cast<uint8_t>(255.f * heat);
+    const auto green = static_cast<uint8_t>(255.f * (1.f - heat));
+    const auto alpha = static_cast<uint8_t>(static_cast<int>(m_alpha) / 3);
+    const auto heatColor = math::Color(red, green, 0, alpha).value;
+
+    auto drawList = ne::GetNodeBackgroundDrawList(ne::NodeId(m_nodeId));
+    drawList->AddRectFilled(gui::ToImGui(m_nodeRect.LeftTop()), gui::ToImGui(m_nodeRect.RightBottom()),
+        heatColor, ne::GetStyle().NodeRounding);
+}
+
+std::string DrawNode::GetProfileTooltip(const NodeProfile& profile) const {
+    constexpr const double nsInMs = 1000000.;
+    std::string result = fmt::format("evaluations: {}\nlast time: {:.3f} ms\naverage time: {:.3f} ms\noutput copy: {} bytes",
+        profile.evaluations,
+        static_cast<double>(profile.lastTimeNs) / nsInMs,
+        static_cast<double>(profile.AvgTimeNs()) / nsInMs,
+        profile.outputBytes);
+
+    if ((m_preview != nullptr) && (m_preview->BakesCount() != 0)) {
+        result += fmt::format("\npreview bakes: {}, last time: {:.3f} ms",
+            m_preview->BakesCount(), static_cast<double>(m_preview->LastBakeTimeNs()) / nsInMs);
+    }
+
+    return result;
+}
+
 }
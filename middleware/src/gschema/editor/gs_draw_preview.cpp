@@ -1,14 +1,33 @@
 #include "middleware/gschema/editor/gs_draw_preview.h"
 
+#include <memory>
+#include <chrono>
+
 #include "dg/device.h"
 #include "eigen/core.h"
 #include "cpgf/variant.h"
 #include "core/common/exception.h"
 #include "middleware/imgui/image.h"
+#include "middleware/gschema/graph/gs_profile.h"
 #include "middleware/generator/texture/section_plane.h"
+#include "middleware/generator/texture/generator_tile_cache.h"
 #include "middleware/generator/texture/generator2d_to_texture.h"
 
 
+namespace {
+
+constexpr const uint32_t FullPreviewSize = 512;
+constexpr const uint32_t NodePreviewSize = 128;
+const math::RectF PreviewRect(-5.f, -5.f, 10.f, 10.f);
+
+// the node previews (LOD 2) and the full preview (LOD 0) of the same generator share the samples
+const std::shared_ptr<GeneratorTileCache>& GetPreviewCache() {
+    static const auto cache = std::make_shared<GeneratorTileCache>(GeneratorTileCacheDesc());
+    return cache;
+}
+
+}
+
 namespace gs {
 
 DrawPreview::DrawPreview(bool full)
@@ -17,9 +36,6 @@ DrawPreview::DrawPreview(bool full)
 }
 
 DrawPreview::~DrawPreview() {
-    if (m_texture.RawPtr() != nullptr) {
-        m_texture.Release();
-    }
     if (m_generator != nullptr) {
         delete m_generator;
     }
@@ -28,9 +44,7 @@ DrawPreview::~DrawPreview() {
 void DrawPreview::Reset() {
     m_frameCounter = 0;
     m_valueVersion = 0;
-    if (m_texture.RawPtr() != nullptr) {
-        m_texture.Release();
-    }
+    m_isFilled = false;
 }
 
 
@@ -64,7 +78,7 @@ void DrawPreview::Draw(TypeId typeId, const cpgf::GVariant& value, uint8_t value
             const auto tmp = cpgf::fromVariant<math::Generator2D>(value);
             FillTexture(tmp);
         }
-        gui::Image(drawSize, m_texture, style);
+        DrawTexture(drawSize, style);
     } else if (typeId == TypeId::Generator3d) {
         if (IsNeedUpdateTexture(valueVersion)) {
             const auto tmp = cpgf::fromVariant<math::Generator3D>(value);
@@ -72,14 +86,14 @@ void DrawPreview::Draw(TypeId typeId, const cpgf::GVariant& value, uint8_t value
             sPlane.SetInput(tmp);
             FillTexture(sPlane.Result());
         }
-        gui::Image(drawSize, m_texture, style);
+        DrawTexture(drawSize, style);
     } else {
         throw EngineError("gs::DrawPreview::Draw: unknown value type (id = {})", typeId);
     }
 }
 
 bool DrawPreview::IsNeedUpdateTexture(uint8_t valueVersion) {
-    if (m_texture.RawPtr() == nullptr) {
+    if (!m_isFilled) {
         m_frameCounter = 0;
         m_valueVersion = valueVersion;
         return true;
@@ -100,14 +114,33 @@ bool DrawPreview::IsNeedUpdateTexture(uint8_t valueVersion) {
 }
 
 void DrawPreview::FillTexture(const math::Generator2D& v) {
+#if GS_PROFILE_ENABLE
+    const auto start = std::chrono::steady_clock::now();
+#endif
+
     if (m_generator == nullptr) {
         m_generator = new Generator2dToTexture();
-        m_generator->SetTextureSize(math::Size(m_fullPreview ? 512 : 128));
-        m_generator->SetGeneratorRect(math::RectF(-5.f, -5.f, 10.f, 10.f));
+        m_generator->SetTextureSize(math::Size(m_fullPreview ? FullPreviewSize : NodePreviewSize));
+        m_generator->SetGeneratorRect(PreviewRect);
+        const double step = static_cast<double>(PreviewRect.w) / static_cast<double>(FullPreviewSize);
+        m_generator->SetCache(GetPreviewCache(), TileLattice{static_cast<double>(PreviewRect.x), static_cast<double>(PreviewRect.y), step});
     }
 
     m_generator->SetInput(v);
-    m_texture = m_generator->Result()->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE);
+    m_generator->Result();
+    m_isFilled = true;
+
+#if GS_PROFILE_ENABLE
+    const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    m_lastBakeTimeNs = static_cast<uint64_t>(time.count());
+    ++m_bakesCount;
+#endif
+}
+
+// the view isn't kept between the frames, so the texture of the hidden preview can be evicted by the memory budget
+void DrawPreview::DrawTexture(math::SizeF drawSize, gui::ImageStyle& style) {
+    TextureViewPtr texture(m_generator->Current()->GetDefaultView(dg::TEXTURE_VIEW_SHADER_RESOURCE));
+    gui::Image(drawSize, texture, style);
 }
 
 }
@@ -50,6 +50,8 @@ void Editor::Create() {
 
 void Editor::DrawGraph() {
     ne::SetCurrentEditor(m_context);
+    // ne::Begin takes all available space
+    m_draw->SetViewport(math::RectF(gui::ToPointF(ImGui::GetCursorScreenPos()), gui::ToSizeF(ImGui::GetContentRegionAvail())));
     ne::Begin(m_name.c_str());
 
     ImGuiStyle& imStyle = ImGui::GetStyle();
@@ -147,6 +149,13 @@ void Editor::DrawGraph() {
 
     if (ImGui::BeginPopup("Background menu")) {
         DrawNewNodeMenu(m_menuPopupX, m_menuPopupY);
+#if GS_PROFILE_ENABLE
+        ImGui::Separator();
+        bool showProfile = m_draw->IsShowProfile();
+        if (ImGui::MenuItem("Show profiling", nullptr, &showProfile)) {
+            m_draw->SetShowProfile(showProfile);
+        }
+#endif
         ImGui::EndPopup();
     }
     ImGui::PopStyleVar();
@@ -95,6 +95,25 @@ void Class::Create(const MetaClass* metaClass,
             break;
         }
     }
+
+    // default values are taken from a temporary instance here, not on the first CreateInstance,
+    // after Create the class is immutable and can be shared between threads
+    const auto defaultsCount = static_cast<uint8_t>(m_countEmbeddedPins + m_countInputPins);
+    m_defaults = new cpgf::GVariant[defaultsCount];
+    void* instance = m_metaClass->CreateInstance();
+    try {
+        for (uint8_t i=0; i!=defaultsCount; ++i) {
+            // inside the value is completely copied
+            m_defaults[i] = m_props[i]->Get(instance);
+            if (HasUniversalBit(m_defaultTypeIds[i])) {
+                m_defaultTypeIds[i] = GetUniversalTypeId(cpgf::fromVariant<UniversalType>(m_defaults[i]));
+            }
+        }
+    } catch(...) {
+        m_metaClass->DestroyInstance(instance);
+        throw;
+    }
+    m_metaClass->DestroyInstance(instance);
 }
 
 std::string_view Class::GetName() const {
@@ -143,25 +162,20 @@ ConvertFunc Class::GetFuncConvertToDefaultType(uint8_t pinIndex, TypeId typeId)
     return nullptr;
 }
 
-void* Class::CreateInstance() {
-    void* instance = m_metaClass->CreateInstance();
+size_t Class::GetInstanceSize() const noexcept {
+    return m_metaClass->GetInstanceSize();
+}
 
-    if (m_defaults == nullptr) {
-        m_defaults = new cpgf::GVariant[m_countEmbeddedPins + m_countInputPins];
-        for (uint8_t i=0; i!=(m_countEmbeddedPins + m_countInputPins); ++i) {
-            // inside the value is completely copied
-            m_defaults[i] = m_props[i]->Get(instance);
-            if (HasUniversalBit(m_defaultTypeIds[i])) {
-                m_defaultTypeIds[i] = GetUniversalTypeId(cpgf::fromVariant<UniversalType>(m_defaults[i]));
-            }
-        }
-    }
+size_t Class::GetInstanceAlignment() const noexcept {
+    return m_metaClass->GetInstanceAlignment();
+}
 
-    return instance;
+void* Class::CreateInstance(void* memory) const {
+    return m_metaClass->ConstructInstance(memory);
 }
 
-void Class::DestroyInstance(void* instance) {
-    m_metaClass->DestroyInstance(instance);
+void Class::DestroyInstance(void* instance) const {
+    m_metaClass->DestructInstance(instance);
 }
 
 cpgf::GVariant Class::GetValue(uint8_t pinIndex, const void* instance) const {
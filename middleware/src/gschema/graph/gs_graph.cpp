@@ -1,6 +1,6 @@
 #include "middleware/gschema/graph/gs_graph.h"
 
-#include <utility>
+#include <chrono>
 #include <algorithm>
 #include <typeindex>
 
@@ -16,39 +16,89 @@ namespace gs {
 
 class Class;
 
-static_assert(sizeof(Graph) == 40, "sizeof(Graph) == 40 bytes");
+#if GS_PROFILE_ENABLE
+static_assert(sizeof(Graph) == 304, "sizeof(Graph) == 304 bytes");
+#else
+static_assert(sizeof(Graph) == 280, "sizeof(Graph) == 280 bytes");
+#endif
 
 Graph::Graph(const std::shared_ptr<ClassStorage>& classStorage, uint16_t initialNodeCount)
     : m_free(initialNodeCount)
     , m_capacity(initialNodeCount)
     , m_firstFreeIndex(0)
     , m_firstCalcIndex(INVALID_NODE_INDEX)
-    , m_nodes(new Node[m_capacity])
-    , m_indeciesForOrder(new uint16_t[m_capacity + m_capacity])
+    , m_arena(classStorage.get(), initialNodeCount)
     , m_classStorage(classStorage) {
 
+    m_nodes.Reserve(m_capacity);
+    ResizeNodeBuffers();
+}
+
+Graph::~Graph() {
+    // pins and instances must be returned before the arena is destroyed
     for (uint16_t i=0; i!=m_capacity; ++i) {
-        m_nodes[i].Init(i + 1);
+        m_nodes[i].Reset(INVALID_NODE_INDEX, m_arena);
     }
+    m_classStorage.reset();
 }
 
-Graph::~Graph() {
-    if (m_nodes != nullptr) {
-        for (uint16_t i=0; i!=m_capacity; ++i) {
-            m_nodes[i].Reset(INVALID_NODE_INDEX);
+ArenaCounters Graph::GetAllocationCounters() const noexcept {
+    ArenaCounters counters = m_arena.GetCounters();
+    counters.nodeChunks = m_nodes.ChunksCount();
+
+    return counters;
+}
+
+ResultCacheCounters Graph::GetResultCacheCounters() const noexcept {
+    if (m_resultCache) {
+        return m_resultCache->GetCounters();
+    }
+
+    return ResultCacheCounters();
+}
+
+void Graph::EnableResultCache(size_t maxEntries, size_t maxMemory) {
+    m_resultCache = std::make_unique<ResultCache>(maxEntries, maxMemory);
+    // the outputs refer to the entries of the previous cache, so all nodes are recalculated once
+    for (uint16_t i=0; i!=m_capacity; ++i) {
+        if (!m_nodes[i].IsRemoved()) {
+            m_nodes[i].InvalidateOutputs();
         }
-        delete[] m_nodes;
     }
+}
+
+void Graph::DisableResultCache() {
+    m_resultCache.reset();
+}
 
-    if (m_indeciesForOrder != nullptr) {
-        delete[] m_indeciesForOrder;
+NodeProfile Graph::GetNodeProfile(uint16_t nodeId) const {
+    try {
+        CheckIsValidNodeId(nodeId);
+    } catch(const EngineError& e) {
+        throw EngineError("gs::Graph::GetNodeProfile: wrong nodeId, {}", e.what());
     }
-    m_classStorage.reset();
+
+#if GS_PROFILE_ENABLE
+    return m_profiles[nodeId - 1];
+#else
+    return NodeProfile();
+#endif
+}
+
+void Graph::ResetProfiles() noexcept {
+#if GS_PROFILE_ENABLE
+    std::fill(m_profiles.begin(), m_profiles.end(), NodeProfile());
+#endif
 }
 
 void Graph::UpdateState() {
-    for(uint16_t it = m_firstCalcIndex; it != INVALID_NODE_INDEX; it = m_nodes[it].UpdateState(m_nodes)) {
+#if GS_PROFILE_ENABLE
+    for(uint16_t it = m_firstCalcIndex; it != INVALID_NODE_INDEX; it = UpdateNodeStateWithProfile(it)) {
+    }
+#else
+    for(uint16_t it = m_firstCalcIndex; it != INVALID_NODE_INDEX; it = m_nodes[it].UpdateState(m_nodes, m_resultCache.get())) {
     }
+#endif
     for (uint16_t i=0; i!=m_capacity; ++i) {
         m_nodes[i].ResetChangeState();
     }
@@ -57,16 +107,47 @@ void Graph::UpdateState() {
 void Graph::DrawGraph(IDraw* drawer) {
     drawer->OnStartDrawGraph();
 
+    constexpr const auto hidden = static_cast<uint8_t>(IDraw::NodeLod::Hidden);
+    constexpr const auto collapsed = static_cast<uint8_t>(IDraw::NodeLod::Collapsed);
+    for (uint16_t i=0; i!=m_capacity; ++i) {
+        m_drawLods[i] = m_nodes[i].IsRemoved() ? hidden : static_cast<uint8_t>(drawer->GetNodeLod(i + 1));
+    }
+
+    // a link with one visible end needs pins of the other end, such nodes are drawn collapsed
+    constexpr const uint8_t linked = 3;
+    const auto isVisible = [this](uint16_t nodeIndex) -> bool {
+        return (m_drawLods[nodeIndex] == collapsed) || (m_drawLods[nodeIndex] == static_cast<uint8_t>(IDraw::NodeLod::Full));
+    };
     for (uint16_t i=0; i!=m_capacity; ++i) {
         if (!m_nodes[i].IsRemoved()) {
+            for(const Pin* pin=m_nodes[i].InputPinsBegin(); pin!=m_nodes[i].InputPinsEnd(); ++pin) {
+                if (pin->attachedPinID != 0) {
+                    uint16_t srcNodeIndex = NodeIndexFromPinId(pin->attachedPinID);
+                    if (!isVisible(i) && isVisible(srcNodeIndex)) {
+                        m_drawLods[i] = linked;
+                    } else if (isVisible(i) && !isVisible(srcNodeIndex)) {
+                        m_drawLods[srcNodeIndex] = linked;
+                    }
+                }
+            }
+        }
+    }
+
+    for (uint16_t i=0; i!=m_capacity; ++i) {
+        if ((m_drawLods[i] == collapsed) || (m_drawLods[i] == linked)) {
+            m_nodes[i].DrawCollapsedGraph(drawer);
+        } else if (m_drawLods[i] != hidden) {
             m_nodes[i].DrawGraph(drawer);
+#if GS_PROFILE_ENABLE
+            drawer->OnDrawNodeProfile(m_profiles[i]);
+#endif
         }
     }
 
     for (uint16_t i=0; i!=m_capacity; ++i) {
-        if (!m_nodes[i].IsRemoved()) {
+        if (m_drawLods[i] != hidden) {
             for(const Pin* pin=m_nodes[i].InputPinsBegin(); pin!=m_nodes[i].InputPinsEnd(); ++pin) {
-                if (pin->attachedPinID != 0) {
+                if ((pin->attachedPinID != 0) && (m_drawLods[NodeIndexFromPinId(pin->attachedPinID)] != hidden)) {
                     uint32_t dstPinId = pin->id;
                     uint32_t srcPinId = pin->attachedPinID;
                     drawer->OnDrawLink(
@@ -127,6 +208,19 @@ const cpgf::GVariant& Graph::GetOutputValue(uint16_t nodeId, uint8_t outputPinOf
     return GetOutputValue(m_nodes[nodeId - 1].GetOutputPinId(outputPinOffset));
 }
 
+TypeId Graph::GetOutputBaseValue(uint16_t nodeId, uint8_t outputPinOffset, cpgf::GVariant& value) const {
+    uint32_t pinId;
+    try {
+        CheckIsValidNodeId(nodeId);
+        pinId = m_nodes[nodeId - 1].GetOutputPinId(outputPinOffset);
+        CheckIsValidOutputPinId(pinId);
+    } catch(const EngineError& e) {
+        throw EngineError("gs::Graph::GetOutputBaseValue: {}", e.what());
+    }
+
+    return m_nodes[nodeId - 1].GetOutputBaseValue(PinIndexFromPinId(pinId), value);
+}
+
 uint16_t Graph::AddNode(uint16_t classIndex) {
     Class* cls = m_classStorage->GetClass(classIndex);
     if (m_free == 0) {
@@ -134,34 +228,26 @@ uint16_t Graph::AddNode(uint16_t classIndex) {
             throw EngineError("gs::Graph::AddNode: failed to add node, node limit exceeded");
         }
 
-        auto* prevNodes = m_nodes;
+        // the nodes are not moved, a new chunk is added only when the last one is full
         auto prevCapacity = m_capacity;
-
-        if (prevCapacity < (MAX_NODES_COUNT - prevCapacity)) {
-            m_capacity = prevCapacity * 2;
-        } else {
-            m_capacity = MAX_NODES_COUNT;
+        if (prevCapacity == m_nodes.Capacity()) {
+            m_nodes.Reserve(static_cast<uint32_t>(prevCapacity) + 1);
         }
+        m_capacity = static_cast<uint16_t>(std::min(m_nodes.Capacity(), static_cast<uint32_t>(MAX_NODES_COUNT)));
 
         m_free = m_capacity - prevCapacity;
         m_firstFreeIndex = prevCapacity;
-
-        m_nodes = new Node[m_capacity];
-        delete[] m_indeciesForOrder;
-        m_indeciesForOrder = new uint16_t[m_capacity + m_capacity];
-        for (uint16_t i=0; i!=prevCapacity; ++i) {
-            m_nodes[i] = std::move(prevNodes[i]);
-        }
-        delete[] prevNodes;
-        for (uint16_t i=prevCapacity; i!=m_capacity; ++i) {
-            m_nodes[i].Init(i + 1);
-        }
+        ResizeNodeBuffers();
     }
 
     uint16_t nodeIndex = m_firstFreeIndex;
-    m_firstFreeIndex = m_nodes[m_firstFreeIndex].GetNextIndex();
-    m_nodes[nodeIndex].Create(cls);
+    // the node stays in the free list if Create throws
+    m_nodes[nodeIndex].Create(cls, m_arena);
+    m_firstFreeIndex = m_nodes[nodeIndex].GetNextIndex();
     --m_free;
+#if GS_PROFILE_ENABLE
+    m_profiles[nodeIndex] = NodeProfile();
+#endif
 
     SortNodesByDependency();
 
@@ -172,13 +258,72 @@ uint16_t Graph::AddNode(std::string_view name) {
     return AddNode(m_classStorage->GetClassIndex(name));
 }
 
-bool Graph::TestRemoveNode(uint16_t nodeId) const noexcept {
-    try {
-        CheckRemoveNode(nodeId);
-        return true;
-    } catch(const std::exception&) {
-        return false;
+CheckResult Graph::ValidateRemoveNode(uint16_t nodeId) const noexcept {
+    return ValidateNodeId(nodeId);
+}
+
+CheckResult Graph::ValidateAddLink(uint32_t srcPinId, uint32_t dstPinId) const noexcept {
+    if (auto result = ValidateOutputPinId(srcPinId); result != CheckResult::Ok) {
+        return result;
+    }
+    if (auto result = ValidateInputPinId(dstPinId); result != CheckResult::Ok) {
+        return result;
+    }
+
+    const uint16_t srcNodeIndex = NodeIndexFromPinId(srcPinId);
+    const uint16_t dstNodeIndex = NodeIndexFromPinId(dstPinId);
+    if (srcNodeIndex == dstNodeIndex) {
+        return CheckResult::SameNode;
+    }
+
+    const uint8_t srcPinIndex = PinIndexFromPinId(srcPinId);
+    const uint8_t dstPinIndex = PinIndexFromPinId(dstPinId);
+    if (m_nodes[dstNodeIndex].GetAttachedPinId(dstPinIndex) == srcPinId) {
+        return CheckResult::LinkExists;
+    }
+
+    // an already existing link to dstPinId is replaced, it does not affect the paths from dstNode
+    if (ExistsPath(dstNodeIndex, srcNodeIndex)) {
+        return CheckResult::Cycle;
+    }
+
+    // pinIndex is checked above, CheckConvert does not throw for input pins
+    if (!m_nodes[dstNodeIndex].CheckConvert(dstPinIndex, m_nodes[srcNodeIndex].GetPinType(srcPinIndex))) {
+        return CheckResult::IncompatibleTypes;
+    }
+
+    return CheckResult::Ok;
+}
+
+CheckResult Graph::ValidateRemoveLink(uint64_t linkId) const noexcept {
+    if (linkId == 0) {
+        return CheckResult::ZeroId;
+    }
+
+    const uint32_t srcPinId = SrcPinIdFromLinkId(linkId);
+    if (auto result = ValidateOutputPinId(srcPinId); result != CheckResult::Ok) {
+        return result;
+    }
+
+    const uint32_t dstPinId = DstPinIdFromLinkId(linkId);
+    if (auto result = ValidateInputPinId(dstPinId); result != CheckResult::Ok) {
+        return result;
+    }
+
+    const uint16_t dstNodeIndex = NodeIndexFromPinId(dstPinId);
+    if (NodeIndexFromPinId(srcPinId) == dstNodeIndex) {
+        return CheckResult::SameNode;
+    }
+
+    if (m_nodes[dstNodeIndex].GetAttachedPinId(PinIndexFromPinId(dstPinId)) != srcPinId) {
+        return CheckResult::LinkNotExists;
     }
+
+    return CheckResult::Ok;
+}
+
+bool Graph::TestRemoveNode(uint16_t nodeId) const noexcept {
+    return (ValidateRemoveNode(nodeId) == CheckResult::Ok);
 }
 
 void Graph::RemoveNode(uint16_t nodeId) {
@@ -206,9 +351,9 @@ void Graph::RemoveNode(uint16_t nodeId) {
 
     if (m_free == 0) {
         m_firstFreeIndex = index;
-        node.Reset(INVALID_NODE_INDEX);
+        node.Reset(INVALID_NODE_INDEX, m_arena);
     } else if (m_firstFreeIndex > index) {
-        node.Reset(m_firstFreeIndex);
+        node.Reset(m_firstFreeIndex, m_arena);
         m_firstFreeIndex = index;
     } else {
         uint16_t lastIt = 0;
@@ -220,8 +365,8 @@ void Graph::RemoveNode(uint16_t nodeId) {
             }
             lastIt = it;
         }
-        m_nodes[lastIt].Reset(index);
-        node.Reset(it);
+        m_nodes[lastIt].Reset(index, m_arena);
+        node.Reset(it, m_arena);
     }
 
     ++m_free;
@@ -230,19 +375,11 @@ void Graph::RemoveNode(uint16_t nodeId) {
 }
 
 bool Graph::TestAddLink(uint32_t srcPinId, uint32_t dstPinId) const noexcept {
-    try {
-        CheckAddLink(srcPinId, dstPinId);
-        return true;
-    } catch(const std::exception&) {
-        return false;
-    }
+    return (ValidateAddLink(srcPinId, dstPinId) == CheckResult::Ok);
 }
 
 bool Graph::TestAddLink(uint16_t srcNodeId, uint8_t outputPinOffset, uint16_t dstNodeId, uint8_t inputPinOffset) const noexcept {
-    try {
-        CheckIsValidNodeId(srcNodeId);
-        CheckIsValidNodeId(dstNodeId);
-    } catch(const EngineError& e) {
+    if ((ValidateNodeId(srcNodeId) != CheckResult::Ok) || (ValidateNodeId(dstNodeId) != CheckResult::Ok)) {
         return false;
     }
 
@@ -295,12 +432,7 @@ uint64_t Graph::AddLink(uint16_t srcNodeId, uint8_t outputPinOffset, uint16_t ds
 }
 
 bool Graph::TestRemoveLink(uint64_t linkId) const noexcept {
-    try {
-        CheckRemoveLink(linkId);
-        return true;
-    } catch(const std::exception&) {
-        return false;
-    }
+    return (ValidateRemoveLink(linkId) == CheckResult::Ok);
 }
 
 void Graph::RemoveLink(uint64_t linkId) {
@@ -369,8 +501,48 @@ void Graph::SetInputValueImpl(uint16_t nodeId, uint8_t inputPinOffset, const cpg
     SetInputValueImpl(m_nodes[nodeId - 1].GetInputPinId(inputPinOffset), value, typeId);
 }
 
+void Graph::RemoveAllNodes() {
+    for (uint16_t i=0; i!=m_capacity; ++i) {
+        m_nodes[i].Reset(i + 1, m_arena);
+    }
+    m_free = m_capacity;
+    m_firstFreeIndex = 0;
+    m_firstCalcIndex = INVALID_NODE_INDEX;
+    ResetProfiles();
+}
+
+void Graph::ResizeNodeBuffers() {
+    m_indeciesForOrder.resize(static_cast<size_t>(m_capacity) + static_cast<size_t>(m_capacity));
+    m_stack.reserve(m_capacity);
+    m_drawLods.resize(m_capacity);
+#if GS_PROFILE_ENABLE
+    m_profiles.resize(m_capacity);
+#endif
+}
+
+#if GS_PROFILE_ENABLE
+uint16_t Graph::UpdateNodeStateWithProfile(uint16_t nodeIndex) {
+    Node& node = m_nodes[nodeIndex];
+    const uint8_t version = node.GetOutputValueVersion();
+    const auto start = std::chrono::steady_clock::now();
+    const uint16_t nextIndex = node.UpdateState(m_nodes, m_resultCache.get());
+    if (version != node.GetOutputValueVersion()) {
+        const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        NodeProfile& profile = m_profiles[nodeIndex];
+        ++profile.evaluations;
+        profile.lastTimeNs = static_cast<uint64_t>(time.count());
+        profile.totalTimeNs += profile.lastTimeNs;
+        for (const Pin* pin=node.OutputPinsBegin(); pin!=node.OutputPinsEnd(); ++pin) {
+            profile.outputBytes += GetTypeSize(pin->typeId);
+        }
+    }
+
+    return nextIndex;
+}
+#endif
+
 void Graph::SortNodesByDependency() {
-    std::fill(m_indeciesForOrder, m_indeciesForOrder + m_capacity + m_capacity, INVALID_NODE_INDEX);
+    std::fill(m_indeciesForOrder.begin(), m_indeciesForOrder.end(), INVALID_NODE_INDEX);
     for (uint16_t i=0; i!=m_capacity; ++i) {
         if (!m_nodes[i].IsRemoved()) {
             m_nodes[i].ResetOrder();
@@ -379,9 +551,11 @@ void Graph::SortNodesByDependency() {
 
     m_firstCalcIndex = INVALID_NODE_INDEX;
     uint16_t maxOrder = 0;
+    const uint16_t mark = NextVisitMark();
     for (uint16_t index=0; index!=m_capacity; ++index) {
         if (!m_nodes[index].IsRemoved()) {
-            uint16_t order = m_nodes[index].GetOrderNumber(m_nodes);
+            CalcOrder(index, mark);
+            uint16_t order = m_nodes[index].GetOrder();
             if ((m_firstCalcIndex == INVALID_NODE_INDEX) && (order == 0)) {
                 m_firstCalcIndex = index;
             }
@@ -400,143 +574,183 @@ void Graph::SortNodesByDependency() {
     }
 
     for (uint16_t order=1; order<=maxOrder; ++order) {
-        uint16_t lastIndexForPrevOrder = m_indeciesForOrder[order - 1 + m_capacity];
+        uint16_t lastIndexForPrevOrder = m_indeciesForOrder[static_cast<size_t>(order - 1 + m_capacity)];
         uint16_t firstIndexForCurOrder = m_indeciesForOrder[order];
         m_nodes[lastIndexForPrevOrder].SetNextCalcIndex(firstIndexForCurOrder);
     }
 }
 
-void Graph::CheckIsValidNodeId(uint16_t nodeId) const {
-    if (nodeId == 0) {
-        throw EngineError("for nodeId = {}, min value = 1", nodeId);
-    }
-    if (nodeId > m_capacity) {
-        throw EngineError("for nodeId = {}, max value = {}", nodeId, m_capacity);
-    }
-    if (m_nodes[nodeId - 1].IsRemoved()) {
-        throw EngineError("for nodeId = {}, node is removed", nodeId);
+void Graph::CalcOrder(uint16_t nodeIndex, uint16_t mark) noexcept {
+    if (m_nodes[nodeIndex].IsVisited(mark)) {
+        return;
     }
-}
 
-void Graph::CheckIsValidEmbeddedPinId(uint32_t pinId) const {
-    uint16_t nodeId = NodeIdFromPinId(pinId);
-    CheckIsValidNodeId(nodeId);
-    m_nodes[nodeId - 1].CheckIsValidEmbeddedPinId(pinId);
-}
+    // depth-first by the input links, pinIndex is the next input pin of the node to go through,
+    // every node is pushed once, so the stack does not exceed the reserved capacity
+    m_stack.clear();
+    m_nodes[nodeIndex].SetVisited(mark);
+    m_stack.push_back(StackItem{nodeIndex, m_nodes[nodeIndex].InputPinsBeginIndex()});
+    while (!m_stack.empty()) {
+        StackItem& item = m_stack.back();
+        Node& node = m_nodes[item.nodeIndex];
+
+        bool pushed = false;
+        for (; item.pinIndex != node.InputPinsEndIndex(); ++item.pinIndex) {
+            uint32_t attachedPinId = node.GetAttachedPinId(item.pinIndex);
+            if (attachedPinId == 0) {
+                continue;
+            }
+            uint16_t attachedNodeIndex = NodeIndexFromPinId(attachedPinId);
+            if (!m_nodes[attachedNodeIndex].IsVisited(mark)) {
+                m_nodes[attachedNodeIndex].SetVisited(mark);
+                ++item.pinIndex;
+                m_stack.push_back(StackItem{attachedNodeIndex, m_nodes[attachedNodeIndex].InputPinsBeginIndex()});
+                pushed = true;
+                break;
+            }
+        }
+        if (pushed) {
+            continue;
+        }
 
-void Graph::CheckIsValidInputPinId(uint32_t pinId) const {
-    uint16_t nodeId = NodeIdFromPinId(pinId);
-    CheckIsValidNodeId(nodeId);
-    m_nodes[nodeId - 1].CheckIsValidInputPinId(pinId);
+        // all the attached nodes have an order
+        uint16_t order = 0;
+        for (uint8_t i=node.InputPinsBeginIndex(); i!=node.InputPinsEndIndex(); ++i) {
+            if (node.GetAttachedPinId(i) != 0) {
+                order = std::max(order, static_cast<uint16_t>(m_nodes[NodeIndexFromPinId(node.GetAttachedPinId(i))].GetOrder() + 1));
+            }
+        }
+        node.SetOrder(order);
+        m_stack.pop_back();
+    }
 }
 
-void Graph::CheckIsValidOutputPinId(uint32_t pinId) const {
-    uint16_t nodeId = NodeIdFromPinId(pinId);
-    CheckIsValidNodeId(nodeId);
-    m_nodes[nodeId - 1].CheckIsValidOutputPinId(pinId);
+bool Graph::ExistsPath(uint16_t srcNodeIndex, uint16_t dstNodeIndex) const noexcept {
+    // for each link order(src) < order(dst), so the path from srcNode to dstNode
+    // is impossible if order(srcNode) >= order(dstNode), most of the links are accepted here
+    const uint16_t srcOrder = m_nodes[srcNodeIndex].GetOrder();
+    if (srcOrder >= m_nodes[dstNodeIndex].GetOrder()) {
+        return (srcNodeIndex == dstNodeIndex);
+    }
+
+    // search back from dstNode only among the nodes with order in (order(srcNode), order(dstNode)],
+    // the stack and the visited flags are local, so the const validation doesn't write the graph
+    std::vector<bool> visited(m_capacity, false);
+    std::vector<uint16_t> stack;
+    visited[dstNodeIndex] = true;
+    stack.push_back(dstNodeIndex);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        for (uint8_t i=node.InputPinsBeginIndex(); i!=node.InputPinsEndIndex(); ++i) {
+            uint32_t attachedPinId = node.GetAttachedPinId(i);
+            if (attachedPinId == 0) {
+                continue;
+            }
+            uint16_t attachedNodeIndex = NodeIndexFromPinId(attachedPinId);
+            if (attachedNodeIndex == srcNodeIndex) {
+                return true;
+            }
+            if ((m_nodes[attachedNodeIndex].GetOrder() > srcOrder) && !visited[attachedNodeIndex]) {
+                visited[attachedNodeIndex] = true;
+                stack.push_back(attachedNodeIndex);
+            }
+        }
+    }
+
+    return false;
 }
 
-void Graph::CheckRemoveNode(uint16_t nodeId) const {
-    try {
-        CheckIsValidNodeId(nodeId);
-    } catch(const EngineError& e) {
-        throw EngineError("wrong node, {}", e.what());
+uint16_t Graph::NextVisitMark() noexcept {
+    ++m_lastVisitMark;
+    if (m_lastVisitMark == 0) {
+        // the marks have wrapped around, nodes must not keep the old ones
+        for (uint16_t i=0; i!=m_capacity; ++i) {
+            m_nodes[i].SetVisited(0);
+        }
+        m_lastVisitMark = 1;
     }
+
+    return m_lastVisitMark;
 }
 
-void Graph::CheckAddLink(uint32_t srcPinId, uint32_t dstPinId) const {
-    try {
-        CheckIsValidOutputPinId(srcPinId);
-    } catch(const EngineError& e) {
-        throw EngineError("wrong srcPinId, {}", e.what());
+CheckResult Graph::ValidateNodeId(uint16_t nodeId) const noexcept {
+    if (nodeId == 0) {
+        return CheckResult::ZeroId;
     }
-
-    try {
-        CheckIsValidInputPinId(dstPinId);
-    } catch(const EngineError& e) {
-        throw EngineError("wrong dstPinId, {}", e.what());
+    if (nodeId > m_capacity) {
+        return CheckResult::NodeIdOutOfRange;
     }
-
-    if (srcPinId == dstPinId) {
-        throw EngineError("wrong srcPinId = {} and dstPinId = {}, it cannot be equivalent", srcPinId, dstPinId);
+    if (m_nodes[nodeId - 1].IsRemoved()) {
+        return CheckResult::NodeRemoved;
     }
 
-    const uint16_t srcNodeId = NodeIdFromPinId(srcPinId);
-    const uint16_t dstNodeId = NodeIdFromPinId(dstPinId);
-    if (srcNodeId == dstNodeId) {
-        throw EngineError(
-            "wrong srcPinId = {} and dstPinId = {}, node ids (srcNodeId = {} and dstPinId = {}) cannot be equivalent",
-            srcPinId, dstPinId, srcNodeId, dstNodeId);
-    }
+    return CheckResult::Ok;
+}
 
-    for (uint16_t i=0; i!=m_capacity; ++i) {
-        m_nodes[i].ResetAcyclicityChecked();
+CheckResult Graph::ValidateEmbeddedPinId(uint32_t pinId) const noexcept {
+    if (auto result = ValidateNodeId(NodeIdFromPinId(pinId)); result != CheckResult::Ok) {
+        return result;
     }
 
-    if (!m_nodes[srcNodeId - 1].CheckAcyclicity(m_nodes, dstNodeId)) {
-        throw EngineError(
-                "wrong link from srcPinId = {} to dstPinId = {}, graph after add this link is not acyclic", srcPinId, dstPinId);
-    }
+    return m_nodes[NodeIndexFromPinId(pinId)].ValidateEmbeddedPinId(pinId);
+}
 
-    const uint8_t srcPinIndex = PinIndexFromPinId(srcPinId);
-    const uint8_t dstPinIndex = PinIndexFromPinId(dstPinId);
-    const uint32_t attachedPinId = m_nodes[dstNodeId - 1].GetAttachedPinId(dstPinIndex);
-    if (attachedPinId == srcPinId) {
-        throw EngineError(
-            "wrong link from srcPinId = {} to dstPinId = {}, link already exist", srcPinId, dstPinId);
+CheckResult Graph::ValidateInputPinId(uint32_t pinId) const noexcept {
+    if (auto result = ValidateNodeId(NodeIdFromPinId(pinId)); result != CheckResult::Ok) {
+        return result;
     }
 
-    if (!m_nodes[dstNodeId - 1].CheckConvert(dstPinIndex, m_nodes[srcNodeId - 1].GetPinType(srcPinIndex))) {
-        throw EngineError(
-            "wrong link from srcPinId = {} to dstPinId = {}, types are not compatible", srcPinId, dstPinId);
+    return m_nodes[NodeIndexFromPinId(pinId)].ValidateInputPinId(pinId);
+}
+
+CheckResult Graph::ValidateOutputPinId(uint32_t pinId) const noexcept {
+    if (auto result = ValidateNodeId(NodeIdFromPinId(pinId)); result != CheckResult::Ok) {
+        return result;
     }
 
-    if (attachedPinId != 0) {
-        auto existsLinkId = LinkId(attachedPinId, dstPinId);
-        try {
-            CheckRemoveLink(existsLinkId);
-        } catch(const EngineError& e) {
-            throw EngineError(
-                "wrong link from srcPinId = {} to dstPinId = {}, to create it, can't delete an already existing linkId = {}, {}",
-                srcPinId, dstPinId, existsLinkId, e.what());
-        }
+    return m_nodes[NodeIndexFromPinId(pinId)].ValidateOutputPinId(pinId);
+}
+
+void Graph::CheckIsValidNodeId(uint16_t nodeId) const {
+    if (auto result = ValidateNodeId(nodeId); result != CheckResult::Ok) {
+        throw EngineError("for nodeId = {}, {}", nodeId, ToString(result));
     }
 }
 
-void Graph::CheckRemoveLink(uint64_t linkId) const {
-    if (linkId == 0) {
-        throw EngineError("wrong linkId = {}, min value = 1", linkId);
+void Graph::CheckIsValidEmbeddedPinId(uint32_t pinId) const {
+    if (auto result = ValidateEmbeddedPinId(pinId); result != CheckResult::Ok) {
+        throw EngineError("for pinId = {}, {}", pinId, ToString(result));
     }
+}
 
-    uint32_t srcPinId = SrcPinIdFromLinkId(linkId);
-    try {
-        CheckIsValidOutputPinId(srcPinId);
-    } catch(const EngineError& e) {
-        throw EngineError("wrong srcPinId (from linkId = {}), {}", linkId, e.what());
+void Graph::CheckIsValidInputPinId(uint32_t pinId) const {
+    if (auto result = ValidateInputPinId(pinId); result != CheckResult::Ok) {
+        throw EngineError("for pinId = {}, {}", pinId, ToString(result));
     }
+}
 
-    uint32_t dstPinId = DstPinIdFromLinkId(linkId);
-    try {
-        CheckIsValidInputPinId(dstPinId);
-    } catch(const EngineError& e) {
-        throw EngineError("wrong dstPinId (from linkId = {}), {}", linkId, e.what());
+void Graph::CheckIsValidOutputPinId(uint32_t pinId) const {
+    if (auto result = ValidateOutputPinId(pinId); result != CheckResult::Ok) {
+        throw EngineError("for pinId = {}, {}", pinId, ToString(result));
     }
+}
 
-    if (srcPinId == dstPinId) {
-        throw EngineError(
-            "wrong srcPinId = {} and dstPinId = {} (from linkId = {}), it cannot be equivalent", srcPinId, dstPinId, linkId);
+void Graph::CheckRemoveNode(uint16_t nodeId) const {
+    if (auto result = ValidateRemoveNode(nodeId); result != CheckResult::Ok) {
+        throw EngineError("wrong nodeId = {}, {}", nodeId, ToString(result));
     }
+}
 
-    uint16_t srcNodeId = NodeIdFromPinId(srcPinId);
-    uint16_t dstNodeId = NodeIdFromPinId(dstPinId);
-    if (srcNodeId == dstNodeId) {
-        throw EngineError(
-            "wrong srcNodeId = {} and dstNodeId = {} (from linkId = {}), node ids cannot be equivalent", srcNodeId, dstNodeId, linkId);
+void Graph::CheckAddLink(uint32_t srcPinId, uint32_t dstPinId) const {
+    if (auto result = ValidateAddLink(srcPinId, dstPinId); result != CheckResult::Ok) {
+        throw EngineError("wrong link from srcPinId = {} to dstPinId = {}, {}", srcPinId, dstPinId, ToString(result));
     }
+}
 
-    if (m_nodes[dstNodeId - 1].GetAttachedPinId(PinIndexFromPinId(dstPinId)) != srcPinId) {
-        throw EngineError(
-            "wrong linkId = {}, link does not exist", linkId);
+void Graph::CheckRemoveLink(uint64_t linkId) const {
+    if (auto result = ValidateRemoveLink(linkId); result != CheckResult::Ok) {
+        throw EngineError("wrong linkId = {}, {}", linkId, ToString(result));
     }
 }
 
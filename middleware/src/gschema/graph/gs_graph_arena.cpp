@@ -0,0 +1,145 @@
+#include "middleware/gschema/graph/gs_graph_arena.h"
+
+#include <new>
+#include <algorithm>
+
+#include "middleware/gschema/graph/gs_class.h"
+#include "middleware/gschema/graph/gs_limits.h"
+#include "middleware/gschema/graph/gs_class_storage.h"
+
+
+namespace gs {
+
+NodeStorage::~NodeStorage() {
+    for (auto* chunk: m_chunks) {
+        delete[] chunk;
+    }
+}
+
+void NodeStorage::Reserve(uint32_t nodeCount) {
+    while (Capacity() < nodeCount) {
+        const uint32_t firstIndex = Capacity();
+        auto* chunk = new Node[ChunkSize];
+        m_chunks.push_back(chunk);
+        for (uint32_t i=0; i!=ChunkSize; ++i) {
+            if (firstIndex + i < MAX_NODES_COUNT) {
+                chunk[i].Init(static_cast<uint16_t>(firstIndex + i + 1));
+            }
+        }
+    }
+}
+
+void GraphArena::FreeList::Push(void* memory) noexcept {
+    new (memory) void*(head);
+    head = memory;
+}
+
+void* GraphArena::FreeList::Pop() noexcept {
+    void* memory = head;
+    if (memory != nullptr) {
+        head = *std::launder(static_cast<void**>(memory));
+    }
+
+    return memory;
+}
+
+GraphArena::GraphArena(const ClassStorage* classStorage, uint16_t initialNodeCount)
+    : m_classesBegin(classStorage->ClassesBegin())
+    , m_freePins(static_cast<size_t>(MAX_PINS_COUNT) + 1) {
+
+    uint32_t pinsCount = 0;
+    uint32_t classesCount = 0;
+    for (const Class* cls = classStorage->ClassesBegin(); cls != classStorage->ClassesEnd(); ++cls) {
+        pinsCount += static_cast<uint32_t>(cls->EmbeddedPinsCount() + cls->InputPinsCount() + cls->OutputPinsCount());
+        ++classesCount;
+    }
+
+    m_classSlabs.resize(classesCount);
+    if (classesCount != 0) {
+        const uint32_t averagePinsCount = (pinsCount + classesCount - 1) / classesCount;
+        m_pinBlock = AllocatePinBlock(std::max(averagePinsCount, uint32_t(1)) * std::max(initialNodeCount, uint16_t(1)));
+    }
+}
+
+GraphArena::~GraphArena() {
+    for (auto* block: m_pinBlocks) {
+        ::operator delete(block);
+    }
+    for (const auto& slab: m_slabs) {
+        ::operator delete(slab.memory, std::align_val_t(slab.alignment));
+    }
+}
+
+Pin* GraphArena::AllocatePins(uint16_t count) {
+    // a node without pins still needs a valid pointer
+    const uint32_t size = std::max(static_cast<uint32_t>(count), uint32_t(1));
+    ++m_counters.pinAllocations;
+
+    Pin* pins = static_cast<Pin*>(m_freePins[size].Pop());
+    if (pins == nullptr) {
+        if (m_pinBlockUsed + size > m_pinBlockSize) {
+            m_pinBlock = AllocatePinBlock(std::max(m_pinBlockSize * 2, size));
+        }
+        pins = m_pinBlock + m_pinBlockUsed;
+        m_pinBlockUsed += size;
+    }
+
+    for (uint32_t i=0; i!=size; ++i) {
+        new (pins + i) Pin();
+    }
+
+    return pins;
+}
+
+void GraphArena::DeallocatePins(Pin* pins, uint16_t count) noexcept {
+    const uint32_t size = std::max(static_cast<uint32_t>(count), uint32_t(1));
+    for (uint32_t i=0; i!=size; ++i) {
+        pins[i].~Pin();
+    }
+    m_freePins[size].Push(pins);
+}
+
+void* GraphArena::AllocateInstance(const Class* cls) {
+    auto& slabs = m_classSlabs[static_cast<size_t>(cls - m_classesBegin)];
+    ++m_counters.instanceAllocations;
+
+    if (void* memory = slabs.freeList.Pop(); memory != nullptr) {
+        return memory;
+    }
+
+    if (slabs.used == slabs.size) {
+        if (slabs.slotSize == 0) {
+            // the slot must fit a free list pointer
+            slabs.alignment = std::max(cls->GetInstanceAlignment(), alignof(void*));
+            slabs.slotSize = std::max(cls->GetInstanceSize(), sizeof(void*));
+            slabs.slotSize = (slabs.slotSize + slabs.alignment - 1) / slabs.alignment * slabs.alignment;
+            slabs.size = FirstSlabSize;
+        } else {
+            slabs.size = std::min(slabs.size * 2, MaxSlabSize);
+        }
+
+        void* memory = ::operator new(slabs.slotSize * slabs.size, std::align_val_t(slabs.alignment));
+        m_slabs.push_back(Slab{memory, slabs.alignment});
+        ++m_counters.instanceSlabs;
+        slabs.current = static_cast<std::byte*>(memory);
+        slabs.used = 0;
+    }
+
+    return slabs.current + slabs.slotSize * slabs.used++;
+}
+
+void GraphArena::DeallocateInstance(const Class* cls, void* memory) noexcept {
+    m_classSlabs[static_cast<size_t>(cls - m_classesBegin)].freeList.Push(memory);
+}
+
+Pin* GraphArena::AllocatePinBlock(uint32_t size) {
+    auto* block = static_cast<Pin*>(::operator new(sizeof(Pin) * size));
+    m_pinBlocks.push_back(block);
+    ++m_counters.pinBlocks;
+    m_pinBlockUsed = 0;
+    m_pinBlockSize = size;
+
+    return block;
+}
+
+}
@@ -0,0 +1,362 @@
+#include "middleware/gschema/graph/gs_graph.h"
+
+#include <string>
+#include <cstring>
+#include <fstream>
+#include <errno.h>
+#include <string_view>
+#include <unordered_map>
+
+#include "core/common/exception.h"
+#include "core/path/mapped_file.h"
+#include "middleware/gschema/graph/gs_id.h"
+#include "middleware/gschema/graph/gs_node.h"
+#include "middleware/gschema/graph/gs_class.h"
+#include "middleware/gschema/graph/gs_limits.h"
+#include "middleware/gschema/graph/gs_class_storage.h"
+
+
+namespace gs {
+
+class Class;
+
+namespace {
+
+/*
+    Schema layout (little endian, records are packed one after another):
+    SchemaHeader
+    ClassRecord[classesCount] - class names are stored in the names section
+    NodeRecord[nodesCount]
+    LinkRecord[linksCount]
+    ValueRecord[valuesCount] - values of embedded and not connected input pins
+    uint64_t[fieldsCount] - raw fields of the values (see IPrimitiveType::ToBits)
+    char[namesSize]
+*/
+
+constexpr const uint32_t SCHEMA_MAGIC = 0x52475347; // "GSGR"
+constexpr const uint16_t SCHEMA_VERSION = 1;
+
+struct SchemaHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t classesCount;
+    uint16_t nodesCount;
+    // max node index + 1
+    uint16_t nodesCapacity;
+    uint32_t linksCount;
+    uint32_t valuesCount;
+    uint32_t fieldsCount;
+    uint32_t namesSize;
+    uint32_t reserved;
+};
+
+struct ClassRecord {
+    uint32_t nameOffset;
+    uint32_t nameSize;
+};
+
+struct NodeRecord {
+    uint16_t nodeIndex;
+    // index in the ClassRecord array
+    uint16_t classIndex;
+};
+
+struct LinkRecord {
+    uint16_t srcNodeIndex;
+    uint16_t dstNodeIndex;
+    uint8_t srcPinIndex;
+    uint8_t dstPinIndex;
+    uint16_t reserved;
+};
+
+struct ValueRecord {
+    uint16_t nodeIndex;
+    uint8_t pinIndex;
+    TypeId typeId;
+    uint32_t firstField;
+    uint32_t fieldsCount;
+};
+
+static_assert(sizeof(SchemaHeader) == 32, "sizeof(SchemaHeader) == 32 bytes");
+static_assert(sizeof(ClassRecord) == 8, "sizeof(ClassRecord) == 8 bytes");
+static_assert(sizeof(NodeRecord) == 4, "sizeof(NodeRecord) == 4 bytes");
+static_assert(sizeof(LinkRecord) == 8, "sizeof(LinkRecord) == 8 bytes");
+static_assert(sizeof(ValueRecord) == 12, "sizeof(ValueRecord) == 12 bytes");
+
+struct SchemaLayout {
+    size_t classes = 0;
+    size_t nodes = 0;
+    size_t links = 0;
+    size_t values = 0;
+    size_t fields = 0;
+    size_t names = 0;
+    size_t size = 0;
+};
+
+SchemaLayout CalcLayout(const SchemaHeader& header) {
+    SchemaLayout layout;
+    layout.classes = sizeof(SchemaHeader);
+    layout.nodes = layout.classes + sizeof(ClassRecord) * header.classesCount;
+    layout.links = layout.nodes + sizeof(NodeRecord) * header.nodesCount;
+    layout.values = layout.links + sizeof(LinkRecord) * header.linksCount;
+    layout.fields = layout.values + sizeof(ValueRecord) * header.valuesCount;
+    layout.names = layout.fields + sizeof(uint64_t) * header.fieldsCount;
+    layout.size = layout.names + header.namesSize;
+
+    return layout;
+}
+
+// the data may be unaligned, so records are copied
+template<typename T> T ReadRecord(const uint8_t* data, size_t offset, size_t index) {
+    T record;
+    std::memcpy(&record, data + offset + sizeof(T) * index, sizeof(T));
+    return record;
+}
+
+template<typename T> void WriteRecords(uint8_t* data, size_t offset, const std::vector<T>& records) {
+    if (!records.empty()) {
+        std::memcpy(data + offset, records.data(), sizeof(T) * records.size());
+    }
+}
+
+}
+
+void Graph::Save(std::vector<uint8_t>& data) const {
+    std::string names;
+    std::vector<ClassRecord> classes;
+    std::vector<NodeRecord> nodes;
+    std::vector<LinkRecord> links;
+    std::vector<ValueRecord> values;
+    std::vector<uint64_t> fields;
+    std::unordered_map<const Class*, uint16_t> classIndexes;
+    uint16_t nodesCapacity = 0;
+
+    for (uint16_t i=0; i!=m_capacity; ++i) {
+        const Node& node = m_nodes[i];
+        if (node.IsRemoved()) {
+            continue;
+        }
+
+        const Class* cls = node.GetClass();
+        auto [it, inserted] = classIndexes.emplace(cls, static_cast<uint16_t>(classes.size()));
+        if (inserted) {
+            const std::string_view name = cls->GetName();
+            classes.push_back(ClassRecord{static_cast<uint32_t>(names.size()), static_cast<uint32_t>(name.size())});
+            names.append(name);
+        }
+        nodes.push_back(NodeRecord{i, it->second});
+        nodesCapacity = static_cast<uint16_t>(i + 1);
+
+        for (uint8_t pinIndex=node.EmbeddedPinsBeginIndex(); pinIndex!=node.InputPinsEndIndex(); ++pinIndex) {
+            TypeId typeId = TypeId::Unknown;
+            const auto firstField = static_cast<uint32_t>(fields.size());
+            if (node.SaveValue(pinIndex, typeId, fields)) {
+                values.push_back(ValueRecord{i, pinIndex, typeId, firstField, static_cast<uint32_t>(fields.size()) - firstField});
+            }
+        }
+
+        for (uint8_t pinIndex=node.InputPinsBeginIndex(); pinIndex!=node.InputPinsEndIndex(); ++pinIndex) {
+            const uint32_t attachedPinId = node.GetAttachedPinId(pinIndex);
+            if (attachedPinId != 0) {
+                links.push_back(LinkRecord{NodeIndexFromPinId(attachedPinId), i, PinIndexFromPinId(attachedPinId), pinIndex, 0});
+            }
+        }
+    }
+
+    SchemaHeader header;
+    header.magic = SCHEMA_MAGIC;
+    header.version = SCHEMA_VERSION;
+    header.classesCount = static_cast<uint16_t>(classes.size());
+    header.nodesCount = static_cast<uint16_t>(nodes.size());
+    header.nodesCapacity = nodesCapacity;
+    header.linksCount = static_cast<uint32_t>(links.size());
+    header.valuesCount = static_cast<uint32_t>(values.size());
+    header.fieldsCount = static_cast<uint32_t>(fields.size());
+    header.namesSize = static_cast<uint32_t>(names.size());
+    header.reserved = 0;
+
+    const SchemaLayout layout = CalcLayout(header);
+    data.assign(layout.size, 0);
+    std::memcpy(data.data(), &header, sizeof(SchemaHeader));
+    WriteRecords(data.data(), layout.classes, classes);
+    WriteRecords(data.data(), layout.nodes, nodes);
+    WriteRecords(data.data(), layout.links, links);
+    WriteRecords(data.data(), layout.values, values);
+    WriteRecords(data.data(), layout.fields, fields);
+    if (!names.empty()) {
+        std::memcpy(data.data() + layout.names, names.data(), names.size());
+    }
+}
+
+void Graph::SaveToFile(const std::filesystem::path& path) const {
+    std::vector<uint8_t> data;
+    Save(data);
+
+    std::ofstream ofs(path.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    if (!ofs) {
+        throw EngineError("gs::Graph::SaveToFile: couldn't open file '{}', error: {}", path.c_str(), strerror(errno));
+    }
+    ofs.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!ofs) {
+        throw EngineError("gs::Graph::SaveToFile: couldn't write file '{}', error: {}", path.c_str(), strerror(errno));
+    }
+}
+
+void Graph::Load(const uint8_t* data, size_t size) {
+    try {
+        LoadImpl(data, size);
+    } catch(const std::exception& e) {
+        RemoveAllNodes();
+        throw EngineError("gs::Graph::Load: {}", e.what());
+    }
+}
+
+void Graph::LoadFromFile(const std::filesystem::path& path) {
+    MappedFile file;
+    std::string error;
+    if (!file.Open(path, error)) {
+        throw EngineError("gs::Graph::LoadFromFile: {}", error);
+    }
+
+    Load(file.Data(), file.Size());
+}
+
+void Graph::LoadImpl(const uint8_t* data, size_t size) {
+    if ((data == nullptr) || (size < sizeof(SchemaHeader))) {
+        throw EngineError("data size = {} is less than the header size = {}", size, sizeof(SchemaHeader));
+    }
+
+    const auto header = ReadRecord<SchemaHeader>(data, 0, 0);
+    if (header.magic != SCHEMA_MAGIC) {
+        throw EngineError("wrong magic = {:#x}", header.magic);
+    }
+    if (header.version != SCHEMA_VERSION) {
+        throw EngineError("unsupported version = {}, expected = {}", header.version, SCHEMA_VERSION);
+    }
+    if ((header.nodesCount > header.nodesCapacity) || (header.nodesCapacity > MAX_NODES_COUNT)) {
+        throw EngineError("wrong nodes count = {} or capacity = {}", header.nodesCount, header.nodesCapacity);
+    }
+    const SchemaLayout layout = CalcLayout(header);
+    if (layout.size != size) {
+        throw EngineError("data size = {} is not equal to the size from the header = {}", size, layout.size);
+    }
+
+    std::vector<uint16_t> classIndexes(header.classesCount);
+    for (uint16_t i=0; i!=header.classesCount; ++i) {
+        const auto record = ReadRecord<ClassRecord>(data, layout.classes, i);
+        if (static_cast<uint64_t>(record.nameOffset) + static_cast<uint64_t>(record.nameSize) > header.namesSize) {
+            throw EngineError("wrong name for class record = {}", i);
+        }
+        const auto name = std::string_view(reinterpret_cast<const char*>(data + layout.names + record.nameOffset), record.nameSize);
+        classIndexes[i] = m_classStorage->GetClassIndex(name);
+    }
+
+    RemoveAllNodes();
+    if (header.nodesCapacity > m_capacity) {
+        m_nodes.Reserve(header.nodesCapacity);
+        m_capacity = header.nodesCapacity;
+        ResizeNodeBuffers();
+    }
+
+    for (uint16_t i=0; i!=header.nodesCount; ++i) {
+        const auto record = ReadRecord<NodeRecord>(data, layout.nodes, i);
+        if ((record.nodeIndex >= header.nodesCapacity) || (record.classIndex >= header.classesCount)) {
+            throw EngineError("wrong node record = {}, nodeIndex = {}, classIndex = {}", i, record.nodeIndex, record.classIndex);
+        }
+        if (!m_nodes[record.nodeIndex].IsRemoved()) {
+            throw EngineError("wrong node record = {}, duplicate nodeIndex = {}", i, record.nodeIndex);
+        }
+        m_nodes[record.nodeIndex].Create(m_classStorage->GetClass(classIndexes[record.classIndex]), m_arena);
+    }
+
+    // free list in ascending order, as after RemoveNode
+    uint16_t nextFreeIndex = m_capacity;
+    for (uint16_t i=m_capacity; i!=0; --i) {
+        if (m_nodes[i - 1].IsRemoved()) {
+            m_nodes[i - 1].Reset(nextFreeIndex, m_arena);
+            nextFreeIndex = i - 1;
+        }
+    }
+    m_firstFreeIndex = nextFreeIndex;
+    m_free = m_capacity - header.nodesCount;
+
+    std::vector<uint64_t> fields(header.fieldsCount);
+    if (!fields.empty()) {
+        std::memcpy(fields.data(), data + layout.fields, sizeof(uint64_t) * fields.size());
+    }
+    for (uint32_t i=0; i!=header.valuesCount; ++i) {
+        const auto record = ReadRecord<ValueRecord>(data, layout.values, i);
+        if ((record.nodeIndex >= m_capacity) || m_nodes[record.nodeIndex].IsRemoved()) {
+            throw EngineError("wrong value record = {}, node with nodeIndex = {} not found", i, record.nodeIndex);
+        }
+        if (static_cast<uint64_t>(record.firstField) + static_cast<uint64_t>(record.fieldsCount) > fields.size()) {
+            throw EngineError("wrong value record = {}, fields are out of range", i);
+        }
+        m_nodes[record.nodeIndex].LoadValue(record.pinIndex, record.typeId, fields.data() + record.firstField, record.fieldsCount);
+    }
+
+    // acyclicity is checked once for all links (Kahn's algorithm)
+    std::vector<uint32_t> inputLinksCount(m_capacity, 0);
+    std::vector<uint32_t> firstOutputLink(static_cast<size_t>(m_capacity) + 1, 0);
+    std::vector<uint16_t> outputLinks(header.linksCount);
+    for (uint32_t i=0; i!=header.linksCount; ++i) {
+        const auto record = ReadRecord<LinkRecord>(data, layout.links, i);
+        if ((record.srcNodeIndex >= m_capacity) || m_nodes[record.srcNodeIndex].IsRemoved() ||
+            (record.dstNodeIndex >= m_capacity) || m_nodes[record.dstNodeIndex].IsRemoved()) {
+            throw EngineError("wrong link record = {}, node not found", i);
+        }
+        if (record.srcNodeIndex == record.dstNodeIndex) {
+            throw EngineError("wrong link record = {}, src and dst nodes cannot be equivalent", i);
+        }
+
+        Node& srcNode = m_nodes[record.srcNodeIndex];
+        Node& dstNode = m_nodes[record.dstNodeIndex];
+        if ((record.srcPinIndex < srcNode.OutputPinsBeginIndex()) || (record.srcPinIndex >= srcNode.OutputPinsEndIndex())) {
+            throw EngineError("wrong link record = {}, srcPinIndex = {} is not output pin", i, record.srcPinIndex);
+        }
+        if ((record.dstPinIndex < dstNode.InputPinsBeginIndex()) || (record.dstPinIndex >= dstNode.InputPinsEndIndex())) {
+            throw EngineError("wrong link record = {}, dstPinIndex = {} is not input pin", i, record.dstPinIndex);
+        }
+        if (dstNode.IsConnectedPin(record.dstPinIndex)) {
+            throw EngineError("wrong link record = {}, dst pin already has a link", i);
+        }
+
+        const uint32_t srcPinId = srcNode.GetOutputPinId(static_cast<uint8_t>(record.srcPinIndex - srcNode.OutputPinsBeginIndex()));
+        dstNode.AttachToInputPin(record.dstPinIndex, srcPinId, srcNode.GetPinType(record.srcPinIndex));
+        srcNode.IncLinkForOutputPin(record.srcPinIndex);
+        ++inputLinksCount[record.dstNodeIndex];
+        ++firstOutputLink[static_cast<size_t>(record.srcNodeIndex) + 1];
+    }
+
+    for (uint16_t i=0; i!=m_capacity; ++i) {
+        firstOutputLink[static_cast<size_t>(i) + 1] += firstOutputLink[i];
+    }
+    std::vector<uint32_t> outputLinksEnd(firstOutputLink.cbegin(), firstOutputLink.cend() - 1);
+    for (uint32_t i=0; i!=header.linksCount; ++i) {
+        const auto record = ReadRecord<LinkRecord>(data, layout.links, i);
+        outputLinks[outputLinksEnd[record.srcNodeIndex]++] = record.dstNodeIndex;
+    }
+
+    std::vector<uint16_t> queue;
+    queue.reserve(header.nodesCount);
+    for (uint16_t i=0; i!=m_capacity; ++i) {
+        if ((!m_nodes[i].IsRemoved()) && (inputLinksCount[i] == 0)) {
+            queue.push_back(i);
+        }
+    }
+    for (size_t it=0; it!=queue.size(); ++it) {
+        const uint16_t nodeIndex = queue[it];
+        for (uint32_t link=firstOutputLink[nodeIndex]; link!=firstOutputLink[static_cast<size_t>(nodeIndex) + 1]; ++link) {
+            if (--inputLinksCount[outputLinks[link]] == 0) {
+                queue.push_back(outputLinks[link]);
+            }
+        }
+    }
+    if (queue.size() != header.nodesCount) {
+        throw EngineError("graph is not acyclic");
+    }
+
+    SortNodesByDependency();
+}
+
+}
@@ -1,7 +1,6 @@
 #include "middleware/gschema/graph/gs_node.h"
 
 #include <vector>
-#include <utility>
 #include <variant>
 #include <string_view>
 
@@ -11,36 +10,17 @@
 #include "middleware/gschema/graph/gs_types.h"
 #include "middleware/gschema/graph/gs_class.h"
 #include "middleware/gschema/graph/gs_limits.h"
+#include "middleware/gschema/graph/gs_graph_arena.h"
+#include "middleware/gschema/graph/gs_result_cache.h"
 #include "middleware/gschema/meta/gs_type_instance.h"
+#include "middleware/gschema/meta/gs_type_interface.h"
 #include "middleware/gschema/graph/gs_draw_interface.h"
 
 
 namespace gs {
 
 static_assert(sizeof(Pin) == 40, "sizeof(Pin) == 40 bytes");
-static_assert(sizeof(Node) == 72, "sizeof(Node) == 72 bytes");
-
-Node::Node(Node&& other) noexcept {
-    *this = std::move(other);
-}
-
-Node& Node::operator=(Node&& o) noexcept {
-    std::swap(m_id, o.m_id);
-    std::swap(m_countEmbeddedPins, o.m_countEmbeddedPins);
-    std::swap(m_countInputPins, o.m_countInputPins);
-    std::swap(m_countOutputPins, o.m_countOutputPins);
-    std::swap(m_outputValueVersion, o.m_outputValueVersion);
-    std::swap(m_validFlags, o.m_validFlags);
-    std::swap(m_changeState, o.m_changeState);
-    std::swap(m_order, o.m_order);
-    std::swap(m_nextIndex, o.m_nextIndex);
-    std::swap(m_pins, o.m_pins);
-    std::swap(m_class, o.m_class);
-    std::swap(m_instance, o.m_instance);
-    std::swap(m_lastResultError, o.m_lastResultError);
-
-    return *this;
-}
+static_assert(sizeof(Node) == 80, "sizeof(Node) == 80 bytes");
 
 void Node::Init(uint16_t id) noexcept {
     m_id = id;
@@ -48,18 +28,40 @@ void Node::Init(uint16_t id) noexcept {
     m_nextIndex = id;
 }
 
-void Node::Create(Class* cls) {
+void Node::Create(Class* cls, GraphArena& arena) {
+    m_countEmbeddedPins = cls->EmbeddedPinsCount();
+    m_countInputPins = cls->InputPinsCount();
+    m_countOutputPins = cls->OutputPinsCount();
+    // the node stays removed (m_pins == nullptr) if some allocation throws
+    Pin* pins = arena.AllocatePins(AllPinsEndIndex());
+    void* memory = nullptr;
+    try {
+        memory = arena.AllocateInstance(cls);
+        m_instance = cls->CreateInstance(memory);
+    } catch(...) {
+        if (memory != nullptr) {
+            arena.DeallocateInstance(cls, memory);
+        }
+        arena.DeallocatePins(pins, AllPinsEndIndex());
+        throw;
+    }
     m_class = cls;
-    m_instance = cls->CreateInstance();
+    m_pins = pins;
 
-    m_countEmbeddedPins = m_class->EmbeddedPinsCount();
-    m_countInputPins = m_class->InputPinsCount();
-    m_countOutputPins = m_class->OutputPinsCount();
     m_outputValueVersion = 0;
+    m_outputId = 0;
     m_lastResultError.clear();
     m_validFlags = ValidFlags::Valid;
     m_changeState = ChangeState::NotChanged;
-    m_pins = new Pin[m_countEmbeddedPins + m_countInputPins + m_countOutputPins];
+    try {
+        InitPins();
+    } catch(...) {
+        Reset(m_nextIndex, arena);
+        throw;
+    }
+}
+
+void Node::InitPins() {
     constexpr const uint32_t isUniversalTypeFlag = 4;
     uint32_t baseID = static_cast<uint32_t>(m_id) << uint32_t(16);
 
@@ -95,17 +97,18 @@ void Node::Create(Class* cls) {
     }
 }
 
-void Node::Reset(uint16_t nextIndex) {
+void Node::Reset(uint16_t nextIndex, GraphArena& arena) {
     m_nextIndex = nextIndex;
 
     if (m_instance != nullptr) {
         m_class->DestroyInstance(m_instance);
+        arena.DeallocateInstance(m_class, m_instance);
         m_instance = nullptr;
     }
 
     m_class = nullptr;
     if (m_pins != nullptr) {
-        delete[] m_pins;
+        arena.DeallocatePins(m_pins, AllPinsEndIndex());
         m_pins = nullptr;
     }
 }
@@ -126,27 +129,21 @@ uint32_t Node::GetEmbeddedPinId(uint8_t offset) const noexcept {
     return m_pins[EmbeddedPinsBeginIndex() + offset].id;
 }
 
-void Node::CheckIsValidEmbeddedPinId(uint32_t pinId) const {
+CheckResult Node::ValidateEmbeddedPinId(uint32_t pinId) const noexcept {
     if (pinId == 0) {
-        throw EngineError("for pinId = {}, min value = 1", pinId);
+        return CheckResult::ZeroId;
     }
 
     if (!IsEmbeddedFromPinId(pinId)) {
-        throw EngineError("for pinId = {}, flag IsEmbedded not set", pinId);
-    }
-
-    if (m_countEmbeddedPins == 0) {
-        throw EngineError("for pinId = {}, not found embedded pins", pinId);
+        return CheckResult::NotEmbeddedPin;
     }
 
     uint8_t pinIndex = PinIndexFromPinId(pinId);
-    if (EmbeddedPinsBeginIndex() > pinIndex) {
-        throw EngineError("for pinId = {}, pinIndex = {} less than the minimum value = {}", pinId, pinIndex, EmbeddedPinsBeginIndex());
+    if ((EmbeddedPinsBeginIndex() > pinIndex) || (EmbeddedPinsEndIndex() <= pinIndex)) {
+        return CheckResult::PinIndexOutOfRange;
     }
 
-    if (EmbeddedPinsEndIndex() <= pinIndex) {
-        throw EngineError("for pinId = {}, pinIndex = {} greater than maximum value = {}", pinId, pinIndex, EmbeddedPinsEndIndex() - 1);
-    }
+    return CheckResult::Ok;
 }
 
 void Node::CheckIsValidEmbeddedPinType(uint8_t pinIndex, std::type_index typeIndex) const {
@@ -166,31 +163,21 @@ uint32_t Node::GetInputPinId(uint8_t offset) const noexcept {
     return m_pins[InputPinsBeginIndex() + offset].id;
 }
 
-void Node::CheckIsValidInputPinId(uint32_t pinId) const {
+CheckResult Node::ValidateInputPinId(uint32_t pinId) const noexcept {
     if (pinId == 0) {
-        throw EngineError("for pinId = {}, min value = 1", pinId);
-    }
-
-    if (IsEmbeddedFromPinId(pinId)) {
-        throw EngineError("for pinId = {}, flag IsEmbedded is setting", pinId);
+        return CheckResult::ZeroId;
     }
 
-    if (!IsInputFromPinId(pinId)) {
-        throw EngineError("for pinId = {}, flag IsInput not set", pinId);
-    }
-
-    if (m_countInputPins == 0) {
-        throw EngineError("for pinId = {}, not found input pins", pinId);
+    if (IsEmbeddedFromPinId(pinId) || !IsInputFromPinId(pinId)) {
+        return CheckResult::NotInputPin;
     }
 
     uint8_t pinIndex = PinIndexFromPinId(pinId);
-    if (InputPinsBeginIndex() > pinIndex) {
-        throw EngineError("for pinId = {}, pinIndex = {} less than the minimum value = {}", pinId, pinIndex, InputPinsBeginIndex());
+    if ((InputPinsBeginIndex() > pinIndex) || (InputPinsEndIndex() <= pinIndex)) {
+        return CheckResult::PinIndexOutOfRange;
     }
 
-    if (InputPinsEndIndex() <= pinIndex) {
-        throw EngineError("for pinId = {}, pinIndex = {} greater than maximum value = {}", pinId, pinIndex, InputPinsEndIndex() - 1);
-    }
+    return CheckResult::Ok;
 }
 
 uint32_t Node::GetOutputPinId(uint8_t offset) const noexcept {
@@ -201,31 +188,21 @@ uint32_t Node::GetOutputPinId(uint8_t offset) const noexcept {
     return m_pins[OutputPinsBeginIndex() + offset].id;
 }
 
-void Node::CheckIsValidOutputPinId(uint32_t pinId) const {
+CheckResult Node::ValidateOutputPinId(uint32_t pinId) const noexcept {
     if (pinId == 0) {
-        throw EngineError("for pinId = {}, min value = 1", pinId);
-    }
-
-    if (IsEmbeddedFromPinId(pinId)) {
-        throw EngineError("for pinId = {}, flag IsEmbedded is setting", pinId);
-    }
-
-    if (IsInputFromPinId(pinId)) {
-        throw EngineError("for pinId = {}, flag IsInput is setting", pinId);
+        return CheckResult::ZeroId;
     }
 
-    if (m_countOutputPins == 0) {
-        throw EngineError("for pinId = {}, not found output pins", pinId);
+    if (IsEmbeddedFromPinId(pinId) || IsInputFromPinId(pinId)) {
+        return CheckResult::NotOutputPin;
     }
 
     uint8_t pinIndex = PinIndexFromPinId(pinId);
-    if (OutputPinsBeginIndex() > pinIndex) {
-        throw EngineError("for pinId = {}, pinIndex = {} less than the minimum value = {}", pinId, pinIndex, OutputPinsBeginIndex());
+    if ((OutputPinsBeginIndex() > pinIndex) || (OutputPinsEndIndex() <= pinIndex)) {
+        return CheckResult::PinIndexOutOfRange;
     }
 
-    if (OutputPinsEndIndex() <= pinIndex) {
-        throw EngineError("for pinId = {}, pinIndex = {} greater than maximum value = {}", pinId, pinIndex, OutputPinsEndIndex() - 1);
-    }
+    return CheckResult::Ok;
 }
 
 void Node::ResetOrder() noexcept {
@@ -233,52 +210,18 @@ void Node::ResetOrder() noexcept {
     m_nextIndex = INVALID_NODE_INDEX;
 }
 
-uint16_t Node::GetOrderNumber(Node* nodes) noexcept {
-    if (m_order == INVALID_ORDER_VALUE) {
-        m_order = 0;
-        for(uint8_t i=InputPinsBeginIndex(); i!=InputPinsEndIndex(); ++i) {
-            if (GetAttachedPinId(i) != 0) {
-                uint16_t nodeIndex = NodeIndexFromPinId(GetAttachedPinId(i));
-                uint16_t order = nodes[nodeIndex].GetOrderNumber(nodes) + 1;
-                if (order > m_order) {
-                    m_order = order;
-                }
-            }
-        }
-    }
-
-    return m_order;
-}
-
-void Node::ResetAcyclicityChecked() noexcept {
-    m_isAcyclicityChecked = false;
+void Node::ResetChangeState() noexcept {
+    m_changeState = ChangeState::NotChanged;
 }
 
-bool Node::CheckAcyclicity(Node* nodes, uint16_t dstNodeId) noexcept {
-    if (m_isAcyclicityChecked) {
-        return true;
+void Node::InvalidateOutputs() noexcept {
+    m_outputId = 0;
+    if (m_changeState == ChangeState::NotChanged) {
+        m_changeState = ChangeState::NeedUpdateOutputs;
     }
-    m_isAcyclicityChecked = true;
-    if (m_id == dstNodeId) {
-        return false;
-    }
-
-    for(uint8_t i=InputPinsBeginIndex(); i!=InputPinsEndIndex(); ++i) {
-        if (GetAttachedPinId(i) != 0) {
-            if (!nodes[NodeIndexFromPinId(GetAttachedPinId(i))].CheckAcyclicity(nodes, dstNodeId)) {
-                return false;
-            }
-        }
-    }
-
-    return true;
 }
 
-void Node::ResetChangeState() noexcept {
-    m_changeState = ChangeState::NotChanged;
-}
-
-uint16_t Node::UpdateState(Node* nodes) {
+uint16_t Node::UpdateState(const NodeStorage& nodes, ResultCache* resultCache) {
     bool isChanged = false;
     RemoveConvertError();
     for (uint8_t inputPinIndex=InputPinsBeginIndex(); inputPinIndex!=InputPinsEndIndex(); ++inputPinIndex) {
@@ -319,21 +262,30 @@ uint16_t Node::UpdateState(Node* nodes) {
         }
     }
 
-    if (!ExistsConvertError() && (isChanged || (m_changeState == ChangeState::NeedUpdateOutputs))) {
-        for (uint8_t outputPinIndex=OutputPinsBeginIndex(); outputPinIndex!=OutputPinsEndIndex(); ++outputPinIndex) {
-            try {
-                auto& pin = m_pins[outputPinIndex];
-                pin.cachedValue = m_class->GetValue(outputPinIndex, m_instance);
-                isChanged = true;
-                ++m_outputValueVersion;
-                if (HasUniversalBit(pin.typeId)) {
-                    pin.typeId = GetUniversalTypeId(cpgf::fromVariant<UniversalType>(pin.cachedValue));
-                }
-                RemoveResultError();
-            } catch(const std::exception& e) {
-                SetResultError(e.what());
+    if (ExistsConvertError()) {
+        m_outputId = 0;
+    } else if (isChanged || (m_changeState == ChangeState::NeedUpdateOutputs)) {
+        const bool hasKey = (resultCache != nullptr) && CalcInputsKey(nodes, resultCache->GetKeyBuffer());
+        const uint64_t currentId = ExistsResultError() ? 0 : m_outputId;
+        uint64_t id = 0;
+        if (hasKey) {
+            id = resultCache->Restore(resultCache->GetKeyBuffer(), currentId, m_pins + OutputPinsBeginIndex(), OutputPinsCount());
+        }
+
+        if ((id != 0) && (id == currentId)) {
+            // the same inputs as for the current outputs, dependent nodes are not changed
+            isChanged = false;
+        } else if (id != 0) {
+            m_outputValueVersion = static_cast<uint8_t>(m_outputValueVersion + OutputPinsCount());
+            RemoveResultError();
+            isChanged = true;
+        } else {
+            isChanged = CalcOutputs() || isChanged;
+            if (hasKey && !ExistsResultError()) {
+                id = resultCache->Insert(resultCache->GetKeyBuffer(), m_pins + OutputPinsBeginIndex(), OutputPinsCount());
             }
         }
+        m_outputId = ExistsResultError() ? 0 : id;
     }
 
     m_changeState = isChanged ? ChangeState::Updated : ChangeState::NotChanged;
@@ -345,6 +297,17 @@ const cpgf::GVariant& Node::GetOutputValue(uint8_t pinIndex) const {
     return m_pins[pinIndex].cachedValue;
 }
 
+TypeId Node::GetOutputBaseValue(uint8_t pinIndex, cpgf::GVariant& value) const {
+    value = m_pins[pinIndex].cachedValue;
+    if (IsUniversalTypeFromPinId(m_pins[pinIndex].id)) {
+        value = std::visit([](auto&& v) -> auto {
+            return cpgf::copyVariantFromCopyable(v);
+        }, cpgf::fromVariant<UniversalType>(value));
+    }
+
+    return ToBaseTypeId(GetPinType(pinIndex));
+}
+
 void Node::SetInputValue(uint8_t pinIndex, TypeId typeId, const cpgf::GVariant& value) {
     if (IsConnectedPin(pinIndex)) {
         throw EngineError("gs::Node::SetValue: trying to change the connected pin (pinId = {})", m_pins[pinIndex].id);
@@ -381,6 +344,44 @@ void Node::ResetToDefault(uint8_t pinIndex) {
     m_changeState = ChangeState::NeedUpdateOutputs;
 }
 
+bool Node::SaveValue(uint8_t pinIndex, TypeId& typeId, std::vector<uint64_t>& fields) const {
+    if (pinIndex < EmbeddedPinsEndIndex()) {
+        typeId = TypeId::Unknown;
+    } else {
+        if (IsConnectedPin(pinIndex)) {
+            return false;
+        }
+        typeId = ToBaseTypeId(GetPinType(pinIndex));
+        if (!IsEnableUI(typeId)) {
+            return false;
+        }
+    }
+
+    GetTypeInstance(pinIndex, typeId)->ValueToBits(GetEditValue(pinIndex), fields);
+
+    return true;
+}
+
+void Node::LoadValue(uint8_t pinIndex, TypeId typeId, const uint64_t* fields, size_t count) {
+    if (pinIndex >= InputPinsEndIndex()) {
+        throw EngineError("gs::Node::LoadValue: wrong pinIndex = {}, need embedded or input pin", pinIndex);
+    }
+    if ((pinIndex >= EmbeddedPinsEndIndex()) && (ToBaseTypeId(GetPinType(pinIndex)) != typeId)) {
+        throw EngineError("gs::Node::LoadValue: wrong value type = {}, it is not the same as the pin type = {}", typeId, GetPinType(pinIndex));
+    }
+
+    const TypeInstance* typeInstance = GetTypeInstance(pinIndex, typeId);
+    if (typeInstance->Count() != count) {
+        throw EngineError("gs::Node::LoadValue: wrong fields count = {} for pinIndex = {}, expected = {}", count, pinIndex, typeInstance->Count());
+    }
+
+    if (pinIndex < EmbeddedPinsEndIndex()) {
+        SetEmbeddedValue(pinIndex, typeInstance->ValueFromBits(fields, count));
+    } else {
+        SetInputValue(pinIndex, typeId, typeInstance->ValueFromBits(fields, count));
+    }
+}
+
 void Node::AttachToInputPin(uint8_t inputPinIndex, uint32_t attachedPinID, TypeId attachedPinType) {
     m_changeState = ChangeState::NeedUpdateInputs;
     m_pins[inputPinIndex].attachedPinID = attachedPinID;
@@ -481,16 +482,81 @@ void Node::TryChange(uint8_t pinIndex) {
     }
 }
 
+bool Node::CalcInputsKey(const NodeStorage& nodes, std::vector<uint64_t>& key) const {
+    key.clear();
+    key.push_back(reinterpret_cast<uintptr_t>(m_class));
+    for (uint8_t pinIndex=EmbeddedPinsBeginIndex(); pinIndex!=InputPinsEndIndex(); ++pinIndex) {
+        TypeId typeId = TypeId::Unknown;
+        if (pinIndex >= EmbeddedPinsEndIndex()) {
+            typeId = GetPinType(pinIndex);
+            const uint32_t attachedPinId = GetAttachedPinId(pinIndex);
+            // the header of the input pin, the types of the embedded pins are constant
+            const uint64_t isAttached = (attachedPinId != 0) ? 1 : 0;
+            key.push_back(isAttached | (static_cast<uint64_t>(typeId) << 8));
+            if (attachedPinId != 0) {
+                const uint64_t attachedId = nodes[NodeIndexFromPinId(attachedPinId)].GetOutputId();
+                if (attachedId == 0) {
+                    return false;
+                }
+                key.push_back(attachedId);
+                key.push_back(PinIndexFromPinId(attachedPinId));
+                continue;
+            }
+
+            typeId = ToBaseTypeId(typeId);
+            if (!IsEnableUI(typeId)) {
+                return false;
+            }
+        }
+
+        GetTypeInstance(pinIndex, typeId)->ValueToBits(GetEditValue(pinIndex), key);
+    }
+
+    return true;
+}
+
+bool Node::CalcOutputs() {
+    bool isChanged = false;
+    for (uint8_t outputPinIndex=OutputPinsBeginIndex(); outputPinIndex!=OutputPinsEndIndex(); ++outputPinIndex) {
+        try {
+            auto& pin = m_pins[outputPinIndex];
+            pin.cachedValue = m_class->GetValue(outputPinIndex, m_instance);
+            isChanged = true;
+            ++m_outputValueVersion;
+            if (HasUniversalBit(pin.typeId)) {
+                pin.typeId = GetUniversalTypeId(cpgf::fromVariant<UniversalType>(pin.cachedValue));
+            }
+            RemoveResultError();
+        } catch(const std::exception& e) {
+            SetResultError(e.what());
+        }
+    }
+
+    return isChanged;
+}
+
+const TypeInstance* Node::GetTypeInstance(uint8_t pinIndex, TypeId typeId) const {
+    if (pinIndex < EmbeddedPinsEndIndex()) {
+        return m_class->GetTypeInstanceForEmbedded(pinIndex);
+    }
+
+    return m_class->GetFreeTypeInstance(typeId);
+}
+
+cpgf::GVariant Node::GetEditValue(uint8_t pinIndex) const {
+    cpgf::GVariant value = m_class->GetValue(pinIndex, m_instance);
+    if ((pinIndex >= EmbeddedPinsEndIndex()) && IsUniversalTypeFromPinId(m_pins[pinIndex].id)) {
+        value = std::visit([](auto&& v) -> auto {
+            return cpgf::copyVariantFromCopyable(v);
+        }, cpgf::fromVariant<UniversalType>(value));
+    }
+
+    return value;
+}
+
 TypeId Node::GetValueForPreview(cpgf::GVariant& value) {
     if (OutputPinsCount() > 0) {
-        auto index = OutputPinsBeginIndex();
-        value = m_pins[index].cachedValue;
-        if (IsUniversalTypeFromPinId(m_pins[index].id)) {
-            value = std::visit([](auto&& v) -> auto {
-                return cpgf::copyVariantFromCopyable(v);
-            }, cpgf::fromVariant<UniversalType>(value));
-        }
-        return ToBaseTypeId(GetPinType(index));
+        return GetOutputBaseValue(OutputPinsBeginIndex(), value);
     } else {
         throw EngineError("gs::Node::GetValueForPreview: not found output pins for draw node (id = {})", m_id);
     }
@@ -528,6 +594,23 @@ void Node::DrawGraph(IDraw* drawer) {
     }
 }
 
+void Node::DrawCollapsedGraph(IDraw* drawer) {
+    std::vector<IDraw::Pin> inputPins;
+    inputPins.reserve(InputPinsCount());
+    for (uint8_t i=InputPinsBeginIndex(); i!=InputPinsEndIndex(); ++i) {
+        inputPins.emplace_back(IDraw::Pin{ static_cast<uintptr_t>(m_pins[i].id), IsConnectedPin(i), std::string_view() });
+    }
+
+    std::vector<IDraw::Pin> outputPins;
+    outputPins.reserve(OutputPinsCount());
+    for (uint8_t i=OutputPinsBeginIndex(); i!=OutputPinsEndIndex(); ++i) {
+        outputPins.emplace_back(IDraw::Pin{ static_cast<uintptr_t>(m_pins[i].id), IsConnectedPin(i), std::string_view() });
+    }
+
+    drawer->OnDrawCollapsedNode(static_cast<uintptr_t>(m_id), m_class->GetDisplayName(), inputPins, outputPins,
+        (m_validFlags == ValidFlags::Valid));
+}
+
 void Node::DrawNodePreview(IDraw* drawer) {
     cpgf::GVariant value;
     TypeId valueTypeId = GetValueForPreview(value);
@@ -0,0 +1,161 @@
+#include "middleware/gschema/graph/gs_result_cache.h"
+
+#include <variant>
+#include <utility>
+
+#include "core/common/hash.h"
+#include "middleware/gschema/graph/gs_id.h"
+#include "middleware/gschema/graph/gs_node.h"
+#include "middleware/gschema/graph/gs_types.h"
+
+
+namespace gs {
+
+namespace {
+
+// the object of std::make_shared: the counters and the pointer to the virtual table
+constexpr const size_t SharedBlockSize = 3 * sizeof(void*);
+// the nodes of the list and of the index
+constexpr const size_t EntryOverhead = 6 * sizeof(void*);
+
+// memory of the objects owned by the value over sizeof(T): the shared functors of the generators,
+// the state captured by the functors over the small buffer of std::function is unknown
+template<typename T> size_t CalcOwnedMemory([[maybe_unused]] const T& value) {
+    if constexpr (IsGenerator<T>) {
+        size_t result = sizeof(typename T::Functor) + SharedBlockSize;
+        if (value.HasGradient()) {
+            result += sizeof(typename T::GradientFunctor) + SharedBlockSize;
+        }
+        if (value.HasBounds()) {
+            result += sizeof(typename T::BoundsFunctor) + SharedBlockSize;
+        }
+        return result;
+    }
+
+    return 0;
+}
+
+size_t HashKey(const std::vector<uint64_t>& key) noexcept {
+    size_t hash = 0;
+    HashCombine(hash, key.data(), key.size());
+
+    return hash;
+}
+
+}
+
+ResultCache::ResultCache(size_t maxEntries, size_t maxMemory)
+    : m_maxEntries(maxEntries)
+    , m_maxMemory(maxMemory) {
+
+    m_index.reserve(maxEntries);
+}
+
+uint64_t ResultCache::Restore(const std::vector<uint64_t>& key, uint64_t currentId, Pin* outputPins, uint8_t count) {
+    auto it = m_index.find(HashKey(key));
+    if ((it == m_index.cend()) || (it->second->key != key) || (it->second->values.size() != count)) {
+        ++m_misses;
+        return 0;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    const auto& entry = *it->second;
+    // the pins already have these values
+    if (entry.id == currentId) {
+        return entry.id;
+    }
+
+    ++m_hits;
+    for (uint8_t i=0; i!=count; ++i) {
+        outputPins[i].cachedValue = entry.values[i].value;
+        outputPins[i].typeId = entry.values[i].typeId;
+    }
+
+    return entry.id;
+}
+
+uint64_t ResultCache::Insert(const std::vector<uint64_t>& key, const Pin* outputPins, uint8_t count) {
+    if (m_maxEntries == 0) {
+        return 0;
+    }
+
+    size_t memory = sizeof(Entry) + EntryOverhead + key.size() * sizeof(uint64_t) + count * sizeof(Value);
+    for (uint8_t i=0; i!=count; ++i) {
+        memory += CalcValueMemory(outputPins[i].cachedValue, outputPins[i].typeId, IsUniversalTypeFromPinId(outputPins[i].id));
+    }
+    if (memory > m_maxMemory) {
+        return 0;
+    }
+
+    // the entry with the same key or with the collision of the hash is replaced
+    const size_t hash = HashKey(key);
+    if (auto it = m_index.find(hash); it != m_index.cend()) {
+        m_memory -= it->second->memory;
+        m_entries.erase(it->second);
+        m_index.erase(it);
+    }
+
+    Entry entry{m_nextId++, hash, memory, key, {}};
+    entry.values.reserve(count);
+    for (uint8_t i=0; i!=count; ++i) {
+        entry.values.push_back(Value{outputPins[i].cachedValue, outputPins[i].typeId});
+    }
+
+    const uint64_t id = entry.id;
+    m_entries.push_front(std::move(entry));
+    m_index[hash] = m_entries.begin();
+    m_memory += memory;
+    Evict();
+
+    return id;
+}
+
+void ResultCache::Clear() {
+    m_entries.clear();
+    m_index.clear();
+    m_memory = 0;
+}
+
+ResultCacheCounters ResultCache::GetCounters() const noexcept {
+    ResultCacheCounters counters;
+    counters.hits = m_hits;
+    counters.misses = m_misses;
+    counters.evictions = m_evictions;
+    counters.entries = m_index.size();
+    counters.memory = m_memory;
+
+    return counters;
+}
+
+size_t ResultCache::CalcValueMemory(const cpgf::GVariant& value, TypeId typeId, bool isUniversal) {
+    if (value.isEmpty()) {
+        return 0;
+    }
+
+    if (isUniversal) {
+        return sizeof(UniversalType) + std::visit([](const auto& v) -> size_t {
+            return CalcOwnedMemory(v);
+        }, cpgf::fromVariant<UniversalType>(value));
+    }
+
+    switch (ToBaseTypeId(typeId)) {
+    case TypeId::Generator2d:
+        return GetTypeSize(TypeId::Generator2d) + CalcOwnedMemory(cpgf::fromVariant<math::Generator2D>(value));
+    case TypeId::Generator3d:
+        return GetTypeSize(TypeId::Generator3d) + CalcOwnedMemory(cpgf::fromVariant<math::Generator3D>(value));
+    default:
+        return GetTypeSize(ToBaseTypeId(typeId));
+    }
+}
+
+void ResultCache::Evict() {
+    while ((m_index.size() > m_maxEntries) || (m_memory > m_maxMemory)) {
+        const Entry& entry = m_entries.back();
+        m_memory -= entry.memory;
+        m_index.erase(entry.hash);
+        m_entries.pop_back();
+        ++m_evictions;
+    }
+}
+
+}
@@ -81,4 +81,23 @@ bool IsEnableUI(TypeId typeId) {
     );
 }
 
+size_t GetTypeSize(TypeId typeId) {
+    switch (ToBaseTypeId(typeId)) {
+    case TypeId::Float:
+        return sizeof(float);
+    case TypeId::Vector2f:
+        return sizeof(Eigen::Vector2f);
+    case TypeId::Vector3f:
+        return sizeof(Eigen::Vector3f);
+    case TypeId::Vector4f:
+        return sizeof(Eigen::Vector4f);
+    case TypeId::Generator2d:
+        return sizeof(math::Generator2D);
+    case TypeId::Generator3d:
+        return sizeof(math::Generator3D);
+    default:
+        return 0;
+    }
+}
+
 }
@@ -1,15 +1,20 @@
 #include "middleware/gschema/meta/gs_meta_class.h"
 
+#include <new>
+
 #include "core/common/exception.h"
 #include "middleware/gschema/meta/gs_meta_property.h"
 
 
 namespace gs {
 
-MetaClass::MetaClass(TCtor ctor, TDtor dtor, std::string_view name, std::string_view displayName, MetaClass* baseClass)
+MetaClass::MetaClass(TCtor ctor, TDtor dtor, size_t instanceSize, size_t instanceAlignment,
+    std::string_view name, std::string_view displayName, MetaClass* baseClass)
     : m_baseClass(baseClass)
     , m_ctor(ctor)
     , m_dtor(dtor)
+    , m_instanceSize(instanceSize)
+    , m_instanceAlignment(instanceAlignment)
     , m_name(name.cbegin(), name.cend())
     , m_displayName(displayName.cbegin(), displayName.cend()) {
 
@@ -34,10 +39,27 @@ MetaClass::~MetaClass() {
 }
 
 void* MetaClass::CreateInstance() const {
-    return m_ctor();
+    void* memory = ::operator new(m_instanceSize, std::align_val_t(m_instanceAlignment));
+    try {
+        return m_ctor(memory);
+    } catch(...) {
+        ::operator delete(memory, std::align_val_t(m_instanceAlignment));
+        throw;
+    }
 }
 
 void MetaClass::DestroyInstance(void* instance) const {
+    if (instance != nullptr) {
+        m_dtor(instance);
+        ::operator delete(instance, std::align_val_t(m_instanceAlignment));
+    }
+}
+
+void* MetaClass::ConstructInstance(void* memory) const {
+    return m_ctor(memory);
+}
+
+void MetaClass::DestructInstance(void* instance) const {
     if (instance != nullptr) {
         m_dtor(instance);
     }
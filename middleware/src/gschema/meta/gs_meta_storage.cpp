@@ -1,5 +1,7 @@
 #include "middleware/gschema/meta/gs_meta_storage.h"
 
+#include <mutex>
+#include <atomic>
 #include <string>
 #include <utility>
 #include <string_view>
@@ -17,6 +19,10 @@ struct MetaStorage::Impl : Fixed {
     Impl() = default;
     ~Impl();
 
+    void CheckNotFrozen(std::string_view method) const;
+
+    std::atomic<bool> m_frozen = false;
+    std::once_flag m_defineOnce;
     std::vector<TDefineCallback> m_defineTypesFuncs;
     std::vector<TDefineCallback> m_defineClassesFuncs;
     std::unordered_map<std::type_index, MetaType*> m_types;
@@ -40,6 +46,12 @@ MetaStorage::Impl::~Impl() {
     }
 }
 
+void MetaStorage::Impl::CheckNotFrozen(std::string_view method) const {
+    if (m_frozen.load(std::memory_order_acquire)) {
+        throw EngineError("gs::MetaStorage::{}: storage is frozen after RunDefineCallbacks", method);
+    }
+}
+
 MetaStorage::MetaStorage() {
 }
 
@@ -47,22 +59,31 @@ MetaStorage::~MetaStorage() {
 }
 
 void MetaStorage::AddDefineTypesCallback(TDefineCallback func) {
+    impl->CheckNotFrozen("AddDefineTypesCallback");
     impl->m_defineTypesFuncs.push_back(func);
 }
 
 void MetaStorage::AddDefineClassesCallback(TDefineCallback func) {
+    impl->CheckNotFrozen("AddDefineClassesCallback");
     impl->m_defineClassesFuncs.push_back(func);
 }
 
 void MetaStorage::RunDefineCallbacks() {
-    for (auto& func: impl->m_defineTypesFuncs) {
-        func();
-    }
-    for (auto& func: impl->m_defineClassesFuncs) {
-        func();
-    }
-    impl->m_defineTypesFuncs.clear();
-    impl->m_defineClassesFuncs.clear();
+    std::call_once(impl->m_defineOnce, [this] {
+        for (auto& func: impl->m_defineTypesFuncs) {
+            func();
+        }
+        for (auto& func: impl->m_defineClassesFuncs) {
+            func();
+        }
+        impl->m_defineTypesFuncs.clear();
+        impl->m_defineClassesFuncs.clear();
+        impl->m_frozen.store(true, std::memory_order_release);
+    });
+}
+
+bool MetaStorage::IsFrozen() const noexcept {
+    return impl->m_frozen.load(std::memory_order_acquire);
 }
 
 MetaClass* MetaStorage::GetBaseClass(std::type_index id) const {
@@ -74,6 +95,7 @@ MetaClass* MetaStorage::GetBaseClass(std::type_index id) const {
 }
 
 void MetaStorage::AddBaseClass(std::type_index id, MetaClass* metaClass) {
+    impl->CheckNotFrozen("AddBaseClass");
     if (!metaClass->IsBaseClass()) {
         throw EngineError("gs::MetaStorage::AddBaseClass: MetaClass with name = {} is not base class", id.name());
     }
@@ -104,6 +126,7 @@ MetaClass* MetaStorage::GetClass(std::type_index id) const {
 }
 
 void MetaStorage::AddClass(std::type_index id, MetaClass* metaClass) {
+    impl->CheckNotFrozen("AddClass");
     if (metaClass->IsBaseClass()) {
         throw EngineError("gs::MetaStorage::AddBaseClass: MetaClass with name = {} is base class", id.name());
     }
@@ -130,6 +153,7 @@ MetaType* MetaStorage::GetType(std::type_index id) const {
 }
 
 void MetaStorage::AddType(std::type_index id, MetaType* metaType) {
+    impl->CheckNotFrozen("AddType");
     if (impl->m_types.find(id) != impl->m_types.cend()) {
         throw EngineError("gs::MetaStorage::AddType: MetaType with name = {} already exists by id", id.name());
     }
@@ -146,6 +170,7 @@ MetaEnum* MetaStorage::GetEnum(std::type_index id) const {
 }
 
 void MetaStorage::AddEnum(std::type_index id, MetaEnum* metaEnum) {
+    impl->CheckNotFrozen("AddEnum");
     if (impl->m_enums.find(id) != impl->m_enums.cend()) {
         throw EngineError("gs::MetaStorage::AddEnum: MetaEnum with name = {} already exists by id", id.name());
     }
@@ -61,6 +61,28 @@ IPrimitiveType* TypeInstance::GetValue(size_t index) const {
     return m_compositeType->GetItemValue(index);
 }
 
+void TypeInstance::ValueToBits(const cpgf::GVariant& value, std::vector<uint64_t>& fields) const {
+    if (IsPrimitiveType()) {
+        fields.push_back(m_primitiveType->ValueToBits(value));
+        return;
+    }
+
+    const size_t offset = fields.size();
+    fields.resize(offset + m_compositeType->CountItem());
+    m_compositeType->ValueToBits(value, fields.data() + offset);
+}
+
+cpgf::GVariant TypeInstance::ValueFromBits(const uint64_t* fields, size_t count) const {
+    if (count != Count()) {
+        throw EngineError("gs::TypeInstance::ValueFromBits: wrong fields count = {}, expected = {}", count, Count());
+    }
+    if (IsPrimitiveType()) {
+        return m_primitiveType->ValueFromBits(fields[0]);
+    }
+
+    return m_compositeType->ValueFromBits(fields);
+}
+
 TypeInstanceEdit::TypeInstanceEdit(IPrimitiveTypeEdit* primitiveType)
     : TypeInstance(primitiveType, nullptr) {
 
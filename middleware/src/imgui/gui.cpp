@@ -2,7 +2,9 @@
 
 #include <string>
 #include <cfloat>
+#include <vector>
 #include <cstring>
+#include <utility>
 #include <iterator>
 #include <algorithm>
 #include <filesystem>
@@ -10,7 +12,9 @@
 #include "dg/math.h"
 #include "dg/device.h"
 #include "dg/context.h"
+#include "core/engine.h"
 #include "imgui/imgui.h"
+#include "core/path/path.h"
 #include "core/math/types.h"
 #include "platforms/platforms.h"
 #include "middleware/imgui/font.h"
@@ -59,6 +63,24 @@ float4 main(in PSInput psIn) : SV_TARGET {
 }
 )";
 
+namespace {
+
+// the font is read from the mapped file, the atlas doesn't own the data, the view keeps it alive
+ImFont* AddFontFromMappedFile(const std::filesystem::path& path, float sizePixels, ImFontConfig config, const ImWchar* glyphRanges, std::vector<FileView>& files) {
+    FileView view;
+    if (!Engine::Get().GetFileManager()->MapFile(path, view) || view.IsEmpty()) {
+        return nullptr;
+    }
+
+    config.FontDataOwnedByAtlas = false;
+    auto* font = ImGui::GetIO().Fonts->AddFontFromMemoryTTF(const_cast<char*>(view.Chars()), static_cast<int>(view.Size()), sizePixels, &config, glyphRanges);
+    files.push_back(std::move(view));
+
+    return font;
+}
+
+}
+
 namespace gui {
 
 Gui::Gui(const DevicePtr& device, const ContextPtr& context, dg::TEXTURE_FORMAT backBufferFormat, dg::TEXTURE_FORMAT depthBufferFormat, const std::shared_ptr<RenderWindow>& window)
@@ -423,8 +445,6 @@ void Gui::ApplyTheme() {
 }
 
 void Gui::CreateFonts() {
-    ImGuiIO& io = ImGui::GetIO();
-
     // if (io.Fonts->AddFontDefault() == nullptr) {
     //     throw EngineError("failed to load a default font");
     // }
@@ -434,8 +454,9 @@ void Gui::CreateFonts() {
         config.OversampleH = 3;
         config.OversampleV = 1;
         config.PixelSnapH = false;
-        const auto bFontPath = std::filesystem::current_path() / "assets" / "fonts" / "bfont.ttf";
-        if (io.Fonts->AddFontFromFileTTF(bFontPath.c_str(), 18.0f, nullptr, nullptr) == nullptr) {
+        // the relative path is resolved through the mounted archives and directories, then the current directory
+        const auto bFontPath = std::filesystem::path("assets") / "fonts" / "bfont.ttf";
+        if (AddFontFromMappedFile(bFontPath, 18.0f, ImFontConfig(), nullptr, m_fontFiles) == nullptr) {
             throw EngineError("failed to load a font {}", bFontPath.c_str());
         }
     }
@@ -445,8 +466,8 @@ void Gui::CreateFonts() {
         config.MergeMode = true;
         config.PixelSnapH = true;
         static const ImWchar iconRanges[] = { startUsedRange, stopUsedRange, 0 };
-        const auto faSolid900Path = std::filesystem::current_path() / "assets" / "fonts" / "fa-solid-900.ttf";
-        if (io.Fonts->AddFontFromFileTTF(faSolid900Path.c_str(), 13.0f, &config, iconRanges) == nullptr) {
+        const auto faSolid900Path = std::filesystem::path("assets") / "fonts" / "fa-solid-900.ttf";
+        if (AddFontFromMappedFile(faSolid900Path, 13.0f, config, iconRanges, m_fontFiles) == nullptr) {
             throw EngineError("failed to load a font {}", faSolid900Path.c_str());
         }
     }
@@ -23,6 +23,11 @@ static uint64_t BaseColorTextureMask() {
     return value;
 }
 
+static uint64_t BaseColorTextureArrayMask() {
+    static auto value = Engine::Get().GetMaterialBuilder()->GetShaderMask("BASE_COLOR_TEXTURE_ARRAY");
+    return value;
+}
+
 static uint64_t AlphaTestMask() {
     static auto value = Engine::Get().GetMaterialBuilder()->GetShaderMask("ALPHA_TEST");
     return value;
@@ -110,8 +115,23 @@ void StdMaterial::SetBaseTexture(TextureViewPtr& texture) {
 
     m_baseTexture = texture;
     if (!texture) {
-        AddAndRemoveFlag(BaseColorMaterialMask(), BaseColorTextureMask());
-    } else if (!AddAndRemoveFlag(BaseColorTextureMask(), BaseColorMaterialMask())) {
+        AddAndRemoveFlag(BaseColorMaterialMask(), BaseColorTextureMask() | BaseColorTextureArrayMask());
+    } else if (!AddAndRemoveFlag(BaseColorTextureMask(), BaseColorMaterialMask() | BaseColorTextureArrayMask())) {
+        SetPixelShaderVar("texBase", m_baseTexture);
+    }
+}
+
+void StdMaterial::SetBaseTextureArray(TextureViewPtr& texture, const TextureArraySlot& slot) {
+    m_data.texRect = dg::float4(slot.uvRect.x, slot.uvRect.y, slot.uvRect.w, slot.uvRect.h);
+    m_data.texSlice = static_cast<float>(slot.slice);
+    if (m_baseTexture == texture) {
+        return;
+    }
+
+    m_baseTexture = texture;
+    if (!texture) {
+        AddAndRemoveFlag(BaseColorMaterialMask(), BaseColorTextureMask() | BaseColorTextureArrayMask());
+    } else if (!AddAndRemoveFlag(BaseColorTextureArrayMask(), BaseColorMaterialMask() | BaseColorTextureMask())) {
         SetPixelShaderVar("texBase", m_baseTexture);
     }
 }
@@ -175,7 +195,7 @@ void StdMaterial::OnAfterCreateView(MaterialView& view) {
         view.SetPixelShaderVar("Material", m_buffer);
     }
 
-    if ((mask & BaseColorTextureMask()) != 0) {
+    if ((mask & (BaseColorTextureMask() | BaseColorTextureArrayMask())) != 0) {
         view.SetPixelShaderVar("texBase", m_baseTexture);
     }
 }
@@ -183,7 +203,7 @@ void StdMaterial::OnAfterCreateView(MaterialView& view) {
 void StdMaterial::ApplyMask(uint64_t mask) {
     SetShadersMask(mask);
 
-    auto materialEnableFlags = (AlphaTestMask() | BaseColorMaterialMask());
+    auto materialEnableFlags = (AlphaTestMask() | BaseColorMaterialMask() | BaseColorTextureArrayMask());
     m_dataEnable = ((mask & materialEnableFlags) != 0);
 
     if (m_dataEnable && (!m_buffer)) {
@@ -200,7 +220,7 @@ void StdMaterial::ApplyMask(uint64_t mask) {
         AddShaderVar(m_materialVarId);
     }
 
-    if ((mask & BaseColorTextureMask()) != 0) {
+    if ((mask & (BaseColorTextureMask() | BaseColorTextureArrayMask())) != 0) {
         AddShaderVar(m_baseTextureVarId);
     }
 }
@@ -1,7 +1,9 @@
 #include "middleware/std_render/std_scene.h"
 
+#include <cmath>
 #include <vector>
 #include <cstddef>
+#include <cstring>
 
 #include "dg/dg.h"
 #include "dg/device.h"
@@ -17,6 +19,9 @@
 #include "core/material/material_builder.h"
 
 
+// the matrices of the instances are copied to the per instance vertex buffer as is
+static_assert(sizeof(InstanceMatrices) == sizeof(dg::float4x4) + sizeof(dg::float3x3));
+
 StdScene::StdScene()
     : Scene()
     , m_renderTarget(new RenderTarget(Engine::Get().GetDevice(), Engine::Get().GetContext(), Engine::Get().GetSwapChain(), Engine::Get().GetMaterialBuilder())) {
@@ -115,6 +120,11 @@ void StdScene::Update(uint32_t width, uint32_t height) {
     }
 
     auto targetsId = m_renderTarget->Update(countColorTargets, width, height);
+    float lodScale = 0.f;
+    if (m_lodPixelError > 0) {
+        lodScale = static_cast<float>(m_renderTarget->GetHeight()) / (2.f * std::tan(m_camera->GetFovY() * 0.5f) * m_lodPixelError);
+    }
+    SetLodParams(m_camera->GetPosition(), lodScale);
     TransformUpdateDesc& updateDesc = Scene::Update(targetsId, vDeclIdPerInstance, findNodeId);
     if (findNodeId != 0) {
         m_pickerResult = updateDesc.findResult;
@@ -122,7 +132,12 @@ void StdScene::Update(uint32_t width, uint32_t height) {
     }
     auto& nodeList = updateDesc.nodeList;
 
-    auto needBufferSize = static_cast<uint32_t>(nodeList.size()) * itemSize;
+    size_t instanceCount = 0;
+    for (const auto& node: nodeList) {
+        instanceCount += node.GetInstanceCount();
+    }
+
+    auto needBufferSize = static_cast<uint32_t>(instanceCount * itemSize);
     if (!m_transformBuffer || (m_transformBufferBufferSize < needBufferSize)) {
         m_transformBufferBufferSize = (static_cast<uint32_t>(needBufferSize >> uint32_t(16)) + uint32_t(1)) << uint32_t(16);
         m_transformBuffer = std::make_shared<WriteableVertexBuffer>(device, m_transformBufferBufferSize, dg::USAGE_DYNAMIC, "transform vb");
@@ -130,11 +145,31 @@ void StdScene::Update(uint32_t width, uint32_t height) {
 
     uint8_t* data = m_transformBuffer->Map<uint8_t>(context);
     for (const auto& node: nodeList) {
-        *reinterpret_cast<dg::float4x4*>(data) = node.worldMatrix;
-        data += sizeof(dg::float4x4);
-        *reinterpret_cast<dg::float3x3*>(data) = node.normalMatrix;
-        data += sizeof(dg::float3x3);
-        if (countColorTargets == 2) {
+        if (node.instances == nullptr) {
+            *reinterpret_cast<dg::float4x4*>(data) = node.worldMatrix;
+            data += sizeof(dg::float4x4);
+            *reinterpret_cast<dg::float3x3*>(data) = node.normalMatrix;
+            data += sizeof(dg::float3x3);
+            if (countColorTargets == 2) {
+                *reinterpret_cast<uint32_t*>(data) = node.id;
+                data += sizeof(uint32_t);
+            }
+            continue;
+        }
+
+        // the matrices are expanded by the node, only for the changed instances
+        if (countColorTargets == 1) {
+            const size_t size = node.instances->size() * sizeof(InstanceMatrices);
+            std::memcpy(data, node.instances->data(), size);
+            data += size;
+            continue;
+        }
+
+        for (const auto& instance: *node.instances) {
+            *reinterpret_cast<dg::float4x4*>(data) = instance.world;
+            data += sizeof(dg::float4x4);
+            *reinterpret_cast<dg::float3x3*>(data) = instance.normal;
+            data += sizeof(dg::float3x3);
             *reinterpret_cast<uint32_t*>(data) = node.id;
             data += sizeof(uint32_t);
         }
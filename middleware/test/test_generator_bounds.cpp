@@ -0,0 +1,96 @@
+#include <random>
+#include <cstdint>
+
+#include "test/test.h"
+#include "core/math/generator_type.h"
+#include "core/math/generator_type_operators.h"
+#include "middleware/generator/texture/perlin.h"
+#include "middleware/generator/texture/spheres.h"
+#include "middleware/generator/texture/cylinders.h"
+#include "middleware/generator/texture/chess_cubes.h"
+#include "middleware/generator/mesh/iso_surface_shape.h"
+
+
+namespace {
+
+using Interval = math::Interval<double>;
+
+// the samples inside the random boxes must be inside the bounds of the box
+void ExpectConservative(const math::Generator3D& generator, double maxBoxSize) {
+    ASSERT_TRUE(generator.HasBounds());
+
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> position(-3., 3.);
+    std::uniform_real_distribution<double> size(0., maxBoxSize);
+    std::uniform_real_distribution<double> factor(0., 1.);
+    for (uint32_t i=0; i!=200; ++i) {
+        Interval box[3];
+        for (auto& v: box) {
+            v.lower = position(gen);
+            v.upper = v.lower + size(gen);
+        }
+        const auto bounds = generator.Bounds(box[0], box[1], box[2]);
+        for (uint32_t j=0; j!=50; ++j) {
+            const double x = box[0].lower + (box[0].upper - box[0].lower) * factor(gen);
+            const double y = box[1].lower + (box[1].upper - box[1].lower) * factor(gen);
+            const double z = box[2].lower + (box[2].upper - box[2].lower) * factor(gen);
+            const double value = generator(x, y, z);
+            ASSERT_GE(value, bounds.lower);
+            ASSERT_LE(value, bounds.upper);
+        }
+    }
+}
+
+TEST(GeneratorBounds, Primitives) {
+    Spheres spheres;
+    spheres.SetFrequency(1.5f);
+    ExpectConservative(spheres.Result(), 0.5);
+    Cylinders cylinders;
+    ExpectConservative(cylinders.Result(), 0.5);
+    ChessCubes chessCubes;
+    chessCubes.SetFrequency(2.f);
+    ExpectConservative(chessCubes.Result(), 0.4);
+    Perlin perlin;
+    ExpectConservative(perlin.Result(), 2.);
+    ExpectConservative(std::min(spheres.Result(), perlin.Result() + 0.5), 0.5);
+}
+
+TEST(GeneratorBounds, NarrowBox) {
+    Spheres spheres;
+    // the distance from the origin is in [0.1, 0.2], the wave decreases from 1 at the center
+    const auto bounds = spheres.Result().Bounds(Interval{0.1, 0.2}, Interval{0., 0.}, Interval{0., 0.});
+    EXPECT_NEAR(bounds.lower, 1. - 4. * 0.2, 1e-12);
+    EXPECT_NEAR(bounds.upper, 1. - 4. * 0.1, 1e-12);
+
+    ChessCubes chessCubes;
+    const auto cube = chessCubes.Result().Bounds(Interval{0.1, 0.9}, Interval{0.1, 0.9}, Interval{0.1, 0.9});
+    EXPECT_DOUBLE_EQ(cube.lower, cube.upper);
+}
+
+TEST(GeneratorBounds, IsoSurfaceSkipsChunks) {
+    // ball with the radius 1 from the spheres wave, carved by the noise
+    Spheres spheres;
+    spheres.SetFrequency(0.25f);
+    Perlin perlin;
+    perlin.SetOctaveCount(2);
+    const auto input = std::min(spheres.Result(), perlin.Result() + 0.5);
+
+    IsoSurfaceDesc desc;
+    desc.origin = dg::float3(-2.f, -2.f, -2.f);
+    desc.size = dg::float3(4.f, 4.f, 4.f);
+    desc.cells = dg::uint3(48, 48, 48);
+    desc.chunkSize = 8;
+    desc.threadCount = 2;
+    IsoSurfaceShape withBounds(desc);
+    withBounds.Generate(input);
+    desc.useBounds = false;
+    IsoSurfaceShape withoutBounds(desc);
+    withoutBounds.Generate(input);
+
+    EXPECT_GT(withBounds.GetSkippedChunkCount(), 0);
+    EXPECT_EQ(withoutBounds.GetSkippedChunkCount(), 0);
+    EXPECT_EQ(withBounds.LenghtVertex(), withoutBounds.LenghtVertex());
+    EXPECT_EQ(withBounds.LenghtIndex(), withoutBounds.LenghtIndex());
+}
+
+}
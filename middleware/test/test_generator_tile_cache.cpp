@@ -0,0 +1,185 @@
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+#include "test/test.h"
+#include "core/math/generator_type.h"
+#include "middleware/generator/texture/texel_baker.h"
+#include "middleware/generator/texture/generator_tile_cache.h"
+
+
+namespace {
+
+constexpr const uint32_t TileSize = 16;
+constexpr const size_t TileMemory = TileSize * TileSize * sizeof(float);
+
+math::Generator2D Wave() {
+    return math::Generator2D([](double x, double y) { return std::sin(x * 0.7) * std::cos(y * 0.3); });
+}
+
+GeneratorTileCacheDesc MakeDesc(size_t maxTiles) {
+    GeneratorTileCacheDesc desc;
+    desc.maxMemory = maxTiles * TileMemory;
+    desc.tileSize = TileSize;
+
+    return desc;
+}
+
+std::vector<float> SampleDirect(const math::Generator2D& input, const TileLattice& lattice, uint32_t lod, int32_t x, int32_t y, math::Size size) {
+    const double step = lattice.step * static_cast<double>(1u << lod);
+    std::vector<float> result;
+    for (uint32_t j=0; j!=size.h; ++j) {
+        for (uint32_t i=0; i!=size.w; ++i) {
+            const double u = lattice.originX + static_cast<double>(x + static_cast<int32_t>(i)) * step;
+            const double v = lattice.originY + static_cast<double>(y + static_cast<int32_t>(j)) * step;
+            result.push_back(static_cast<float>(input(u, v)));
+        }
+    }
+
+    return result;
+}
+
+TEST(GeneratorTileCache, HitsAndMisses) {
+    GeneratorTileCache cache(MakeDesc(100));
+    const auto input = Wave();
+    const TileLattice lattice{-5., 3., 0.125};
+    const math::Size size(40, 20);
+    std::vector<float> samples(size.w * size.h);
+
+    // [-10, 30) * [-5, 15) - 3 * 2 tiles, with negative tile coordinates
+    cache.Sample(input, lattice, 0, -10, -5, size, samples.data());
+    ASSERT_EQ(samples, SampleDirect(input, lattice, 0, -10, -5, size));
+    auto counters = cache.GetCounters();
+    ASSERT_EQ(counters.hits, 0);
+    ASSERT_EQ(counters.misses, 6);
+    ASSERT_EQ(counters.tiles, 6);
+    ASSERT_EQ(counters.memory, 6 * TileMemory);
+
+    std::vector<float> cached(size.w * size.h);
+    cache.Sample(input, lattice, 0, -10, -5, size, cached.data());
+    ASSERT_EQ(cached, samples);
+    counters = cache.GetCounters();
+    ASSERT_EQ(counters.hits, 6);
+    ASSERT_EQ(counters.misses, 6);
+
+    // other generator and other lattice
+    cache.Sample(Wave(), lattice, 0, 0, 0, math::Size(1, 1), cached.data());
+    cache.Sample(input, TileLattice{-5., 3., 0.25}, 0, 0, 0, math::Size(1, 1), cached.data());
+    ASSERT_EQ(cache.GetCounters().misses, 8);
+
+    cache.Invalidate(input);
+    ASSERT_EQ(cache.GetCounters().tiles, 1);
+    cache.Clear();
+    ASSERT_EQ(cache.GetCounters().tiles, 0);
+    ASSERT_EQ(cache.GetCounters().memory, 0);
+}
+
+TEST(GeneratorTileCache, Downsample) {
+    GeneratorTileCache cache(MakeDesc(100));
+    const auto input = Wave();
+    const TileLattice lattice{0.5, -1., 0.1};
+
+    // 4 * 4 tiles of LOD 0 cover tile (-1, 0) of LOD 2
+    std::vector<float> samples(64 * 64);
+    cache.Sample(input, lattice, 0, -64, 0, math::Size(64, 64), samples.data());
+    ASSERT_EQ(cache.GetCounters().misses, 16);
+
+    const auto tile = cache.GetTile(input, lattice, -1, 0, 2);
+    auto counters = cache.GetCounters();
+    ASSERT_EQ(counters.downsampled, 1);
+    ASSERT_EQ(counters.tiles, 17);
+    // bit to bit equal to the sampling of LOD 2
+    ASSERT_EQ(*tile, SampleDirect(input, lattice, 2, -16, 0, math::Size(TileSize, TileSize)));
+
+    // the finer tiles of tile (0, 0) are not in the cache
+    cache.GetTile(input, lattice, 0, 0, 1);
+    ASSERT_EQ(cache.GetCounters().downsampled, 1);
+}
+
+TEST(GeneratorTileCache, Eviction) {
+    GeneratorTileCache cache(MakeDesc(3));
+    const auto input = Wave();
+    const TileLattice lattice;
+
+    cache.GetTile(input, lattice, 0, 0, 0);
+    cache.GetTile(input, lattice, 1, 0, 0);
+    cache.GetTile(input, lattice, 2, 0, 0);
+    // tile 0 becomes the most recently used, so tile 1 is evicted
+    cache.GetTile(input, lattice, 0, 0, 0);
+    cache.GetTile(input, lattice, 3, 0, 0);
+    auto counters = cache.GetCounters();
+    ASSERT_EQ(counters.evictions, 1);
+    ASSERT_EQ(counters.tiles, 3);
+    ASSERT_EQ(counters.memory, 3 * TileMemory);
+
+    cache.GetTile(input, lattice, 0, 0, 0);
+    ASSERT_EQ(cache.GetCounters().hits, 2);
+    cache.GetTile(input, lattice, 1, 0, 0);
+    ASSERT_EQ(cache.GetCounters().misses, 5);
+
+    // the evicted tile is still alive for its users
+    auto tile = cache.GetTile(input, lattice, 10, 0, 0);
+    cache.Clear();
+    ASSERT_EQ(tile->size(), TileSize * TileSize);
+}
+
+TEST(GeneratorTileCache, Threads) {
+    GeneratorTileCache cache(MakeDesc(1000));
+    const auto input = Wave();
+    const TileLattice lattice{0, 0, 0.05};
+    const math::Size size(100, 100);
+    const auto expected = SampleDirect(input, lattice, 1, -50, -50, size);
+
+    std::vector<std::vector<float>> results(4, std::vector<float>(size.w * size.h));
+    std::vector<std::thread> threads;
+    for (size_t i=0; i!=results.size(); ++i) {
+        threads.emplace_back([&cache, &input, &lattice, &results, size, i]() {
+            for (uint32_t repeat=0; repeat!=3; ++repeat) {
+                cache.Sample(input, lattice, 1, -50, -50, size, results[i].data());
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    for (const auto& result: results) {
+        ASSERT_EQ(result, expected);
+    }
+    const auto counters = cache.GetCounters();
+    ASSERT_EQ(counters.tiles, 8 * 8);
+    ASSERT_EQ(counters.hits + counters.misses, 4 * 3 * 8 * 8);
+}
+
+TEST(GeneratorTileCache, TexelBaker) {
+    auto cache = std::make_shared<GeneratorTileCache>(MakeDesc(1000));
+    const auto input = Wave();
+    const math::RectF rect(-5.f, -5.f, 10.f, 10.f);
+    const TileLattice lattice{-5., -5., 10. / 128.};
+
+    TexelBaker full;
+    full.SetCache(cache, lattice);
+    full.Bake(input, rect, math::Size(128, 128));
+    ASSERT_EQ(cache->GetCounters().downsampled, 0);
+
+    // LOD 2 is downsampled from the samples of the full bake
+    TexelBaker preview;
+    preview.SetCache(cache, lattice);
+    preview.Bake(input, rect, math::Size(32, 32));
+    ASSERT_EQ(cache->GetCounters().downsampled, 4);
+
+    TexelBaker sampled;
+    sampled.SetCache(std::make_shared<GeneratorTileCache>(MakeDesc(1000)), lattice);
+    sampled.Bake(input, rect, math::Size(32, 32));
+    ASSERT_EQ(std::vector<uint32_t>(preview.GetTexels(), preview.GetTexels() + 32 * 32),
+        std::vector<uint32_t>(sampled.GetTexels(), sampled.GetTexels() + 32 * 32));
+
+    // the rect isn't aligned to the lattice, the input is sampled directly
+    const auto counters = cache->GetCounters();
+    preview.Bake(input, math::RectF(-4.99f, -5.f, 10.f, 10.f), math::Size(32, 32));
+    ASSERT_EQ(cache->GetCounters().misses, counters.misses);
+}
+
+}
@@ -0,0 +1,216 @@
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "test/test.h"
+#include "core/math/types.h"
+#include "middleware/gschema/graph/gs_graph.h"
+#include "middleware/gschema/editor/gs_draw.h"
+#include "middleware/gschema/graph/gs_class_storage.h"
+#include "middleware/gschema/graph/gs_draw_interface.h"
+
+
+namespace {
+
+// records what Graph::DrawGraph draws, the levels of detail are set by the test
+class RecordDraw final : public gs::IDraw {
+public:
+    void OnStartDrawGraph() final {}
+    void OnFinishDrawGraph() final {}
+
+    NodeLod GetNodeLod(uintptr_t id) final {
+        lodRequests.push_back(id);
+        auto it = lods.find(id);
+        return (it != lods.cend()) ? it->second : NodeLod::Full;
+    }
+    void OnDrawCollapsedNode(uintptr_t id, std::string_view displayName, const std::vector<Pin>& inputPins,
+        const std::vector<Pin>& outputPins, bool /* isValid */) final {
+        collapsedNodes.push_back(id);
+        hasNodeNames = hasNodeNames && !displayName.empty();
+        for (const auto& pins: {inputPins, outputPins}) {
+            for (const auto& pin: pins) {
+                hasPinNames = hasPinNames || !pin.displayName.empty();
+            }
+        }
+    }
+
+    void OnStartDrawNode(uintptr_t id, std::string_view /* displayName */) final {
+        fullNodes.push_back(id);
+    }
+    void OnFinishDrawNode(bool /* isValid */, std::string_view /* errorMessage */) final {}
+
+    void OnDrawInputPins(const std::vector<Pin>& /* pins */) final {}
+    void OnDrawMiniPreview(gs::TypeId /* valueTypeId */, const cpgf::GVariant& /* value */, uint8_t /* valueVersion */) final {}
+    void OnDrawOutputPins(const std::vector<Pin>& /* pins */) final {}
+    void OnDrawLink(uintptr_t linkId, uintptr_t /* srcPinId */, uintptr_t /* dstPinId */) final {
+        links.push_back(static_cast<uint64_t>(linkId));
+    }
+    void OnDrawNodeProfile(const gs::NodeProfile& /* profile */) final {}
+
+    void OnDrawFullPreview(uint16_t /* nodeId */, gs::TypeId /* valueTypeId */, const cpgf::GVariant& /* value */, uint8_t /* valueVersion */) final {}
+
+    void OnStartDrawNodeProperty(std::string_view /* displayName */) final {}
+    ButtonsState OnDrawPinProperty(std::string_view /* displayName */, gs::TypeInstance* /* typeInstance */, bool /* disabled */) final {
+        return ButtonsState::None;
+    }
+    void OnFinishDrawNodeProperty() final {}
+
+    void Clear() {
+        lodRequests.clear();
+        collapsedNodes.clear();
+        fullNodes.clear();
+        links.clear();
+        hasNodeNames = true;
+        hasPinNames = false;
+    }
+
+public:
+    std::unordered_map<uintptr_t, NodeLod> lods;
+    std::vector<uintptr_t> lodRequests;
+    std::vector<uintptr_t> collapsedNodes;
+    std::vector<uintptr_t> fullNodes;
+    std::vector<uint64_t> links;
+    // for the collapsed nodes
+    bool hasNodeNames = true;
+    bool hasPinNames = false;
+};
+
+class GSDrawGraphSuite : public ::testing::Test {
+protected:
+    GSDrawGraphSuite() = default;
+    ~GSDrawGraphSuite() = default;
+
+    // constant -> add1 -> add2 -> add3, add1 input 1 <- constant
+    void SetUp() final {
+        m_graph = std::make_unique<gs::Graph>(std::make_shared<gs::ClassStorage>(), 16);
+        m_constantId = m_graph->AddNode("Constant");
+        m_add1Id = m_graph->AddNode("Add");
+        m_add2Id = m_graph->AddNode("Add");
+        m_add3Id = m_graph->AddNode("Add");
+        m_constantToAdd1 = m_graph->AddLink(m_constantId, 0, m_add1Id, 0);
+        m_constantToAdd1Second = m_graph->AddLink(m_constantId, 0, m_add1Id, 1);
+        m_add1ToAdd2 = m_graph->AddLink(m_add1Id, 0, m_add2Id, 0);
+        m_add2ToAdd3 = m_graph->AddLink(m_add2Id, 0, m_add3Id, 0);
+    }
+
+    std::unique_ptr<gs::Graph> m_graph;
+    uint16_t m_constantId = 0;
+    uint16_t m_add1Id = 0;
+    uint16_t m_add2Id = 0;
+    uint16_t m_add3Id = 0;
+    uint64_t m_constantToAdd1 = 0;
+    uint64_t m_constantToAdd1Second = 0;
+    uint64_t m_add1ToAdd2 = 0;
+    uint64_t m_add2ToAdd3 = 0;
+};
+
+TEST_F(GSDrawGraphSuite, AllVisible) {
+    RecordDraw drawer;
+    m_graph->DrawGraph(&drawer);
+
+    ASSERT_EQ(std::vector<uintptr_t>({m_constantId, m_add1Id, m_add2Id, m_add3Id}), drawer.lodRequests);
+    ASSERT_EQ(std::vector<uintptr_t>({m_constantId, m_add1Id, m_add2Id, m_add3Id}), drawer.fullNodes);
+    ASSERT_TRUE(drawer.collapsedNodes.empty());
+    ASSERT_EQ(4, drawer.links.size());
+}
+
+TEST_F(GSDrawGraphSuite, RemovedNodesAreNotRequested) {
+    m_graph->RemoveNode(m_add3Id);
+    RecordDraw drawer;
+    m_graph->DrawGraph(&drawer);
+
+    ASSERT_EQ(std::vector<uintptr_t>({m_constantId, m_add1Id, m_add2Id}), drawer.lodRequests);
+    ASSERT_EQ(std::vector<uintptr_t>({m_constantId, m_add1Id, m_add2Id}), drawer.fullNodes);
+    ASSERT_EQ(3, drawer.links.size());
+}
+
+TEST_F(GSDrawGraphSuite, CullHiddenNodes) {
+    RecordDraw drawer;
+    drawer.lods[m_add2Id] = gs::IDraw::NodeLod::Hidden;
+    drawer.lods[m_add3Id] = gs::IDraw::NodeLod::Hidden;
+    m_graph->DrawGraph(&drawer);
+
+    // add2 is linked to the visible add1, so it is drawn collapsed to keep the link attached,
+    // add3 is linked only to the hidden add2, it is culled together with its link
+    ASSERT_EQ(std::vector<uintptr_t>({m_constantId, m_add1Id}), drawer.fullNodes);
+    ASSERT_EQ(std::vector<uintptr_t>({m_add2Id}), drawer.collapsedNodes);
+    ASSERT_EQ(std::vector<uint64_t>({m_constantToAdd1, m_constantToAdd1Second, m_add1ToAdd2}), drawer.links);
+}
+
+TEST_F(GSDrawGraphSuite, CullHiddenSourceNode) {
+    RecordDraw drawer;
+    drawer.lods[m_constantId] = gs::IDraw::NodeLod::Hidden;
+    drawer.lods[m_add1Id] = gs::IDraw::NodeLod::Hidden;
+    m_graph->DrawGraph(&drawer);
+
+    // the hidden source of the visible add2 is drawn collapsed, the source of the hidden add1 is culled
+    ASSERT_EQ(std::vector<uintptr_t>({m_add2Id, m_add3Id}), drawer.fullNodes);
+    ASSERT_EQ(std::vector<uintptr_t>({m_add1Id}), drawer.collapsedNodes);
+    ASSERT_EQ(std::vector<uint64_t>({m_add1ToAdd2, m_add2ToAdd3}), drawer.links);
+}
+
+TEST_F(GSDrawGraphSuite, AllHidden) {
+    RecordDraw drawer;
+    for (const uint16_t nodeId: {m_constantId, m_add1Id, m_add2Id, m_add3Id}) {
+        drawer.lods[nodeId] = gs::IDraw::NodeLod::Hidden;
+    }
+    m_graph->DrawGraph(&drawer);
+
+    ASSERT_TRUE(drawer.fullNodes.empty());
+    ASSERT_TRUE(drawer.collapsedNodes.empty());
+    ASSERT_TRUE(drawer.links.empty());
+}
+
+TEST_F(GSDrawGraphSuite, CollapsedNodes) {
+    RecordDraw drawer;
+    for (const uint16_t nodeId: {m_constantId, m_add1Id, m_add2Id, m_add3Id}) {
+        drawer.lods[nodeId] = gs::IDraw::NodeLod::Collapsed;
+    }
+    m_graph->DrawGraph(&drawer);
+
+    // collapsed nodes keep all links, the pins are anchors without names
+    ASSERT_TRUE(drawer.fullNodes.empty());
+    ASSERT_EQ(std::vector<uintptr_t>({m_constantId, m_add1Id, m_add2Id, m_add3Id}), drawer.collapsedNodes);
+    ASSERT_EQ(4, drawer.links.size());
+    ASSERT_TRUE(drawer.hasNodeNames);
+    ASSERT_FALSE(drawer.hasPinNames);
+
+    // the levels of detail are requested again on each frame
+    drawer.Clear();
+    drawer.lods.clear();
+    m_graph->DrawGraph(&drawer);
+    ASSERT_EQ(4, drawer.fullNodes.size());
+    ASSERT_TRUE(drawer.collapsedNodes.empty());
+}
+
+TEST(GSDrawNodeLod, CalcNodeLod) {
+    using NodeLod = gs::IDraw::NodeLod;
+    const math::RectF visibleRect(0.f, 0.f, 100.f, 100.f);
+    const bool fullZoom = false;
+    const bool collapsedZoom = true;
+
+    ASSERT_EQ(NodeLod::Full, gs::Draw::CalcNodeLod(math::RectF(10.f, 10.f, 20.f, 20.f), visibleRect, fullZoom));
+    ASSERT_EQ(NodeLod::Collapsed, gs::Draw::CalcNodeLod(math::RectF(10.f, 10.f, 20.f, 20.f), visibleRect, collapsedZoom));
+    // partially visible
+    ASSERT_EQ(NodeLod::Full, gs::Draw::CalcNodeLod(math::RectF(-10.f, 90.f, 20.f, 20.f), visibleRect, fullZoom));
+    ASSERT_EQ(NodeLod::Hidden, gs::Draw::CalcNodeLod(math::RectF(110.f, 10.f, 20.f, 20.f), visibleRect, fullZoom));
+    ASSERT_EQ(NodeLod::Hidden, gs::Draw::CalcNodeLod(math::RectF(10.f, -40.f, 20.f, 20.f), visibleRect, collapsedZoom));
+    // the node that was not drawn yet and the unknown viewport
+    ASSERT_EQ(NodeLod::Full, gs::Draw::CalcNodeLod(math::RectF(110.f, 10.f, 0.f, 0.f), visibleRect, collapsedZoom));
+    ASSERT_EQ(NodeLod::Full, gs::Draw::CalcNodeLod(math::RectF(110.f, 10.f, 20.f, 20.f), math::RectF(), collapsedZoom));
+}
+
+TEST(GSDrawNodeLod, IsCollapsedZoom) {
+    const math::RectF viewport(0.f, 0.f, 800.f, 600.f);
+    const float collapseZoom = 0.5f;
+
+    // 1 screen pixel per canvas unit
+    ASSERT_FALSE(gs::Draw::IsCollapsedZoom(viewport, math::RectF(-50.f, 20.f, 800.f, 600.f), collapseZoom));
+    // zoomed out to 0.4
+    ASSERT_TRUE(gs::Draw::IsCollapsedZoom(viewport, math::RectF(0.f, 0.f, 2000.f, 1500.f), collapseZoom));
+    ASSERT_FALSE(gs::Draw::IsCollapsedZoom(viewport, math::RectF(0.f, 0.f, 1600.f, 1200.f), collapseZoom));
+    ASSERT_FALSE(gs::Draw::IsCollapsedZoom(viewport, math::RectF(), collapseZoom));
+}
+
+}
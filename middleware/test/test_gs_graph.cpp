@@ -1,10 +1,13 @@
 #include <memory>
+#include <thread>
+#include <vector>
 #include <cstdint>
 #include <variant>
 
 #include "test/test.h"
 #include "eigen/core.h"
 #include "cpgf/variant.h"
+#include "middleware/gschema/graph/gs_id.h"
 #include "middleware/gschema/graph/gs_types.h"
 #include "middleware/gschema/graph/gs_graph.h"
 #include "middleware/gschema/graph/gs_class_storage.h"
@@ -271,4 +274,276 @@ TEST_F(GSGraphSuite, AcyclicityForThreeNodes) {
     ASSERT_ANY_THROW(graph.AddLink(nodeAddId1, 0, nodeAddId2, 0));
 }
 
+TEST_F(GSGraphSuite, AcyclicityWithoutPath) {
+    gs::Graph graph(m_classStorage, 16);
+
+    // order of nodeAddId2 is greater than order of nodeAddId3, but there is no path between them
+    uint16_t nodeAddId1 = graph.AddNode("Add");
+    uint16_t nodeAddId2 = graph.AddNode("Add");
+    uint16_t nodeAddId3 = graph.AddNode("Add");
+    uint16_t nodeAddId4 = graph.AddNode("Add");
+    graph.AddLink(nodeAddId1, 0, nodeAddId2, 0);
+    ASSERT_TRUE(graph.TestAddLink(nodeAddId2, 0, nodeAddId3, 0));
+    graph.AddLink(nodeAddId2, 0, nodeAddId3, 0);
+    graph.AddLink(nodeAddId4, 0, nodeAddId1, 0);
+    ASSERT_FALSE(graph.TestAddLink(nodeAddId3, 0, nodeAddId4, 0));
+    ASSERT_TRUE(graph.TestAddLink(nodeAddId4, 0, nodeAddId3, 1));
+}
+
+TEST_F(GSGraphSuite, AcyclicityForDeepChain) {
+    gs::Graph graph(m_classStorage, 16);
+
+    uint16_t firstNodeId = graph.AddNode("Add");
+    uint16_t lastNodeId = firstNodeId;
+    for (uint16_t i=0; i!=2000; ++i) {
+        uint16_t nodeAddId = graph.AddNode("Add");
+        graph.AddLink(lastNodeId, 0, nodeAddId, 0);
+        lastNodeId = nodeAddId;
+    }
+
+    ASSERT_FALSE(graph.TestAddLink(lastNodeId, 0, firstNodeId, 0));
+    ASSERT_FALSE(graph.TestAddLink(lastNodeId, 0, firstNodeId + 1, 1));
+    ASSERT_TRUE(graph.TestAddLink(firstNodeId, 0, lastNodeId, 1));
+    ASSERT_ANY_THROW(graph.AddLink(lastNodeId, 0, firstNodeId, 0));
+}
+
+TEST_F(GSGraphSuite, ValidateWithoutExceptions) {
+    gs::Graph graph(m_classStorage, 16);
+
+    uint16_t constantId = graph.AddNode("Constant");
+    uint16_t nodeAddId1 = graph.AddNode("Add");
+    uint16_t nodeAddId2 = graph.AddNode("Add");
+
+    ASSERT_EQ(gs::CheckResult::Ok, graph.ValidateRemoveNode(constantId));
+    ASSERT_EQ(gs::CheckResult::ZeroId, graph.ValidateRemoveNode(0));
+    ASSERT_EQ(gs::CheckResult::NodeIdOutOfRange, graph.ValidateRemoveNode(10000));
+
+    uint64_t linkId = graph.AddLink(nodeAddId1, 0, nodeAddId2, 0);
+    ASSERT_EQ(gs::CheckResult::Ok, graph.ValidateRemoveLink(linkId));
+    ASSERT_EQ(gs::CheckResult::ZeroId, graph.ValidateRemoveLink(0));
+
+    uint32_t srcPinId = gs::SrcPinIdFromLinkId(linkId);
+    uint32_t dstPinId = gs::DstPinIdFromLinkId(linkId);
+    ASSERT_EQ(gs::CheckResult::LinkExists, graph.ValidateAddLink(srcPinId, dstPinId));
+    ASSERT_EQ(gs::CheckResult::NotInputPin, graph.ValidateAddLink(srcPinId, srcPinId));
+    ASSERT_EQ(gs::CheckResult::NotOutputPin, graph.ValidateAddLink(dstPinId, dstPinId));
+
+    graph.RemoveLink(linkId);
+    ASSERT_EQ(gs::CheckResult::LinkNotExists, graph.ValidateRemoveLink(linkId));
+    ASSERT_FALSE(graph.TestRemoveLink(linkId));
+
+    graph.RemoveNode(nodeAddId2);
+    ASSERT_EQ(gs::CheckResult::NodeRemoved, graph.ValidateRemoveNode(nodeAddId2));
+    ASSERT_EQ(gs::CheckResult::NodeRemoved, graph.ValidateAddLink(srcPinId, dstPinId));
+}
+
+TEST_F(GSGraphSuite, ResultCache) {
+    gs::Graph graph(m_classStorage, 16);
+
+    uint16_t constantId = graph.AddNode("Constant");
+    uint16_t nodeAddId = graph.AddNode("Add");
+    graph.SetEmbeddedValue(constantId, 0, 2.f);
+    graph.SetInputValue(nodeAddId, 1, 1.f);
+    graph.AddLink(constantId, 0, nodeAddId, 0);
+    graph.EnableResultCache(16, 1024 * 1024);
+
+    graph.UpdateState();
+    ASSERT_VARIANT_FLOAT(3.f, graph.GetOutputValue(nodeAddId, 0));
+    ASSERT_EQ(0, graph.GetResultCacheCounters().hits);
+    ASSERT_EQ(2, graph.GetResultCacheCounters().misses);
+    ASSERT_EQ(2, graph.GetResultCacheCounters().entries);
+
+    graph.SetEmbeddedValue(constantId, 0, 5.f);
+    graph.UpdateState();
+    ASSERT_VARIANT_FLOAT(6.f, graph.GetOutputValue(nodeAddId, 0));
+    ASSERT_EQ(0, graph.GetResultCacheCounters().hits);
+    ASSERT_EQ(4, graph.GetResultCacheCounters().misses);
+
+    // back to the previous value: both nodes are taken from the cache
+    graph.SetEmbeddedValue(constantId, 0, 2.f);
+    graph.UpdateState();
+    ASSERT_VARIANT_FLOAT(3.f, graph.GetOutputValue(nodeAddId, 0));
+    ASSERT_EQ(2, graph.GetResultCacheCounters().hits);
+    ASSERT_EQ(4, graph.GetResultCacheCounters().misses);
+
+    // the same value: the cache is not used, the dependent node is not changed
+    graph.SetEmbeddedValue(constantId, 0, 2.f);
+    graph.UpdateState();
+    ASSERT_VARIANT_FLOAT(3.f, graph.GetOutputValue(nodeAddId, 0));
+    ASSERT_EQ(2, graph.GetResultCacheCounters().hits);
+    ASSERT_EQ(4, graph.GetResultCacheCounters().misses);
+}
+
+TEST_F(GSGraphSuite, ResultCacheEviction) {
+    gs::Graph graph(m_classStorage, 16);
+
+    uint16_t constantId = graph.AddNode("Constant");
+    graph.EnableResultCache(2, 1024 * 1024);
+    for (uint32_t i=0; i!=4; ++i) {
+        graph.SetEmbeddedValue(constantId, 0, static_cast<float>(i));
+        graph.UpdateState();
+    }
+    ASSERT_EQ(2, graph.GetResultCacheCounters().entries);
+    ASSERT_EQ(2, graph.GetResultCacheCounters().evictions);
+
+    // the least recently used value is evicted
+    graph.SetEmbeddedValue(constantId, 0, 0.f);
+    graph.UpdateState();
+    ASSERT_VARIANT_FLOAT(0.f, graph.GetOutputValue(constantId, 0));
+    ASSERT_EQ(0, graph.GetResultCacheCounters().hits);
+
+    graph.SetEmbeddedValue(constantId, 0, 3.f);
+    graph.UpdateState();
+    ASSERT_VARIANT_FLOAT(3.f, graph.GetOutputValue(constantId, 0));
+    ASSERT_EQ(1, graph.GetResultCacheCounters().hits);
+}
+
+TEST_F(GSGraphSuite, ResultCacheMemoryLimit) {
+    gs::Graph graph(m_classStorage, 16);
+
+    uint16_t constantId = graph.AddNode("Constant");
+    graph.EnableResultCache(16, 1024 * 1024);
+    graph.SetEmbeddedValue(constantId, 0, 1.f);
+    graph.UpdateState();
+    const size_t entryMemory = graph.GetResultCacheCounters().memory;
+    ASSERT_NE(0, entryMemory);
+
+    // only one entry fits into the limit
+    graph.EnableResultCache(16, entryMemory);
+    for (uint32_t i=0; i!=3; ++i) {
+        graph.SetEmbeddedValue(constantId, 0, static_cast<float>(i));
+        graph.UpdateState();
+    }
+    ASSERT_EQ(1, graph.GetResultCacheCounters().entries);
+    ASSERT_EQ(2, graph.GetResultCacheCounters().evictions);
+    ASSERT_EQ(entryMemory, graph.GetResultCacheCounters().memory);
+
+    // an entry over the limit is not inserted
+    graph.EnableResultCache(16, entryMemory - 1);
+    graph.UpdateState();
+    ASSERT_VARIANT_FLOAT(2.f, graph.GetOutputValue(constantId, 0));
+    ASSERT_EQ(0, graph.GetResultCacheCounters().entries);
+    ASSERT_EQ(0, graph.GetResultCacheCounters().memory);
+}
+
+// ValidateAddLink is const, it's called from several threads without the synchronization
+TEST_F(GSGraphSuite, ConcurrentValidateAddLink) {
+    gs::Graph graph(m_classStorage, 16);
+    constexpr const uint16_t count = 32;
+    constexpr const uint32_t threadsCount = 8;
+    constexpr const uint32_t iterations = 200;
+
+    uint16_t firstId = graph.AddNode("Constant");
+    uint16_t prevNodeId = firstId;
+    uint32_t firstAddInputPinId = 0;
+    for (uint16_t i=1; i!=count; ++i) {
+        uint16_t addId = graph.AddNode("Add");
+        const uint64_t linkId = graph.AddLink(prevNodeId, 0, addId, 0);
+        if (firstAddInputPinId == 0) {
+            firstAddInputPinId = gs::DstPinIdFromLinkId(linkId);
+        }
+        prevNodeId = addId;
+    }
+    // the node with the low order, a link to it from the last node doesn't make a cycle
+    uint16_t sideId = graph.AddNode("Add");
+    graph.AddLink(firstId, 0, sideId, 0);
+    const uint32_t sideInputPinId = gs::DstPinIdFromLinkId(graph.AddLink(firstId, 0, sideId, 1));
+    const uint32_t lastOutputPinId = gs::SrcPinIdFromLinkId(graph.AddLink(prevNodeId, 0, graph.AddNode("Add"), 0));
+
+    std::vector<uint32_t> errors(threadsCount, 0);
+    std::vector<std::thread> threads;
+    for (uint32_t i=0; i!=threadsCount; ++i) {
+        threads.emplace_back([&graph, &errors, i, firstAddInputPinId, sideInputPinId, lastOutputPinId] {
+            for (uint32_t it=0; it!=iterations; ++it) {
+                if (graph.ValidateAddLink(lastOutputPinId, firstAddInputPinId) != gs::CheckResult::Cycle) {
+                    ++errors[i];
+                }
+                if (graph.ValidateAddLink(lastOutputPinId, sideInputPinId) != gs::CheckResult::Ok) {
+                    ++errors[i];
+                }
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    for (uint32_t i=0; i!=threadsCount; ++i) {
+        ASSERT_EQ(0, errors[i]);
+    }
+}
+
+#if GS_PROFILE_ENABLE
+TEST_F(GSGraphSuite, NodeProfile) {
+    gs::Graph graph(m_classStorage, 16);
+
+    uint16_t constantId = graph.AddNode("Constant");
+    uint16_t nodeAddId = graph.AddNode("Add");
+    graph.AddLink(constantId, 0, nodeAddId, 0);
+    graph.SetEmbeddedValue(constantId, 0, 2.f);
+    graph.UpdateState();
+    graph.SetInputValue(nodeAddId, 1, 1.f);
+    graph.UpdateState();
+    // nothing is changed
+    graph.UpdateState();
+
+    ASSERT_EQ(1, graph.GetNodeProfile(constantId).evaluations);
+    ASSERT_EQ(2, graph.GetNodeProfile(nodeAddId).evaluations);
+    ASSERT_EQ(2 * sizeof(float), graph.GetNodeProfile(nodeAddId).outputBytes);
+    ASSERT_ANY_THROW(graph.GetNodeProfile(0));
+
+    graph.ResetProfiles();
+    ASSERT_EQ(0, graph.GetNodeProfile(nodeAddId).evaluations);
+    ASSERT_EQ(0, graph.GetNodeProfile(nodeAddId).totalTimeNs);
+}
+#endif
+
+TEST_F(GSGraphSuite, ArenaReusesMemory) {
+    gs::Graph graph(m_classStorage, 16);
+
+    uint16_t ids[16];
+    for (uint16_t i=0; i!=16; ++i) {
+        ids[i] = graph.AddNode((i % 2 == 0) ? "Add" : "Constant");
+    }
+    const auto countersBefore = graph.GetAllocationCounters();
+    ASSERT_EQ(1, countersBefore.nodeChunks);
+    ASSERT_EQ(16, countersBefore.pinAllocations);
+    ASSERT_EQ(16, countersBefore.instanceAllocations);
+
+    for (uint16_t i=0; i!=16; ++i) {
+        graph.RemoveNode(ids[i]);
+    }
+    for (uint16_t i=0; i!=16; ++i) {
+        graph.AddNode((i % 2 == 0) ? "Add" : "Constant");
+    }
+
+    // same classes are placed in the released memory
+    const auto countersAfter = graph.GetAllocationCounters();
+    ASSERT_EQ(countersBefore.nodeChunks, countersAfter.nodeChunks);
+    ASSERT_EQ(countersBefore.pinBlocks, countersAfter.pinBlocks);
+    ASSERT_EQ(countersBefore.instanceSlabs, countersAfter.instanceSlabs);
+    ASSERT_EQ(32, countersAfter.pinAllocations);
+    ASSERT_EQ(32, countersAfter.instanceAllocations);
+}
+
+TEST_F(GSGraphSuite, GrowByChunks) {
+    gs::Graph graph(m_classStorage, 1);
+
+    uint16_t nodeConstantId = graph.AddNode("Constant");
+    graph.SetEmbeddedValue(nodeConstantId, 0, 2.f);
+    uint16_t prevNodeId = nodeConstantId;
+    for (uint16_t i=0; i!=200; ++i) {
+        uint16_t nodeAddId = graph.AddNode("Add");
+        graph.AddLink(prevNodeId, 0, nodeAddId, 0);
+        graph.SetInputValue(nodeAddId, 1, 1.f);
+        prevNodeId = nodeAddId;
+    }
+    ASSERT_EQ(201, graph.CountNodes());
+    ASSERT_EQ(4, graph.GetAllocationCounters().nodeChunks);
+
+    graph.UpdateState();
+    ASSERT_VARIANT_FLOAT(2.f, graph.GetOutputValue(nodeConstantId, 0));
+    ASSERT_VARIANT_FLOAT(202.f, graph.GetOutputValue(prevNodeId, 0));
+}
+
 }
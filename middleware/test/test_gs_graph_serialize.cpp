@@ -0,0 +1,113 @@
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <variant>
+#include <filesystem>
+
+#include "test/test.h"
+#include "eigen/core.h"
+#include "cpgf/variant.h"
+#include "middleware/gschema/graph/gs_types.h"
+#include "middleware/gschema/graph/gs_graph.h"
+#include "middleware/gschema/graph/gs_class_storage.h"
+
+
+#define ASSERT_VARIANT_FLOAT(expected, actual) do { \
+    const auto& tmpFloatValue = actual; \
+    ASSERT_FALSE(tmpFloatValue.isEmpty()); \
+    ASSERT_TRUE(cpgf::canFromVariant<gs::UniversalType>(tmpFloatValue)); \
+    ASSERT_FLOAT_EQ(expected, std::get<float>(cpgf::fromVariant<gs::UniversalType>(tmpFloatValue))); \
+    } while(false)
+
+namespace {
+
+class GSGraphSerializeSuite : public ::testing::Test {
+protected:
+    GSGraphSerializeSuite() = default;
+    ~GSGraphSerializeSuite() = default;
+
+    void SetUp() final {
+        m_classStorage = std::make_shared<gs::ClassStorage>();
+    }
+
+    std::shared_ptr<gs::ClassStorage> m_classStorage;
+};
+
+TEST_F(GSGraphSerializeSuite, RoundTrip) {
+    gs::Graph graph(m_classStorage, 4);
+
+    uint16_t removedId = graph.AddNode("Constant");
+    uint16_t constantId = graph.AddNode("Constant");
+    graph.SetEmbeddedValue(constantId, 0, 0.123456789f);
+    uint16_t addId1 = graph.AddNode("Add");
+    graph.SetInputValue(addId1, 1, 10.f);
+    graph.AddLink(constantId, 0, addId1, 0);
+    uint16_t addId2 = graph.AddNode("Add");
+    graph.AddLink(addId1, 0, addId2, 0);
+    graph.AddLink(constantId, 0, addId2, 1);
+    graph.RemoveNode(removedId);
+    graph.UpdateState();
+
+    std::vector<uint8_t> data;
+    graph.Save(data);
+
+    gs::Graph loaded(m_classStorage, 1);
+    loaded.Load(data.data(), data.size());
+    loaded.UpdateState();
+
+    ASSERT_EQ(graph.CountNodes(), loaded.CountNodes());
+    ASSERT_FALSE(loaded.TestRemoveNode(removedId));
+    ASSERT_VARIANT_FLOAT(0.123456789f, loaded.GetOutputValue(constantId, 0));
+    ASSERT_VARIANT_FLOAT(10.123456789f, loaded.GetOutputValue(addId1, 0));
+    ASSERT_VARIANT_FLOAT(10.24691358f, loaded.GetOutputValue(addId2, 0));
+
+    // the hole is reused by the next node
+    ASSERT_EQ(removedId, loaded.AddNode("Constant"));
+    loaded.RemoveNode(removedId);
+
+    std::vector<uint8_t> dataLoaded;
+    loaded.Save(dataLoaded);
+    ASSERT_EQ(data, dataLoaded);
+}
+
+TEST_F(GSGraphSerializeSuite, File) {
+    gs::Graph graph(m_classStorage, 16);
+    uint16_t constantId = graph.AddNode("Constant");
+    graph.SetEmbeddedValue(constantId, 0, 5.f);
+
+    const auto path = std::filesystem::temp_directory_path() / "test_gs_graph_serialize.gsgr";
+    graph.SaveToFile(path);
+
+    gs::Graph loaded(m_classStorage, 16);
+    loaded.LoadFromFile(path);
+    std::filesystem::remove(path);
+    loaded.UpdateState();
+
+    ASSERT_EQ(1, loaded.CountNodes());
+    ASSERT_VARIANT_FLOAT(5.f, loaded.GetOutputValue(constantId, 0));
+}
+
+TEST_F(GSGraphSerializeSuite, InvalidData) {
+    gs::Graph graph(m_classStorage, 16);
+    uint16_t constantId = graph.AddNode("Constant");
+    uint16_t addId = graph.AddNode("Add");
+    graph.AddLink(constantId, 0, addId, 0);
+
+    std::vector<uint8_t> data;
+    graph.Save(data);
+
+    gs::Graph loaded(m_classStorage, 16);
+    for (size_t size=0; size!=data.size(); ++size) {
+        ASSERT_ANY_THROW(loaded.Load(data.data(), size));
+        ASSERT_EQ(0, loaded.CountNodes());
+    }
+
+    auto wrongMagic = data;
+    wrongMagic[0] ^= 0xFF;
+    ASSERT_ANY_THROW(loaded.Load(wrongMagic.data(), wrongMagic.size()));
+
+    loaded.Load(data.data(), data.size());
+    ASSERT_EQ(2, loaded.CountNodes());
+}
+
+}
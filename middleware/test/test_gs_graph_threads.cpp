@@ -0,0 +1,144 @@
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <variant>
+
+#include "test/test.h"
+#include "cpgf/variant.h"
+#include "middleware/gschema/graph/gs_types.h"
+#include "middleware/gschema/graph/gs_class.h"
+#include "middleware/gschema/graph/gs_graph.h"
+#include "middleware/gschema/graph/gs_class_storage.h"
+
+
+// Stress tests for the concurrency guarantees of gs (see ClassStorage and Graph),
+// races are reported when the tests are built with TERRA_TSAN_ENABLE
+namespace {
+
+constexpr const uint32_t THREADS_COUNT = 8;
+
+float GetFloat(const cpgf::GVariant& value) {
+    if (value.isEmpty() || !cpgf::canFromVariant<gs::UniversalType>(value)) {
+        return -1.f;
+    }
+
+    return std::get<float>(cpgf::fromVariant<gs::UniversalType>(value));
+}
+
+// chain of adds: result = sum of (base + i) for i in [0, count).
+// With cacheAndReload the result cache hashes the input values and the graph is saved and loaded
+// on each iteration, both convert the values by the type instances of the shared ClassStorage,
+// the result of the reloaded graph is returned
+float UpdateChain(const std::shared_ptr<gs::ClassStorage>& classStorage, float base, uint16_t count, uint32_t iterations, bool cacheAndReload = false) {
+    gs::Graph graph(classStorage, 16);
+    if (cacheAndReload) {
+        graph.EnableResultCache(1024, 1 << 20);
+    }
+
+    std::vector<uint16_t> constantIds;
+    uint16_t prevNodeId = graph.AddNode("Constant");
+    constantIds.push_back(prevNodeId);
+    for (uint16_t i=1; i!=count; ++i) {
+        uint16_t constantId = graph.AddNode("Constant");
+        constantIds.push_back(constantId);
+        uint16_t addId = graph.AddNode("Add");
+        graph.AddLink(prevNodeId, 0, addId, 0);
+        graph.AddLink(constantId, 0, addId, 1);
+        prevNodeId = addId;
+    }
+
+    // values are changed on each iteration, the last one sets the expected values,
+    // the values are repeated for the result cache hits
+    float reloadedResult = -1.f;
+    for (uint32_t it=0; it!=iterations; ++it) {
+        const float delta = static_cast<float>((iterations - it - 1) % 4);
+        for (size_t i=0; i!=constantIds.size(); ++i) {
+            graph.SetEmbeddedValue(constantIds[i], 0, base + static_cast<float>(i) + delta);
+        }
+        graph.UpdateState();
+
+        if (cacheAndReload) {
+            std::vector<uint8_t> data;
+            graph.Save(data);
+            gs::Graph reloaded(classStorage, 16);
+            reloaded.Load(data.data(), data.size());
+            reloaded.UpdateState();
+            reloadedResult = GetFloat(reloaded.GetOutputValue(prevNodeId, 0));
+        }
+    }
+
+    if (cacheAndReload) {
+        return (graph.GetResultCacheCounters().hits != 0) ? reloadedResult : -1.f;
+    }
+
+    return GetFloat(graph.GetOutputValue(prevNodeId, 0));
+}
+
+TEST(GSGraphThreads, ConcurrentClassStorageCreate) {
+    std::vector<std::shared_ptr<gs::ClassStorage>> storages(THREADS_COUNT);
+    std::vector<std::thread> threads;
+    for (uint32_t i=0; i!=THREADS_COUNT; ++i) {
+        threads.emplace_back([&storages, i] {
+            storages[i] = std::make_shared<gs::ClassStorage>();
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    for (const auto& storage: storages) {
+        ASSERT_NE(nullptr, storage);
+        ASSERT_EQ(storages[0]->ClassesEnd() - storages[0]->ClassesBegin(), storage->ClassesEnd() - storage->ClassesBegin());
+    }
+}
+
+TEST(GSGraphThreads, ConcurrentUpdateWithSharedClassStorage) {
+    auto classStorage = std::make_shared<gs::ClassStorage>();
+    constexpr const uint16_t count = 32;
+    constexpr const uint32_t iterations = 50;
+
+    std::vector<float> results(THREADS_COUNT, 0.f);
+    std::vector<std::thread> threads;
+    for (uint32_t i=0; i!=THREADS_COUNT; ++i) {
+        threads.emplace_back([&classStorage, &results, i] {
+            results[i] = UpdateChain(classStorage, static_cast<float>(i), count, iterations);
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    for (uint32_t i=0; i!=THREADS_COUNT; ++i) {
+        // sum of (i + k), k in [0, count)
+        const float expected = static_cast<float>(i * count) + static_cast<float>(count * (count - 1) / 2);
+        ASSERT_FLOAT_EQ(expected, results[i]);
+        ASSERT_FLOAT_EQ(UpdateChain(classStorage, static_cast<float>(i), count, 1), results[i]);
+    }
+}
+
+
+TEST(GSGraphThreads, ConcurrentCacheAndReloadWithSharedClassStorage) {
+    auto classStorage = std::make_shared<gs::ClassStorage>();
+    constexpr const uint16_t count = 32;
+    constexpr const uint32_t iterations = 20;
+
+    std::vector<float> results(THREADS_COUNT, 0.f);
+    std::vector<std::thread> threads;
+    for (uint32_t i=0; i!=THREADS_COUNT; ++i) {
+        threads.emplace_back([&classStorage, &results, i] {
+            const bool cacheAndReload = true;
+            results[i] = UpdateChain(classStorage, static_cast<float>(i), count, iterations, cacheAndReload);
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    for (uint32_t i=0; i!=THREADS_COUNT; ++i) {
+        const float expected = static_cast<float>(i * count) + static_cast<float>(count * (count - 1) / 2);
+        ASSERT_FLOAT_EQ(expected, results[i]);
+    }
+}
+
+}
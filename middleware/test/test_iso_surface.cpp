@@ -0,0 +1,134 @@
+#include <map>
+#include <cmath>
+#include <tuple>
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+#include "test/test.h"
+#include "core/render/vertexes.h"
+#include "core/math/generator_type.h"
+#include "middleware/generator/mesh/iso_surface_shape.h"
+
+
+namespace {
+
+struct Mesh {
+    std::vector<VertexPNC> vertexes;
+    std::vector<uint32_t> indexes;
+};
+
+// solid ball with radius 0.7, the analytic gradient gives the exact normals
+math::Generator3D Ball() {
+    return math::Generator3D(
+        [](double x, double y, double z) -> double { return 0.7 - std::sqrt(x * x + y * y + z * z); },
+        [](double x, double y, double z) -> math::Gradient3<double> {
+            const double r = std::sqrt(x * x + y * y + z * z);
+            return math::Gradient3<double>{0.7 - r, -x / r, -y / r, -z / r};
+        });
+}
+
+IsoSurfaceDesc MakeDesc(uint32_t chunkSize, uint32_t threadCount) {
+    IsoSurfaceDesc desc;
+    desc.origin = dg::float3(-1.f, -1.f, -1.f);
+    desc.size = dg::float3(2.f, 2.f, 2.f);
+    desc.cells = dg::uint3(30, 27, 33);
+    desc.chunkSize = chunkSize;
+    desc.threadCount = threadCount;
+
+    return desc;
+}
+
+Mesh Generate(const IsoSurfaceDesc& desc, const math::Generator3D& input, uint32_t vertexStartIndex = 0) {
+    IsoSurfaceShape shape(desc);
+    shape.Generate(input);
+
+    Mesh mesh;
+    mesh.vertexes.resize(shape.LenghtVertex());
+    mesh.indexes.resize(shape.LenghtIndex());
+    shape.FillVertex(mesh.vertexes.data());
+    shape.FillIndex(mesh.indexes.data(), vertexStartIndex);
+
+    return mesh;
+}
+
+TEST(IsoSurfaceShape, Ball) {
+    const auto mesh = Generate(MakeDesc(8, 4), Ball());
+    ASSERT_FALSE(mesh.vertexes.empty());
+    ASSERT_EQ(mesh.indexes.size() % 3, 0);
+
+    for (const auto& v: mesh.vertexes) {
+        ASSERT_NEAR(dg::length(v.position), 0.7f, 0.01f);
+        ASSERT_NEAR(dg::dot(v.normal, v.position / dg::length(v.position)), 1.f, 1e-4f);
+    }
+
+    // triangles look outside
+    for (size_t i=0; i!=mesh.indexes.size(); i+=3) {
+        const auto& p0 = mesh.vertexes[mesh.indexes[i]].position;
+        const auto& p1 = mesh.vertexes[mesh.indexes[i + 1]].position;
+        const auto& p2 = mesh.vertexes[mesh.indexes[i + 2]].position;
+        ASSERT_GE(dg::dot(dg::cross(p1 - p0, p2 - p0), p0 + p1 + p2), 0.f);
+    }
+}
+
+TEST(IsoSurfaceShape, ClosedAndWelded) {
+    const auto mesh = Generate(MakeDesc(8, 4), Ball());
+
+    // every edge of a closed welded mesh is shared by two triangles with the opposite directions
+    std::map<std::pair<uint32_t, uint32_t>, int> edges;
+    for (size_t i=0; i!=mesh.indexes.size(); i+=3) {
+        for (size_t j=0; j!=3; ++j) {
+            ++edges[std::make_pair(mesh.indexes[i + j], mesh.indexes[i + (j + 1) % 3])];
+        }
+    }
+    for (const auto& [edge, count]: edges) {
+        ASSERT_EQ(count, 1);
+        ASSERT_EQ(edges.count(std::make_pair(edge.second, edge.first)), 1);
+    }
+}
+
+TEST(IsoSurfaceShape, ChunkSizeIndependent) {
+    const auto single = Generate(MakeDesc(64, 1), Ball());
+    const auto chunked = Generate(MakeDesc(7, 3), Ball());
+
+    ASSERT_EQ(single.vertexes.size(), chunked.vertexes.size());
+    ASSERT_EQ(single.indexes.size(), chunked.indexes.size());
+
+    // the same vertexes in the different order
+    std::map<std::tuple<float, float, float>, int> positions;
+    for (const auto& v: single.vertexes) {
+        ++positions[std::make_tuple(v.position.x, v.position.y, v.position.z)];
+    }
+    for (const auto& v: chunked.vertexes) {
+        --positions[std::make_tuple(v.position.x, v.position.y, v.position.z)];
+    }
+    for (const auto& [position, count]: positions) {
+        ASSERT_EQ(count, 0);
+    }
+}
+
+TEST(IsoSurfaceShape, VertexStartIndex) {
+    const auto base = Generate(MakeDesc(8, 1), Ball());
+    const auto shifted = Generate(MakeDesc(8, 1), Ball(), 100);
+    ASSERT_EQ(base.indexes.size(), shifted.indexes.size());
+    for (size_t i=0; i!=base.indexes.size(); ++i) {
+        ASSERT_EQ(base.indexes[i] + 100, shifted.indexes[i]);
+    }
+}
+
+TEST(IsoSurfaceShape, EmptyVolume) {
+    const auto mesh = Generate(MakeDesc(8, 2), math::Generator3D(-1.0));
+    ASSERT_TRUE(mesh.vertexes.empty());
+    ASSERT_TRUE(mesh.indexes.empty());
+}
+
+TEST(IsoSurfaceShape, InvalidDesc) {
+    auto desc = MakeDesc(0, 1);
+    ASSERT_ANY_THROW(IsoSurfaceShape shape(desc));
+
+    desc = MakeDesc(8, 1);
+    desc.cells = dg::uint3(0, 1, 1);
+    ASSERT_ANY_THROW(IsoSurfaceShape shape(desc));
+}
+
+}
@@ -0,0 +1,136 @@
+#include <array>
+#include <tuple>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "test/test.h"
+#include "core/render/vertexes.h"
+#include "middleware/generator/mesh/mesh_optimizer.h"
+#include "middleware/generator/mesh/uv_grid_generator.h"
+
+
+namespace {
+
+struct Mesh {
+    std::vector<VertexPNC> vertexes;
+    std::vector<uint32_t> indexes;
+};
+
+Mesh GenerateGrid(uint32_t segmentsX, uint32_t segmentsY) {
+    UVGridGenerator generator(dg::uint2(segmentsX, segmentsY));
+    Mesh mesh;
+    mesh.vertexes.resize(generator.LenghtVertex());
+    mesh.indexes.resize(generator.LenghtIndex());
+    generator.FillVertex(mesh.vertexes.data());
+    generator.FillIndex(mesh.indexes.data(), 0);
+    for (auto& v: mesh.vertexes) {
+        v.position = dg::float3(v.uv.x, 0, v.uv.y);
+        v.normal = dg::float3(0, 1.f, 0);
+    }
+
+    return mesh;
+}
+
+using Triangle = std::array<std::tuple<float, float, float>, 3>;
+
+// triangles by vertex positions with normalized rotation, the winding order is preserved
+std::vector<Triangle> GetTriangles(const Mesh& mesh) {
+    std::vector<Triangle> result;
+    for (size_t i=0; i!=mesh.indexes.size(); i+=3) {
+        Triangle triangle;
+        for (size_t k=0; k!=3; ++k) {
+            const auto& pos = mesh.vertexes[mesh.indexes[i + k]].position;
+            triangle[k] = std::make_tuple(pos.x, pos.y, pos.z);
+        }
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        result.push_back(triangle);
+    }
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+TEST(MeshOptimizer, Metrics) {
+    const std::vector<uint32_t> triangle = {0, 1, 2};
+    ASSERT_FLOAT_EQ(MeshOptimizer::CalcACMR(triangle.data(), triangle.size(), 16), 3.f);
+    ASSERT_FLOAT_EQ(MeshOptimizer::CalcATVR(triangle.data(), triangle.size(), 3, 16), 1.f);
+
+    const std::vector<uint32_t> quad = {0, 1, 2, 2, 1, 3};
+    ASSERT_FLOAT_EQ(MeshOptimizer::CalcACMR(quad.data(), quad.size(), 16), 2.f);
+    ASSERT_FLOAT_EQ(MeshOptimizer::CalcATVR(quad.data(), quad.size(), 4, 16), 1.f);
+
+    // cache size 3 evicts vertexes 0 and 1
+    const std::vector<uint32_t> fan = {0, 1, 2, 3, 2, 1, 0, 3, 1};
+    ASSERT_FLOAT_EQ(MeshOptimizer::CalcACMR(fan.data(), fan.size(), 3), 2.f);
+
+    ASSERT_FLOAT_EQ(MeshOptimizer::CalcACMR(nullptr, 0, 16), 0.f);
+    ASSERT_FLOAT_EQ(MeshOptimizer::CalcATVR(nullptr, 0, 0, 16), 0.f);
+}
+
+TEST(MeshOptimizer, VertexCache) {
+    auto mesh = GenerateGrid(64, 64);
+    const auto trianglesBefore = GetTriangles(mesh);
+    const float acmrBefore = MeshOptimizer::CalcACMR(mesh.indexes.data(), mesh.indexes.size(), 16);
+
+    MeshOptimizer::OptimizeVertexCache(mesh.indexes.data(), mesh.indexes.size(), mesh.vertexes.size());
+    const float acmrAfter = MeshOptimizer::CalcACMR(mesh.indexes.data(), mesh.indexes.size(), 16);
+
+    ASSERT_LT(acmrAfter, acmrBefore * 0.8f);
+    ASSERT_EQ(trianglesBefore, GetTriangles(mesh));
+}
+
+TEST(MeshOptimizer, Overdraw) {
+    auto mesh = GenerateGrid(32, 32);
+    MeshOptimizer::OptimizeVertexCache(mesh.indexes.data(), mesh.indexes.size(), mesh.vertexes.size());
+    const auto trianglesBefore = GetTriangles(mesh);
+    const float acmrBefore = MeshOptimizer::CalcACMR(mesh.indexes.data(), mesh.indexes.size(), 16);
+
+    const float threshold = 1.05f;
+    MeshOptimizer::OptimizeOverdraw(mesh.indexes.data(), mesh.indexes.size(), mesh.vertexes.data(), mesh.vertexes.size(), 16, threshold);
+    const float acmrAfter = MeshOptimizer::CalcACMR(mesh.indexes.data(), mesh.indexes.size(), 16);
+
+    ASSERT_LE(acmrAfter, acmrBefore * threshold);
+    ASSERT_EQ(trianglesBefore, GetTriangles(mesh));
+}
+
+TEST(MeshOptimizer, VertexFetch) {
+    auto mesh = GenerateGrid(8, 8);
+    // unused vertex
+    mesh.vertexes.insert(mesh.vertexes.begin(), mesh.vertexes.back());
+    for (auto& index: mesh.indexes) {
+        ++index;
+    }
+    std::reverse(mesh.indexes.begin(), mesh.indexes.end());
+    const auto trianglesBefore = GetTriangles(mesh);
+
+    MeshOptimizer::OptimizeVertexFetch(mesh.vertexes.data(), mesh.vertexes.size(), mesh.indexes.data(), mesh.indexes.size());
+
+    uint32_t nextIndex = 0;
+    for (const auto index: mesh.indexes) {
+        ASSERT_LE(index, nextIndex);
+        nextIndex = std::max(nextIndex, index + 1);
+    }
+    ASSERT_EQ(nextIndex + 1, mesh.vertexes.size());
+    ASSERT_EQ(trianglesBefore, GetTriangles(mesh));
+}
+
+TEST(MeshOptimizer, Optimize) {
+    auto mesh = GenerateGrid(48, 32);
+    auto meshCopy = GenerateGrid(48, 32);
+    const auto trianglesBefore = GetTriangles(mesh);
+
+    MeshOptimizer optimizer;
+    const auto stats = optimizer.Optimize(mesh.vertexes.data(), mesh.vertexes.size(), mesh.indexes.data(), mesh.indexes.size());
+    ASSERT_LT(stats.acmrAfter, stats.acmrBefore);
+    ASSERT_LT(stats.atvrAfter, stats.atvrBefore);
+    ASSERT_GE(stats.atvrAfter, 1.f);
+    ASSERT_EQ(trianglesBefore, GetTriangles(mesh));
+
+    // deterministic
+    optimizer.Optimize(meshCopy.vertexes.data(), meshCopy.vertexes.size(), meshCopy.indexes.data(), meshCopy.indexes.size());
+    ASSERT_EQ(mesh.indexes, meshCopy.indexes);
+    ASSERT_EQ(GetTriangles(mesh), GetTriangles(meshCopy));
+}
+
+}
@@ -0,0 +1,178 @@
+#include <cmath>
+#include <vector>
+#include <cstdint>
+
+#include "test/test.h"
+#include "core/render/vertexes.h"
+#include "middleware/generator/mesh/mesh_simplifier.h"
+#include "middleware/generator/mesh/uv_grid_generator.h"
+
+
+namespace {
+
+struct Mesh {
+    std::vector<VertexPNC> vertexes;
+    std::vector<uint32_t> indexes;
+};
+
+template<typename HeightFunc> Mesh GenerateGrid(uint32_t segments, HeightFunc&& heightFunc) {
+    UVGridGenerator generator(dg::uint2(segments, segments));
+    Mesh mesh;
+    mesh.vertexes.resize(generator.LenghtVertex());
+    mesh.indexes.resize(generator.LenghtIndex());
+    generator.FillVertex(mesh.vertexes.data());
+    generator.FillIndex(mesh.indexes.data(), 0);
+    for (auto& v: mesh.vertexes) {
+        v.position = dg::float3(v.uv.x, heightFunc(v.uv.x, v.uv.y), v.uv.y);
+        v.normal = dg::float3(0, 1.f, 0);
+    }
+
+    return mesh;
+}
+
+float NormalY(const Mesh& mesh, const uint32_t* tri) {
+    const auto& p0 = mesh.vertexes[tri[0]].position;
+    const auto& p1 = mesh.vertexes[tri[1]].position;
+    const auto& p2 = mesh.vertexes[tri[2]].position;
+
+    return (p1.z - p0.z) * (p2.x - p0.x) - (p1.x - p0.x) * (p2.z - p0.z);
+}
+
+// all triangles of the height map must look in the same direction as the source triangles
+bool IsFlipped(const Mesh& mesh, const uint32_t* indexes, size_t indexCount) {
+    const bool sourceSign = std::signbit(NormalY(mesh, mesh.indexes.data()));
+    for (size_t i=0; i!=indexCount; i+=3) {
+        const float ny = NormalY(mesh, &indexes[i]);
+        if ((std::abs(ny) > 0) && (std::signbit(ny) != sourceSign)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+TEST(MeshSimplifier, Plane) {
+    auto mesh = GenerateGrid(32, [](float, float) { return 0.f; });
+    ASSERT_FALSE(IsFlipped(mesh, mesh.indexes.data(), mesh.indexes.size()));
+
+    std::vector<uint32_t> result(mesh.indexes.size());
+    float error = 1.f;
+    const size_t targetIndexCount = mesh.indexes.size() / 10 / 3 * 3;
+    const size_t count = MeshSimplifier::Simplify(mesh.vertexes.data(), mesh.vertexes.size(), mesh.indexes.data(), mesh.indexes.size(),
+        result.data(), targetIndexCount, 0.01f, &error);
+
+    ASSERT_LE(count, targetIndexCount);
+    ASSERT_GT(count, 0);
+    ASSERT_EQ(count % 3, 0);
+    ASSERT_LE(error, 0.01f);
+    ASSERT_FALSE(IsFlipped(mesh, result.data(), count));
+    for (size_t i=0; i!=count; ++i) {
+        ASSERT_LT(result[i], mesh.vertexes.size());
+    }
+}
+
+TEST(MeshSimplifier, TargetError) {
+    auto mesh = GenerateGrid(48, [](float x, float z) { return 0.1f * std::sin(x * 12.f) * std::cos(z * 12.f); });
+
+    std::vector<uint32_t> result(mesh.indexes.size());
+    float error = 1.f;
+    const size_t count = MeshSimplifier::Simplify(mesh.vertexes.data(), mesh.vertexes.size(), mesh.indexes.data(), mesh.indexes.size(),
+        result.data(), 0, 0.005f, &error);
+
+    ASSERT_LT(count, mesh.indexes.size());
+    ASSERT_GT(count, 0);
+    ASSERT_LE(error, 0.005f);
+    ASSERT_FALSE(IsFlipped(mesh, result.data(), count));
+
+    // a zero error allows only the collapses without changing the surface
+    const size_t countZeroError = MeshSimplifier::Simplify(mesh.vertexes.data(), mesh.vertexes.size(), mesh.indexes.data(), mesh.indexes.size(),
+        result.data(), 0, 0.f, &error);
+    ASSERT_GE(countZeroError, count);
+}
+
+TEST(MeshSimplifier, ScaledMesh) {
+    auto mesh = GenerateGrid(48, [](float x, float z) { return 0.1f * std::sin(x * 12.f) * std::cos(z * 12.f); });
+    auto scaled = mesh;
+    // power of 2, the scaled positions are exact
+    const float scale = 16.f;
+    for (auto& v: scaled.vertexes) {
+        v.position *= scale;
+    }
+
+    std::vector<uint32_t> result(mesh.indexes.size());
+    std::vector<uint32_t> scaledResult(mesh.indexes.size());
+    float error = 1.f;
+    float scaledError = 1.f;
+    const size_t count = MeshSimplifier::Simplify(mesh.vertexes.data(), mesh.vertexes.size(), mesh.indexes.data(), mesh.indexes.size(),
+        result.data(), 0, 0.005f, &error);
+    const size_t scaledCount = MeshSimplifier::Simplify(scaled.vertexes.data(), scaled.vertexes.size(), scaled.indexes.data(), scaled.indexes.size(),
+        scaledResult.data(), 0, 0.005f, &scaledError);
+
+    // the relative error doesn't depend on the mesh scale
+    ASSERT_LT(count, mesh.indexes.size());
+    ASSERT_EQ(count, scaledCount);
+    ASSERT_FLOAT_EQ(error, scaledError);
+    ASSERT_LE(error, 0.005f);
+    ASSERT_GT(error, 0.f);
+
+    MeshLodDesc desc;
+    const auto lods = MeshSimplifier::BuildLods(mesh.vertexes.data(), mesh.vertexes.size(), mesh.indexes.data(), mesh.indexes.size(), desc);
+    const auto scaledLods = MeshSimplifier::BuildLods(scaled.vertexes.data(), scaled.vertexes.size(), scaled.indexes.data(), scaled.indexes.size(), desc);
+    ASSERT_FALSE(lods.empty());
+    ASSERT_EQ(lods.size(), scaledLods.size());
+    for (size_t i=0; i!=lods.size(); ++i) {
+        ASSERT_EQ(lods[i].indexes.size(), scaledLods[i].indexes.size());
+        // the absolute error is in the mesh space
+        ASSERT_FLOAT_EQ(lods[i].error * scale, scaledLods[i].error);
+    }
+}
+
+TEST(MeshSimplifier, Seams) {
+    auto mesh = GenerateGrid(16, [](float, float) { return 0.f; });
+    // duplicate the vertex with another uv
+    const uint32_t seamVertex = 17 * 8 + 8;
+    mesh.vertexes.push_back(mesh.vertexes[seamVertex]);
+    mesh.vertexes.back().uv = dg::float2(2.f, 2.f);
+    const auto duplicateVertex = static_cast<uint32_t>(mesh.vertexes.size() - 1);
+    for (size_t i=0; i!=mesh.indexes.size() / 2; ++i) {
+        if (mesh.indexes[i] == seamVertex) {
+            mesh.indexes[i] = duplicateVertex;
+        }
+    }
+
+    std::vector<uint32_t> result(mesh.indexes.size());
+    const size_t count = MeshSimplifier::Simplify(mesh.vertexes.data(), mesh.vertexes.size(), mesh.indexes.data(), mesh.indexes.size(),
+        result.data(), 0, 0.01f);
+
+    bool seamExists = false;
+    bool duplicateExists = false;
+    for (size_t i=0; i!=count; ++i) {
+        seamExists |= (result[i] == seamVertex);
+        duplicateExists |= (result[i] == duplicateVertex);
+    }
+    ASSERT_TRUE(seamExists);
+    ASSERT_TRUE(duplicateExists);
+}
+
+TEST(MeshSimplifier, BuildLods) {
+    auto mesh = GenerateGrid(64, [](float x, float z) { return 0.05f * std::sin(x * 6.f + z * 3.f); });
+
+    MeshLodDesc desc;
+    desc.maxLevels = 4;
+    desc.ratio = 0.5f;
+    desc.targetError = 0.05f;
+    const auto lods = MeshSimplifier::BuildLods(mesh.vertexes.data(), mesh.vertexes.size(), mesh.indexes.data(), mesh.indexes.size(), desc);
+
+    ASSERT_EQ(lods.size(), 3);
+    size_t prevCount = mesh.indexes.size();
+    float prevError = 0.f;
+    for (const auto& lod: lods) {
+        ASSERT_LE(lod.indexes.size(), prevCount / 2);
+        ASSERT_GE(lod.error, prevError);
+        ASSERT_FALSE(IsFlipped(mesh, lod.indexes.data(), lod.indexes.size()));
+        prevCount = lod.indexes.size();
+        prevError = lod.error;
+    }
+}
+
+}
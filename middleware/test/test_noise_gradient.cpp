@@ -0,0 +1,109 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+
+#include "test/test.h"
+#include "core/math/generator_type.h"
+#include "middleware/generator/texture/perlin.h"
+#include "middleware/generator/texture/spheres.h"
+#include "middleware/generator/texture/noise_types.h"
+#include "middleware/generator/texture/section_plane.h"
+#include "middleware/generator/texture/gradient_split.h"
+#include "middleware/generator/texture/normal_map_baker.h"
+
+
+namespace {
+
+math::Color4 ToColor(uint32_t texel) {
+    math::Color4 color;
+    color.value = texel;
+    return color;
+}
+
+// compares the analytic gradient with the central differences of a small step
+void ExpectNumericGradient(const math::Generator3D& generator) {
+    ASSERT_TRUE(generator.HasGradient());
+
+    constexpr double step = 1e-7;
+    for (int i=0; i!=200; ++i) {
+        const double x = 0.0137 * i - 3.1;
+        const double y = 0.0111 * i + 0.2;
+        const double z = -0.0123 * i + 1.3;
+        const auto g = generator.Gradient(x, y, z);
+        EXPECT_NEAR(g.value, generator(x, y, z), 1e-12);
+        EXPECT_NEAR(g.dx, (generator(x + step, y, z) - generator(x - step, y, z)) / (2. * step), 1e-4);
+        EXPECT_NEAR(g.dy, (generator(x, y + step, z) - generator(x, y - step, z)) / (2. * step), 1e-4);
+        EXPECT_NEAR(g.dz, (generator(x, y, z + step) - generator(x, y, z - step)) / (2. * step), 1e-4);
+    }
+}
+
+TEST(NoiseGradient, Perlin) {
+    for (auto quality: {NoiseQuality::BestSpeed, NoiseQuality::Default, NoiseQuality::BestQuality}) {
+        Perlin perlin;
+        perlin.SetFrequency(1.7);
+        perlin.SetOctaveCount(1);
+        perlin.SetQuality(quality);
+        ExpectNumericGradient(perlin.Result());
+    }
+
+    Perlin perlin;
+    perlin.SetOctaveCount(3);
+    ExpectNumericGradient(perlin.Result());
+}
+
+TEST(NoiseGradient, Spheres) {
+    Spheres spheres;
+    spheres.SetFrequency(2.f);
+    ExpectNumericGradient(spheres.Result());
+
+    const auto center = spheres.Result().Gradient(0, 0, 0);
+    EXPECT_DOUBLE_EQ(center.dx, 0.);
+    EXPECT_DOUBLE_EQ(center.value, 1.);
+}
+
+TEST(NoiseGradient, SectionPlaneAndSplit) {
+    Spheres spheres;
+    SectionPlaneX0Y sectionPlane;
+    sectionPlane.SetOffset(0.3f);
+    sectionPlane.SetInput(spheres.Result());
+    const auto plane = sectionPlane.Result();
+    ASSERT_TRUE(plane.HasGradient());
+
+    GradientSplit split;
+    split.SetInput(spheres.Result());
+    const auto g = plane.Gradient(0.2, -0.1);
+    const auto g3 = spheres.Result().Gradient(0.2, -0.1, static_cast<double>(0.3f));
+    EXPECT_DOUBLE_EQ(g.dx, g3.dx);
+    EXPECT_DOUBLE_EQ(g.dy, g3.dy);
+    EXPECT_DOUBLE_EQ(split.DX()(0.2, -0.1, static_cast<double>(0.3f)), g3.dx);
+    EXPECT_DOUBLE_EQ(split.DZ()(0.2, -0.1, static_cast<double>(0.3f)), g3.dz);
+}
+
+TEST(NoiseGradient, NormalMapModesMatch) {
+    Perlin perlin;
+    perlin.SetOctaveCount(2);
+    SectionPlaneX0Y sectionPlane;
+    sectionPlane.SetInput(perlin.Result());
+
+    NormalMapBakerDesc desc;
+    desc.region = math::RectF(-0.2f, 0.1f, 0.25f, 0.25f);
+    desc.size = math::Size(64, 64);
+    desc.heightScale = 0.5f;
+    NormalMapBaker analytic(desc);
+    analytic.Bake(sectionPlane.Result());
+    desc.mode = NormalMapMode::FiniteDifferences;
+    NormalMapBaker numeric(desc);
+    numeric.Bake(sectionPlane.Result());
+
+    // the half texel step of the finite differences gives a small error
+    for (size_t i=0; i!=64 * 64; ++i) {
+        const auto a = ToColor(analytic.GetTexels()[i]);
+        const auto b = ToColor(numeric.GetTexels()[i]);
+        EXPECT_LE(std::abs(static_cast<int>(a.red) - static_cast<int>(b.red)), 2);
+        EXPECT_LE(std::abs(static_cast<int>(a.green) - static_cast<int>(b.green)), 2);
+        EXPECT_EQ(a.alpha, b.alpha);
+    }
+}
+
+}
@@ -0,0 +1,123 @@
+#include <cmath>
+#include <vector>
+#include <cstdint>
+
+#include "test/test.h"
+#include "core/math/generator_type.h"
+#include "middleware/generator/scatter/scatter.h"
+
+
+namespace {
+
+ScatterDesc MakeDesc(uint32_t threadCount) {
+    ScatterDesc desc;
+    desc.region = math::RectF(-20.f, -10.f, 40.f, 30.f);
+    desc.minDistance = 1.f;
+    desc.tileSize = 8.f;
+    desc.minScale = 0.5f;
+    desc.maxScale = 1.f;
+    desc.seed = 7;
+    desc.threadCount = threadCount;
+
+    return desc;
+}
+
+bool IsEqual(const std::vector<InstanceTransform>& a, const std::vector<InstanceTransform>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i=0; i!=a.size(); ++i) {
+        if ((a[i].position != b[i].position) || std::islessgreater(a[i].scale, b[i].scale) || std::islessgreater(a[i].angleY, b[i].angleY)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+math::Generator2D LeftHalfDensity() {
+    return math::Generator2D([](double x, double) -> double { return (x < 0) ? 1. : 0.; });
+}
+
+TEST(Scatter, MinDistance) {
+    Scatter scatter(MakeDesc(4));
+    ASSERT_EQ(scatter.GetTileCountX(), 5);
+    ASSERT_EQ(scatter.GetTileCountY(), 4);
+    ASSERT_EQ(scatter.Update(), 20);
+
+    const auto& instances = scatter.GetInstances();
+    const auto& region = scatter.GetDesc().region;
+    // Poisson-disk set with minDistance = 1 covers more than 0.5 points per unit
+    ASSERT_GT(instances.size(), static_cast<size_t>(region.w * region.h * 0.5f));
+    for (size_t i=0; i!=instances.size(); ++i) {
+        const auto& p = instances[i].position;
+        ASSERT_GE(p.x, region.Left());
+        ASSERT_LT(p.x, region.Right());
+        ASSERT_GE(p.z, region.Top());
+        ASSERT_LT(p.z, region.Bottom());
+        ASSERT_GE(instances[i].scale, 0.5f);
+        ASSERT_LE(instances[i].scale, 1.f);
+        for (size_t j=i + 1; j!=instances.size(); ++j) {
+            const auto d = instances[j].position - p;
+            ASSERT_GE(d.x * d.x + d.z * d.z, 1.f);
+        }
+    }
+}
+
+TEST(Scatter, Deterministic) {
+    Scatter scatter1(MakeDesc(1));
+    Scatter scatter4(MakeDesc(4));
+    scatter1.Update();
+    scatter4.Update();
+    ASSERT_TRUE(IsEqual(scatter1.GetInstances(), scatter4.GetInstances()));
+
+    auto desc = MakeDesc(4);
+    desc.seed = 8;
+    Scatter scatterOtherSeed(desc);
+    scatterOtherSeed.Update();
+    ASSERT_FALSE(IsEqual(scatter1.GetInstances(), scatterOtherSeed.GetInstances()));
+}
+
+TEST(Scatter, Density) {
+    Scatter scatter(MakeDesc(0));
+    scatter.Update();
+    const size_t fullCount = scatter.GetInstances().size();
+
+    scatter.SetDensity(math::Generator2D(0.5));
+    scatter.Update();
+    const size_t halfCount = scatter.GetInstances().size();
+    ASSERT_GT(halfCount, fullCount / 4);
+    ASSERT_LT(halfCount, fullCount * 3 / 4);
+
+    scatter.SetDensity(math::Generator2D(0.0));
+    scatter.Update();
+    ASSERT_TRUE(scatter.GetInstances().empty());
+}
+
+TEST(Scatter, PartialUpdate) {
+    Scatter scatter(MakeDesc(0));
+    scatter.Update();
+    const uint32_t version = scatter.GetVersion();
+
+    // the same density doesn't change anything
+    scatter.SetDensity(math::Generator2D(1.0));
+    ASSERT_EQ(scatter.Update(), 0);
+    ASSERT_EQ(scatter.GetVersion(), version);
+
+    // only the right half is changed, the tile column x in [-4, 4) contains the border
+    scatter.SetDensity(LeftHalfDensity(), math::RectF(0.f, -10.f, 20.f, 30.f));
+    ASSERT_EQ(scatter.Update(), 12);
+    ASSERT_NE(scatter.GetVersion(), version);
+    for (uint32_t ty=0; ty!=scatter.GetTileCountY(); ++ty) {
+        ASSERT_FALSE(scatter.GetTileInstances(0, ty).empty());
+        ASSERT_TRUE(scatter.GetTileInstances(4, ty).empty());
+    }
+
+    // the partial update gives the same result as the full generation
+    Scatter scatterFull(MakeDesc(0));
+    scatterFull.SetDensity(LeftHalfDensity());
+    scatterFull.Update();
+    ASSERT_TRUE(IsEqual(scatter.GetInstances(), scatterFull.GetInstances()));
+}
+
+}
@@ -0,0 +1,138 @@
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include "test/test.h"
+#include "core/math/generator_type.h"
+#include "middleware/generator/texture/texel_baker.h"
+
+
+namespace {
+
+math::Generator2D Wave() {
+    return math::Generator2D([](double x, double y) { return std::sin(x * 0.7) * std::cos(y * 0.3); });
+}
+
+std::vector<uint32_t> BakeFull(const math::Generator2D& input, const math::RectF& rect, math::Size size) {
+    TexelBaker baker;
+    baker.Bake(input, rect, size);
+    const auto* texels = baker.GetTexels();
+
+    return std::vector<uint32_t>(texels, texels + size.w * size.h);
+}
+
+std::vector<uint32_t> GetTexels(const TexelBaker& baker, math::Size size) {
+    return std::vector<uint32_t>(baker.GetTexels(), baker.GetTexels() + size.w * size.h);
+}
+
+// the texture: only the rects returned by Bake are copied
+void Upload(const TexelBaker& baker, const std::vector<math::Rect>& rects, math::Size size, std::vector<uint32_t>& texture) {
+    texture.resize(size.w * size.h);
+    for (const auto& rect: rects) {
+        const uint32_t* src = baker.GetTexels(rect);
+        for (uint32_t y=0; y!=rect.h; ++y) {
+            std::copy_n(src + y * size.w, rect.w, &texture[(rect.y + y) * size.w + rect.x]);
+        }
+    }
+}
+
+TEST(TexelBaker, FullBake) {
+    TexelBaker baker;
+    const math::Size size(100, 70);
+    const auto& rects = baker.Bake(Wave(), math::RectF(-5.f, -5.f, 10.f, 7.f), size);
+    ASSERT_EQ(rects.size(), 1);
+    ASSERT_EQ(rects[0].w, size.w);
+    ASSERT_EQ(rects[0].h, size.h);
+    ASSERT_EQ(baker.GetSampledCount(), size.w * size.h);
+    ASSERT_EQ(baker.GetStride(), size.w * 4);
+
+    // nothing has changed
+    ASSERT_TRUE(baker.Bake(Wave(), math::RectF(-5.f, -5.f, 10.f, 7.f), size).empty());
+    ASSERT_EQ(baker.GetSampledCount(), 0);
+}
+
+TEST(TexelBaker, Pan) {
+    TexelBaker baker;
+    const math::Size size(128, 64);
+    // texel size = 0.125
+    math::RectF rect(-8.f, -4.f, 16.f, 8.f);
+    std::vector<uint32_t> texture;
+    Upload(baker, baker.Bake(Wave(), rect, size), size, texture);
+
+    const std::vector<std::pair<int32_t, int32_t>> shifts = {{3, 0}, {-5, 0}, {0, 2}, {0, -7}, {4, -3}, {-6, 5}};
+    for (const auto& [dx, dy]: shifts) {
+        rect.x += static_cast<float>(dx) * 0.125f;
+        rect.y += static_cast<float>(dy) * 0.125f;
+        const auto& rects = baker.Bake(Wave(), rect, size);
+        ASSERT_FALSE(rects.empty());
+        const size_t exposed = static_cast<size_t>(std::abs(dx)) * size.h + static_cast<size_t>(std::abs(dy)) * (size.w - static_cast<uint32_t>(std::abs(dx)));
+        ASSERT_EQ(baker.GetSampledCount(), exposed);
+        const auto expected = BakeFull(Wave(), rect, size);
+        ASSERT_EQ(GetTexels(baker, size), expected);
+        Upload(baker, rects, size, texture);
+        ASSERT_EQ(texture, expected);
+    }
+
+    // not a whole number of texels
+    rect.x += 0.05f;
+    Upload(baker, baker.Bake(Wave(), rect, size), size, texture);
+    ASSERT_EQ(baker.GetSampledCount(), size.w * size.h);
+    ASSERT_EQ(GetTexels(baker, size), BakeFull(Wave(), rect, size));
+    ASSERT_EQ(texture, BakeFull(Wave(), rect, size));
+}
+
+TEST(TexelBaker, PanUploadsOnlyChangedTiles) {
+    TexelBaker baker;
+    const math::Size size(128, 128);
+    // the wave along x only, the tiles don't change by a shift along y
+    const auto input = math::Generator2D([](double x, double /* y */) { return std::sin(x * 0.7); });
+    math::RectF rect(0.f, 0.f, 128.f, 128.f);
+    std::vector<uint32_t> texture;
+    Upload(baker, baker.Bake(input, rect, size), size, texture);
+
+    rect.y += 5.f;
+    ASSERT_TRUE(baker.Bake(input, rect, size).empty());
+    ASSERT_EQ(baker.GetSampledCount(), 5 * size.w);
+
+    rect.x += 3.f;
+    const auto& rects = baker.Bake(input, rect, size);
+    ASSERT_EQ(rects.size(), 16);
+    for (const auto& tileRect: rects) {
+        ASSERT_EQ(tileRect.w, TexelBaker::TileSize);
+        ASSERT_EQ(tileRect.h, TexelBaker::TileSize);
+    }
+    Upload(baker, rects, size, texture);
+    ASSERT_EQ(texture, BakeFull(input, rect, size));
+}
+
+TEST(TexelBaker, ChangedRect) {
+    TexelBaker baker;
+    const math::Size size(128, 128);
+    const math::RectF rect(0.f, 0.f, 128.f, 128.f);
+    baker.Bake(Wave(), rect, size);
+
+    // local change inside the one tile
+    auto changed = math::Generator2D([](double x, double y) {
+        return ((x >= 40.) && (x < 50.) && (y >= 70.) && (y < 80.)) ? 1. : std::sin(x * 0.7) * std::cos(y * 0.3);
+    });
+    baker.Invalidate(math::RectF(40.f, 70.f, 10.f, 10.f));
+    const auto& rects = baker.Bake(changed, rect, size);
+    ASSERT_EQ(rects.size(), 1);
+    ASSERT_EQ(rects[0].x, 32);
+    ASSERT_EQ(rects[0].y, 64);
+    ASSERT_EQ(baker.GetSampledCount(), TexelBaker::TileSize * TexelBaker::TileSize);
+    ASSERT_EQ(GetTexels(baker, size), BakeFull(changed, rect, size));
+
+    // the input has changed everywhere, but the texels are the same, so nothing to upload
+    baker.Invalidate();
+    ASSERT_TRUE(baker.Bake(changed, rect, size).empty());
+    ASSERT_EQ(baker.GetSampledCount(), size.w * size.h);
+
+    // resize
+    ASSERT_EQ(baker.Bake(changed, rect, math::Size(64, 64)).size(), 1);
+    ASSERT_EQ(GetTexels(baker, math::Size(64, 64)), BakeFull(changed, rect, math::Size(64, 64)));
+}
+
+}
@@ -0,0 +1,85 @@
+#include <vector>
+#include <cstdint>
+
+#include "test/test.h"
+#include "core/math/generator_type.h"
+#include "middleware/generator/texture/tile_sampler.h"
+
+
+namespace {
+
+TileSamplerDesc MakeDesc(uint32_t threadCount) {
+    TileSamplerDesc desc;
+    desc.region = math::RectF(-10.f, 20.f, 50.f, 30.f);
+    desc.size = math::Size(50, 30);
+    desc.tileSize = 8;
+    desc.threadCount = threadCount;
+
+    return desc;
+}
+
+// the generator rect maps one unit to one sample, so the sample value is x + y * 1000 in the sample space
+math::Generator2D SampleIndex() {
+    return math::Generator2D([](double x, double y) -> double { return (x + 10.) + (y - 20.) * 1000.; });
+}
+
+std::vector<float> SampleAll(TileSampler& sampler, bool bottomUp, std::vector<uint32_t>& bandRows) {
+    const auto size = sampler.GetDesc().size;
+    std::vector<float> result(static_cast<size_t>(size.w) * static_cast<size_t>(size.h), -1.f);
+    sampler.Sample(SampleIndex(), [&result, &bandRows, size](const float* rows, uint32_t y, uint32_t rowsCount) {
+        bandRows.push_back(y);
+        for (uint32_t i=0; i!=rowsCount * size.w; ++i) {
+            result[y * size.w + i] = rows[i];
+        }
+    }, bottomUp);
+
+    return result;
+}
+
+TEST(TileSampler, SampleAllRegion) {
+    TileSampler sampler(MakeDesc(4));
+    ASSERT_EQ(sampler.GetBandCount(), 4);
+
+    std::vector<uint32_t> bandRows;
+    const auto result = SampleAll(sampler, false, bandRows);
+    ASSERT_EQ(sampler.GetSampledCount(), 50 * 30);
+    ASSERT_EQ(bandRows, std::vector<uint32_t>({0, 8, 16, 24}));
+    for (uint32_t y=0; y!=30; ++y) {
+        for (uint32_t x=0; x!=50; ++x) {
+            ASSERT_FLOAT_EQ(static_cast<float>(x + y * 1000), result[y * 50 + x]);
+        }
+    }
+}
+
+TEST(TileSampler, BottomUp) {
+    TileSampler sampler(MakeDesc(4));
+    std::vector<uint32_t> bandRows;
+    const auto bottomUp = SampleAll(sampler, true, bandRows);
+    ASSERT_EQ(bandRows, std::vector<uint32_t>({24, 16, 8, 0}));
+
+    TileSampler singleThread(MakeDesc(1));
+    bandRows.clear();
+    const auto topDown = SampleAll(singleThread, false, bandRows);
+    ASSERT_EQ(topDown, bottomUp);
+}
+
+TEST(TileSampler, ThreadCount) {
+    ASSERT_EQ(TileSampler(MakeDesc(4)).GetThreadCount(), 4);
+    ASSERT_EQ(TileSampler(MakeDesc(1)).GetThreadCount(), 1);
+    // not more than the tiles of a band: 50 / 8 -> 7 tiles
+    ASSERT_EQ(TileSampler(MakeDesc(16)).GetThreadCount(), 7);
+    // all hardware threads
+    ASSERT_GE(TileSampler(MakeDesc(0)).GetThreadCount(), 1);
+}
+
+TEST(TileSampler, InvalidDesc) {
+    auto desc = MakeDesc(1);
+    desc.tileSize = 0;
+    ASSERT_ANY_THROW(TileSampler sampler(desc));
+
+    desc = MakeDesc(1);
+    desc.size = math::Size(0, 10);
+    ASSERT_ANY_THROW(TileSampler sampler(desc));
+}
+
+}
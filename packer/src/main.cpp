@@ -0,0 +1,126 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <string_view>
+
+#include "core/common/timer.h"
+#include "core/common/exception.h"
+#include "core/path/asset_archive.h"
+
+
+namespace {
+
+constexpr const char* USAGE =
+    "usage: terra_packer --add <path> [--add <path> ...] --out <file> [options]\n"
+    "Packs the asset files into one archive for FileManager::MountArchive\n"
+    "  --root <dir>         the entries are named by the paths relative to it, default current directory\n"
+    "  --add <path>         file or directory (recursively) relative to the root\n"
+    "  --out <file>         output archive\n"
+    "  --align <bytes>      alignment of the stored entries, the power of two, default 16\n"
+    "  --compress <0|1>     LZ4 compression of the entries, default 1\n";
+
+struct Options {
+    std::filesystem::path root = ".";
+    std::vector<std::filesystem::path> paths;
+    std::filesystem::path outPath;
+    AssetArchiveDesc desc;
+};
+
+uint32_t ParseUInt(std::string_view name, const std::string& value) {
+    char* end = nullptr;
+    const unsigned long long number = std::strtoull(value.c_str(), &end, 10);
+    if (value.empty() || (*end != '\0') || (number > UINT32_MAX)) {
+        throw EngineError("wrong value '{}' of {}, expected unsigned integer", value, name);
+    }
+
+    return static_cast<uint32_t>(number);
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i=1; i<argc; i+=2) {
+        const std::string_view name = argv[i];
+        if ((name == "-h") || (name == "--help")) {
+            std::fputs(USAGE, stdout);
+            std::exit(EXIT_SUCCESS);
+        }
+        if (i + 1 == argc) {
+            throw EngineError("missing value of {}", name);
+        }
+
+        const std::string value = argv[i + 1];
+        if (name == "--root") {
+            options.root = value;
+        } else if (name == "--add") {
+            options.paths.emplace_back(value);
+        } else if (name == "--out") {
+            options.outPath = value;
+        } else if (name == "--align") {
+            options.desc.alignment = ParseUInt(name, value);
+        } else if (name == "--compress") {
+            options.desc.compress = (ParseUInt(name, value) != 0);
+        } else {
+            throw EngineError("unknown option {}", name);
+        }
+    }
+
+    if (options.paths.empty() || options.outPath.empty()) {
+        throw EngineError("--add and --out are required");
+    }
+
+    return options;
+}
+
+void AddPath(AssetArchiveWriter& writer, const std::filesystem::path& root, const std::filesystem::path& path) {
+    const auto fullPath = root / path;
+    if (std::filesystem::is_regular_file(fullPath)) {
+        writer.AddFile(path, fullPath);
+        return;
+    }
+    if (!std::filesystem::is_directory(fullPath)) {
+        throw EngineError("file or directory '{}' doesn't exist", fullPath.c_str());
+    }
+
+    for (const auto& entry: std::filesystem::recursive_directory_iterator(fullPath)) {
+        if (entry.is_regular_file()) {
+            writer.AddFile(std::filesystem::relative(entry.path(), root), entry.path());
+        }
+    }
+}
+
+int Run(const Options& options) {
+    Timer timer;
+    timer.Start();
+
+    AssetArchiveWriter writer;
+    for (const auto& path: options.paths) {
+        AddPath(writer, options.root, path);
+    }
+    const auto stats = writer.Write(options.outPath, options.desc);
+    const double totalTime = timer.TimePoint();
+
+    // one line with key=value pairs for CI scripts
+    std::printf("entries=%u compressed=%u original_bytes=%ju archive_bytes=%ju time_s=%.3f\n",
+        stats.entriesCount,
+        stats.compressedCount,
+        static_cast<uintmax_t>(stats.originalSize),
+        static_cast<uintmax_t>(stats.archiveSize),
+        totalTime);
+
+    return EXIT_SUCCESS;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        return Run(ParseOptions(argc, argv));
+    } catch(const std::exception& e) {
+        std::fprintf(stderr, "error: %s\n%s", e.what(), USAGE);
+        return EXIT_FAILURE;
+    }
+}
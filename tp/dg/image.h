@@ -0,0 +1,9 @@
+#pragma once
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wfloat-equal"
+#if defined(__GNUC__)
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+#include <DiligentTools/TextureLoader/interface/Image.h>
+#pragma GCC diagnostic pop